@@ -0,0 +1,123 @@
+/**
+ * @file card_dispatch_bench.cpp
+ * @brief Microbenchmark of card target resolution
+ * @details Compares resolving a card target with dynamic_cast against the
+ *          EntityKind tag used by Character::from, both on the bare lookup
+ *          and on a full Poison play against a mixed pool of targets
+ */
+
+#include "Character.h"
+#include "Entity.h"
+#include "GameContext.h"
+#include "Poison.h"
+#include "Warrior.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace {
+    /** @brief Number of lookups timed per variant */
+    constexpr size_t LOOKUPS = 20000000;
+
+    /** @brief Number of card plays timed per variant */
+    constexpr size_t PLAYS = 2000000;
+
+    /** @brief Number of targets in the pool */
+    constexpr size_t POOL_SIZE = 64;
+
+    /**
+     * @brief Time a callable
+     * @param label Name printed with the result
+     * @param iterations Number of iterations the callable performs
+     * @param body The work to time
+     * @details Prints the average cost of one iteration in nanoseconds
+     */
+    template <typename Body>
+    void measure(const char* label, size_t iterations, Body body) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+        std::printf("%-28s %8.2f ns/op\n", label, elapsed.count() / iterations);
+    }
+
+    /**
+     * @brief Poison play that resolves its target with dynamic_cast
+     * @param target The entity the card is played on
+     * @details Mirrors the previous Poison::play so both variants do the same work
+     */
+    void playPoisonWithRtti(Entity& target) {
+        if (Character* character = dynamic_cast<Character*>(&target)) {
+            character->applyEffect(EffectType::POISON, 1.0f, 3, 5);
+        }
+    }
+
+    /**
+     * @brief Poison play that resolves its target through the kind tag
+     * @param target The entity the card is played on
+     */
+    void playPoisonWithTag(Entity& target) {
+        if (Character* character = Character::from(target)) {
+            character->applyEffect(EffectType::POISON, 1.0f, 3, 5);
+        }
+    }
+}
+
+/**
+ * @brief Entry point of the benchmark
+ * @return 0
+ */
+int main() {
+    GameContext context(1, nullptr, GameContext::ClockMode::VIRTUAL);
+
+    // Every fourth target is a plain entity, so both branches are exercised
+    std::vector<std::unique_ptr<Entity>> pool;
+    auto resetPool = [&] {
+        pool.clear();
+        for (size_t i = 0; i < POOL_SIZE; ++i) {
+            if (i % 4 == 0) {
+                pool.push_back(std::make_unique<Entity>("Dummy", 100, 0));
+            } else {
+                pool.push_back(std::make_unique<Warrior>("Warrior", 100, 50, 20, 5));
+            }
+            pool.back()->setContext(&context);
+        }
+    };
+    resetPool();
+
+    size_t hits = 0;
+    measure("lookup dynamic_cast", LOOKUPS, [&] {
+        for (size_t i = 0; i < LOOKUPS; ++i) {
+            Entity* volatile entity = pool[i % POOL_SIZE].get();
+            hits += dynamic_cast<Character*>(entity) != nullptr;
+        }
+    });
+    measure("lookup Character::from", LOOKUPS, [&] {
+        for (size_t i = 0; i < LOOKUPS; ++i) {
+            Entity* volatile entity = pool[i % POOL_SIZE].get();
+            hits += Character::from(*entity) != nullptr;
+        }
+    });
+
+    measure("play dynamic_cast", PLAYS, [&] {
+        for (size_t i = 0; i < PLAYS; ++i) {
+            playPoisonWithRtti(*pool[i % POOL_SIZE]);
+        }
+    });
+    resetPool();
+    measure("play Character::from", PLAYS, [&] {
+        for (size_t i = 0; i < PLAYS; ++i) {
+            playPoisonWithTag(*pool[i % POOL_SIZE]);
+        }
+    });
+    resetPool();
+    Poison poison;
+    measure("play Poison::play", PLAYS, [&] {
+        for (size_t i = 0; i < PLAYS; ++i) {
+            poison.play(*pool[i % POOL_SIZE], context);
+        }
+    });
+
+    std::printf("(%zu characters resolved)\n", hits);
+    return 0;
+}
@@ -0,0 +1,314 @@
+/**
+ * @file combat_benchmarks.cpp
+ * @brief Google Benchmark suite of the combat hot paths
+ * @details Measures damage, effect ticks, every card, the deck operations,
+ *          the decision of every AI and a full headless battle. Benchmarks
+ *          are parameterized by effect count and deck size. Run with
+ *          --benchmark_out=FILE --benchmark_out_format=json to get results
+ *          that can be compared between builds.
+ *
+ *          Benchmarks that change their characters restore them from a
+ *          BattleState snapshot every iteration; BM_SnapshotRestore times
+ *          that restore alone so it can be subtracted.
+ */
+
+#include "AdvancedAI.h"
+#include "BattleMode.h"
+#include "BattleState.h"
+#include "BossAI.h"
+#include "Card.h"
+#include "CardCatalog.h"
+#include "Deck.h"
+#include "EasyAI.h"
+#include "Entity.h"
+#include "GameContext.h"
+#include "Mage.h"
+#include "MctsAI.h"
+#include "Warrior.h"
+#include <benchmark/benchmark.h>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace {
+    /** @brief Seed of every benchmark session */
+    constexpr uint64_t SEED = 42;
+
+    /** @brief Playouts of one MctsAI decision, so the search does fixed work */
+    constexpr uint64_t MCTS_ITERATIONS = 256;
+
+    /** @brief Search threads of one MctsAI decision, so the timing does not depend on the machine */
+    constexpr unsigned MCTS_THREADS = 1;
+
+    /**
+     * @brief Create a silent session
+     * @return Session without output and with virtual time
+     */
+    std::unique_ptr<GameContext> makeContext() {
+        return std::make_unique<GameContext>(SEED, nullptr, GameContext::ClockMode::VIRTUAL);
+    }
+
+    /**
+     * @brief Build a deck cycling through the catalog
+     * @param size Number of cards
+     * @return The deck
+     */
+    std::shared_ptr<Deck> makeDeck(size_t size) {
+        auto deck = std::make_shared<Deck>();
+        for (size_t i = 0; i < size; ++i) {
+            deck->addCard(static_cast<CardId>(i % CardCatalog::size()));
+        }
+        return deck;
+    }
+
+    /**
+     * @brief Pair of characters bound to a silent session
+     */
+    struct Duel {
+        /** @brief Session both characters are bound to */
+        std::unique_ptr<GameContext> context = makeContext();
+
+        /** @brief Character acting in the benchmark */
+        std::shared_ptr<Character> hero;
+
+        /** @brief Its opponent */
+        std::shared_ptr<Character> enemy;
+
+        /**
+         * @brief Constructor for Duel
+         * @param deckSize Number of cards in the hero's deck
+         */
+        explicit Duel(size_t deckSize = 3) {
+            GameContext::Mute mute(GameContext::threadDefault());
+            hero = std::make_shared<Mage>("Hero", Entity::MAX_HEALTH, 200, 15, 5);
+            enemy = std::make_shared<Warrior>("Enemy", Entity::MAX_HEALTH, 100, 14, 6);
+            hero->setContext(context.get());
+            enemy->setContext(context.get());
+            hero->setDeck(makeDeck(deckSize));
+            hero->setTarget(enemy);
+            enemy->setTarget(hero);
+        }
+
+        /**
+         * @brief Break the ownership cycles of targets and AIs
+         */
+        ~Duel() {
+            for (const auto& side : {hero, enemy}) {
+                side->setAI(nullptr);
+                side->setTarget(nullptr);
+            }
+        }
+    };
+
+    /**
+     * @brief Give a character a steady set of long-lasting effects
+     * @param character The character
+     * @param count Number of effects
+     * @details Poison and regeneration alternate, so health stays roughly
+     *          constant, and no effect expires during the benchmark
+     */
+    void applySteadyEffects(Character& character, int count) {
+        for (int i = 0; i < count; ++i) {
+            if (i % 2 == 0) {
+                character.applyEffect(EffectType::POISON, 1.0f, std::numeric_limits<int>::max(), 2);
+            } else {
+                character.applyEffect(EffectType::REGENERATION, 1.0f, std::numeric_limits<int>::max(), 0, 2);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Time restoring both sides of a duel from a snapshot
+ * @param state Benchmark state; range 0 is the hero's deck size
+ */
+static void BM_SnapshotRestore(benchmark::State& state) {
+    Duel duel(static_cast<size_t>(state.range(0)));
+    BattleState start = BattleState::capture(*duel.hero, *duel.enemy);
+    for (auto _ : state) {
+        start.restore(*duel.hero, *duel.enemy);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_SnapshotRestore)->Arg(4)->Arg(32)->Arg(256);
+
+/**
+ * @brief Time Entity::takeDamage on a character with active effects
+ * @param state Benchmark state; range 0 is the number of active effects
+ */
+static void BM_TakeDamage(benchmark::State& state) {
+    Duel duel;
+    applySteadyEffects(*duel.enemy, static_cast<int>(state.range(0)));
+    Entity& target = *duel.enemy;
+    for (auto _ : state) {
+        target.takeDamage(20);
+        if (target.getHealth() < Entity::MAX_HEALTH / 2) {
+            target.heal(Entity::MAX_HEALTH);
+        }
+        benchmark::DoNotOptimize(target.getHealth());
+    }
+}
+BENCHMARK(BM_TakeDamage)->Arg(0)->Arg(1)->Arg(8)->Arg(64);
+
+/**
+ * @brief Time one tick of Character::updateEffect
+ * @param state Benchmark state; range 0 is the number of active effects
+ */
+static void BM_UpdateEffect(benchmark::State& state) {
+    Duel duel;
+    applySteadyEffects(*duel.enemy, static_cast<int>(state.range(0)));
+    Character& target = *duel.enemy;
+    for (auto _ : state) {
+        target.updateEffect();
+        if (target.getHealth() < Entity::MAX_HEALTH / 2) {
+            target.heal(Entity::MAX_HEALTH);
+        }
+        benchmark::DoNotOptimize(target.getHealth());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UpdateEffect)->Arg(1)->Arg(8)->Arg(64);
+
+/**
+ * @brief Time Card::play of one catalog card, including a snapshot restore
+ * @param state Benchmark state; range 0 is the CardId
+ */
+static void BM_CardPlay(benchmark::State& state) {
+    Duel duel;
+    const std::shared_ptr<Card>& card = CardCatalog::get(static_cast<CardId>(state.range(0)));
+    state.SetLabel(card->getName());
+    BattleState start = BattleState::capture(*duel.hero, *duel.enemy);
+    for (auto _ : state) {
+        start.restore(*duel.hero, *duel.enemy);
+        card->play(*duel.enemy, *duel.context);
+        benchmark::DoNotOptimize(duel.enemy->getHealth());
+    }
+}
+BENCHMARK(BM_CardPlay)->DenseRange(0, static_cast<int>(CardCatalog::size()) - 1);
+
+/**
+ * @brief Time drawing the top card of a deck and putting it back
+ * @param state Benchmark state; range 0 is the deck size
+ */
+static void BM_DeckDrawCard(benchmark::State& state) {
+    auto context = makeContext();
+    auto deck = makeDeck(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::shared_ptr<Card> card = deck->drawCard(*context);
+        deck->addCard(card->getId());
+        benchmark::DoNotOptimize(card.get());
+    }
+}
+BENCHMARK(BM_DeckDrawCard)->Arg(4)->Arg(32)->Arg(256);
+
+/**
+ * @brief Time removing a card from the middle of a deck and adding it back
+ * @param state Benchmark state; range 0 is the deck size
+ */
+static void BM_DeckRemoveCard(benchmark::State& state) {
+    auto deck = makeDeck(static_cast<size_t>(state.range(0)));
+    CardId middle = deck->getCardIds()[deck->size() / 2];
+    for (auto _ : state) {
+        deck->removeCard(middle);
+        deck->addCard(middle);
+        benchmark::DoNotOptimize(deck->size());
+    }
+}
+BENCHMARK(BM_DeckRemoveCard)->Arg(4)->Arg(32)->Arg(256);
+
+/**
+ * @brief Time copying out the cards of a deck
+ * @param state Benchmark state; range 0 is the deck size
+ */
+static void BM_DeckGetCards(benchmark::State& state) {
+    auto deck = makeDeck(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::vector<std::shared_ptr<Card>> cards = deck->getCards();
+        benchmark::DoNotOptimize(cards.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DeckGetCards)->Arg(4)->Arg(32)->Arg(256);
+
+/**
+ * @brief Time one AI decision, including a snapshot restore
+ * @param state Benchmark state; range 0 is the hero's deck size
+ * @param makeAI Builds the AI for the duel
+ */
+template <typename MakeAI>
+static void decide(benchmark::State& state, MakeAI makeAI) {
+    Duel duel(static_cast<size_t>(state.range(0)));
+    std::shared_ptr<AI> ai = makeAI(duel);
+    duel.hero->setAI(ai);
+    BattleState start = BattleState::capture(*duel.hero, *duel.enemy);
+    for (auto _ : state) {
+        start.restore(*duel.hero, *duel.enemy);
+        ai->makeDecision(*duel.hero, *duel.enemy, *duel.context);
+        benchmark::DoNotOptimize(duel.enemy->getHealth());
+    }
+}
+
+/**
+ * @brief Time EasyAI::makeDecision
+ * @param state Benchmark state; range 0 is the hero's deck size
+ */
+static void BM_EasyAIDecision(benchmark::State& state) {
+    decide(state, [](Duel& duel) { return std::make_shared<EasyAI>(duel.hero); });
+}
+BENCHMARK(BM_EasyAIDecision)->Arg(4)->Arg(32)->Arg(256);
+
+/**
+ * @brief Time AdvancedAI::makeDecision
+ * @param state Benchmark state; range 0 is the hero's deck size
+ */
+static void BM_AdvancedAIDecision(benchmark::State& state) {
+    decide(state, [](Duel& duel) {
+        return std::make_shared<AdvancedAI>(duel.hero, duel.enemy, duel.hero->getDeck());
+    });
+}
+BENCHMARK(BM_AdvancedAIDecision)->Arg(4)->Arg(32)->Arg(256);
+
+/**
+ * @brief Time BossAI::makeDecision
+ * @param state Benchmark state; range 0 is the hero's deck size
+ */
+static void BM_BossAIDecision(benchmark::State& state) {
+    decide(state, [](Duel& duel) { return std::make_shared<BossAI>(duel.hero, duel.enemy, duel.hero->getDeck()); });
+}
+BENCHMARK(BM_BossAIDecision)->Arg(4)->Arg(32)->Arg(256);
+
+/**
+ * @brief Time MctsAI::makeDecision with a fixed number of playouts
+ * @param state Benchmark state; range 0 is the hero's deck size
+ */
+static void BM_MctsAIDecision(benchmark::State& state) {
+    decide(state, [](Duel&) {
+        auto ai = std::make_shared<MctsAI>(std::chrono::seconds(10), MCTS_THREADS);
+        ai->setMaxIterations(MCTS_ITERATIONS);
+        return ai;
+    });
+}
+BENCHMARK(BM_MctsAIDecision)->Arg(4)->Arg(32)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Time a full headless BattleMode battle, including a snapshot restore
+ * @param state Benchmark state; range 0 is the hero's deck size
+ */
+static void BM_HeadlessBattle(benchmark::State& state) {
+    Duel duel(static_cast<size_t>(state.range(0)));
+    duel.hero->setAI(std::make_shared<EasyAI>(duel.hero));
+    duel.enemy->setAI(std::make_shared<EasyAI>(duel.enemy));
+    BattleMode battle(duel.hero, duel.enemy, std::make_shared<AutoActionSource>());
+    battle.setContext(duel.context.get());
+    BattleState start = BattleState::capture(*duel.hero, *duel.enemy);
+    int64_t turns = 0;
+    for (auto _ : state) {
+        start.restore(*duel.hero, *duel.enemy);
+        battle.start();
+        turns += battle.getResult().turns;
+    }
+    state.counters["turns"] = benchmark::Counter(static_cast<double>(turns), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_HeadlessBattle)->Arg(4)->Arg(32)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -5,11 +5,25 @@
  *          that can control characters in the game
  */
 #pragma once
+#include <cstdint>
 #include <memory>
 
 // Forward declarations
 class Character;
 class Entity;
+class GameContext;
+
+/**
+ * @enum AIKind
+ * @brief Concrete kind of an AI controller, used to identify it without RTTI
+ */
+enum class AIKind : uint8_t {
+    CUSTOM,   /**< Controller of a class without a kind of its own */
+    EASY,     /**< EasyAI */
+    ADVANCED, /**< AdvancedAI */
+    BOSS,     /**< BossAI */
+    MCTS      /**< MctsAI */
+};
 
 /**
  * @class AI
@@ -18,15 +32,43 @@ class Entity;
  *          for characters during battles and other game modes
  */
 class AI {
+protected:
+    /** @brief Concrete kind of the controller, set by the constructors of tagged subclasses */
+    AIKind kind = AIKind::CUSTOM;
+
 public:
     /**
      * @brief Makes a decision for the controlled character
      * @param self The character controlled by this AI
      * @param target The target entity (usually an opponent)
+     * @param context Session the decision is made in
      * @details Implementation should decide what action to take
-     *          based on game state, character status, and target
+     *          based on game state, character status, and target.
+     *          Random draws and messages go through the given context.
+     */
+    virtual void makeDecision(Character& self, Entity& target, GameContext& context) = 0;
+
+    /**
+     * @brief Makes a decision in the session of the controlled character
+     * @param self The character controlled by this AI
+     * @param target The target entity (usually an opponent)
+     */
+    void makeDecision(Character& self, Entity& target);
+
+    /**
+     * @brief Get the concrete kind of the controller
+     * @return The kind tag
+     */
+    AIKind getKind() const { return kind; }
+
+    /**
+     * @brief Check whether every decision from now on is a basic attack
+     * @param self The character controlled by this AI
+     * @return True if makeDecision() will do nothing but call self.attack()
+     *         for the rest of the battle; false if unsure
+     * @details Lets the battle engine resolve attack-only stretches in closed form
      */
-    virtual void makeDecision(Character& self, Entity& target) = 0;
+    virtual bool onlyAttacks(const Character& self) const { return false; }
     
     /**
      * @brief Virtual destructor
@@ -39,9 +39,11 @@ public:
      * @brief Makes the best decision for the character in the current game state
      * @param self The character controlled by the AI
      * @param target The entity being targeted by the AI
+     * @param context Session the decision is made in
      * @override Override of AI's makeDecision method
      */
-    void makeDecision(Character& self, Entity& target) override;
+    void makeDecision(Character& self, Entity& target, GameContext& context) override;
+    using AI::makeDecision;
 
 private:
     /**
@@ -49,14 +51,18 @@ private:
      * 
      * This method analyzes the available cards, character status, and target status
      * to determine the optimal card to play.
+     *
+     * @param context Session the decision is made in
      */
-    void useBestCard();
+    void useBestCard(GameContext& context);
     
     /**
      * @brief Decides between attacking or defending based on game state
      * 
      * This method evaluates the health, mana, and status effects of both characters
      * to determine if an offensive or defensive approach is optimal.
+     *
+     * @param context Session the decision is made in
      */
-    void attackOrDefend();
+    void attackOrDefend(GameContext& context);
 };
\ No newline at end of file
@@ -15,9 +15,6 @@
  *          special abilities that can slow enemies with ice-based attacks
  */
 class Archer : public Character {
-private:
-    /** @brief The archer's deck of cards */
-    std::shared_ptr<Deck> deck;
 public:
     /**
      * @brief Constructor for Archer
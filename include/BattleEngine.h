@@ -0,0 +1,329 @@
+/**
+ * @file BattleEngine.h
+ * @brief Definition of the headless battle engine
+ * @details This file defines the BattleEngine class, which resolves combat
+ *          between two characters without prompts, animations or screen output.
+ *          Interactive game modes drive it through ActionSource and BattleObserver.
+ */
+#pragma once
+#include "Character.h"
+#include "GameContext.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+class ReplayRecorder;
+
+/**
+ * @enum BattleAction
+ * @brief Possible actions during battle
+ */
+enum class BattleAction {
+    ATTACK,  /**< Basic attack action */
+    ABILITY, /**< Play a card from the deck */
+    DEFEND,  /**< Defensive stance */
+    ITEM,    /**< Use an item */
+    AUTO,    /**< Let the character's AI, or without one its class routine, act */
+    UNDO     /**< Take back the previous round; needs a command log */
+};
+
+/**
+ * @struct BattleChoice
+ * @brief An action chosen for a turn together with its argument
+ */
+struct BattleChoice {
+    /** @brief Chosen action */
+    BattleAction action;
+
+    /** @brief Index of the card (ABILITY) or item (ITEM) to use */
+    size_t index;
+
+    /**
+     * @brief Constructor for BattleChoice
+     * @param a Chosen action
+     * @param i Index of the card or item, ignored for other actions
+     */
+    BattleChoice(BattleAction a = BattleAction::ATTACK, size_t i = 0)
+        : action(a), index(i) {}
+};
+
+/**
+ * @class ActionSource
+ * @brief Supplies the player's actions to the battle engine
+ * @details Implemented by interactive modes (reading std::cin) as well as
+ *          by automated controllers used in headless simulations
+ */
+class ActionSource {
+public:
+    /**
+     * @brief Choose the next action for a character
+     * @param self The character whose turn it is
+     * @param opponent The opposing character
+     * @return The chosen action
+     */
+    virtual BattleChoice chooseAction(Character& self, Character& opponent) = 0;
+
+    /**
+     * @brief Check whether the source always hands the turn to the character's AI
+     * @return True if chooseAction() returns BattleAction::AUTO whatever the
+     *         state of the battle, which lets the engine predict the player's moves
+     */
+    virtual bool isAutomatic() const { return false; }
+
+    /**
+     * @brief Virtual destructor
+     */
+    virtual ~ActionSource() = default;
+};
+
+/**
+ * @class AutoActionSource
+ * @brief Action source that hands every turn to the character's AI routine
+ */
+class AutoActionSource : public ActionSource {
+public:
+    /**
+     * @brief Choose the next action for a character
+     * @param self The character whose turn it is
+     * @param opponent The opposing character
+     * @return Always BattleAction::AUTO
+     */
+    BattleChoice chooseAction(Character& self, Character& opponent) override {
+        return BattleChoice(BattleAction::AUTO);
+    }
+
+    /**
+     * @brief Check whether the source always hands the turn to the character's AI
+     * @return Always true
+     */
+    bool isAutomatic() const override { return true; }
+};
+
+/**
+ * @class BattleObserver
+ * @brief Receives notifications about the progress of a battle
+ * @details Used by interactive modes to render the battle log; headless
+ *          runs simply do not attach an observer
+ */
+class BattleObserver {
+public:
+    /**
+     * @brief Called after the player's action has been resolved
+     * @param player The player character
+     * @param enemy The enemy character
+     * @param choice The action the player chose
+     * @param card The card that was played, or nullptr for non-card actions
+     * @param succeeded False if the action could not be performed
+     */
+    virtual void onPlayerAction(const Character& player, const Character& enemy,
+                                const BattleChoice& choice, const Card* card, bool succeeded) {}
+
+    /**
+     * @brief Called right before the enemy acts
+     * @param enemy The enemy character
+     * @param player The player character
+     */
+    virtual void onEnemyTurn(const Character& enemy, const Character& player) {}
+
+    /**
+     * @brief Called after the player asked to take back the previous round
+     * @param player The player character
+     * @param enemy The enemy character
+     * @param undone False if there was no round to take back
+     */
+    virtual void onUndo(const Character& player, const Character& enemy, bool undone) {}
+
+    /**
+     * @brief Virtual destructor
+     */
+    virtual ~BattleObserver() = default;
+};
+
+/**
+ * @struct BattleResult
+ * @brief Outcome and statistics of a finished battle
+ */
+struct BattleResult {
+    /**
+     * @enum Winner
+     * @brief Side that won the battle
+     */
+    enum class Winner {
+        PLAYER, /**< The enemy was defeated */
+        ENEMY,  /**< The player was defeated */
+        DRAW    /**< Both survived the turn limit */
+    };
+
+    /** @brief Side that won the battle */
+    Winner winner = Winner::DRAW;
+
+    /** @brief Identifier of the battle in its session; replays the battle's random draws */
+    uint64_t battleId = 0;
+
+    /** @brief Number of rounds played */
+    int turns = 0;
+
+    /** @brief Health removed from the enemy by the player's actions and effects */
+    int playerDamageDealt = 0;
+
+    /** @brief Health removed from the player by the enemy's actions and effects */
+    int enemyDamageDealt = 0;
+
+    /** @brief Number of effects applied during the player's actions */
+    int playerEffectsApplied = 0;
+
+    /** @brief Number of effects applied during the enemy's actions */
+    int enemyEffectsApplied = 0;
+
+    /** @brief Rounds resolved in closed form instead of being played, included in turns */
+    int fastForwardedTurns = 0;
+};
+
+/**
+ * @class BattleEngine
+ * @brief Resolves turn-based combat between two characters
+ * @details The engine runs the same round structure as the interactive battle:
+ *          the player acts, the enemy answers unless the player played a card
+ *          or used an item, and then active effects tick on both sides.
+ *          It performs no terminal input, sleeps or flushes. Both combatants are
+ *          bound to the engine's context for the duration of run(); while quiet
+ *          (the default) the context's combat messages are muted. Every round
+ *          draws from its own (battle id, turn) stream of the context.
+ */
+class BattleEngine {
+private:
+    /** @brief Player character */
+    std::shared_ptr<Character> player;
+
+    /** @brief Enemy character */
+    std::shared_ptr<Character> enemy;
+
+    /** @brief Session the battle runs in */
+    GameContext& context;
+
+    /** @brief Maximum number of rounds, 0 for no limit */
+    int maxTurns = 0;
+
+    /** @brief Whether combat messages are muted while the battle runs */
+    bool quiet = true;
+
+    /** @brief Identifier of the battle in its session, 0 to number it automatically */
+    uint64_t battleId = 0;
+
+    /** @brief History that lets the player undo rounds, nullptr to disable undo */
+    CommandLog* commandLog = nullptr;
+
+    /** @brief Whether attack-only stretches of the battle are resolved in closed form */
+    bool fastForward = true;
+
+    /** @brief Recorder taking keyframes of the battle, nullptr for none */
+    ReplayRecorder* recorder = nullptr;
+
+    /** @brief Statistics and round count the battle continues from */
+    BattleResult progress;
+
+public:
+    /**
+     * @brief Constructor for BattleEngine
+     * @param player Player character
+     * @param enemy Enemy character
+     * @param context Session the battle runs in; it must outlive the engine
+     */
+    BattleEngine(std::shared_ptr<Character> player, std::shared_ptr<Character> enemy,
+                 GameContext& context = GameContext::threadDefault());
+
+    /**
+     * @brief Limit the number of rounds
+     * @param turns Maximum number of rounds, 0 for no limit
+     */
+    void setMaxTurns(int turns) { maxTurns = turns; }
+
+    /**
+     * @brief Choose whether combat messages are muted
+     * @param q True to mute the context's combat messages during run()
+     */
+    void setQuiet(bool q) { quiet = q; }
+
+    /**
+     * @brief Choose which random streams of the session the battle uses
+     * @param id Identifier of the battle, 0 to take the session's next one
+     * @details Running a battle again with the same session seed and id
+     *          repeats all of its random draws
+     */
+    void setBattleId(uint64_t id) { battleId = id; }
+
+    /**
+     * @brief Let the player undo rounds
+     * @param log History to record the battle into, nullptr to disable undo
+     * @details The log is attached to the context during run() and cleared
+     *          when the battle starts. BattleAction::UNDO then reverts the
+     *          previous round, statistics included, and replays its turn
+     *          number so the round draws the same random numbers again.
+     */
+    void setCommandLog(CommandLog* log) { commandLog = log; }
+
+    /**
+     * @brief Choose whether attack-only stretches are resolved in closed form
+     * @param enabled False to play every round
+     * @details Once neither side can do anything but a basic attack, the
+     *          rounds before the one someone falls in are skipped and their
+     *          end state applied directly. This only happens while nothing
+     *          watches the rounds: the engine is quiet, no observer or command
+     *          log is attached and the action source is automatic. The result
+     *          and the characters end up exactly as if every round was played.
+     */
+    void setFastForward(bool enabled) { fastForward = enabled; }
+
+    /**
+     * @brief Let a replay recorder take keyframes of the battle
+     * @param replayRecorder Recorder told about the start of every round, nullptr for none
+     */
+    void setReplayRecorder(ReplayRecorder* replayRecorder) { recorder = replayRecorder; }
+
+    /**
+     * @brief Continue a battle from a saved point instead of starting it
+     * @param saved Statistics and round count of the rounds already played
+     * @details The characters must hold the state they had at that point.
+     *          run() then counts on from saved.turns, so later rounds draw
+     *          from the same streams as in the original battle.
+     */
+    void resumeFrom(const BattleResult& saved) { progress = saved; }
+
+    /**
+     * @brief Run the battle to completion
+     * @param source Supplier of the player's actions
+     * @param observer Optional observer notified about the battle's progress
+     * @return Outcome and statistics of the battle
+     */
+    BattleResult run(ActionSource& source, BattleObserver* observer = nullptr);
+
+private:
+    /**
+     * @brief Resolve the player's action
+     * @param choice The action to perform
+     * @param observer Optional observer to notify
+     * @return True if the enemy gets to answer this round
+     */
+    bool playerTurn(const BattleChoice& choice, BattleObserver* observer);
+
+    /**
+     * @brief Let the enemy act
+     * @param observer Optional observer to notify
+     */
+    void enemyTurn(BattleObserver* observer);
+
+    /**
+     * @brief Let a character act on its own
+     * @param self The acting character
+     * @param opponent The character it fights
+     */
+    void actOnOwn(Character& self, Character& opponent);
+
+    /**
+     * @brief Resolve the coming attack-only rounds in closed form
+     * @param result Result to add the skipped rounds and their damage to
+     * @return Number of rounds skipped, 0 if a side can still do more than
+     *         attack or someone falls in the next round
+     */
+    int skipAttackRounds(BattleResult& result);
+};
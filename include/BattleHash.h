@@ -0,0 +1,173 @@
+/**
+ * @file BattleHash.h
+ * @brief Definition of the Zobrist hash of battle states
+ * @details This file defines the BattleHash class, a 64-bit Zobrist hash
+ *          over the combat state of the two sides of a battle that search
+ *          code keeps up to date one mutation at a time.
+ */
+#pragma once
+#include "Card.h"
+#include "CombatantStore.h"
+#include "Entity.h"
+#include <cstdint>
+
+struct BattleState;
+struct CombatantSnapshot;
+
+/**
+ * @class BattleHash
+ * @brief Incremental Zobrist hash of a battle between two sides
+ * @details The hash is the XOR of one key per feature of the state: health,
+ *          mana, defense, damage reduction and attack power of each side,
+ *          each active effect together with its position in the effect
+ *          list, the number of cards of each kind left in each deck, and
+ *          the side to move. Changing a feature XORs its old key out and
+ *          its new key in, so a mutation costs one or two key computations
+ *          no matter how large the state is.
+ *
+ *          Keys are derived from the feature and its value with a
+ *          SplitMix64 finalizer instead of being read from a random table,
+ *          so features without a fixed range such as defense need no table
+ *          and every hash is the same in every process. Sides are numbered
+ *          0 and 1; callers whose outcomes depend on anything else mix it
+ *          in with custom().
+ */
+class BattleHash {
+public:
+    /**
+     * @enum Feature
+     * @brief Integer stat of one side
+     */
+    enum class Feature : uint8_t {
+        HEALTH,           /**< Current health */
+        MANA,             /**< Current mana */
+        DEFENSE,          /**< Defense reported by Character::getDefense */
+        DAMAGE_REDUCTION, /**< Defense subtracted from incoming damage */
+        ATTACK_POWER      /**< Attack power */
+    };
+
+private:
+    /** @brief Current hash value */
+    uint64_t value = 0;
+
+public:
+    /**
+     * @brief Get the key of a stat value
+     * @param feature The stat
+     * @param side Side the stat belongs to
+     * @param statValue Value of the stat
+     * @return Key of the stat having that value
+     */
+    static uint64_t stat(Feature feature, uint32_t side, int statValue);
+
+    /**
+     * @brief Get the key of an active effect
+     * @param side Side the effect is active on
+     * @param slot Position of the effect in the side's effect list
+     * @param effect The effect
+     * @return Key of the effect at that position
+     */
+    static uint64_t effect(uint32_t side, size_t slot, const ActiveEffect& effect);
+
+    /**
+     * @brief Get the key of a deck holding some cards of a kind
+     * @param side Side the deck belongs to
+     * @param card Kind of card
+     * @param count Number of cards of that kind
+     * @return Key of the count, 0 for no cards
+     */
+    static uint64_t cards(uint32_t side, CardId card, uint32_t count);
+
+    /**
+     * @brief Get the key of the side to move
+     * @param side Side to move
+     * @return Key of that side being to move
+     */
+    static uint64_t sideToMove(uint32_t side);
+
+    /**
+     * @brief Get the key of a caller-defined feature
+     * @param side Side the feature belongs to
+     * @param tag Value of the feature
+     * @return Key distinct from every built-in feature
+     */
+    static uint64_t custom(uint32_t side, uint64_t tag);
+
+    /**
+     * @brief Hash the stats and effects of a combatant
+     * @param store Store holding the combatant
+     * @param handle The combatant
+     * @param side Side the combatant plays
+     * @return XOR of the combatant's stat and effect keys
+     * @details Deck contents are not in the store; add them with cards()
+     */
+    static uint64_t combatant(const CombatantStore& store, CombatantHandle handle, uint32_t side);
+
+    /**
+     * @brief Hash the stats, effects and deck of a snapshot
+     * @param snapshot The snapshot
+     * @param side Side the character plays
+     * @return XOR of the snapshot's stat, effect and card keys
+     */
+    static uint64_t combatant(const CombatantSnapshot& snapshot, uint32_t side);
+
+    /**
+     * @brief Hash a captured battle
+     * @param state The battle, with the player as side 0
+     * @param toMove Side to move
+     * @return Hash of the battle
+     */
+    static BattleHash of(const BattleState& state, uint32_t toMove);
+
+    /**
+     * @brief Get the hash value
+     * @return The hash of the state
+     */
+    uint64_t get() const { return value; }
+
+    /**
+     * @brief Add or remove a key
+     * @param key The key; toggling it twice leaves the hash unchanged
+     */
+    void toggle(uint64_t key) { value ^= key; }
+
+    /**
+     * @brief Follow a change of a stat
+     * @param feature The stat
+     * @param side Side the stat belongs to
+     * @param before Value before the change
+     * @param after Value after the change
+     */
+    void changeStat(Feature feature, uint32_t side, int before, int after) {
+        if (before != after) {
+            value ^= stat(feature, side, before) ^ stat(feature, side, after);
+        }
+    }
+
+    /**
+     * @brief Follow a change of the number of cards of a kind
+     * @param side Side the deck belongs to
+     * @param card Kind of card
+     * @param before Count before the change
+     * @param after Count after the change
+     */
+    void changeCards(uint32_t side, CardId card, uint32_t before, uint32_t after) {
+        if (before != after) {
+            value ^= cards(side, card, before) ^ cards(side, card, after);
+        }
+    }
+
+    /**
+     * @brief Compare two hashes
+     * @param other Hash to compare with
+     * @return True if both have the same value
+     */
+    bool operator==(const BattleHash& other) const { return value == other.value; }
+
+    /**
+     * @brief Compare two hashes
+     * @param other Hash to compare with
+     * @return True if the values differ
+     */
+    bool operator!=(const BattleHash& other) const { return value != other.value; }
+};
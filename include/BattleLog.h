@@ -0,0 +1,173 @@
+/**
+ * @file BattleLog.h
+ * @brief Definition of the on-screen battle log
+ * @details This file defines the BattleLog class, a fixed-capacity ring of
+ *          small records behind the battle log shown in the interface. The
+ *          text of an entry is only produced when the log is drawn.
+ */
+#pragma once
+#include "Card.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @class BattleLog
+ * @brief Most recent battle log entries of a session
+ * @details Adding an entry overwrites the oldest one once the log is full.
+ *          Entries refer to characters by actor id; the log remembers the
+ *          names of the characters its live entries mention in fixed
+ *          buffers, reusing those of names no longer mentioned, so a
+ *          running battle adds entries without allocating.
+ */
+class BattleLog {
+public:
+    /** @brief Maximum number of entries kept */
+    static constexpr size_t CAPACITY = 5;
+
+    /** @brief Longest name the log shows; longer names are cut short */
+    static constexpr size_t MAX_NAME_LENGTH = 31;
+
+    /**
+     * @enum Kind
+     * @brief What an entry reports
+     */
+    enum class Kind : uint8_t {
+        TEXT,            /**< Free text added with addText() */
+        ATTACK,          /**< Actor attacks other */
+        ENEMY_ATTACK,    /**< Actor, the enemy, attacks other */
+        CARD_USED,       /**< Actor uses card */
+        NOT_ENOUGH_MANA, /**< Actor lacks the mana for card */
+        DEFEND,          /**< Actor raises its defense by amount */
+        DAMAGE,          /**< Actor takes amount damage */
+        HEAL,            /**< Actor heals amount health */
+        VICTORY,         /**< Actor defeated other and gained amount experience */
+        KILLS,           /**< Actor has amount kills */
+        DEFEAT,          /**< Actor was defeated by other */
+        DRAW,            /**< The battle ended in a draw */
+        UNDO,            /**< Actor took back the last turn */
+        NOTHING_TO_UNDO  /**< There was no turn to take back */
+    };
+
+    /**
+     * @struct Entry
+     * @brief One log entry
+     */
+    struct Entry {
+        /** @brief What the entry reports */
+        Kind kind = Kind::TEXT;
+
+        /** @brief Card involved, CardId::NONE if none */
+        CardId card = CardId::NONE;
+
+        /** @brief Actor id of the acting character, 0 if none */
+        uint32_t actor = 0;
+
+        /** @brief Actor id of the other character, 0 if none */
+        uint32_t other = 0;
+
+        /** @brief Figure of the entry */
+        int32_t amount = 0;
+    };
+
+private:
+    /** @brief Number of remembered names; every live entry mentions at most two */
+    static constexpr size_t NAME_SLOTS = 2 * CAPACITY;
+
+    /** @brief Entry slots */
+    std::array<Entry, CAPACITY> entries{};
+
+    /** @brief Text of the TEXT entry in the same slot */
+    std::array<std::string, CAPACITY> texts;
+
+    /** @brief Actor id of each remembered name, 0 for a free slot */
+    std::array<uint32_t, NAME_SLOTS> nameIds{};
+
+    /** @brief Remembered names, each terminated by a null character */
+    std::array<std::array<char, MAX_NAME_LENGTH + 1>, NAME_SLOTS> names{};
+
+    /** @brief Slot the next entry is written to */
+    size_t next = 0;
+
+    /** @brief Number of entries kept */
+    size_t count = 0;
+
+    /**
+     * @brief Get the slot of the i-th kept entry
+     * @param i Position among the kept entries, 0 for the oldest
+     * @return Index into the entry slots
+     */
+    size_t slotOf(size_t i) const { return (next + CAPACITY - count + i) % CAPACITY; }
+
+    /**
+     * @brief Check whether a live entry mentions an actor
+     * @param id Actor id
+     * @return True if some kept entry refers to it
+     */
+    bool mentioned(uint32_t id) const;
+
+    /**
+     * @brief Remember the name of a character
+     * @param entity The character
+     * @return Its actor id
+     */
+    uint32_t remember(const Entity& entity);
+
+    /**
+     * @brief Take the slot of the next entry
+     * @return The slot, emptied and counted as kept
+     */
+    Entry& claim();
+
+public:
+    /**
+     * @brief Add an entry
+     * @param kind What it reports
+     * @param actor The acting character, nullptr if none
+     * @param other The other character, nullptr if none
+     * @param amount Figure of the entry
+     * @param card Card involved
+     */
+    void add(Kind kind, const Entity* actor = nullptr, const Entity* other = nullptr, int amount = 0,
+             CardId card = CardId::NONE);
+
+    /**
+     * @brief Add a free-text entry
+     * @param message The text
+     */
+    void addText(const std::string& message);
+
+    /**
+     * @brief Get the number of entries kept
+     * @return At most CAPACITY
+     */
+    size_t size() const { return count; }
+
+    /**
+     * @brief Get a kept entry
+     * @param i Position among the kept entries, 0 for the oldest
+     * @return The entry
+     */
+    const Entry& operator[](size_t i) const { return entries[slotOf(i)]; }
+
+    /**
+     * @brief Get the text of a TEXT entry
+     * @param i Position among the kept entries, 0 for the oldest
+     * @return The text, empty for other kinds
+     */
+    const std::string& text(size_t i) const;
+
+    /**
+     * @brief Get the name of a character mentioned by a kept entry
+     * @param id Actor id
+     * @return The name, empty if the id is 0 or not mentioned; valid until
+     *         the next entry is added
+     */
+    const char* nameOf(uint32_t id) const;
+
+    /**
+     * @brief Remove all entries
+     */
+    void clear() { count = 0; }
+};
@@ -7,14 +7,18 @@
 #pragma once
 #include "GameMode.h"
 #include "Character.h"
+#include "BattleEngine.h"
+#include "CommandLog.h"
+#include <string>
 
 /**
  * @class BattleMode
  * @brief Manages combat between two characters
- * @details Handles turn-based combat mechanics, player actions,
- *          and determines the outcome of battles
+ * @details Handles player input, the battle interface and rewards, while the
+ *          combat itself is resolved by BattleEngine. When constructed with an
+ *          action source the battle runs headless, without prompts or output.
  */
-class BattleMode : public GameMode {
+class BattleMode : public GameMode, public ActionSource, public BattleObserver {
 private:
     /** @brief Player character involved in battle */
     std::shared_ptr<Character> player;
@@ -31,17 +35,24 @@ private:
     /** @brief Maximum number of battle rounds in test mode */
     static const int MAX_TEST_ROUNDS = 3;
 
+    /** @brief Maximum number of battle rounds in headless battles */
+    static const int MAX_HEADLESS_ROUNDS = 1000;
+
+    /** @brief Controller for headless battles, nullptr for interactive play */
+    std::shared_ptr<ActionSource> autopilot;
+
+    /** @brief Outcome of the last battle */
+    BattleResult result;
+
+    /** @brief Name of the item selected for the current turn */
+    std::string selectedItemName;
+
+    /** @brief History of the interactive battle, used to undo rounds */
+    CommandLog commandLog;
+
 public:
-    /**
-     * @enum BattleAction
-     * @brief Possible actions during battle
-     */
-    enum class BattleAction {
-        ATTACK,  /**< Basic attack action */
-        ABILITY, /**< Use a special ability */
-        DEFEND,  /**< Defensive stance */
-        ITEM     /**< Use an item */
-    };
+    /** @brief Possible actions during battle */
+    using BattleAction = ::BattleAction;
 
     /**
      * @brief Constructor for BattleMode
@@ -50,6 +61,16 @@ public:
      * @param testMode Flag to set test mode for automated testing
      */
     BattleMode(std::shared_ptr<Character> p, std::shared_ptr<Character> e, bool testMode = false);
+
+    /**
+     * @brief Constructor for a headless BattleMode
+     * @param p Player character
+     * @param e Enemy character
+     * @param autopilot Controller choosing the player's actions, or nullptr for interactive play
+     * @details With an autopilot the battle prints nothing, draws no interface
+     *          and reads no input
+     */
+    BattleMode(std::shared_ptr<Character> p, std::shared_ptr<Character> e, std::shared_ptr<ActionSource> autopilot);
     
     /**
      * @brief Start the battle
@@ -80,6 +101,47 @@ public:
         return enemy;
     }
 
+    /**
+     * @brief Get the outcome of the last battle
+     * @return Result reported by the battle engine
+     */
+    const BattleResult& getResult() const { return result; }
+
+    /**
+     * @brief Choose the player's action for the current round
+     * @param self The player character
+     * @param opponent The enemy character
+     * @return The action selected by the player
+     * @details Draws the battle interface and prompts for input
+     */
+    BattleChoice chooseAction(Character& self, Character& opponent) override;
+
+    /**
+     * @brief Report the player's action in the battle log
+     * @param player The player character
+     * @param enemy The enemy character
+     * @param choice The action the player chose
+     * @param card The card that was played, or nullptr for non-card actions
+     * @param succeeded False if the action could not be performed
+     */
+    void onPlayerAction(const Character& player, const Character& enemy,
+                        const BattleChoice& choice, const Card* card, bool succeeded) override;
+
+    /**
+     * @brief Announce the enemy's turn
+     * @param enemy The enemy character
+     * @param player The player character
+     */
+    void onEnemyTurn(const Character& enemy, const Character& player) override;
+
+    /**
+     * @brief Report an undo request in the battle log
+     * @param player The player character
+     * @param enemy The enemy character
+     * @param undone False if there was no round to take back
+     */
+    void onUndo(const Character& player, const Character& enemy, bool undone) override;
+
 private:
     /**
      * @brief Get the player's chosen action
@@ -88,22 +150,16 @@ private:
     BattleAction getPlayerChoice() const;
     
     /**
-     * @brief Let the player select an ability
-     * @param character The character selecting an ability
-     * @return The selected ability
-     */
-    std::shared_ptr<Ability> selectAbility(const Character& character) const;
-    
-    /**
-     * @brief Use an item from the character's inventory
+     * @brief Select an item from the character's inventory
      * @param character The character using an item
+     * @return Index of the selected item, out of range if none was selected
      */
-    void useItemFromInventory(Character& character);
+    size_t selectItem(Character& character);
     
     /**
      * @brief Select a card with an ability effect
      * @param character The character selecting a card
-     * @return The selected card
+     * @return Index of the selected card, out of range if none was selected
      */
-    std::shared_ptr<Card> selectAbilityCard(Character& character);
+    size_t selectAbilityCard(Character& character);
 };
\ No newline at end of file
@@ -0,0 +1,718 @@
+/**
+ * @file BattleReplay.h
+ * @brief Definition of the battle replay format
+ * @details This file defines the BattleReplay class, a compact binary record
+ *          of the battles of a session, the ReplayRecorder that game modes
+ *          write it through and the action sources used to record and play
+ *          back the player's choices. A battle is fully determined by the
+ *          session seed, its battle id, the starting state of both sides and
+ *          the choices made by the players, so that is all a replay stores,
+ *          together with a rolling hash of every round to check replays
+ *          against.
+ */
+#pragma once
+#include "BattleEngine.h"
+#include "BattleState.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ReplayRecorder;
+
+/**
+ * @struct ReplayItem
+ * @brief Inventory item of a recorded character
+ */
+struct ReplayItem {
+    /**
+     * @enum Kind
+     * @brief Concrete class of the item
+     */
+    enum class Kind : uint8_t {
+        HEALTH_POTION, /**< HealthPotion */
+        MANA_ELIXIR,   /**< ManaElixir */
+        WEAPON,        /**< Weapon */
+        ARMOR          /**< Armor */
+    };
+
+    /** @brief Concrete class of the item */
+    Kind kind = Kind::HEALTH_POTION;
+
+    /** @brief Name of a weapon or armor */
+    std::string name;
+
+    /** @brief Description of a weapon or armor */
+    std::string description;
+
+    /** @brief Damage of a weapon or defense of an armor */
+    int value = 0;
+};
+
+/**
+ * @struct ReplayCombatant
+ * @brief Starting configuration of one side of a recorded battle
+ */
+struct ReplayCombatant {
+    /**
+     * @enum Class
+     * @brief Character class
+     */
+    enum class Class : uint8_t {
+        WARRIOR, /**< Warrior */
+        MAGE,    /**< Mage */
+        ARCHER,  /**< Archer */
+        HEALER   /**< Healer */
+    };
+
+    /**
+     * @enum Brain
+     * @brief AI attached to the character
+     */
+    enum class Brain : uint8_t {
+        NONE,          /**< No AI */
+        EASY,          /**< EasyAI */
+        ADVANCED,      /**< AdvancedAI playing the character's deck */
+        BOSS,          /**< BossAI playing the character's deck */
+        SEARCHING_BOSS /**< BossAI playing the character's deck, with its search enabled */
+    };
+
+    /** @brief Character class */
+    Class characterClass = Class::WARRIOR;
+
+    /** @brief AI attached to the character */
+    Brain brain = Brain::NONE;
+
+    /** @brief Character name */
+    std::string name;
+
+    /** @brief Combat state; its item pointers are not used */
+    CombatantSnapshot state;
+
+    /** @brief Inventory items, in inventory order */
+    std::vector<ReplayItem> items;
+
+    /**
+     * @brief Record the current configuration of a character
+     * @param character The character
+     * @return Its configuration
+     * @throws std::invalid_argument if its class, its AI or an item cannot be recorded
+     * @throws std::length_error if it does not fit in a snapshot
+     */
+    static ReplayCombatant capture(const Character& character);
+
+    /**
+     * @brief Build a character with the recorded configuration
+     * @param context Session to bind the character to
+     * @return The character, without AI or target
+     */
+    std::shared_ptr<Character> create(GameContext& context) const;
+
+    /**
+     * @brief Give a character built by create() its recorded AI
+     * @param self The character
+     * @param opponent The character it fights
+     */
+    void attachBrain(const std::shared_ptr<Character>& self, const std::shared_ptr<Character>& opponent) const;
+};
+
+/**
+ * @struct ReplayKeyframe
+ * @brief Full state of a recorded battle at the start of a round
+ */
+struct ReplayKeyframe {
+    /** @brief Statistics so far; turns is the number of rounds already played */
+    BattleResult progress;
+
+    /** @brief Position in the encoded choices of the round's first choice */
+    uint32_t choiceOffset = 0;
+
+    /** @brief State of both sides; its item pointers are not used */
+    BattleState state;
+
+    /** @brief Inventory of the player, as positions in its recorded items */
+    std::vector<uint8_t> playerItems;
+
+    /** @brief Inventory of the enemy, as positions in its recorded items */
+    std::vector<uint8_t> enemyItems;
+};
+
+/**
+ * @struct ReplayDivergence
+ * @brief First round at which a replayed battle left its recording
+ */
+struct ReplayDivergence {
+    /** @brief Position of the first differing round hash */
+    size_t round = 0;
+
+    /** @brief Round count of the replayed battle at that hash */
+    int turn = 0;
+
+    /** @brief Recorded round hash, 0 if the recording has no more rounds */
+    uint32_t expected = 0;
+
+    /** @brief Replayed round hash, 0 if the replay ended first */
+    uint32_t actual = 0;
+
+    /** @brief Combat events the replay emitted since the previous round hash, rendered */
+    std::vector<std::string> events;
+};
+
+/**
+ * @struct ReplayCheck
+ * @brief Outcome of checking a recorded battle by playing it again
+ */
+struct ReplayCheck {
+    /** @brief Outcome of the replayed battle */
+    BattleResult result;
+
+    /** @brief Number of round hashes compared */
+    size_t rounds = 0;
+
+    /** @brief First round that differs, empty if every hash matched */
+    std::optional<ReplayDivergence> divergence;
+};
+
+/**
+ * @struct ReplayBattle
+ * @brief One recorded battle
+ * @details The player's choices are stored as one varint per turn holding
+ *          the action in the low three bits and the card or item index above
+ *          them, so a typical turn takes a single byte. Battles driven by an
+ *          automatic source store no choices at all. Keyframes of the full
+ *          state every KEYFRAME_INTERVAL rounds let ReplayCursor seek
+ *          without playing the battle from its start.
+ */
+struct ReplayBattle {
+    /**
+     * @enum Mode
+     * @brief Game mode the battle was fought in
+     */
+    enum class Mode : uint8_t {
+        BATTLE, /**< BattleMode, also used for the battles of a dungeon */
+        PVP     /**< PvPMode; the choices of both players alternate */
+    };
+
+    /** @brief Game mode the battle was fought in */
+    Mode mode = Mode::BATTLE;
+
+    /** @brief Identifier of the battle in its session */
+    uint64_t battleId = 0;
+
+    /** @brief Maximum number of rounds, 0 for no limit */
+    int maxTurns = 0;
+
+    /** @brief Whether rounds could be undone */
+    bool undo = false;
+
+    /** @brief Whether every turn was handed to the character's AI */
+    bool automatic = false;
+
+    /** @brief The player, or the first player of a PvP battle */
+    ReplayCombatant player;
+
+    /** @brief The enemy, or the second player of a PvP battle */
+    ReplayCombatant enemy;
+
+    /** @brief Varint-encoded choices */
+    std::vector<uint8_t> choices;
+
+    /** @brief Recorded outcome */
+    BattleResult::Winner winner = BattleResult::Winner::DRAW;
+
+    /** @brief Recorded number of rounds */
+    int turns = 0;
+
+    /** @brief Keyframes, in increasing round order */
+    std::vector<ReplayKeyframe> keyframes;
+
+    /**
+     * @brief Low half of the rolling hash at the start of every round played, and at the end
+     * @details Each hash covers the state of both sides, the round count
+     *          and the combat events since the previous one, and folds in
+     *          the hash before it. Rounds resolved in closed form by the
+     *          engine's fast-forward and undone rounds count like any other.
+     */
+    std::vector<uint32_t> roundHashes;
+
+    /**
+     * @brief Append a choice to the recorded ones
+     * @param choice The choice
+     */
+    void addChoice(const BattleChoice& choice);
+
+    /**
+     * @brief Play the battle again
+     * @param seed Seed of the session it was recorded in
+     * @param recorder Recorder to record the replayed battle into, nullptr for none
+     * @return Outcome of the replayed battle
+     * @details Rebuilds both sides and runs them through the same engine or
+     *          game mode, headless. A battle without a round limit is cut off
+     *          one round after its recorded length, so a replay that diverged
+     *          always terminates.
+     */
+    BattleResult replay(uint64_t seed, ReplayRecorder* recorder = nullptr) const;
+
+    /**
+     * @brief Play the battle again and compare its round hashes with the recorded ones
+     * @param seed Seed of the session it was recorded in
+     * @return The replayed outcome and the first round that differs
+     * @details A battle recorded without hashes only has its outcome replayed
+     */
+    ReplayCheck verify(uint64_t seed) const;
+
+    /**
+     * @brief Find the last keyframe at or before a round
+     * @param turn Number of rounds played
+     * @return The keyframe, nullptr if the first one comes later
+     */
+    const ReplayKeyframe* keyframeAt(int turn) const;
+};
+
+/**
+ * @struct ReplayIndex
+ * @brief Index stored at the end of a replay file
+ * @details Lets a viewer load a single battle of a long session with
+ *          BattleReplay::readBattle() instead of reading the whole file
+ */
+struct ReplayIndex {
+    /**
+     * @struct Entry
+     * @brief Location and extent of one battle
+     */
+    struct Entry {
+        /** @brief Byte offset of the battle in the file */
+        uint64_t offset = 0;
+
+        /** @brief Recorded number of rounds */
+        int turns = 0;
+
+        /** @brief Rounds the battle's keyframes were taken at */
+        std::vector<int> keyframeTurns;
+    };
+
+    /** @brief Seed of the session */
+    uint64_t seed = 0;
+
+    /** @brief The battles, in the order they were fought */
+    std::vector<Entry> battles;
+};
+
+/**
+ * @class BattleReplay
+ * @brief Recorded battles of a session
+ */
+class BattleReplay {
+public:
+    /** @brief Seed of the session */
+    uint64_t seed = 0;
+
+    /** @brief Recorded battles, in the order they were fought */
+    std::vector<ReplayBattle> battles;
+
+    /**
+     * @brief Write the replay in its binary format
+     * @param out Stream to write to
+     */
+    void write(std::ostream& out) const;
+
+    /**
+     * @brief Read a replay in its binary format
+     * @param in Stream to read from
+     * @return The replay
+     * @throws std::runtime_error if the data is not a valid replay
+     */
+    static BattleReplay read(std::istream& in);
+
+    /**
+     * @brief Write the replay to a file
+     * @param path Path of the file
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @brief Read a replay from a file
+     * @param path Path of the file
+     * @return The replay
+     * @throws std::runtime_error if the file cannot be read or is not a replay
+     */
+    static BattleReplay load(const std::string& path);
+
+    /**
+     * @brief Read the index at the end of a replay
+     * @param in Seekable stream holding the replay
+     * @return The index
+     * @throws std::runtime_error if the data is not a replay with an index
+     */
+    static ReplayIndex readIndex(std::istream& in);
+
+    /**
+     * @brief Read a single battle of a replay
+     * @param in Seekable stream holding the replay
+     * @param offset Offset of the battle, as listed in the index
+     * @return The battle
+     * @throws std::runtime_error if no valid battle starts at the offset
+     */
+    static ReplayBattle readBattle(std::istream& in, uint64_t offset);
+};
+
+/**
+ * @class ReplayRecorder
+ * @brief Records the battles of a session into a replay
+ * @details Game modes record their battles when a recorder is attached to
+ *          their GameContext. With a path every battle is appended to the
+ *          file when it ends, so a crash loses at most the battle being
+ *          fought, and a long session does not write its file over and
+ *          over.
+ */
+class ReplayRecorder {
+private:
+    /** @brief The recorded battles */
+    BattleReplay replay;
+
+    /** @brief File the replay is saved to, empty to keep it in memory */
+    std::string path;
+
+    /** @brief Number of recorded battles already in the file */
+    size_t savedBattles = 0;
+
+    /** @brief Offset of the index in the file, where the next battle goes */
+    uint64_t indexOffset = 0;
+
+    /** @brief Encoded index entries of the battles in the file */
+    std::string indexEntries;
+
+    /** @brief Whether a battle is being recorded */
+    bool recording = false;
+
+    /** @brief Round count at which the next keyframe is due */
+    int nextKeyframe = 0;
+
+    /** @brief Round count of the last keyframe kept, 0 if none */
+    int lastKeyframe = 0;
+
+    /** @brief Highest round count the battle has reached */
+    int reached = 0;
+
+    /** @brief Session the recorded battle is fought in */
+    const GameContext* context = nullptr;
+
+    /** @brief The player, or the first player of a PvP battle */
+    const Character* player = nullptr;
+
+    /** @brief The enemy, or the second player of a PvP battle */
+    const Character* enemy = nullptr;
+
+    /** @brief Actor id of the player in the battle's session, as of the latest round */
+    uint32_t playerActor = 0;
+
+    /** @brief Actor id of the enemy in the battle's session, as of the latest round */
+    uint32_t enemyActor = 0;
+
+    /** @brief Rolling hash of the rounds recorded so far */
+    uint64_t rollingHash = 0;
+
+    /** @brief Number of the session's combat events already hashed */
+    uint64_t eventsHashed = 0;
+
+    /** @brief Round hashes to check the battle against, nullptr to only record */
+    const std::vector<uint32_t>* expected = nullptr;
+
+    /** @brief First round that differed from the expected hashes */
+    std::optional<ReplayDivergence> divergence;
+
+    /**
+     * @brief Append the battles not yet in the file to it
+     * @throws std::runtime_error if the file cannot be written
+     */
+    void save();
+
+    /**
+     * @brief Extend the rolling hash by the current round
+     * @param turns Number of rounds played so far
+     * @details Also compares the hash with the expected one
+     */
+    void hashRound(int turns);
+
+    /**
+     * @brief Note the first round that differs from the expected hashes
+     * @param turns Number of rounds played so far
+     * @param actual The round's hash, 0 if the battle ended
+     */
+    void diverge(int turns, uint32_t actual);
+
+    /**
+     * @brief Take a keyframe, or drop those an undo made invalid
+     * @param player The player, or the first player of a PvP battle
+     * @param enemy The enemy, or the second player of a PvP battle
+     * @param progress Statistics of the rounds played so far
+     */
+    void keyframe(const Character& player, const Character& enemy, const BattleResult& progress);
+
+public:
+    /** @brief Number of rounds between keyframes */
+    static constexpr int KEYFRAME_INTERVAL = 32;
+
+    /**
+     * @brief Constructor for ReplayRecorder
+     * @param path File to append every battle to, empty to keep the replay in memory
+     */
+    explicit ReplayRecorder(std::string path = "") : path(std::move(path)) {}
+
+    /**
+     * @brief Start recording a battle
+     * @param context Session the battle is fought in
+     * @param mode Game mode of the battle
+     * @param player The player, or the first player of a PvP battle
+     * @param enemy The enemy, or the second player of a PvP battle
+     * @param maxTurns Round limit of the battle, 0 for none
+     * @param undo Whether rounds can be undone
+     * @param automatic Whether every turn is handed to the character's AI
+     * @details Failing to capture a side is logged and the battle is left unrecorded
+     */
+    void beginBattle(const GameContext& context, ReplayBattle::Mode mode, const Character& player,
+                     const Character& enemy, int maxTurns, bool undo, bool automatic);
+
+    /**
+     * @brief Record a player's choice
+     * @param choice The choice
+     */
+    void record(const BattleChoice& choice) {
+        if (recording) {
+            replay.battles.back().addChoice(choice);
+        }
+    }
+
+    /**
+     * @brief Note the start of a round
+     * @param player The player, or the first player of a PvP battle
+     * @param enemy The enemy, or the second player of a PvP battle
+     * @param progress Statistics of the rounds played so far
+     * @details Notes the actor ids the characters hold in the battle's
+     *          session. Takes a keyframe every KEYFRAME_INTERVAL rounds, the
+     *          first time the battle gets that far. Undoing rounds back past
+     *          a keyframe drops it, since a battle resumed from it could not
+     *          undo them again.
+     */
+    void startRound(const Character& player, const Character& enemy, const BattleResult& progress) {
+        if (!recording) {
+            return;
+        }
+        playerActor = player.getActorId();
+        enemyActor = enemy.getActorId();
+        hashRound(progress.turns);
+        if (progress.turns < lastKeyframe || (progress.turns > reached && progress.turns >= nextKeyframe)) {
+            keyframe(player, enemy, progress);
+        }
+        reached = std::max(reached, progress.turns);
+    }
+
+    /**
+     * @brief Finish recording a battle
+     * @param result Its outcome
+     * @details Appends the battle to the file if the recorder has a path; a failure is logged
+     */
+    void endBattle(const BattleResult& result);
+
+    /**
+     * @brief Check the next recorded battle against round hashes
+     * @param hashes Hashes it should produce; they must outlive the battle
+     */
+    void expect(const std::vector<uint32_t>& hashes) {
+        expected = &hashes;
+        divergence.reset();
+    }
+
+    /**
+     * @brief Get the first round that differed from the expected hashes
+     * @return The round, empty if none differed
+     */
+    const std::optional<ReplayDivergence>& getDivergence() const { return divergence; }
+
+    /**
+     * @brief Get the recorded battles
+     * @return The replay
+     */
+    const BattleReplay& getReplay() const { return replay; }
+};
+
+/**
+ * @class RecordingActionSource
+ * @brief Action source that records the choices of another one
+ */
+class RecordingActionSource : public ActionSource {
+private:
+    /** @brief Source making the choices */
+    ActionSource& inner;
+
+    /** @brief Recorder the choices go to */
+    ReplayRecorder& recorder;
+
+public:
+    /**
+     * @brief Constructor for RecordingActionSource
+     * @param inner Source making the choices
+     * @param recorder Recorder the choices go to
+     */
+    RecordingActionSource(ActionSource& inner, ReplayRecorder& recorder) : inner(inner), recorder(recorder) {}
+
+    /**
+     * @brief Choose the next action for a character
+     * @param self The character whose turn it is
+     * @param opponent The opposing character
+     * @return The inner source's choice; automatic sources are not recorded
+     */
+    BattleChoice chooseAction(Character& self, Character& opponent) override {
+        BattleChoice choice = inner.chooseAction(self, opponent);
+        if (!inner.isAutomatic()) {
+            recorder.record(choice);
+        }
+        return choice;
+    }
+
+    /**
+     * @brief Check whether the source always hands the turn to the character's AI
+     * @return Whether the inner source does
+     */
+    bool isAutomatic() const override { return inner.isAutomatic(); }
+};
+
+/**
+ * @class ReplayActionSource
+ * @brief Action source that plays back recorded choices
+ */
+class ReplayActionSource : public ActionSource {
+private:
+    /** @brief Varint-encoded choices */
+    const std::vector<uint8_t>& choices;
+
+    /** @brief Position of the next choice */
+    size_t position;
+
+public:
+    /**
+     * @brief Constructor for ReplayActionSource
+     * @param choices Varint-encoded choices; they must outlive the source
+     * @param position Position of the first choice to play back
+     */
+    explicit ReplayActionSource(const std::vector<uint8_t>& choices, size_t position = 0)
+        : choices(choices), position(position) {}
+
+    /**
+     * @brief Choose the next action for a character
+     * @param self The character whose turn it is
+     * @param opponent The opposing character
+     * @return The next recorded choice, BattleAction::AUTO once they run out
+     */
+    BattleChoice chooseAction(Character& self, Character& opponent) override;
+
+    /**
+     * @brief Get the position of the next choice
+     * @return Offset in the encoded choices
+     */
+    size_t getPosition() const { return position; }
+};
+
+/**
+ * @class ReplayCursor
+ * @brief Moves through a recorded battle round by round
+ * @details Holds live copies of both sides. Seeking restores the last
+ *          keyframe before the target round and plays the remaining rounds,
+ *          so any round is reached by playing at most KEYFRAME_INTERVAL
+ *          rounds, in either direction; without undo, seeking forward past
+ *          no keyframe continues from the current round. When rounds were
+ *          undone, a round count refers to the first time the battle
+ *          reached it.
+ */
+class ReplayCursor {
+private:
+    /** @brief The battle */
+    const ReplayBattle& battle;
+
+    /** @brief Session the battle is replayed in */
+    GameContext context;
+
+    /** @brief The player, or the first player of a PvP battle */
+    std::shared_ptr<Character> player;
+
+    /** @brief The enemy, or the second player of a PvP battle */
+    std::shared_ptr<Character> enemy;
+
+    /** @brief Items of the player, in recorded order */
+    std::vector<Item*> playerItems;
+
+    /** @brief Items of the enemy, in recorded order */
+    std::vector<Item*> enemyItems;
+
+    /** @brief Statistics of the rounds played up to the current one */
+    BattleResult progress;
+
+    /** @brief Position in the encoded choices of the next round's first choice */
+    size_t choiceOffset = 0;
+
+public:
+    /**
+     * @brief Constructor for ReplayCursor
+     * @param battle The battle; it must outlive the cursor
+     * @param seed Seed of the session it was recorded in
+     * @details Starts before the first round
+     */
+    ReplayCursor(const ReplayBattle& battle, uint64_t seed);
+
+    /**
+     * @brief Destructor for ReplayCursor
+     */
+    ~ReplayCursor();
+
+    ReplayCursor(const ReplayCursor&) = delete;
+    ReplayCursor& operator=(const ReplayCursor&) = delete;
+
+    /**
+     * @brief Move to the state after a number of rounds
+     * @param turn Number of rounds played, clamped to the battle's length
+     */
+    void seek(int turn);
+
+    /**
+     * @brief Play the next round
+     * @return False if the battle was already over
+     */
+    bool stepForward();
+
+    /**
+     * @brief Take back the last round
+     * @return False if no round was played
+     */
+    bool stepBackward();
+
+    /**
+     * @brief Get the number of rounds played
+     * @return The current round count
+     */
+    int getTurn() const { return progress.turns; }
+
+    /**
+     * @brief Get the statistics of the rounds played
+     * @return Statistics up to the current round
+     */
+    const BattleResult& getProgress() const { return progress; }
+
+    /**
+     * @brief Get the player
+     * @return The player, or the first player of a PvP battle
+     */
+    const Character& getPlayer() const { return *player; }
+
+    /**
+     * @brief Get the enemy
+     * @return The enemy, or the second player of a PvP battle
+     */
+    const Character& getEnemy() const { return *enemy; }
+};
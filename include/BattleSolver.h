@@ -0,0 +1,96 @@
+/**
+ * @file BattleSolver.h
+ * @brief Definition of the exact battle outcome solver
+ * @details This file defines the BattleSolver class, which computes the
+ *          exact probabilities of every battle outcome by following all
+ *          random draws instead of sampling them, and the BattleOdds type
+ *          it reports them with.
+ */
+#pragma once
+#include "Character.h"
+#include "GameContext.h"
+#include <cstdint>
+#include <memory>
+
+/**
+ * @struct BattleOdds
+ * @brief Exact outcome distribution of a battle
+ */
+struct BattleOdds {
+    /** @brief Probability that the player wins */
+    double playerWins = 0.0;
+
+    /** @brief Probability that the enemy wins */
+    double enemyWins = 0.0;
+
+    /** @brief Probability that both survive the turn limit */
+    double draws = 0.0;
+
+    /** @brief Expected number of rounds, counting draws at the turn limit */
+    double meanTurns = 0.0;
+
+    /** @brief Number of distinct states the solver expanded */
+    uint64_t states = 0;
+
+    /** @brief Number of rounds the solver played to expand them */
+    uint64_t branches = 0;
+};
+
+/**
+ * @class BattleSolver
+ * @brief Computes exact win, draw and loss probabilities of a battle
+ * @details The solver plays the battle forward one round at a time on the
+ *          live characters, keeping the probability of every distinct
+ *          BattleState reached after each round. Each state is expanded by
+ *          replaying its round once for every combination of values the
+ *          round's random draws can take, with a ChanceSource attached to
+ *          the context; equal states reached by different draws are merged,
+ *          so the work grows with the number of distinct states rather than
+ *          with the number of possible battles.
+ *
+ *          Rounds follow BattleEngine with the player acting through its
+ *          own AI routine. Only draws made through GameContext::randomInt()
+ *          and randomInts() are enumerated, which covers the cards and the
+ *          rule-based AIs; controllers that read the random stream directly,
+ *          such as MctsAI, are treated as deterministic, and AIs must keep
+ *          no state outside the characters, such as a deck of their own.
+ *          The characters are restored to their starting state when solving
+ *          ends.
+ */
+class BattleSolver {
+private:
+    /** @brief Player character */
+    std::shared_ptr<Character> player;
+
+    /** @brief Enemy character */
+    std::shared_ptr<Character> enemy;
+
+    /** @brief Session the rounds are played in */
+    GameContext& context;
+
+    /** @brief Maximum number of rounds before the battle is a draw */
+    int maxTurns = 1000;
+
+public:
+    /**
+     * @brief Constructor for BattleSolver
+     * @param player Player character
+     * @param enemy Enemy character
+     * @param context Session the rounds are played in; it must outlive the solver
+     */
+    BattleSolver(std::shared_ptr<Character> player, std::shared_ptr<Character> enemy,
+                 GameContext& context = GameContext::threadDefault());
+
+    /**
+     * @brief Limit the number of rounds
+     * @param turns Maximum number of rounds before the battle is a draw
+     */
+    void setMaxTurns(int turns) { maxTurns = turns; }
+
+    /**
+     * @brief Compute the outcome distribution of the battle
+     * @return Exact probabilities, up to floating-point rounding
+     * @throws std::length_error if a character does not fit in a BattleState
+     */
+    BattleOdds solve();
+};
@@ -0,0 +1,169 @@
+/**
+ * @file BattleState.h
+ * @brief Definition of the battle state snapshot
+ * @details This file defines the CombatantSnapshot and BattleState types,
+ *          which capture the complete combat state of two characters as
+ *          plain values. A snapshot is trivially copyable, so search-based
+ *          AI can clone it with a single memcpy and restore it into the
+ *          live characters when it is done.
+ */
+#pragma once
+#include "Card.h"
+#include "Entity.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+class Character;
+class Item;
+
+/**
+ * @struct CombatantSnapshot
+ * @brief Value copy of the combat state of one character
+ * @details Captures stats, progression, active effects, deck contents and
+ *          inventory. Items are referenced, not copied: they carry no state
+ *          and the inventory keeps owned items alive after they are used.
+ *          Name, target, AI and session are relationships, not state, and
+ *          are left alone by restore().
+ */
+struct CombatantSnapshot {
+    /** @brief Largest number of active effects a snapshot holds */
+    static constexpr size_t MAX_EFFECTS = 16;
+
+    /** @brief Largest number of deck cards a snapshot holds */
+    static constexpr size_t MAX_CARDS = 256;
+
+    /** @brief Largest number of inventory items a snapshot holds */
+    static constexpr size_t MAX_ITEMS = 16;
+
+    /** @brief Current health */
+    int health = 0;
+
+    /** @brief Current mana */
+    int mana = 0;
+
+    /** @brief Defense subtracted from incoming damage by Entity::takeDamage */
+    int damageReduction = 0;
+
+    /** @brief Defense reported by Character::getDefense */
+    int defense = 0;
+
+    /** @brief Attack power */
+    int attackPower = 0;
+
+    /** @brief Character level */
+    int level = 1;
+
+    /** @brief Character experience */
+    int experience = 0;
+
+    /** @brief Kill count */
+    int kills = 0;
+
+    /** @brief Number of active effects */
+    uint8_t effectCount = 0;
+
+    /** @brief Number of inventory items */
+    uint8_t itemCount = 0;
+
+    /** @brief Number of deck cards */
+    uint16_t cardCount = 0;
+
+    /** @brief Whether the character had a deck */
+    bool hasDeck = false;
+
+    /** @brief Whether the character had an inventory */
+    bool hasInventory = false;
+
+    /** @brief Active effects, in the order they were applied */
+    std::array<ActiveEffect, MAX_EFFECTS> effects;
+
+    /** @brief Deck cards, bottom first */
+    std::array<CardId, MAX_CARDS> cards{};
+
+    /** @brief Inventory items, in inventory order */
+    std::array<Item*, MAX_ITEMS> items{};
+
+    /**
+     * @brief Capture the state of a character
+     * @param character The character
+     * @return Snapshot of the character
+     * @throws std::length_error if the character has more effects, cards
+     *         or items than a snapshot holds
+     */
+    static CombatantSnapshot capture(const Character& character);
+
+    /**
+     * @brief Write the snapshot back into a character
+     * @param character The character to update
+     * @details Reuses the character's deck, inventory and effect storage.
+     *          A missing deck or inventory is created if the snapshot has one.
+     */
+    void restore(Character& character) const;
+
+    /**
+     * @brief Compare two snapshots
+     * @param other Snapshot to compare with
+     * @return True if both hold the same state; unused array entries are ignored
+     */
+    bool operator==(const CombatantSnapshot& other) const;
+
+    /**
+     * @brief Compare two snapshots
+     * @param other Snapshot to compare with
+     * @return True if the states differ
+     */
+    bool operator!=(const CombatantSnapshot& other) const { return !(*this == other); }
+};
+
+/**
+ * @struct BattleState
+ * @brief Value copy of a battle between two characters
+ * @details Copying a BattleState is the clone operation; restore() applies
+ *          a saved state to the live characters.
+ */
+struct BattleState {
+    /** @brief State of the player character */
+    CombatantSnapshot player;
+
+    /** @brief State of the enemy character */
+    CombatantSnapshot enemy;
+
+    /**
+     * @brief Capture the state of a battle
+     * @param player The player character
+     * @param enemy The enemy character
+     * @return Snapshot of both characters
+     * @throws std::length_error if a character does not fit in a snapshot
+     */
+    static BattleState capture(const Character& player, const Character& enemy) {
+        return {CombatantSnapshot::capture(player), CombatantSnapshot::capture(enemy)};
+    }
+
+    /**
+     * @brief Write the state back into the characters
+     * @param livePlayer The player character
+     * @param liveEnemy The enemy character
+     */
+    void restore(Character& livePlayer, Character& liveEnemy) const {
+        player.restore(livePlayer);
+        enemy.restore(liveEnemy);
+    }
+
+    /**
+     * @brief Compare two battle states
+     * @param other State to compare with
+     * @return True if both sides hold the same state
+     */
+    bool operator==(const BattleState& other) const { return player == other.player && enemy == other.enemy; }
+
+    /**
+     * @brief Compare two battle states
+     * @param other State to compare with
+     * @return True if the states differ
+     */
+    bool operator!=(const BattleState& other) const { return !(*this == other); }
+};
+
+static_assert(std::is_trivially_copyable<BattleState>::value, "battle states are cloned with memcpy");
@@ -0,0 +1,155 @@
+/**
+ * @file BenchmarkBaseline.h
+ * @brief Definition of the benchmark baseline store and comparator
+ * @details This file defines BenchmarkRun, the timings of one run of the
+ *          benchmarks target read from its JSON output, the
+ *          BenchmarkBaseline store that keeps runs by git commit, and the
+ *          Mann-Whitney comparison that flags regressions between two runs.
+ */
+#pragma once
+#include <cstddef>
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * @struct BenchmarkRun
+ * @brief CPU times of one run of the benchmark suite
+ */
+struct BenchmarkRun {
+    /** @brief CPU time of every repetition in nanoseconds, by benchmark name */
+    std::map<std::string, std::vector<double>> samples;
+
+    /**
+     * @brief Read the JSON output of a Google Benchmark run
+     * @param in Stream holding the output
+     * @return The run
+     * @throws std::runtime_error if the data is not benchmark output
+     * @details Only repetitions are read; mean, median and other aggregates
+     *          are skipped, since the comparison needs the raw samples
+     */
+    static BenchmarkRun parse(std::istream& in);
+
+    /**
+     * @brief Read the JSON output of a Google Benchmark run from a file
+     * @param path Path of the file
+     * @return The run
+     * @throws std::runtime_error if the file cannot be read or is not benchmark output
+     */
+    static BenchmarkRun load(const std::string& path);
+};
+
+/**
+ * @struct BenchmarkComparison
+ * @brief Change of one benchmark between a baseline and a current run
+ */
+struct BenchmarkComparison {
+    /**
+     * @enum Verdict
+     * @brief Classification of the change
+     */
+    enum class Verdict {
+        UNCHANGED,      /**< Within the threshold or not significant */
+        REGRESSION,     /**< Significantly slower by more than the threshold */
+        IMPROVEMENT,    /**< Significantly faster by more than the threshold */
+        TOO_FEW_SAMPLES /**< A side has fewer than MIN_SAMPLES repetitions */
+    };
+
+    /** @brief Name of the benchmark */
+    std::string name;
+
+    /** @brief Median CPU time of the baseline in nanoseconds */
+    double baselineMedian = 0;
+
+    /** @brief Median CPU time of the current run in nanoseconds */
+    double currentMedian = 0;
+
+    /** @brief Relative change of the median, 0.1 for 10% slower */
+    double change = 0;
+
+    /** @brief Two-sided p-value of the Mann-Whitney U test */
+    double pValue = 1;
+
+    /** @brief Classification of the change */
+    Verdict verdict = Verdict::UNCHANGED;
+};
+
+/**
+ * @brief Fewest repetitions per side the comparison tests
+ * @details With fewer, even completely separated samples are not significant at 5%
+ */
+constexpr size_t MIN_BENCHMARK_SAMPLES = 5;
+
+/**
+ * @brief Two-sided p-value of the Mann-Whitney U test
+ * @param a First sample
+ * @param b Second sample
+ * @return Probability of a rank difference at least this large if both come
+ *         from the same distribution, 1 if a sample is empty
+ * @details Uses the normal approximation with tie and continuity correction
+ */
+double mannWhitneyPValue(const std::vector<double>& a, const std::vector<double>& b);
+
+/**
+ * @brief Compare the benchmarks two runs have in common
+ * @param baseline The earlier run
+ * @param current The run to check
+ * @param threshold Smallest relative change of the median that counts, 0.05 for 5%
+ * @param alpha Significance level of the test
+ * @return One comparison per common benchmark, in name order
+ * @details A change counts only if it exceeds the threshold and the
+ *          Mann-Whitney test rejects equal distributions at alpha, so
+ *          noisy benchmarks do not raise false alarms
+ */
+std::vector<BenchmarkComparison> compareBenchmarkRuns(const BenchmarkRun& baseline, const BenchmarkRun& current,
+                                                      double threshold, double alpha);
+
+/**
+ * @class BenchmarkBaseline
+ * @brief Directory of benchmark runs keyed by git commit
+ * @details Each run is kept as the unmodified JSON output in COMMIT.json,
+ *          so stored runs can also be read by other tools
+ */
+class BenchmarkBaseline {
+private:
+    /** @brief Directory holding the runs */
+    std::string directory;
+
+public:
+    /**
+     * @brief Constructor for BenchmarkBaseline
+     * @param directory Directory holding the runs; created when a run is stored
+     */
+    explicit BenchmarkBaseline(std::string directory);
+
+    /**
+     * @brief Get the file of a commit's run
+     * @param commit Full commit hash
+     * @return Path of the file
+     */
+    std::string pathFor(const std::string& commit) const;
+
+    /**
+     * @brief Check whether a commit has a stored run
+     * @param commit Full commit hash
+     * @return True if it has
+     */
+    bool has(const std::string& commit) const;
+
+    /**
+     * @brief Store the output of a run for a commit, replacing any earlier one
+     * @param commit Full commit hash
+     * @param resultPath JSON output of the run
+     * @throws std::runtime_error if the output is not benchmark output or cannot be stored
+     */
+    void store(const std::string& commit, const std::string& resultPath) const;
+
+    /**
+     * @brief Read the stored run of a commit
+     * @param commit Full commit hash
+     * @return The run
+     * @throws std::runtime_error if the commit has no readable run
+     */
+    BenchmarkRun load(const std::string& commit) const;
+};
@@ -8,14 +8,30 @@
 #include "AI.h"
 #include "Character.h"
 #include "Deck.h"
+#include <chrono>
+
+class MctsAI;
 
 /**
  * @class BossAI
  * @brief Advanced artificial intelligence for boss enemies
  * @details Implements sophisticated decision-making for challenging boss encounters,
- *          including special ability usage and adaptive combat strategies
+ *          including special ability usage and adaptive combat strategies.
+ *          Moves come from the session's endgame tablebase when it covers
+ *          the battle, then from a Monte Carlo search if one is enabled,
+ *          and otherwise from the scripted routine.
  */
 class BossAI : public AI {
+public:
+    /** @brief Iterations of each search thread per decision */
+    static constexpr uint64_t SEARCH_ITERATIONS = 400;
+
+    /** @brief Number of search threads */
+    static constexpr unsigned SEARCH_THREADS = 2;
+
+    /** @brief Time allowed for one search, ample for SEARCH_ITERATIONS so decisions are reproducible */
+    static constexpr std::chrono::seconds SEARCH_BUDGET{1};
+
 private:
     /** @brief Pointer to the character targeted by this AI (usually the player) */
     std::shared_ptr<Character> target;
@@ -25,12 +41,19 @@ private:
     
     /** @brief Pointer to the boss character controlled by this AI */
     std::shared_ptr<Character> self;
+
+    /** @brief Number of moves taken from the endgame tablebase */
+    uint64_t endgameMoves = 0;
+
+    /** @brief Search choosing the moves the tablebase does not cover, nullptr for the scripted routine */
+    std::shared_ptr<MctsAI> search;
     
     /**
      * @brief Decides whether to use a special ability or basic attack
+     * @param context Session the decision is made in
      * @details Makes a strategic choice based on current battle conditions
      */
-    void useAbilityOrAttack();
+    void useAbilityOrAttack(GameContext& context);
     
     /**
      * @brief Uses a random card from the boss's deck
@@ -40,9 +63,17 @@ private:
     
     /**
      * @brief Checks the boss's health and takes appropriate action
+     * @param context Session the decision is made in
      * @details May trigger special abilities or healing when health is low
      */
-    void checkHealthAndAct();
+    void checkHealthAndAct(GameContext& context);
+
+    /**
+     * @brief Plays the tablebase move if the endgame is covered
+     * @param context Session the decision is made in
+     * @return False if the session has no tablebase or it does not cover the battle
+     */
+    bool playEndgameMove(GameContext& context);
 
 public:
     /**
@@ -57,7 +88,32 @@ public:
      * @brief Makes the best decision for the boss in the current game state
      * @param self The boss character controlled by the AI
      * @param target The entity being targeted by the AI
-     * @details Implements complex boss behavior including phase-based attack patterns
+     * @param context Session the decision is made in
+     * @details Plays the optimal move when the session's endgame tablebase
+     *          covers the battle, then the searched move if the search is
+     *          enabled, and otherwise implements complex boss behavior
+     *          including phase-based attack patterns
+     */
+    void makeDecision(Character& self, Entity& target, GameContext& context) override;
+    using AI::makeDecision;
+
+    /**
+     * @brief Get the number of moves taken from the endgame tablebase
+     * @return Moves played by makeDecision() because the tablebase covered the battle
+     */
+    uint64_t getEndgameMoves() const { return endgameMoves; }
+
+    /**
+     * @brief Choose the moves outside the tablebase with a Monte Carlo search
+     * @details The search runs SEARCH_ITERATIONS iterations on each of
+     *          SEARCH_THREADS threads and plays the cards of the boss's own
+     *          deck. Its threads are kept for the whole battle.
+     */
+    void enableSearch();
+
+    /**
+     * @brief Get the search choosing the moves outside the tablebase
+     * @return The search, nullptr until enableSearch()
      */
-    void makeDecision(Character& self, Entity& target) override;
+    const std::shared_ptr<MctsAI>& getSearch() const { return search; }
 };
\ No newline at end of file
@@ -5,9 +5,33 @@
  *          playable cards in the game with various effects
  */
 #pragma once
+#include <cstdint>
 #include <string>
 #include "Entity.h"
 
+class GameContext;
+
+/**
+ * @enum CardId
+ * @brief Compact identifier of a card kind in the CardCatalog
+ */
+enum class CardId : uint8_t {
+    ATTACK,         /**< AttackCard */
+    DEFENSE,        /**< DefenseCard */
+    SPELL,          /**< SpellCard */
+    TRAP,           /**< TrapCard */
+    SPECIAL,        /**< SpecialCard */
+    FIREBALL,       /**< Fireball */
+    ICE_SPIKE,      /**< IceSpike */
+    LIGHTNING,      /**< LightningCard */
+    BURNING_EFFECT, /**< BurningEffect */
+    POISON,         /**< Poison */
+    REGENERATION,   /**< Regeneration */
+    SHIELD,         /**< Shield */
+    COUNT,          /**< Number of catalog cards */
+    NONE = 0xFF     /**< Card that is not part of the catalog */
+};
+
 /**
  * @class Card
  * @brief Abstract base class for all cards in the game
@@ -16,6 +40,9 @@
  */
 class Card {
 protected:
+    /** @brief Catalog identifier of the card kind */
+    CardId id;
+
     /** @brief Name of the card */
     std::string name;
     
@@ -29,15 +56,38 @@ public:
      * @param description The description of what the card does
      */
     Card(const std::string& name, const std::string& description)
-        : name(name), description(description) {}
+        : id(CardId::NONE), name(name), description(description) {}
+
+    /**
+     * @brief Constructor for a catalog card
+     * @param id Catalog identifier of the card kind
+     * @param name The name of the card
+     * @param description The description of what the card does
+     */
+    Card(CardId id, const std::string& name, const std::string& description)
+        : id(id), name(name), description(description) {}
 
     /**
      * @brief Play this card on a target
      * @param target The entity targeted by this card
-     * @details Implementation should define the effect of playing the card
+     * @param context Session the card is played in
+     * @details Implementation should define the effect of playing the card.
+     *          Random draws and messages go through the given context.
+     */
+    virtual void play(Entity& target, GameContext& context) = 0;
+
+    /**
+     * @brief Play this card on a target in the target's session
+     * @param target The entity targeted by this card
      */
-    virtual void play(Entity& target) = 0;
+    void play(Entity& target) { play(target, target.getContext()); }
     
+    /**
+     * @brief Get the catalog identifier of the card
+     * @return The card kind, or CardId::NONE for cards outside the catalog
+     */
+    CardId getId() const { return id; }
+
     /**
      * @brief Get the name of the card
      * @return The name of the card
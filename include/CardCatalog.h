@@ -0,0 +1,36 @@
+/**
+ * @file CardCatalog.h
+ * @brief Definition of the catalog of card prototypes
+ * @details This file defines the CardCatalog class, which holds one
+ *          statically allocated, shared prototype of every card kind.
+ *          Decks store CardIds and resolve them through the catalog.
+ */
+#pragma once
+#include "Card.h"
+#include <cstddef>
+#include <memory>
+
+/**
+ * @class CardCatalog
+ * @brief Flyweight store of card prototypes
+ * @details Cards carry no per-instance state, so every card of a kind can be
+ *          represented by the same object. The prototypes live for the whole
+ *          program; the shared pointers handed out do not own them and
+ *          copying them touches no reference count.
+ */
+class CardCatalog {
+public:
+    /**
+     * @brief Get the prototype of a card kind
+     * @param id Identifier of the card kind, must be a catalog card
+     * @return Non-owning shared pointer to the prototype
+     * @throws std::out_of_range if id is not a catalog card
+     */
+    static const std::shared_ptr<Card>& get(CardId id);
+
+    /**
+     * @brief Get the number of card kinds in the catalog
+     * @return Number of prototypes
+     */
+    static constexpr size_t size() { return static_cast<size_t>(CardId::COUNT); }
+};
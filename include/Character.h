@@ -10,6 +10,7 @@
 #include "Deck.h"
 #include "Inventory.h"
 #include "AI.h"
+#include "GameContext.h"
 #include <memory>
 #include <vector>
 #include <iostream>
@@ -79,7 +80,25 @@ public:
      * @brief Set character's inventory
      * @param inv New inventory
      */
-    void setInventory(std::shared_ptr<Inventory> inv) { inventory = inv; }
+    void setInventory(std::shared_ptr<Inventory> inv) {
+        inventory = inv;
+        if (inventory) {
+            inventory->setContext(context);
+        }
+    }
+
+    /**
+     * @brief Bind the character and its inventory to a game session
+     * @param newContext Context of the session, nullptr for the thread default
+     * @return The previously bound context, nullptr if there was none
+     */
+    GameContext* setContext(GameContext* newContext) override {
+        GameContext* previous = Entity::setContext(newContext);
+        if (inventory) {
+            inventory->setContext(newContext);
+        }
+        return previous;
+    }
 
     /**
      * @brief Get effect duration of specified type
@@ -100,7 +119,7 @@ public:
      * @param exp Amount of experience to gain
      */
     void gainExp(int exp) {
-        experience += exp;
+        assignField(experience, experience + exp);
         checkLevelUp();
     }
 
@@ -108,7 +127,7 @@ public:
      * @brief Increment kill counter
      */
     void incrementKills() {
-        kills++;
+        assignField(kills, kills + 1);
     }
 
     /**
@@ -156,6 +175,15 @@ protected:
     /** @brief Active effects on the character */
     std::vector<ActiveEffect> activeEffects;
 
+    /** @brief Copies character state in and out of its structure-of-arrays table */
+    friend class CombatantStore;
+
+    /** @brief Captures and restores character state as plain values */
+    friend struct CombatantSnapshot;
+
+    /** @brief Undoes and redoes changes to the active effects */
+    friend class CommandLog;
+
 public:
     /**
      * @brief Character constructor
@@ -172,6 +200,25 @@ public:
      */
     virtual ~Character() = default;
 
+    /**
+     * @brief View an entity as a character
+     * @param entity The entity
+     * @return The entity as a Character, or nullptr if it is not one
+     * @details Resolved from the entity's kind tag, without RTTI
+     */
+    static Character* from(Entity& entity) {
+        return entity.getKind() >= EntityKind::CHARACTER ? static_cast<Character*>(&entity) : nullptr;
+    }
+
+    /**
+     * @brief View an entity as a character
+     * @param entity The entity
+     * @return The entity as a Character, or nullptr if it is not one
+     */
+    static const Character* from(const Entity& entity) {
+        return entity.getKind() >= EntityKind::CHARACTER ? static_cast<const Character*>(&entity) : nullptr;
+    }
+
     /**
      * @brief Attack target
      * @param target Attack target
@@ -222,13 +269,13 @@ public:
      * @brief Set attack power
      * @param power New attack power value
      */
-    void setAttackPower(int power) { attackPower = power; }
+    void setAttackPower(int power) { assignField(attackPower, power); }
     
     /**
      * @brief Set defense
      * @param def New defense value
      */
-    void setDefense(int def) { defense = def; }
+    void setDefense(int def) { assignField(defense, def); }
 
     /**
      * @brief Get character's deck
@@ -292,7 +339,7 @@ private:
     void checkLevelUp() {
         while (experience >= getRequiredExp()) {
             levelUp();
-            experience = 0;
+            assignField(experience, 0);
         }
     }
     
@@ -300,15 +347,10 @@ private:
      * @brief Level up character
      */
     void levelUp() {
-        level++;
-        attackPower += 2;
-        defense += 1;
+        assignField(level, level + 1);
+        assignField(attackPower, attackPower + 2);
+        assignField(defense, defense + 1);
         heal(MAX_HEALTH * 0.25);
-
-        std::cout << "\n=== LEVEL UP! ===\n"
-                  << "New level: " << level << "\n"
-                  << "Attack: +2 (" << attackPower << ")\n"
-                  << "Defense: +1 (" << defense << ")\n"
-                  << "==================\n\n";
+        getContext().emit(CombatEvent::levelUp(level), this, nullptr);
     }
 };
\ No newline at end of file
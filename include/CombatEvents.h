@@ -0,0 +1,228 @@
+/**
+ * @file CombatEvents.h
+ * @brief Definition of the structured combat event stream
+ * @details This file defines the CombatEvent record that combat code emits
+ *          for every action and the CombatEventStream ring buffer a session
+ *          keeps them in. Events are small fixed-size values; their text is
+ *          only produced when a session has somewhere to write it.
+ */
+#pragma once
+#include "Card.h"
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @struct CombatEvent
+ * @brief One combat action as a plain value
+ * @details Characters are referred to by their actor id; the meaning of
+ *          amount and value depends on the type.
+ */
+struct CombatEvent {
+    /**
+     * @enum Type
+     * @brief Kind of action
+     */
+    enum class Type : uint8_t {
+        DAMAGE,         /**< Target lost amount health */
+        HEAL,           /**< Target regained amount health */
+        EFFECT_APPLIED, /**< Target got an effect for amount turns; value is a slow's speed in percent */
+        CARD_PLAYED,    /**< Source played card on target */
+        MANA_SPENT,     /**< Source spent amount mana */
+        MANA_RESTORED,  /**< Target regained amount mana */
+        DEFENSE_RAISED, /**< Target's defense rose by amount */
+        LEVEL_UP        /**< Source reached level amount */
+    };
+
+    /**
+     * @enum Cause
+     * @brief What brought the action about
+     */
+    enum class Cause : uint8_t {
+        NONE,           /**< Nothing more specific */
+        ATTACK,         /**< A basic attack */
+        SWORD,          /**< A Warrior's sword */
+        STAFF,          /**< A Mage's staff */
+        ARROW,          /**< An Archer's arrow */
+        HEALING_STRIKE, /**< A Healer's attack */
+        CARD,           /**< The card in the event */
+        EFFECT,         /**< An active effect ticking */
+        ABILITY         /**< A character ability */
+    };
+
+    /** @brief Kind of action */
+    Type type = Type::DAMAGE;
+
+    /** @brief What brought it about */
+    Cause cause = Cause::NONE;
+
+    /** @brief Card involved, CardId::NONE if none */
+    CardId card = CardId::NONE;
+
+    /** @brief Effect applied, as the value of its EffectType */
+    uint8_t effect = 0;
+
+    /** @brief Actor id of the acting character, 0 if none */
+    uint32_t source = 0;
+
+    /** @brief Actor id of the affected character, 0 if none */
+    uint32_t target = 0;
+
+    /** @brief Main figure of the action */
+    int32_t amount = 0;
+
+    /** @brief Secondary figure of the action */
+    int32_t value = 0;
+
+    /**
+     * @brief Make a damage event
+     * @param cause What dealt the damage
+     * @param amount Damage dealt
+     * @param card Card that dealt it, for Cause::CARD
+     * @return The event
+     */
+    static CombatEvent damage(Cause cause, int amount, CardId card = CardId::NONE);
+
+    /**
+     * @brief Make a healing event
+     * @param cause What healed
+     * @param amount Health restored
+     * @return The event
+     */
+    static CombatEvent heal(Cause cause, int amount);
+
+    /**
+     * @brief Make an effect event
+     * @param type The effect
+     * @param duration Its duration in turns
+     * @param speedModifier Its speed modifier
+     * @return The event
+     */
+    static CombatEvent effectApplied(EffectType type, int duration, float speedModifier);
+
+    /**
+     * @brief Make a card event
+     * @param card The card played
+     * @return The event
+     */
+    static CombatEvent cardPlayed(CardId card);
+
+    /**
+     * @brief Make a mana cost event
+     * @param amount Mana spent
+     * @return The event
+     */
+    static CombatEvent manaSpent(int amount);
+
+    /**
+     * @brief Make a mana event
+     * @param amount Mana restored
+     * @param card Card that restored it
+     * @return The event
+     */
+    static CombatEvent manaRestored(int amount, CardId card);
+
+    /**
+     * @brief Make a defense event
+     * @param amount Defense gained
+     * @param card Card that raised it
+     * @return The event
+     */
+    static CombatEvent defenseRaised(int amount, CardId card);
+
+    /**
+     * @brief Make a level event
+     * @param level The new level
+     * @return The event
+     */
+    static CombatEvent levelUp(int level);
+
+    /**
+     * @brief Write the text of an event
+     * @param out Stream to write to
+     * @param sourceName Name of the acting character
+     * @param targetName Name of the affected character
+     * @details Writes the line the action used to print, newline included
+     */
+    void render(std::ostream& out, const std::string& sourceName, const std::string& targetName) const;
+};
+
+/**
+ * @class CombatEventStream
+ * @brief Ring buffer of the most recent combat events of a session
+ * @details Holds the last capacity() events; older ones are overwritten.
+ *          The buffer is allocated by the first event, so sessions that
+ *          never fight pay nothing, and recording is a copy into it.
+ */
+class CombatEventStream {
+public:
+    /** @brief Number of events kept by default */
+    static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+private:
+    /** @brief Event slots, empty until the first event */
+    std::vector<CombatEvent> events;
+
+    /** @brief Number of slots, a power of two */
+    size_t capacity;
+
+    /** @brief Number of events recorded since the last clear */
+    uint64_t recorded = 0;
+
+public:
+    /**
+     * @brief Constructor for CombatEventStream
+     * @param capacity Number of events to keep, rounded up to a power of two
+     */
+    explicit CombatEventStream(size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * @brief Record an event
+     * @param event The event
+     */
+    void push(const CombatEvent& event) {
+        if (events.empty()) {
+            events.resize(capacity);
+        }
+        events[recorded & (capacity - 1)] = event;
+        recorded++;
+    }
+
+    /**
+     * @brief Get the number of events kept
+     * @return Number of events that can be read
+     */
+    size_t size() const { return recorded < capacity ? static_cast<size_t>(recorded) : capacity; }
+
+    /**
+     * @brief Get the number of events recorded
+     * @return Events recorded since the last clear, including overwritten ones
+     */
+    uint64_t total() const { return recorded; }
+
+    /**
+     * @brief Get the number of events the stream keeps at most
+     * @return The capacity
+     */
+    size_t getCapacity() const { return capacity; }
+
+    /**
+     * @brief Get a kept event
+     * @param i Position among the kept events, 0 for the oldest
+     * @return The event
+     */
+    const CombatEvent& operator[](size_t i) const { return events[(recorded - size() + i) & (capacity - 1)]; }
+
+    /**
+     * @brief Get the most recent event
+     * @return The event; the stream must not be empty
+     */
+    const CombatEvent& back() const { return events[(recorded - 1) & (capacity - 1)]; }
+
+    /**
+     * @brief Forget all events, keeping the buffer
+     */
+    void clear() { recorded = 0; }
+};
@@ -0,0 +1,346 @@
+/**
+ * @file CombatantStore.h
+ * @brief Definition of the structure-of-arrays combatant table
+ * @details This file defines the CombatantStore class, which keeps the combat
+ *          state of many combatants in contiguous per-field arrays, and the
+ *          CombatantHandle type used to refer to a row of the table. Batch
+ *          simulations use it instead of one heap object per Character.
+ */
+#pragma once
+#include "Entity.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Character;
+
+/**
+ * @struct CombatantHandle
+ * @brief Lightweight reference to a combatant in a CombatantStore
+ * @details A handle is just a row index; it stays valid until the store is cleared
+ */
+struct CombatantHandle {
+    /** @brief Row of the combatant in its store */
+    uint32_t index;
+
+    /**
+     * @brief Compare two handles
+     * @param other Handle to compare with
+     * @return True if both refer to the same row
+     */
+    bool operator==(const CombatantHandle& other) const { return index == other.index; }
+
+    /**
+     * @brief Compare two handles
+     * @param other Handle to compare with
+     * @return True if the handles refer to different rows
+     */
+    bool operator!=(const CombatantHandle& other) const { return index != other.index; }
+};
+
+/**
+ * @class CombatantStore
+ * @brief Structure-of-arrays table of combatants
+ * @details Every combat field lives in its own contiguous array indexed by
+ *          the combatant's row. Active effects are stored field by field as
+ *          well; each combatant owns a fixed-size range of effect slots that
+ *          grows for all combatants at once when one of them runs out.
+ *          Operations follow the rules of Entity and Character exactly, but
+ *          print nothing and skip experience and kill bookkeeping.
+ */
+class CombatantStore {
+public:
+    /** @brief Number of effect slots per combatant in a new store */
+    static constexpr size_t DEFAULT_EFFECT_CAPACITY = 4;
+
+    /**
+     * @enum TickKernel
+     * @brief Implementation used to tick the effects of the whole table
+     */
+    enum class TickKernel {
+        AUTO,  /**< AVX2 when the CPU supports it, scalar otherwise */
+        SCALAR /**< Portable per-combatant loop */
+    };
+
+private:
+    /** @brief Names of the combatants; only read for reporting */
+    std::vector<std::string> names;
+
+    /** @brief Current health */
+    std::vector<int> health;
+
+    /** @brief Current mana */
+    std::vector<int> mana;
+
+    /** @brief Defense reported by getDefense(), used by defense-aware attacks */
+    std::vector<int> defense;
+
+    /** @brief Defense subtracted from incoming damage by Entity::takeDamage */
+    std::vector<int> damageReduction;
+
+    /** @brief Attack power */
+    std::vector<int> attackPower;
+
+    /** @brief Character level */
+    std::vector<int> level;
+
+    /** @brief Number of active effects of each combatant */
+    std::vector<uint32_t> effectCount;
+
+    /** @brief Type of each effect slot */
+    std::vector<EffectType> effectType;
+
+    /** @brief Speed modifier of each effect slot */
+    std::vector<float> effectSpeedModifier;
+
+    /** @brief Remaining duration of each effect slot */
+    std::vector<int> effectDuration;
+
+    /** @brief Damage per turn of each effect slot */
+    std::vector<int> effectDamage;
+
+    /** @brief Healing per turn of each effect slot */
+    std::vector<int> effectHeal;
+
+    /** @brief Number of effect slots owned by each combatant */
+    size_t effectCapacity = DEFAULT_EFFECT_CAPACITY;
+
+public:
+    /**
+     * @brief Reserve room for a number of combatants
+     * @param count Expected number of combatants
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Remove all combatants
+     * @details Invalidates every handle issued so far
+     */
+    void clear();
+
+    /**
+     * @brief Get the number of combatants
+     * @return Number of rows in the table
+     */
+    size_t size() const { return health.size(); }
+
+    /**
+     * @brief Add a combatant with the given stats
+     * @param name Combatant name
+     * @param hp Initial health
+     * @param mp Initial mana
+     * @param attack Attack power
+     * @param def Defense value, also subtracted from incoming damage
+     * @return Handle of the new combatant
+     * @details Health and mana are clamped like in the Entity constructor
+     */
+    CombatantHandle add(const std::string& name, int hp, int mp, int attack, int def);
+
+    /**
+     * @brief Add a snapshot of a character
+     * @param character The character to copy
+     * @return Handle of the new combatant
+     */
+    CombatantHandle add(const Character& character);
+
+    /**
+     * @brief Copy a combatant's state back into a character
+     * @param handle The combatant to copy
+     * @param character The character to update
+     * @details Updates health, mana, defense, attack power and active effects;
+     *          level, experience and kills are left untouched
+     */
+    void writeBack(CombatantHandle handle, Character& character) const;
+
+    /**
+     * @brief Get the name of a combatant
+     * @param handle The combatant
+     * @return Name of the combatant
+     */
+    const std::string& getName(CombatantHandle handle) const { return names[handle.index]; }
+
+    /**
+     * @brief Get the health of a combatant
+     * @param handle The combatant
+     * @return Current health
+     */
+    int getHealth(CombatantHandle handle) const { return health[handle.index]; }
+
+    /**
+     * @brief Get the mana of a combatant
+     * @param handle The combatant
+     * @return Current mana
+     */
+    int getMana(CombatantHandle handle) const { return mana[handle.index]; }
+
+    /**
+     * @brief Get the defense of a combatant
+     * @param handle The combatant
+     * @return Defense value
+     */
+    int getDefense(CombatantHandle handle) const { return defense[handle.index]; }
+
+    /**
+     * @brief Get the attack power of a combatant
+     * @param handle The combatant
+     * @return Attack power
+     */
+    int getAttackPower(CombatantHandle handle) const { return attackPower[handle.index]; }
+
+    /**
+     * @brief Get the defense subtracted from damage a combatant takes
+     * @param handle The combatant
+     * @return Damage reduction
+     */
+    int getDamageReduction(CombatantHandle handle) const { return damageReduction[handle.index]; }
+
+    /**
+     * @brief Get the level of a combatant
+     * @param handle The combatant
+     * @return Character level
+     */
+    int getLevel(CombatantHandle handle) const { return level[handle.index]; }
+
+    /**
+     * @brief Check if a combatant is alive
+     * @param handle The combatant
+     * @return True if health is greater than 0
+     */
+    bool isAlive(CombatantHandle handle) const { return health[handle.index] > 0; }
+
+    /**
+     * @brief Get the effect slots of a combatant
+     * @param handle The combatant
+     * @return Half-open range [first, last) of slot indices holding its active effects
+     */
+    std::pair<size_t, size_t> getEffectRange(CombatantHandle handle) const {
+        size_t first = handle.index * effectCapacity;
+        return {first, first + effectCount[handle.index]};
+    }
+
+    /**
+     * @brief Get an active effect of a combatant
+     * @param handle The combatant
+     * @param i Position of the effect, in the order it was applied
+     * @return Copy of the effect
+     */
+    ActiveEffect getEffect(CombatantHandle handle, size_t i) const;
+
+    /**
+     * @brief Apply damage to a combatant
+     * @param handle The combatant
+     * @param damage Damage before defense
+     * @details Same rules as Entity::takeDamage
+     */
+    void takeDamage(CombatantHandle handle, int damage);
+
+    /**
+     * @brief Apply the same damage to a combatant several times
+     * @param handle The combatant
+     * @param damage Damage of each hit before defense
+     * @param hits Number of hits
+     * @details Same result as calling takeDamage() hits times, in constant time
+     */
+    void takeRepeatedDamage(CombatantHandle handle, int damage, int hits);
+
+    /**
+     * @brief Heal a combatant
+     * @param handle The combatant
+     * @param amount Amount of health to restore
+     * @details Same rules as Entity::heal
+     */
+    void heal(CombatantHandle handle, int amount);
+
+    /**
+     * @brief Reduce the mana of a combatant
+     * @param handle The combatant
+     * @param amount Amount of mana to consume
+     */
+    void reduceMana(CombatantHandle handle, int amount);
+
+    /**
+     * @brief Increase the mana of a combatant
+     * @param handle The combatant
+     * @param amount Amount of mana to restore
+     * @details Same rules as Entity::increaseMana
+     */
+    void increaseMana(CombatantHandle handle, int amount) {
+        mana[handle.index] = std::min(mana[handle.index] + amount, Entity::MAX_MANA);
+    }
+
+    /**
+     * @brief Set the defense of a combatant
+     * @param handle The combatant
+     * @param value New defense value
+     * @details Same rules as Character::setDefense: only the reported
+     *          defense changes, not the damage reduction
+     */
+    void setDefense(CombatantHandle handle, int value) { defense[handle.index] = value; }
+
+    /**
+     * @brief Apply an effect to a combatant
+     * @param handle The combatant
+     * @param type Effect type
+     * @param speedMod Speed modifier
+     * @param duration Duration in turns
+     * @param damage Damage per turn
+     * @param healing Healing per turn
+     */
+    void applyEffect(CombatantHandle handle, EffectType type, float speedMod, int duration,
+                     int damage = 0, int healing = 0);
+
+    /**
+     * @brief Tick the active effects of a combatant
+     * @param handle The combatant
+     * @details Same rules and order as Character::updateEffect
+     */
+    void updateEffects(CombatantHandle handle);
+
+    /**
+     * @brief Tick the active effects of every combatant
+     * @param kernel Implementation to use
+     * @details Gives exactly the same result as calling updateEffects() on
+     *          each combatant. The AVX2 kernel handles eight combatants per
+     *          step and drops expired effects in one pass per combatant.
+     */
+    void updateAllEffects(TickKernel kernel = TickKernel::AUTO);
+
+    /**
+     * @brief Check whether the AVX2 effect kernel can run on this CPU
+     * @return True if updateAllEffects() uses AVX2 with TickKernel::AUTO
+     */
+    static bool hasSimdKernel();
+
+    /**
+     * @brief Get the combined speed modifier of a combatant
+     * @param handle The combatant
+     * @return Product of the modifiers of all SLOW effects
+     */
+    float getSpeedModifier(CombatantHandle handle) const;
+
+    /**
+     * @brief Perform a basic attack
+     * @param attacker The attacking combatant
+     * @param target The attacked combatant
+     * @return Damage dealt before the target's defense, 0 if the target was dead
+     * @details Same rules as Character::attack
+     */
+    int attack(CombatantHandle attacker, CombatantHandle target);
+
+private:
+    /**
+     * @brief Drop the expired effects of a combatant
+     * @param row Row of the combatant
+     * @details Keeps the order of the remaining effects
+     */
+    void compactEffects(size_t row);
+
+    /**
+     * @brief Give every combatant more effect slots
+     * @param capacity New number of slots per combatant
+     */
+    void growEffectCapacity(size_t capacity);
+};
@@ -0,0 +1,227 @@
+/**
+ * @file CommandLog.h
+ * @brief Definition of the reversible command log
+ * @details This file defines the CommandLog class, which records every
+ *          combat mutation made in a session together with what it takes
+ *          to reverse it, so moves can be undone and redone in place.
+ */
+#pragma once
+#include "Card.h"
+#include "Entity.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Character;
+class Deck;
+class Inventory;
+class Item;
+
+/**
+ * @class CommandLog
+ * @brief Undo/redo history of combat mutations
+ * @details While a log is attached to a GameContext, entities, characters
+ *          and decks of that session record each change as a command that
+ *          holds both the old and the new value. Commands are plain values
+ *          in one vector, so once the log has reserved enough room recording
+ *          allocates nothing, and undoing or redoing a command is O(1)
+ *          except for re-inserting an expired effect or a removed card in
+ *          the middle of its list.
+ *
+ *          Commands point at the objects they changed; the log must be
+ *          cleared before any of them is destroyed. Undoing and redoing
+ *          write the fields directly and record nothing themselves.
+ */
+class CommandLog {
+public:
+    /**
+     * @struct Command
+     * @brief One recorded mutation
+     */
+    struct Command {
+        /**
+         * @enum Type
+         * @brief Kind of mutation
+         */
+        enum class Type : uint8_t {
+            FIELD,          /**< An integer field changed from before to after */
+            EFFECT_APPLIED, /**< An effect was appended to a character */
+            EFFECTS_TICKED, /**< Every effect of a character lost one turn */
+            EFFECT_EXPIRED, /**< The effect at index was removed from a character */
+            CARD_DRAWN,     /**< The top card was drawn from a deck */
+            CARD_REMOVED,   /**< The card at index was removed from a deck */
+            ITEM_REMOVED,   /**< The item at index was removed from an inventory */
+            TURN            /**< Start of a turn; changes nothing */
+        };
+
+        /** @brief Kind of mutation */
+        Type type = Type::TURN;
+
+        /** @brief Card drawn or removed */
+        CardId card = CardId::NONE;
+
+        /** @brief Position of the expired effect, removed card or removed item */
+        uint32_t index = 0;
+
+        /** @brief Changed field, Character, Deck or Inventory, depending on the type */
+        void* object = nullptr;
+
+        /** @brief Value of the field before the change */
+        int before = 0;
+
+        /** @brief Value of the field after the change */
+        int after = 0;
+
+        /** @brief Item removed from an inventory */
+        Item* item = nullptr;
+
+        /** @brief Effect that was applied or expired */
+        ActiveEffect effect;
+    };
+
+private:
+    /** @brief Recorded commands, oldest first */
+    std::vector<Command> commands;
+
+    /** @brief Number of commands currently applied; the rest can be redone */
+    size_t applied = 0;
+
+public:
+    /**
+     * @brief Reserve room for a number of commands
+     * @param count Expected number of commands
+     */
+    void reserve(size_t count) { commands.reserve(count); }
+
+    /**
+     * @brief Forget all commands
+     */
+    void clear() {
+        commands.clear();
+        applied = 0;
+    }
+
+    /**
+     * @brief Get the number of applied commands
+     * @return Position of the log, usable with undoTo()
+     */
+    size_t position() const { return applied; }
+
+    /**
+     * @brief Check if a command can be undone
+     * @return True if at least one command is applied
+     */
+    bool canUndo() const { return applied > 0; }
+
+    /**
+     * @brief Check if a command can be redone
+     * @return True if at least one undone command is kept
+     */
+    bool canRedo() const { return applied < commands.size(); }
+
+    /**
+     * @brief Record a change of an integer field
+     * @param field The field
+     * @param value Its new value
+     */
+    void recordField(int& field, int value);
+
+    /**
+     * @brief Record that an effect was appended to a character
+     * @param character The character, with the effect already appended
+     */
+    void recordEffectApplied(Character& character);
+
+    /**
+     * @brief Record that every effect of a character lost one turn
+     * @param character The character
+     */
+    void recordEffectsTicked(Character& character);
+
+    /**
+     * @brief Record that an effect expired
+     * @param character The character, with the effect already removed
+     * @param index Position the effect had
+     * @param effect The removed effect
+     */
+    void recordEffectExpired(Character& character, size_t index, const ActiveEffect& effect);
+
+    /**
+     * @brief Record that the top card was drawn from a deck
+     * @param deck The deck, with the card already drawn
+     * @param card The drawn card
+     */
+    void recordCardDrawn(Deck& deck, CardId card);
+
+    /**
+     * @brief Record that a card was removed from a deck
+     * @param deck The deck, with the card already removed
+     * @param index Position the card had
+     * @param card The removed card
+     */
+    void recordCardRemoved(Deck& deck, size_t index, CardId card);
+
+    /**
+     * @brief Record that an item was removed from an inventory
+     * @param inventory The inventory, with the item already removed
+     * @param index Position the item had
+     * @param item The removed item; the inventory keeps owned items alive
+     */
+    void recordItemRemoved(Inventory& inventory, size_t index, Item* item);
+
+    /**
+     * @brief Mark the start of a turn
+     * @details undoTurn() and redoTurn() move between these marks
+     */
+    void markTurn();
+
+    /**
+     * @brief Undo the most recent applied command
+     * @return False if there was nothing to undo
+     */
+    bool undo();
+
+    /**
+     * @brief Redo the oldest undone command
+     * @return False if there was nothing to redo
+     */
+    bool redo();
+
+    /**
+     * @brief Undo commands until the log is at a position
+     * @param target Position returned by position() earlier
+     */
+    void undoTo(size_t target);
+
+    /**
+     * @brief Undo everything since the most recent turn mark, including the mark
+     * @return False if no turn mark was applied
+     */
+    bool undoTurn();
+
+    /**
+     * @brief Redo the next undone turn
+     * @return False if there was no undone turn mark
+     * @details Redoes the mark and every command up to the next mark
+     */
+    bool redoTurn();
+
+private:
+    /**
+     * @brief Append a command, dropping the undone ones
+     * @param command The command
+     */
+    void push(const Command& command);
+
+    /**
+     * @brief Reverse a command
+     * @param command The command
+     */
+    static void revert(const Command& command);
+
+    /**
+     * @brief Perform a command again
+     * @param command The command
+     */
+    static void reapply(const Command& command);
+};
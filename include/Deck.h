@@ -5,33 +5,256 @@
  *          of cards for players and other game entities
  */
 #pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
 #include <vector>
 #include <memory>
 #include "Card.h"
+#include "CardCatalog.h"
+
+class GameContext;
 
 /**
  * @class Deck
  * @brief Manages a collection of cards
  * @details The Deck class provides functionality for adding, removing,
- *          and drawing cards during gameplay
+ *          and drawing cards during gameplay. Cards are stored as CardIds
+ *          and resolved to their shared prototypes in the CardCatalog, so
+ *          copying a deck copies a small array of bytes. The deck also
+ *          counts its cards by kind, so asking whether it holds a kind
+ *          costs the same for a deck of five cards and one of five hundred.
  */
 class Deck {
+public:
+    /**
+     * @class CardView
+     * @brief Non-owning view of the cards of a deck
+     * @details Elements are the catalog prototypes, returned by reference,
+     *          so inspecting a deck allocates nothing and touches no
+     *          reference count. Any change to the deck invalidates the view.
+     */
+    class CardView {
+    public:
+        /**
+         * @class iterator
+         * @brief Random access iterator over the cards of a view
+         */
+        class iterator {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = std::shared_ptr<Card>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const std::shared_ptr<Card>*;
+            using reference = const std::shared_ptr<Card>&;
+
+        private:
+            /** @brief Card the iterator points at */
+            const CardId* position = nullptr;
+
+        public:
+            iterator() = default;
+
+            /**
+             * @brief Constructor for iterator
+             * @param position Card the iterator points at
+             */
+            explicit iterator(const CardId* position) : position(position) {}
+
+            /**
+             * @brief Get the card the iterator points at
+             * @return The prototype of the card
+             */
+            reference operator*() const { return CardCatalog::get(*position); }
+
+            /**
+             * @brief Access the card the iterator points at
+             * @return Pointer to the prototype of the card
+             */
+            pointer operator->() const { return &**this; }
+
+            /**
+             * @brief Get the card at an offset from the iterator
+             * @param offset Distance from the current card
+             * @return The prototype of the card
+             */
+            reference operator[](difference_type offset) const { return CardCatalog::get(position[offset]); }
+
+            iterator& operator++() { ++position; return *this; }
+            iterator operator++(int) { iterator old = *this; ++position; return old; }
+            iterator& operator--() { --position; return *this; }
+            iterator operator--(int) { iterator old = *this; --position; return old; }
+            iterator& operator+=(difference_type offset) { position += offset; return *this; }
+            iterator& operator-=(difference_type offset) { position -= offset; return *this; }
+            iterator operator+(difference_type offset) const { return iterator(position + offset); }
+            iterator operator-(difference_type offset) const { return iterator(position - offset); }
+            difference_type operator-(const iterator& other) const { return position - other.position; }
+            bool operator==(const iterator& other) const { return position == other.position; }
+            bool operator!=(const iterator& other) const { return position != other.position; }
+            bool operator<(const iterator& other) const { return position < other.position; }
+            bool operator>(const iterator& other) const { return position > other.position; }
+            bool operator<=(const iterator& other) const { return position <= other.position; }
+            bool operator>=(const iterator& other) const { return position >= other.position; }
+        };
+
+    private:
+        /** @brief First card of the view */
+        const CardId* first;
+
+        /** @brief One past the last card of the view */
+        const CardId* last;
+
+    public:
+        /**
+         * @brief Constructor for CardView
+         * @param first First card of the view
+         * @param last One past the last card of the view
+         */
+        CardView(const CardId* first, const CardId* last) : first(first), last(last) {}
+
+        /**
+         * @brief Get an iterator to the first card
+         * @return Iterator to the bottom card of the deck
+         */
+        iterator begin() const { return iterator(first); }
+
+        /**
+         * @brief Get an iterator past the last card
+         * @return Iterator past the top card of the deck
+         */
+        iterator end() const { return iterator(last); }
+
+        /**
+         * @brief Get the number of cards in the view
+         * @return The number of cards
+         */
+        size_t size() const { return static_cast<size_t>(last - first); }
+
+        /**
+         * @brief Check if the view has no cards
+         * @return True if the view is empty
+         */
+        bool empty() const { return first == last; }
+
+        /**
+         * @brief Get a card of the view
+         * @param index Position of the card, bottom first; must be in range
+         * @return The prototype of the card
+         */
+        const std::shared_ptr<Card>& operator[](size_t index) const { return CardCatalog::get(first[index]); }
+    };
+
 private:
-    /** @brief The collection of cards in this deck */
-    std::vector<std::shared_ptr<Card>> cards;
+    /** @brief The cards in this deck, bottom first */
+    std::vector<CardId> cards;
+
+    /** @brief Number of cards of each kind, indexed by CardId */
+    std::array<uint32_t, CardCatalog::size()> kindCounts{};
 
 public:
+    /** @brief Position returned by find() when the deck holds no card of a kind */
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    /**
+     * @brief Constructor for an empty Deck
+     */
+    Deck() = default;
+
+    /**
+     * @brief Constructor for a Deck holding the given cards
+     * @param ids The cards of the deck, bottom first
+     * @throws std::invalid_argument if a card is not part of the catalog
+     */
+    Deck(std::initializer_list<CardId> ids);
+
     /**
      * @brief Add a card to the deck
      * @param card The card to add
+     * @throws std::invalid_argument if the card is not part of the catalog
      */
     void addCard(std::shared_ptr<Card> card);
+
+    /**
+     * @brief Add a card to the deck
+     * @param id The kind of card to add
+     * @throws std::invalid_argument if the card is not part of the catalog
+     */
+    void addCard(CardId id);
     
+    /**
+     * @brief Replace the contents of the deck
+     * @param ids The new cards, bottom first
+     * @param count Number of cards
+     * @throws std::invalid_argument if a card is not part of the catalog
+     * @details Reuses the deck's storage when it is large enough
+     */
+    void assign(const CardId* ids, size_t count);
+
     /**
      * @brief Remove a card from the deck
      * @param card The card to remove
+     * @details Removes one card of the same kind
      */
     void removeCard(std::shared_ptr<Card> card);
+
+    /**
+     * @brief Remove a card from the deck
+     * @param id The kind of card to remove
+     * @details Removes the card of this kind nearest to the bottom; returns
+     *          at once if the deck holds none
+     */
+    void removeCard(CardId id);
+
+    /**
+     * @brief Remove a card from the deck during combat
+     * @param id The kind of card to remove
+     * @param context Session the card is removed in
+     * @details Records the removal in the session's command log, if any
+     */
+    void removeCard(CardId id, GameContext& context);
+
+    /**
+     * @brief Insert a card at a position
+     * @param index Position of the new card, bottom first; at most size()
+     * @param id The kind of card to insert
+     * @throws std::out_of_range if index is past the top of the deck
+     * @throws std::invalid_argument if the card is not part of the catalog
+     */
+    void insertCard(size_t index, CardId id);
+
+    /**
+     * @brief Remove the card at a position
+     * @param index Position of the card, bottom first
+     * @throws std::out_of_range if index is not a position in the deck
+     */
+    void removeAt(size_t index);
+
+    /**
+     * @brief Count the cards of a kind
+     * @param id The kind of card
+     * @return Number of cards of this kind in the deck
+     */
+    size_t count(CardId id) const {
+        size_t index = static_cast<size_t>(id);
+        return index < kindCounts.size() ? kindCounts[index] : 0;
+    }
+
+    /**
+     * @brief Check if the deck holds a card of a kind
+     * @param id The kind of card
+     * @return True if at least one card of this kind is in the deck
+     */
+    bool contains(CardId id) const { return count(id) > 0; }
+
+    /**
+     * @brief Find a card of a kind
+     * @param id The kind of card
+     * @return Position of the card of this kind nearest to the bottom,
+     *         or npos if the deck holds none
+     */
+    size_t find(CardId id) const;
     
     /**
      * @brief Draw a card from the deck
@@ -39,16 +262,51 @@ public:
      * @details Removes and returns the top card from the deck
      */
     std::shared_ptr<Card> drawCard();
+
+    /**
+     * @brief Draw a card from the deck during combat
+     * @param context Session the card is drawn in
+     * @return The drawn card, or nullptr if the deck is empty
+     * @details Records the draw in the session's command log, if any
+     */
+    std::shared_ptr<Card> drawCard(GameContext& context);
     
     /**
      * @brief Get all cards in the deck
      * @return Vector containing all cards in the deck
+     * @details Builds a new vector on every call; use view() to inspect the deck
+     */
+    std::vector<std::shared_ptr<Card>> getCards() const;
+
+    /**
+     * @brief Get a view of the cards in the deck
+     * @return Non-owning view of the cards, bottom first
      */
-    std::vector<std::shared_ptr<Card>> getCards() const { return cards; }
+    CardView view() const { return CardView(cards.data(), cards.data() + cards.size()); }
+
+    /**
+     * @brief Get a card of the deck
+     * @param index Position of the card, bottom first
+     * @return The prototype of the card
+     * @throws std::out_of_range if index is not a position in the deck
+     */
+    const std::shared_ptr<Card>& at(size_t index) const { return CardCatalog::get(cards.at(index)); }
+
+    /**
+     * @brief Get the identifiers of all cards in the deck
+     * @return The cards of the deck, bottom first
+     */
+    const std::vector<CardId>& getCardIds() const { return cards; }
     
     /**
      * @brief Get the number of cards in the deck
      * @return The number of cards
      */
     size_t size() const { return cards.size(); }
-};
\ No newline at end of file
+
+    /**
+     * @brief Check if the deck has no cards
+     * @return True if the deck is empty
+     */
+    bool empty() const { return cards.empty(); }
+};
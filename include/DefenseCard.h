@@ -25,9 +25,11 @@ public:
     /**
      * @brief Play this card on a target
      * @param target The entity targeted by this card
+     * @param context Session the card is played in
      * @details Increases the target's defense by a significant amount
      */
-    void play(Entity& target) override;
+    void play(Entity& target, GameContext& context) override;
+    using Card::play;
     
     /**
      * @brief Get the mana cost of this card
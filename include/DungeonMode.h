@@ -8,6 +8,7 @@
 #include "GameMode.h"
 #include "Character.h"
 #include "AI.h"
+#include "BattleEngine.h"
 #include <vector>
 #include <memory>
 
@@ -42,6 +43,9 @@ private:
     /** @brief Current dungeon stage/floor */
     int currentStage = 1;
 
+    /** @brief Controller for headless runs, nullptr for interactive play */
+    std::shared_ptr<ActionSource> autopilot;
+
     /**
      * @brief Add an enemy to the dungeon
      * @param name Enemy name
@@ -59,8 +63,10 @@ public:
     /**
      * @brief Constructor for DungeonMode
      * @param p Pointer to the player character
+     * @param autopilot Controller choosing the player's actions; when set,
+     *        the dungeon runs headless without prompts or output
      */
-    DungeonMode(std::shared_ptr<Character> p);
+    DungeonMode(std::shared_ptr<Character> p, std::shared_ptr<ActionSource> autopilot = nullptr);
     
     /**
      * @brief Start the dungeon mode
@@ -73,6 +79,13 @@ public:
      * @details Creates a powerful boss character for the final battle
      */
     void generateBoss();
+
+    /**
+     * @brief Create the dungeon boss character
+     * @return The boss with its standard stats, without deck or AI
+     * @details Shared by generateBoss and the endgame tablebase generator
+     */
+    static std::shared_ptr<Character> createBoss();
     
     /**
      * @brief Update the dungeon state
@@ -30,8 +30,17 @@ public:
      * @brief Makes a simple decision for the character
      * @param self The character controlled by the AI
      * @param target The entity being targeted by the AI
+     * @param context Session the decision is made in
      * @details Implements basic decision-making logic, usually
      *          choosing to attack directly without complex strategy
      */
-    void makeDecision(Character& self, Entity& target) override;
+    void makeDecision(Character& self, Entity& target, GameContext& context) override;
+    using AI::makeDecision;
+
+    /**
+     * @brief Check whether every decision from now on is a basic attack
+     * @param self The character controlled by this AI
+     * @return True once the character's deck is empty
+     */
+    bool onlyAttacks(const Character& self) const override;
 };
\ No newline at end of file
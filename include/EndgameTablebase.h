@@ -0,0 +1,194 @@
+/**
+ * @file EndgameTablebase.h
+ * @brief Definition of the boss endgame tablebase
+ * @details This file defines the EndgameTablebase class, a precomputed table
+ *          of optimal boss moves for low-health endgames that is solved
+ *          offline and memory-mapped at startup, and the EndgameRules type
+ *          describing the pairing a table was solved for.
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Character;
+class Deck;
+
+/**
+ * @struct EndgameRules
+ * @brief Damage figures of one boss-versus-hero pairing
+ * @details Everything the endgame model needs to know about the two
+ *          characters besides the state of the battle. A table is only
+ *          consulted when the live characters produce the same figures
+ *          as the ones it was solved for.
+ */
+struct EndgameRules {
+    /** @brief Damage the boss takes from the hero's basic attack */
+    int heroHit = 0;
+
+    /** @brief Damage the hero takes from the boss's basic attack without mana */
+    int bossHit = 0;
+
+    /** @brief Defense the hero subtracts from card and effect damage */
+    int heroReduction = 0;
+
+    /** @brief Whether the boss's basic attack is a Fireball while it has 20 mana, as a Mage's */
+    bool bossCastsFireballs = false;
+
+    /**
+     * @brief Work out the rules of a pairing
+     * @param boss The boss
+     * @param hero The hero it fights
+     * @param rules Receives the rules
+     * @return False if the hero's attack is not a fixed amount of damage,
+     *         as for a Mage, so the pairing cannot be tabled
+     */
+    static bool between(const Character& boss, const Character& hero, EndgameRules& rules);
+
+    /**
+     * @brief Compare two rule sets
+     * @param other Rules to compare with
+     * @return True if all figures are equal
+     */
+    bool operator==(const EndgameRules& other) const {
+        return heroHit == other.heroHit && bossHit == other.bossHit &&
+               heroReduction == other.heroReduction && bossCastsFireballs == other.bossCastsFireballs;
+    }
+
+    /**
+     * @brief Compare two rule sets
+     * @param other Rules to compare with
+     * @return True if any figure differs
+     */
+    bool operator!=(const EndgameRules& other) const { return !(*this == other); }
+};
+
+/**
+ * @class EndgameTablebase
+ * @brief Memory-mapped table of optimal boss moves in low-health endgames
+ * @details An endgame is covered when the hero is below the table's health
+ *          limit and the boss could not heal to 30 above it with its
+ *          pending and playable Regeneration, which includes every state
+ *          with both sides below the limit; the boss
+ *          deck holds at most one each of Fireball, Lightning and
+ *          Regeneration, and the only active effects are the burns of the
+ *          boss's Fireballs on the hero and the boss's own Regeneration.
+ *          Within that model the hero is assumed to answer every round with
+ *          a basic attack, and the boss move that maximizes the chance of
+ *          winning is stored, ties going to the shorter win or the longer loss.
+ *
+ *          The file starts with one page holding a directory of tables, one
+ *          per EndgameRules; every table starts on its own page and stores
+ *          two bits per state, so a lookup is an index computation and a
+ *          single byte read, and the pages of a table are only read from
+ *          disk when a lookup first touches them. Files use the byte order
+ *          of the machine that generated them.
+ */
+class EndgameTablebase {
+public:
+    /**
+     * @enum Move
+     * @brief Boss move stored for a state
+     */
+    enum class Move : uint8_t {
+        ATTACK,      /**< Basic attack on the hero */
+        FIREBALL,    /**< Play the Fireball card on the hero */
+        LIGHTNING,   /**< Play the Lightning card on the hero */
+        REGENERATION /**< Play the Regeneration card on itself */
+    };
+
+    /** @brief Health of both sides below which a generated table covers a state */
+    static constexpr int DEFAULT_HEALTH_LIMIT = 60;
+
+    /** @brief Alignment of the directory and of every table in the file */
+    static constexpr size_t PAGE_SIZE = 4096;
+
+    /** @brief Largest number of tables a file holds */
+    static constexpr size_t MAX_TABLES = 64;
+
+    /** @brief File the game maps at startup if it exists */
+    static constexpr const char* DEFAULT_PATH = "boss-endgame.tb";
+
+private:
+    /** @brief Start of the mapped file, nullptr if none is open */
+    const uint8_t* data = nullptr;
+
+    /** @brief Length of the mapping in bytes */
+    size_t length = 0;
+
+public:
+    /**
+     * @brief Constructor for an empty EndgameTablebase
+     * @details Covers no state until a file is opened
+     */
+    EndgameTablebase() = default;
+
+    /**
+     * @brief Constructor for EndgameTablebase
+     * @param path File to map
+     * @throws std::runtime_error if the file cannot be mapped or is not a tablebase
+     */
+    explicit EndgameTablebase(const std::string& path) { open(path); }
+
+    /**
+     * @brief Destructor for EndgameTablebase
+     * @details Unmaps the file
+     */
+    ~EndgameTablebase();
+
+    EndgameTablebase(const EndgameTablebase&) = delete;
+    EndgameTablebase& operator=(const EndgameTablebase&) = delete;
+
+    /**
+     * @brief Map a tablebase file
+     * @param path File to map; replaces the file opened before
+     * @throws std::runtime_error if the file cannot be mapped or is not a tablebase
+     * @details Only the directory is checked; table pages are left unread
+     */
+    void open(const std::string& path);
+
+    /**
+     * @brief Unmap the file
+     */
+    void close();
+
+    /**
+     * @brief Check whether a file is mapped
+     * @return True if lookups can succeed
+     */
+    bool isOpen() const { return data != nullptr; }
+
+    /**
+     * @brief Get the number of tables in the file
+     * @return Number of tables, 0 if no file is open
+     */
+    size_t tableCount() const;
+
+    /**
+     * @brief Look up the best boss move
+     * @param boss The boss, about to move
+     * @param hero The hero it fights
+     * @param bossDeck Cards the boss can still play
+     * @param move Receives the move on a hit
+     * @return False if the state or the pairing is not covered
+     */
+    bool lookup(const Character& boss, const Character& hero, const Deck& bossDeck, Move& move) const;
+
+    /**
+     * @brief Solve tables and write them to a file
+     * @param path File to write
+     * @param rules Pairings to solve, one table each
+     * @param healthLimit Health of both sides below which states are covered
+     * @param threads Number of worker threads, 0 for one per hardware thread
+     * @throws std::invalid_argument if there are no rules, more than
+     *         MAX_TABLES, or the limit leaves no room for states
+     * @throws std::runtime_error if the file cannot be written
+     * @details Each table is solved by retrograde analysis: the hero's
+     *          health never rises, so states are solved in order of
+     *          increasing hero health, and the states sharing one hero
+     *          health are swept in parallel until their values settle.
+     */
+    static void generate(const std::string& path, const std::vector<EndgameRules>& rules,
+                         int healthLimit = DEFAULT_HEALTH_LIMIT, unsigned threads = 0);
+};
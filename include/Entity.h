@@ -10,6 +10,9 @@
 #include <string>
 #include <algorithm> // Replaced bits/algorithmfwd.h with standard <algorithm>
 #include <vector>
+#include <cstdint>
+
+class GameContext;
 
 /**
  * @enum EffectType
@@ -17,6 +20,20 @@
  */
 enum class EffectType { NONE, SLOW, BURN, POISON, REGENERATION };
 
+/**
+ * @enum EntityKind
+ * @brief Concrete kind of an entity, used to resolve targets and classes without RTTI
+ * @details Every kind from CHARACTER on is a Character
+ */
+enum class EntityKind : uint8_t {
+    ENTITY,    /**< Plain entity */
+    CHARACTER, /**< Character of a class without a kind of its own */
+    WARRIOR,   /**< Warrior */
+    MAGE,      /**< Mage */
+    ARCHER,    /**< Archer */
+    HEALER     /**< Healer */
+};
+
 /**
  * @struct ActiveEffect
  * @brief Structure describing an active effect
@@ -24,19 +41,24 @@ enum class EffectType { NONE, SLOW, BURN, POISON, REGENERATION };
  */
 struct ActiveEffect {
     /** @brief Effect type */
-    EffectType type;
+    EffectType type = EffectType::NONE;
     
     /** @brief Speed modifier (for slowing effects) */
-    float speedModifier;
+    float speedModifier = 1.0f;
     
     /** @brief Effect duration in turns */
-    int duration;
+    int duration = 0;
     
     /** @brief Damage per turn (for periodic damage effects) */
-    int damagePerTurn;
+    int damagePerTurn = 0;
     
     /** @brief Healing per turn (for periodic healing effects) */
-    int healPerTurn;
+    int healPerTurn = 0;
+
+    /**
+     * @brief Constructor for an empty effect slot
+     */
+    ActiveEffect() = default;
 
     /**
      * @brief Effect constructor
@@ -72,6 +94,32 @@ protected:
     /** @brief List of active effects on the entity */
     std::vector<ActiveEffect> activeEffects;
 
+    /** @brief Session the entity takes part in, nullptr for the thread default */
+    GameContext* context = nullptr;
+
+    /** @brief Concrete kind of the entity, set by the constructors of tagged subclasses */
+    EntityKind kind = EntityKind::ENTITY;
+
+    /** @brief Identifier of the entity in combat events, unique within its session */
+    uint32_t actorId;
+
+    /** @brief Copies entity state in and out of its structure-of-arrays table */
+    friend class CombatantStore;
+
+    /** @brief Captures and restores entity state as plain values */
+    friend struct CombatantSnapshot;
+
+    /** @brief Reads the damage reduction to work out endgame damage figures */
+    friend struct EndgameRules;
+
+    /**
+     * @brief Change an integer field of the entity
+     * @param field The field
+     * @param value Its new value
+     * @details Records the change in the session's command log, if any
+     */
+    void assignField(int& field, int value);
+
 public:
     /** @brief Maximum health for all entities */
     static constexpr int MAX_HEALTH = 200;
@@ -164,7 +212,7 @@ public:
      * @param newMana New mana value
      */
     virtual void setMana(int newMana) {
-        mana = std::max(0, std::min(newMana, MAX_MANA));
+        assignField(mana, std::max(0, std::min(newMana, MAX_MANA)));
     }
     
     /**
@@ -172,7 +220,7 @@ public:
      * @param amount Amount of mana to increase
      */
     virtual void increaseMana(int amount) {
-        mana = std::min(mana + amount, MAX_MANA);
+        assignField(mana, std::min(mana + amount, MAX_MANA));
     }
     
     /**
@@ -180,6 +228,31 @@ public:
      * @param amount Amount of health to restore
      */
     virtual void restoreHealth(int amount);
+
+    /**
+     * @brief Get the concrete kind of the entity
+     * @return The kind tag
+     */
+    EntityKind getKind() const { return kind; }
+
+    /**
+     * @brief Get the identifier of the entity in combat events
+     * @return The actor id; copies share the id of the original until they move to another session
+     */
+    uint32_t getActorId() const { return actorId; }
+
+    /**
+     * @brief Bind the entity to a game session
+     * @param newContext Context of the session, nullptr for the thread default
+     * @return The previously bound context, nullptr if there was none
+     */
+    virtual GameContext* setContext(GameContext* newContext);
+
+    /**
+     * @brief Get the context of the session the entity takes part in
+     * @return The bound context, or the calling thread's default context
+     */
+    GameContext& getContext() const;
 };
 
 #endif
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include "GameMode.h"
 #include "Character.h"
 #include "Deck.h"
+#include "BattleEngine.h"
 #include <vector>
 #include <memory>
 
@@ -25,12 +26,17 @@ private:
     /** @brief Collection of potential enemy characters */
     std::vector<std::shared_ptr<Character>> enemies;
 
+    /** @brief Controller for headless encounters, nullptr for interactive play */
+    std::shared_ptr<ActionSource> autopilot;
+
 public:
     /**
      * @brief Constructor for ExplorationMode
      * @param p Pointer to the player character
+     * @param autopilot Controller choosing the player's actions; when set,
+     *        events and battles run headless without prompts or output
      */
-    ExplorationMode(std::shared_ptr<Character> p);
+    ExplorationMode(std::shared_ptr<Character> p, std::shared_ptr<ActionSource> autopilot = nullptr);
     
     /**
      * @brief Start the exploration mode
@@ -28,10 +28,12 @@ public:
     /**
      * @brief Play this card on a target
      * @param target The entity targeted by this card
+     * @param context Session the card is played in
      * @details Deals fire damage and applies a burning effect that
      *          continues to damage the target over multiple turns
      */
-    void play(Entity & target) override;
+    void play(Entity& target, GameContext& context) override;
+    using Card::play;
     
     /**
      * @brief Get the mana cost of this card
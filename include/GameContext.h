@@ -0,0 +1,373 @@
+/**
+ * @file GameContext.h
+ * @brief Definition of the per-session game context
+ * @details This file defines the GameContext class, which owns everything a
+ *          game session used to share through process-wide state: the random
+ *          number generator, the sink for combat messages, the battle log and
+ *          the clock used for animations. Sessions with separate contexts can
+ *          run on different threads without sharing any mutable state.
+ */
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "BattleLog.h"
+#include "CombatEvents.h"
+#include "RandomService.h"
+
+class CommandLog;
+class EndgameTablebase;
+class Entity;
+class ReplayRecorder;
+
+/**
+ * @class ChanceSource
+ * @brief Decides the outcome of random draws in place of the random stream
+ * @details Attached to a GameContext by analysis code that needs to follow
+ *          every possible outcome of a draw rather than a sampled one
+ */
+class ChanceSource {
+public:
+    /**
+     * @brief Decide a uniformly distributed integer
+     * @param min Smallest possible value
+     * @param max Largest possible value
+     * @return A value in [min, max]
+     */
+    virtual int draw(int min, int max) = 0;
+
+    /**
+     * @brief Virtual destructor
+     */
+    virtual ~ChanceSource() = default;
+};
+
+/**
+ * @class GameContext
+ * @brief State of a single game session
+ * @details A context is handed to game modes, AI and cards explicitly, and
+ *          entities remember the context of the session they take part in.
+ *          A context must only be used by one thread at a time.
+ */
+class GameContext {
+public:
+    /**
+     * @enum ClockMode
+     * @brief How the session clock advances
+     */
+    enum class ClockMode {
+        REAL_TIME, /**< Delays really sleep; the clock follows the wall clock */
+        VIRTUAL    /**< Delays only advance the session clock; nothing sleeps */
+    };
+
+private:
+    /** @brief Source of the session's random streams */
+    RandomService random;
+
+    /** @brief Identifier of the current battle, 0 outside battles */
+    uint64_t battleId = 0;
+
+    /** @brief Identifier the next automatically numbered battle receives */
+    uint64_t nextBattleId = 1;
+
+    /** @brief Actor id the next entity bound to the session receives */
+    uint32_t nextActorId = 1;
+
+    /** @brief Stream of the current battle and turn */
+    RandomStream stream;
+
+    /** @brief Stream combat messages are written to, nullptr to discard them */
+    std::ostream* sink;
+
+    /** @brief Stream without a buffer; every insertion into it is a no-op */
+    std::ostream nullStream;
+
+    /** @brief Most recent battle log entries */
+    BattleLog battleLog;
+
+    /** @brief Most recent combat events */
+    CombatEventStream events;
+
+    /** @brief How the session clock advances */
+    ClockMode clockMode;
+
+    /** @brief Moment the session was created */
+    std::chrono::steady_clock::time_point startTime;
+
+    /** @brief Time accumulated by delays on a virtual clock */
+    std::chrono::milliseconds virtualTime{0};
+
+    /** @brief Log combat mutations are recorded in, nullptr to record nothing */
+    CommandLog* commandLog = nullptr;
+
+    /** @brief Source deciding random draws, nullptr to use the random stream */
+    ChanceSource* chance = nullptr;
+
+    /** @brief Boss endgame table consulted by BossAI, nullptr for none */
+    const EndgameTablebase* endgame = nullptr;
+
+    /** @brief Recorder battles of the session are written to, nullptr for none */
+    ReplayRecorder* recorder = nullptr;
+
+public:
+    /**
+     * @brief Constructor for an interactive GameContext
+     * @details Seeds the session from std::random_device, writes combat
+     *          messages to std::cout and runs on the real clock
+     */
+    GameContext();
+
+    /**
+     * @brief Constructor for GameContext
+     * @param seed Seed all random streams of the session are derived from
+     * @param sink Stream for combat messages, nullptr to discard them
+     * @param clockMode How the session clock advances
+     */
+    GameContext(uint64_t seed, std::ostream* sink, ClockMode clockMode = ClockMode::REAL_TIME);
+
+    GameContext(const GameContext&) = delete;
+    GameContext& operator=(const GameContext&) = delete;
+
+    /**
+     * @brief Get the context of the current thread
+     * @return A context private to the calling thread
+     * @details Used by entities and game modes that were never given a
+     *          context of their own, so legacy call sites keep working
+     *          without sharing anything across threads
+     */
+    static GameContext& threadDefault();
+
+    /**
+     * @brief Get the seed of the session
+     * @return The seed all random streams are derived from
+     */
+    uint64_t getSeed() const { return random.getSeed(); }
+
+    /**
+     * @brief Get the identifier of the current battle
+     * @return The battle id, 0 outside battles
+     */
+    uint64_t getBattleId() const { return battleId; }
+
+    /**
+     * @brief Start drawing from the streams of a new battle
+     * @return The identifier assigned to the battle
+     * @details Battles are numbered 1, 2, ... in the order they start
+     */
+    uint64_t beginBattle();
+
+    /**
+     * @brief Start drawing from the streams of a given battle
+     * @param id Identifier of the battle, must not be 0
+     * @details Used to replay a battle or to give parallel workers disjoint
+     *          battle ids; later automatically numbered battles follow id
+     */
+    void beginBattle(uint64_t id);
+
+    /**
+     * @brief Start drawing from the stream of a turn of the current battle
+     * @param turn Turn within the battle
+     */
+    void beginTurn(uint32_t turn) { stream = random.stream(battleId, turn); }
+
+    /**
+     * @brief Get the stream random draws are currently taken from
+     * @return Reference to the stream of the current battle and turn
+     */
+    RandomStream& getRandomStream() { return stream; }
+
+    /**
+     * @brief Draw a uniformly distributed integer
+     * @param min Smallest possible value
+     * @param max Largest possible value
+     * @return A value in [min, max]
+     */
+    int randomInt(int min, int max) { return chance ? chance->draw(min, max) : stream.uniformInt(min, max); }
+
+    /**
+     * @brief Draw a batch of uniformly distributed integers
+     * @param min Smallest possible value
+     * @param max Largest possible value
+     * @param out Array receiving the values
+     * @param count Number of values to draw
+     */
+    void randomInts(int min, int max, int* out, size_t count) {
+        if (chance) {
+            for (size_t i = 0; i < count; ++i) {
+                out[i] = chance->draw(min, max);
+            }
+        } else {
+            stream.fillUniform(min, max, out, count);
+        }
+    }
+
+    /**
+     * @brief Get the stream combat messages should be written to
+     * @return The sink, or a discarding stream if the session is quiet
+     */
+    std::ostream& out() { return sink ? *sink : nullStream; }
+
+    /**
+     * @brief Check whether combat messages are written anywhere
+     * @return False if messages are discarded
+     */
+    bool isQuiet() const { return sink == nullptr; }
+
+    /**
+     * @brief Get the stream combat messages are written to
+     * @return The sink, or nullptr if messages are discarded
+     */
+    std::ostream* getSink() const { return sink; }
+
+    /**
+     * @brief Redirect combat messages
+     * @param newSink Stream for combat messages, nullptr to discard them
+     */
+    void setSink(std::ostream* newSink) { sink = newSink; }
+
+    /**
+     * @brief Record a combat event
+     * @param event The event; its actor ids are filled in here
+     * @param source The acting character, nullptr if none
+     * @param target The affected character, nullptr if none
+     * @details The event is kept in the session's event stream and only
+     *          turned into text if the session has a sink
+     */
+    void emit(CombatEvent event, const Entity* source, const Entity* target);
+
+    /**
+     * @brief Get the combat events of the session
+     * @return The most recent events, oldest first
+     */
+    const CombatEventStream& getEvents() const { return events; }
+
+    /**
+     * @brief Forget all recorded combat events
+     */
+    void clearEvents() { events.clear(); }
+
+    /**
+     * @brief Number an entity of the session
+     * @return An actor id no other entity numbered by the session holds, never 0
+     * @details Ids are only unique within a session, so sessions on
+     *          different threads number their entities independently
+     */
+    uint32_t takeActorId();
+
+    /**
+     * @brief Get the battle log
+     * @return The most recent battle log entries
+     */
+    BattleLog& getBattleLog() { return battleLog; }
+
+    /**
+     * @brief Get the battle log
+     * @return The most recent battle log entries
+     */
+    const BattleLog& getBattleLog() const { return battleLog; }
+
+    /**
+     * @brief Record combat mutations of the session in a log
+     * @param log The log, nullptr to stop recording
+     * @return The previously attached log
+     */
+    CommandLog* setCommandLog(CommandLog* log) {
+        CommandLog* previous = commandLog;
+        commandLog = log;
+        return previous;
+    }
+
+    /**
+     * @brief Get the log combat mutations are recorded in
+     * @return The attached log, nullptr if nothing is recorded
+     */
+    CommandLog* getCommandLog() const { return commandLog; }
+
+    /**
+     * @brief Let a chance source decide randomInt() and randomInts() draws
+     * @param source The source, nullptr to draw from the random stream again
+     * @return The previously attached source
+     * @details Code that reads getRandomStream() directly is not affected
+     */
+    ChanceSource* setChanceSource(ChanceSource* source) {
+        ChanceSource* previous = chance;
+        chance = source;
+        return previous;
+    }
+
+    /**
+     * @brief Let boss AI of the session play endgames from a tablebase
+     * @param tablebase The tablebase, nullptr to stop consulting one; it must outlive its use
+     */
+    void setEndgameTablebase(const EndgameTablebase* tablebase) { endgame = tablebase; }
+
+    /**
+     * @brief Get the endgame tablebase of the session
+     * @return The tablebase, or nullptr if none is attached
+     */
+    const EndgameTablebase* getEndgameTablebase() const { return endgame; }
+
+    /**
+     * @brief Record the battles of the session
+     * @param newRecorder The recorder, nullptr to stop recording
+     * @return The previously attached recorder
+     */
+    ReplayRecorder* setReplayRecorder(ReplayRecorder* newRecorder) {
+        ReplayRecorder* previous = recorder;
+        recorder = newRecorder;
+        return previous;
+    }
+
+    /**
+     * @brief Get the recorder battles of the session are written to
+     * @return The attached recorder, nullptr if battles are not recorded
+     */
+    ReplayRecorder* getReplayRecorder() const { return recorder; }
+
+    /**
+     * @brief Wait as part of an animation or pacing delay
+     * @param duration Length of the delay
+     * @details Sleeps on a real-time clock; on a virtual clock only the
+     *          session time advances
+     */
+    void sleepFor(std::chrono::milliseconds duration);
+
+    /**
+     * @brief Get the time elapsed in this session
+     * @return Wall time since creation, or accumulated delays on a virtual clock
+     */
+    std::chrono::milliseconds elapsed() const;
+
+    /**
+     * @class Mute
+     * @brief Silences a context for its lifetime
+     * @details Mutes nest: the previous sink is restored on destruction
+     */
+    class Mute {
+    private:
+        /** @brief The silenced context */
+        GameContext& context;
+
+        /** @brief Sink before this guard was created */
+        std::ostream* previous;
+
+    public:
+        /**
+         * @brief Constructor for Mute
+         * @param context The context to silence
+         */
+        explicit Mute(GameContext& context);
+
+        /**
+         * @brief Destructor for Mute
+         * @details Restores the previous sink of the context
+         */
+        ~Mute();
+
+        Mute(const Mute&) = delete;
+        Mute& operator=(const Mute&) = delete;
+    };
+};
@@ -7,6 +7,9 @@
 #pragma once
 
 #include "GameMode.h"
+#include "EndgameTablebase.h"
+#include "GameContext.h"
+#include <string>
 
 // Forward declarations
 class Character;
@@ -18,6 +21,15 @@ class Character;
  */
 std::shared_ptr<Character> createPlayer(bool testMode = false);
 
+/**
+ * @brief Create a character of the given class with its standard starting stats
+ * @param className One of "Warrior", "Mage", "Archer" or "Healer"
+ * @param name The character's name
+ * @return The created character, or nullptr if the class is unknown
+ * @details Uses the same stats as the classes offered by createPlayer
+ */
+std::shared_ptr<Character> createCharacter(const std::string& className, const std::string& name);
+
 /**
  * @class GameManager
  * @brief Main controller for the game
@@ -40,6 +52,12 @@ private:
     
     /** @brief Flag indicating if the game is currently running */
     bool isGameRunning;
+
+    /** @brief Boss endgame tablebase, mapped at startup if its file exists */
+    EndgameTablebase endgame;
+
+    /** @brief Session shared by the player and every mode started from the menu */
+    GameContext context;
 public:
     /**
      * @brief Constructor for GameManager
@@ -88,4 +106,10 @@ public:
      * @return The NPC trader character
      */
     std::shared_ptr<Character> getTrader() const { return trader; }
+
+    /**
+     * @brief Get the session the game runs in
+     * @return The game's context
+     */
+    GameContext& getContext() { return context; }
 };
\ No newline at end of file
@@ -8,8 +8,9 @@
 
 #include <memory>
 
-// Forward declaration
+// Forward declarations
 class Character;
+class GameContext;
 
 /**
  * @class GameMode
@@ -18,6 +19,10 @@ class Character;
  *          such as battle, dungeon crawling, or trading
  */
 class GameMode {
+private:
+    /** @brief Session the mode runs in, nullptr for the thread default */
+    GameContext* context = nullptr;
+
 public:
     /**
      * @brief Check if the current game mode is finished
@@ -37,6 +42,19 @@ public:
      * @details Initialize and begin the game mode
      */
     virtual void start() = 0;
+
+    /**
+     * @brief Run the mode in a game session
+     * @param newContext Context of the session, nullptr for the thread default
+     * @details Nested modes and battles started by this mode share its context
+     */
+    void setContext(GameContext* newContext) { context = newContext; }
+
+    /**
+     * @brief Get the context of the session the mode runs in
+     * @return The bound context, or the calling thread's default context
+     */
+    GameContext& getContext() const;
     
     /**
      * @brief Virtual destructor
@@ -6,6 +6,7 @@
  */
 #pragma once
 #include "Item.h"
+#include "GameContext.h"
 
 /**
  * @class HealthPotion
@@ -18,7 +19,7 @@ public:
      * @brief Constructor for HealthPotion
      * @details Initializes a health potion with standard name and description
      */
-    HealthPotion() : Item("Health Potion", "Restores 30 HP") {}
+    HealthPotion() : Item("Health Potion", "Restores 30 HP") { kind = ItemKind::HEALTH_POTION; }
 
     /**
      * @brief Apply the effects of the health potion to a character
@@ -27,6 +28,6 @@ public:
      */
     void apply(Character& target) override {
         target.restoreHealth(30);
-        std::cout << target.getName() << " restored 30 HP!\n";
+        target.getContext().out() << target.getName() << " restored 30 HP!\n";
     }
 };
\ No newline at end of file
@@ -25,10 +25,12 @@ public:
     /**
      * @brief Play this card on a target
      * @param target The entity targeted by this card
+     * @param context Session the card is played in
      * @details Deals ice damage and applies a slowing effect that
      *          reduces the target's movement speed by 30%
      */
-    void play(Entity & target) override;
+    void play(Entity& target, GameContext& context) override;
+    using Card::play;
     
     /**
      * @brief Get the mana cost of this card
@@ -5,11 +5,14 @@
  *          collections of items for characters
  */
 #pragma once
+#include <cstddef>
 #include <vector>
+#include <memory>
 #include "Item.h"
 
-// Forward declaration
+// Forward declarations
 class Character;
+class GameContext;
 
 /**
  * @class Inventory
@@ -22,12 +25,29 @@ private:
     /** @brief Collection of items in the inventory */
     std::vector<Item*> items;
 
+    /** @brief Items whose lifetime is managed by this inventory */
+    std::vector<std::unique_ptr<Item>> ownedItems;
+
+    /** @brief Session the owner takes part in, nullptr for the thread default */
+    GameContext* context = nullptr;
+
+    /** @brief Undoes and redoes item removals */
+    friend class CommandLog;
+
 public:
     /**
      * @brief Add an item to the inventory
      * @param item Pointer to the item to add
      */
     void addItem(Item* item);
+
+    /**
+     * @brief Add an item to the inventory and take ownership of it
+     * @param item The item to add
+     * @details The item stays alive until the inventory is destroyed,
+     *          even after it has been used or removed
+     */
+    void addItem(std::unique_ptr<Item> item);
     
     /**
      * @brief Use an item on a character
@@ -48,4 +68,24 @@ public:
      * @param item Pointer to the item to remove
      */
     void removeItem(Item* item);
+
+    /**
+     * @brief Replace the list of items without messages
+     * @param first First of the new items
+     * @param count Number of items
+     * @details Used to restore saved states; the items must still be alive
+     */
+    void assignItems(Item* const* first, size_t count) { items.assign(first, first + count); }
+
+    /**
+     * @brief Bind the inventory to a game session
+     * @param newContext Context of the session, nullptr for the thread default
+     */
+    void setContext(GameContext* newContext) { context = newContext; }
+
+    /**
+     * @brief Get the context inventory messages are written to
+     * @return The bound context, or the calling thread's default context
+     */
+    GameContext& getContext() const;
 };
\ No newline at end of file
@@ -5,11 +5,24 @@
  *          including potions, equipment, and other consumables
  */
 #pragma once
+#include <cstdint>
 #include <string>
 
 // Forward declaration
 class Character;
 
+/**
+ * @enum ItemKind
+ * @brief Concrete kind of an item, used to identify it without RTTI
+ */
+enum class ItemKind : uint8_t {
+    ITEM,          /**< Item of a class without a kind of its own */
+    HEALTH_POTION, /**< HealthPotion */
+    MANA_ELIXIR,   /**< ManaElixir */
+    WEAPON,        /**< Weapon */
+    ARMOR          /**< Armor */
+};
+
 /**
  * @class Item
  * @brief Abstract base class for all items in the game
@@ -24,6 +37,9 @@ protected:
     /** @brief Description of what the item does */
     std::string description;
 
+    /** @brief Concrete kind of the item, set by the constructors of tagged subclasses */
+    ItemKind kind = ItemKind::ITEM;
+
 public:
     /**
      * @brief Constructor for Item
@@ -50,6 +66,12 @@ public:
      * @return The description of the item
      */
     const std::string& getDescription() const { return description; }
+
+    /**
+     * @brief Get the concrete kind of the item
+     * @return The kind tag
+     */
+    ItemKind getKind() const { return kind; }
     
     /**
      * @brief Virtual destructor
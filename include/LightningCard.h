@@ -7,6 +7,7 @@
 #pragma once
 #include "Card.h"
 #include "Entity.h"
+#include <cstddef>
 
 /**
  * @class LightningCard
@@ -16,6 +17,12 @@
  */
 class LightningCard : public Card {
 public:
+    /** @brief Smallest damage a lightning strike deals */
+    static constexpr int MIN_DAMAGE = 10;
+
+    /** @brief Largest damage a lightning strike deals */
+    static constexpr int MAX_DAMAGE = 30;
+
     /**
      * @brief Default constructor for LightningCard
      * @details Initializes a lightning card with standard name and description
@@ -25,8 +32,19 @@ public:
     /**
      * @brief Play this card on a target
      * @param target The entity targeted by this card
+     * @param context Session the card is played in
      * @details Deals a random amount of damage (10-30) to the target
      *          and has a chance to apply a stun effect
      */
-    void play(Entity& target) override;
+    void play(Entity& target, GameContext& context) override;
+    using Card::play;
+
+    /**
+     * @brief Roll the damage of several lightning strikes at once
+     * @param context Session the strikes happen in
+     * @param out Array receiving the damage of each strike
+     * @param count Number of strikes
+     * @details Draws the same values as count consecutive plays would
+     */
+    static void rollDamage(GameContext& context, int* out, size_t count);
 };
\ No newline at end of file
@@ -0,0 +1,238 @@
+/**
+ * @file Logger.h
+ * @brief Definition of the asynchronous diagnostic logger
+ * @details This file defines the Logger class, which writes diagnostic
+ *          messages of selectable severity on a background thread, and the
+ *          LOG_* macros code logs through. Debug messages compile to nothing
+ *          in release builds (NDEBUG) unless CARD_RPG_KEEP_DEBUG_LOG is
+ *          defined. Game text meant for the player does not go through the
+ *          logger; it is written to the session's sink.
+ */
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+/**
+ * @enum LogLevel
+ * @brief Severity of a log message
+ */
+enum class LogLevel : uint8_t {
+    DEBUG,   /**< Decisions and internals, only of use when tracing a problem */
+    INFO,    /**< Notable events of a normal run */
+    WARNING, /**< Something was ignored or worked around */
+    ERROR,   /**< Something failed */
+    OFF      /**< Threshold that disables all messages */
+};
+
+/**
+ * @class Logger
+ * @brief Process-wide logger with a background writer thread
+ * @details Any thread may log. A message below the current level costs one
+ *          relaxed atomic load. Enabled messages are copied into a bounded
+ *          lock-free queue, and a writer thread started on first use drains
+ *          it into the output stream. A full queue drops the message rather
+ *          than stalling the caller. The writer sleeps while the queue is
+ *          empty, and only a message finding it asleep takes a lock to wake
+ *          it. Messages longer than MAX_MESSAGE bytes
+ *          are cut short.
+ */
+class Logger {
+public:
+    /** @brief Number of messages the queue holds */
+    static constexpr size_t QUEUE_CAPACITY = 1024;
+
+    /** @brief Longest message kept, in bytes */
+    static constexpr size_t MAX_MESSAGE = 240;
+
+private:
+    /**
+     * @struct Slot
+     * @brief One queue entry
+     * @details The sequence number tells producers and the writer whose
+     *          turn it is to use the slot
+     */
+    struct Slot {
+        /** @brief Position the slot is ready for */
+        std::atomic<uint64_t> sequence{0};
+
+        /** @brief Severity of the message */
+        LogLevel level = LogLevel::INFO;
+
+        /** @brief Length of the message */
+        uint16_t length = 0;
+
+        /** @brief Text of the message */
+        char text[MAX_MESSAGE];
+    };
+
+    /** @brief Messages below this level are discarded */
+    static std::atomic<LogLevel> threshold;
+
+    /** @brief Queue entries */
+    std::unique_ptr<Slot[]> slots;
+
+    /** @brief Position the next message is written to */
+    std::atomic<uint64_t> enqueuePos{0};
+
+    /** @brief Position the writer reads next */
+    uint64_t dequeuePos = 0;
+
+    /** @brief Number of messages written out */
+    std::atomic<uint64_t> written{0};
+
+    /** @brief Number of messages dropped because the queue was full */
+    std::atomic<uint64_t> droppedCount{0};
+
+    /** @brief Stream messages are written to */
+    std::atomic<std::ostream*> output;
+
+    /** @brief Set when the writer should finish */
+    std::atomic<bool> stopping{false};
+
+    /** @brief Set while the writer waits for messages */
+    std::atomic<bool> parked{false};
+
+    /** @brief Number of threads waiting in flush() */
+    std::atomic<uint32_t> flushers{0};
+
+    /** @brief Guards parking the writer and the flushers */
+    std::mutex waitMutex;
+
+    /** @brief Wakes the writer when a message arrives or the logger stops */
+    std::condition_variable wake;
+
+    /** @brief Wakes flushers when a batch is written out */
+    std::condition_variable drained;
+
+    /** @brief Writer thread */
+    std::thread writer;
+
+    /**
+     * @brief Constructor for Logger
+     * @details Writes to std::clog
+     */
+    Logger();
+
+    /**
+     * @brief Write queued messages until the logger stops
+     */
+    void drain();
+
+    /**
+     * @brief Check whether the writer's next message is published
+     * @return True if it is
+     */
+    bool ready() const;
+
+public:
+    /**
+     * @brief Destructor for Logger
+     * @details Writes the messages still queued and stops the writer
+     */
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /**
+     * @brief Get the logger of the process
+     * @return The logger, created on first use
+     */
+    static Logger& instance();
+
+    /**
+     * @brief Check whether messages of a level are written
+     * @param level Severity to check
+     * @return True if level is at or above the threshold
+     */
+    static bool enabled(LogLevel level) { return level >= threshold.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Set the lowest level that is written
+     * @param level The threshold; LogLevel::OFF discards everything
+     */
+    static void setLevel(LogLevel level) { threshold.store(level, std::memory_order_relaxed); }
+
+    /**
+     * @brief Get the lowest level that is written
+     * @return The threshold
+     */
+    static LogLevel getLevel() { return threshold.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Parse a level name
+     * @param name "debug", "info", "warning", "error" or "off"
+     * @return The level
+     * @throws std::invalid_argument if the name is not a level
+     */
+    static LogLevel parseLevel(const std::string& name);
+
+    /**
+     * @brief Queue a message
+     * @param level Its severity
+     * @param message Its text, without a trailing newline
+     * @details Does not check the threshold; the LOG_* macros do that
+     *          before the message is formatted
+     */
+    void write(LogLevel level, const std::string& message);
+
+    /**
+     * @brief Wait until every message queued so far is written out
+     */
+    void flush();
+
+    /**
+     * @brief Redirect the log
+     * @param stream Stream to write to; it must outlive its use
+     * @return The previous stream
+     * @details Messages queued before the call are written to the previous stream
+     */
+    std::ostream* setOutput(std::ostream& stream);
+
+    /**
+     * @brief Get the number of messages lost to a full queue
+     * @return Dropped messages since the process started
+     */
+    uint64_t dropped() const { return droppedCount.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief Log a message at a level
+ * @param level LogLevel of the message
+ * @param message Stream insertions making up the message, formatted only if the level is enabled
+ */
+#define LOG_AT(level, message)                                        \
+    do {                                                              \
+        if (Logger::enabled(level)) {                                 \
+            std::ostringstream logLine_;                              \
+            logLine_ << message;                                      \
+            Logger::instance().write(level, logLine_.str());          \
+        }                                                             \
+    } while (false)
+
+#if defined(NDEBUG) && !defined(CARD_RPG_KEEP_DEBUG_LOG)
+/** @brief Log a debug message; compiled out of release builds */
+#define LOG_DEBUG(message) \
+    do {                   \
+    } while (false)
+#else
+/** @brief Log a debug message; compiled out of release builds */
+#define LOG_DEBUG(message) LOG_AT(LogLevel::DEBUG, message)
+#endif
+
+/** @brief Log an informational message */
+#define LOG_INFO(message) LOG_AT(LogLevel::INFO, message)
+
+/** @brief Log a warning */
+#define LOG_WARNING(message) LOG_AT(LogLevel::WARNING, message)
+
+/** @brief Log an error */
+#define LOG_ERROR(message) LOG_AT(LogLevel::ERROR, message)
@@ -16,9 +16,6 @@
  *          who excel at dealing damage from a distance and controlling the battlefield
  */
 class Mage : public Character {
-private:
-    /** @brief The mage's deck of cards */
-    std::shared_ptr<Deck> deck;
 public:
     /**
      * @brief Constructor for Mage
@@ -6,6 +6,7 @@
  */
 #pragma once
 #include "Item.h"
+#include "GameContext.h"
 
 /**
  * @class ManaElixir
@@ -18,7 +19,7 @@ public:
      * @brief Constructor for ManaElixir
      * @details Initializes a mana elixir with standard name and description
      */
-    ManaElixir() : Item("Mana Elixir", "Restores 20 Mana") {}
+    ManaElixir() : Item("Mana Elixir", "Restores 20 Mana") { kind = ItemKind::MANA_ELIXIR; }
 
     /**
      * @brief Apply the effects of the mana elixir to a character
@@ -27,6 +28,6 @@ public:
      */
     void apply(Character& target) override {
         target.increaseMana(20);
-        std::cout << target.getName() << " restored 20 Mana!\n";
+        target.getContext().out() << target.getName() << " restored 20 Mana!\n";
     }
 };
\ No newline at end of file
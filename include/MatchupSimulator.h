@@ -0,0 +1,159 @@
+/**
+ * @file MatchupSimulator.h
+ * @brief Definition of the Monte Carlo matchup simulator
+ * @details This file defines the MatchupSimulator class, which plays many
+ *          independent headless battles between two character classes
+ *          in parallel and aggregates their outcomes
+ */
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+
+class GameContext;
+struct BattleOdds;
+
+/**
+ * @struct MatchupStats
+ * @brief Aggregated outcome of a series of battles between two classes
+ * @details Stores only sums, so statistics gathered by different workers
+ *          can be merged exactly
+ */
+struct MatchupStats {
+    /** @brief Number of battles played */
+    uint64_t battles = 0;
+
+    /** @brief Battles won by the first class */
+    uint64_t winsA = 0;
+
+    /** @brief Battles won by the second class */
+    uint64_t winsB = 0;
+
+    /** @brief Battles that hit the turn limit */
+    uint64_t draws = 0;
+
+    /** @brief Sum of battle lengths in rounds */
+    uint64_t turnSum = 0;
+
+    /** @brief Sum of squared battle lengths */
+    uint64_t turnSquareSum = 0;
+
+    /**
+     * @brief Record the outcome of one battle
+     * @param winner 0 if the first class won, 1 if the second class won, -1 for a draw
+     * @param turns Number of rounds the battle lasted
+     */
+    void record(int winner, int turns);
+
+    /**
+     * @brief Add the statistics of another series
+     * @param other Statistics to merge into this one
+     */
+    void merge(const MatchupStats& other);
+
+    /**
+     * @brief Get the mean battle length
+     * @return Mean number of rounds, 0 if no battle was played
+     */
+    double meanTurns() const;
+
+    /**
+     * @brief Get the 95% confidence half-width of the mean battle length
+     * @return Half-width of the normal-approximation interval
+     */
+    double meanTurnsMargin() const;
+
+    /**
+     * @brief Get the 95% Wilson score interval of a win rate
+     * @param wins Number of wins of the side of interest
+     * @return Lower and upper bound of the interval
+     */
+    std::pair<double, double> winRateInterval(uint64_t wins) const;
+};
+
+/**
+ * @class MatchupSimulator
+ * @brief Plays class-vs-class battles in parallel
+ * @details Battles are handed out to worker threads in chunks. Each worker
+ *          owns a GameContext, builds private characters for every battle and
+ *          keeps private statistics, so workers share nothing but the chunk counter.
+ */
+class MatchupSimulator {
+private:
+    /** @brief Class of the first combatant */
+    std::string classA;
+
+    /** @brief Class of the second combatant */
+    std::string classB;
+
+    /** @brief Maximum number of rounds before a battle counts as a draw */
+    int maxTurns = 1000;
+
+public:
+    /**
+     * @brief Constructor for MatchupSimulator
+     * @param classA Class of the first combatant, as accepted by createCharacter
+     * @param classB Class of the second combatant, as accepted by createCharacter
+     * @throws std::invalid_argument if either class is unknown
+     */
+    MatchupSimulator(const std::string& classA, const std::string& classB);
+
+    /**
+     * @brief Set the turn limit of each battle
+     * @param turns Maximum number of rounds before a battle counts as a draw
+     */
+    void setMaxTurns(int turns) { maxTurns = turns; }
+
+    /**
+     * @brief Simulate a series of battles
+     * @param battles Number of battles to play
+     * @param threads Number of worker threads, 0 for one per hardware thread
+     * @param seed Seed from which the random values of every battle are derived
+     * @return Aggregated statistics of all battles
+     * @details The combatant taking the first move is chosen at random for
+     *          every battle, so first-move advantage does not bias the result
+     */
+    MatchupStats run(uint64_t battles, unsigned threads, uint64_t seed) const;
+
+    /**
+     * @brief Compute the exact outcome distribution of the matchup
+     * @return Odds with the first class as the player and the second as the enemy
+     * @details Solves the battle once for each move order with BattleSolver
+     *          and weighs both equally, like the coin flip in run(). The
+     *          result is what run() converges to as the number of battles grows.
+     */
+    BattleOdds solve() const;
+
+    /**
+     * @brief Print a summary of simulated battles
+     * @param out Stream to print to
+     * @param stats Statistics returned by run()
+     */
+    void printReport(std::ostream& out, const MatchupStats& stats) const;
+
+    /**
+     * @brief Print an exact outcome distribution
+     * @param out Stream to print to
+     * @param odds Odds returned by solve()
+     */
+    void printReport(std::ostream& out, const BattleOdds& odds) const;
+
+private:
+    /**
+     * @brief Play a single battle
+     * @param index Index of the battle in the series
+     * @param aMovesFirst Whether the first class takes the first move
+     * @param context Session the battle runs in
+     * @param stats Statistics to record the outcome into
+     */
+    void playBattle(uint64_t index, bool aMovesFirst, GameContext& context, MatchupStats& stats) const;
+
+    /**
+     * @brief Compute the exact outcome distribution for one move order
+     * @param aMovesFirst Whether the first class takes the first move
+     * @param context Session the battle is solved in
+     * @return Odds with the first class as the player and the second as the enemy
+     */
+    BattleOdds solveOrder(bool aMovesFirst, GameContext& context) const;
+};
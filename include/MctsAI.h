@@ -0,0 +1,219 @@
+/**
+ * @file MctsAI.h
+ * @brief Definition of the Monte Carlo Tree Search AI
+ * @details This file defines the MctsAI class, an AI controller that picks
+ *          its move by searching over attack, card and defend actions on
+ *          lightweight copies of the battle, together with the MctsMove and
+ *          MctsSearchStats types it reports its search through.
+ */
+#pragma once
+#include "AI.h"
+#include "BattleEngine.h"
+#include "Card.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+class TranspositionTable;
+class WorkerPool;
+
+/**
+ * @struct MctsMove
+ * @brief A move considered by the search
+ */
+struct MctsMove {
+    /** @brief ATTACK, DEFEND, or ABILITY to play a card */
+    BattleAction action = BattleAction::ATTACK;
+
+    /** @brief Card played by an ABILITY move, CardId::NONE otherwise */
+    CardId card = CardId::NONE;
+
+    /**
+     * @brief Compare two moves
+     * @param other Move to compare with
+     * @return True if both moves are the same action with the same card
+     */
+    bool operator==(const MctsMove& other) const { return action == other.action && card == other.card; }
+
+    /**
+     * @brief Compare two moves
+     * @param other Move to compare with
+     * @return True if the moves differ
+     */
+    bool operator!=(const MctsMove& other) const { return !(*this == other); }
+};
+
+/**
+ * @struct MctsSearchStats
+ * @brief Statistics of the most recent search
+ */
+struct MctsSearchStats {
+    /** @brief Iterations completed by all threads together */
+    uint64_t iterations = 0;
+
+    /** @brief Nodes in all search trees together */
+    uint64_t nodes = 0;
+
+    /** @brief Number of threads that searched */
+    unsigned threads = 0;
+
+    /** @brief Playouts replaced by an evaluation from the transposition table */
+    uint64_t tableHits = 0;
+
+    /** @brief Visits of the chosen move, summed over all trees */
+    uint64_t bestVisits = 0;
+
+    /** @brief Expected outcome of the chosen move, 0 for a loss and 1 for a win */
+    double bestValue = 0.0;
+};
+
+/**
+ * @class MctsAI
+ * @brief AI controller that chooses its moves with Monte Carlo Tree Search
+ * @details Each decision snapshots both combatants into a two-row
+ *          CombatantStore and grows a UCT search tree over attack, card and
+ *          defend moves for both sides, following the round structure of
+ *          BattleEngine. Playing a Lightning Card is a chance node whose
+ *          outcomes are the possible damage rolls. Every iteration starts
+ *          from a copy of the snapshot, which reuses the scratch state's
+ *          buffers instead of allocating.
+ *
+ *          The search stops at a per-move deadline and returns the best move
+ *          found so far. With several threads, each grows its own tree from
+ *          the same root (root parallelisation) and the visit counts of the
+ *          root moves are summed when the deadline passes. The calling
+ *          thread grows the first tree; the other threads are started by the
+ *          first search and kept until the AI is destroyed, so a decision
+ *          does not pay for creating them.
+ *
+ *          With a transposition table, every search state carries an
+ *          incremental BattleHash and playout outcomes are cached under it.
+ *          A state that already has MIN_REUSE_SAMPLES playouts in the table
+ *          is scored with their mean instead of another playout, so states
+ *          reached by different move orders, by other threads, in earlier
+ *          decisions or by other AIs sharing the table are not played out
+ *          again. The hash includes the rounds left before the horizon, since
+ *          playouts are scored by health once it is reached: a mean is only
+ *          reused at the same distance from the horizon.
+ */
+class MctsAI : public AI {
+public:
+    /** @brief Default number of rounds a playout looks ahead */
+    static constexpr int DEFAULT_HORIZON = 30;
+
+    /** @brief Largest number of nodes a single search tree grows to */
+    static constexpr size_t MAX_TREE_NODES = 1 << 20;
+
+    /** @brief Playouts a cached state needs before its mean replaces new playouts */
+    static constexpr uint32_t MIN_REUSE_SAMPLES = 8;
+
+private:
+    /** @brief Time allowed for one decision */
+    std::chrono::microseconds budget;
+
+    /** @brief Number of search threads */
+    unsigned threads;
+
+    /** @brief Iteration limit per thread, 0 for none */
+    uint64_t maxIterations = 0;
+
+    /** @brief Number of rounds a playout looks ahead */
+    int horizon = DEFAULT_HORIZON;
+
+    /** @brief Statistics of the most recent search */
+    MctsSearchStats lastStats;
+
+    /** @brief Cache of playout outcomes, nullptr to play out every leaf */
+    std::shared_ptr<TranspositionTable> table;
+
+    /** @brief Search threads, nullptr until the first search with several threads */
+    std::unique_ptr<WorkerPool> pool;
+
+public:
+    /**
+     * @brief Constructor for MctsAI
+     * @param budget Time allowed for one decision
+     * @param threads Number of search threads, 0 for one per hardware thread
+     */
+    explicit MctsAI(std::chrono::microseconds budget, unsigned threads = 1);
+
+    /**
+     * @brief Destructor for MctsAI
+     * @details Stops the search threads
+     */
+    ~MctsAI() override;
+
+    /**
+     * @brief Limit the number of iterations of each search thread
+     * @param iterations Iteration limit per thread, 0 to search until the deadline
+     * @details With a limit and a generous budget the search is reproducible
+     */
+    void setMaxIterations(uint64_t iterations) { maxIterations = iterations; }
+
+    /**
+     * @brief Set how far playouts look ahead
+     * @param rounds Number of rounds after which a playout is scored by health
+     */
+    void setHorizon(int rounds) { horizon = rounds; }
+
+    /**
+     * @brief Cache playout outcomes in a transposition table
+     * @param shared The table, nullptr to play out every leaf
+     * @details The table may be shared with other MctsAI instances and is
+     *          kept across decisions. Searches stay reproducible only while
+     *          nothing else writes to the table.
+     */
+    void setTranspositionTable(std::shared_ptr<TranspositionTable> shared) { table = std::move(shared); }
+
+    /**
+     * @brief Get the transposition table
+     * @return The table, nullptr if there is none
+     */
+    const std::shared_ptr<TranspositionTable>& getTranspositionTable() const { return table; }
+
+    /**
+     * @brief Get the statistics of the most recent search
+     * @return Statistics of the last call to chooseMove()
+     */
+    const MctsSearchStats& getLastStats() const { return lastStats; }
+
+    /**
+     * @brief Search for the best move
+     * @param self The character controlled by this AI
+     * @param target The opposing character
+     * @param context Session the decision is made in; seeds the search
+     * @return The most visited move at the root
+     * @details Runs until the deadline or the iteration limit. Returns an
+     *          attack if the battle is already decided or nothing was searched.
+     */
+    MctsMove chooseMove(const Character& self, const Character& target, GameContext& context);
+
+    /**
+     * @brief Search for the best move and play it
+     * @param self The character controlled by this AI
+     * @param target The target entity
+     * @param context Session the decision is made in
+     * @details Targets that are not characters are simply attacked
+     */
+    void makeDecision(Character& self, Entity& target, GameContext& context) override;
+    using AI::makeDecision;
+
+    /**
+     * @brief Play a move in the real battle
+     * @param move The move to play
+     * @param self The character making the move
+     * @param target The opposing entity
+     * @param context Session the move is played in
+     * @details Cards are removed from the character's deck; healing and
+     *          protective cards are played on the character itself
+     */
+    static void playMove(const MctsMove& move, Character& self, Entity& target, GameContext& context);
+
+    /**
+     * @brief Check whether a card is played on its owner
+     * @param card The card
+     * @return True for healing, protective and mana cards
+     */
+    static bool targetsSelf(CardId card);
+};
@@ -25,8 +25,10 @@ public:
     /**
      * @brief Play this card on a target
      * @param target The entity targeted by this card
+     * @param context Session the card is played in
      * @details Applies a poison effect that deals 5 damage per turn
      *          for a fixed number of turns
      */
-    void play(Entity & target) override;
+    void play(Entity& target, GameContext& context) override;
+    using Card::play;
 };
\ No newline at end of file
@@ -8,54 +8,109 @@
 
 #include "GameMode.h"
 #include "Character.h"
+#include "BattleEngine.h"
 
 /**
  * @class PvPMode
  * @brief Game mode for player versus player combat
- * @details Manages turn-based combat between two player-controlled characters
+ * @details Manages turn-based combat between two player-controlled characters.
+ *          Each turn draws from its own (battle id, turn) stream of the context.
  */
-class PvPMode : public GameMode {
+class PvPMode : public GameMode, public ActionSource {
 private:
     /** @brief Pointer to the first player's character */
     std::shared_ptr<Character> player1;
-    
+
     /** @brief Pointer to the second player's character */
     std::shared_ptr<Character> player2;
 
+    /** @brief Controller choosing both players' actions, nullptr for interactive play */
+    std::shared_ptr<ActionSource> autopilot;
+
+    /** @brief Maximum number of turns, 0 for no limit */
+    int maxTurns = 0;
+
+    /** @brief Identifier of the battle in its session, 0 to number it automatically */
+    uint64_t battleId = 0;
+
+    /** @brief Outcome of the finished battle; PLAYER means the first player won */
+    BattleResult result;
+
+    /** @brief Statistics and turn count the battle continues from */
+    BattleResult progress;
+
     /**
      * @brief Process a player's turn
+     * @param source Supplier of the player's action
      * @param attacker The character taking their turn
      * @param defender The opponent character
      * @details Handles action selection and execution for a player's turn
      */
-    void playerTurn(std::shared_ptr<Character> attacker, std::shared_ptr<Character> defender);
+    void playerTurn(ActionSource& source, std::shared_ptr<Character> attacker, std::shared_ptr<Character> defender);
 
     /**
-     * @brief Let the player select an ability
-     * @param character The character selecting an ability
-     * @return The selected ability
-     * @details Displays available abilities and processes player selection
+     * @brief Let the player select a card to play
+     * @param character The character selecting a card
+     * @return Index of the selected card, out of range if none was selected
+     * @details Displays the cards in the character's deck and processes player selection
      */
-    static std::shared_ptr<Ability> selectAbility(const Character& character);
-    
+    static size_t selectCard(const Character& character);
+
     /**
-     * @brief Use an item from the character's inventory
+     * @brief Let the player select an item from the character's inventory
      * @param character The character using an item
+     * @return Index of the selected item, out of range if none was selected
      * @details Displays available items and processes player selection
      */
-    static void useItemFromInventory(Character& character);
+    static size_t selectItem(const Character& character);
 
 public:
     /**
      * @brief Constructor for PvPMode
      * @param p1 Pointer to the first player's character
      * @param p2 Pointer to the second player's character
+     * @param autopilot Controller choosing both players' actions, or nullptr for interactive play
      */
-    PvPMode(std::shared_ptr<Character> p1, std::shared_ptr<Character> p2);
-    
+    PvPMode(std::shared_ptr<Character> p1, std::shared_ptr<Character> p2,
+            std::shared_ptr<ActionSource> autopilot = nullptr);
+
     /**
      * @brief Start the PvP mode
      * @details Initializes the battle and displays introductory information
      */
     void start() override;
-};
\ No newline at end of file
+
+    /**
+     * @brief Limit the number of turns
+     * @param turns Maximum number of turns of both players together, 0 for no limit
+     */
+    void setMaxTurns(int turns) { maxTurns = turns; }
+
+    /**
+     * @brief Choose which random streams of the session the battle uses
+     * @param id Identifier of the battle, 0 to take the session's next one
+     */
+    void setBattleId(uint64_t id) { battleId = id; }
+
+    /**
+     * @brief Continue a battle from a saved point instead of starting it
+     * @param saved Statistics and turn count of the turns already played
+     * @details The characters must hold the state they had at that point;
+     *          the player to move follows from the turn count
+     */
+    void resumeFrom(const BattleResult& saved) { progress = saved; }
+
+    /**
+     * @brief Get the outcome of the finished battle
+     * @return Result of the last start(); PLAYER means the first player won
+     */
+    const BattleResult& getResult() const { return result; }
+
+    /**
+     * @brief Asks the player whose turn it is for an action
+     * @param self The character whose turn it is
+     * @param opponent The opposing character
+     * @return The chosen action
+     */
+    BattleChoice chooseAction(Character& self, Character& opponent) override;
+};
@@ -0,0 +1,159 @@
+/**
+ * @file RandomService.h
+ * @brief Definition of the counter-based random number service
+ * @details This file defines the Philox4x32 generator and the RandomStream and
+ *          RandomService classes built on top of it. Every value is a pure
+ *          function of (seed, battle id, turn, position), so any battle can be
+ *          replayed exactly and parallel workers never share generator state.
+ */
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+/**
+ * @class Philox4x32
+ * @brief Philox 4x32-10 counter-based block generator
+ * @details Maps a 128-bit counter and a 64-bit key to 128 random bits.
+ *          The generator has no state; equal inputs always give equal output.
+ */
+class Philox4x32 {
+public:
+    /** @brief 128-bit counter, also the type of a generated block */
+    using Counter = std::array<uint32_t, 4>;
+
+    /** @brief 64-bit key */
+    using Key = std::array<uint32_t, 2>;
+
+    /**
+     * @brief Generate one block of random bits
+     * @param counter Counter of the block
+     * @param key Key of the generator
+     * @return Four random 32-bit words
+     */
+    static Counter generate(Counter counter, Key key);
+};
+
+/**
+ * @class RandomStream
+ * @brief Sequence of random values for one (seed, battle id, turn) triple
+ * @details Words are produced block by block from consecutive counters.
+ *          A stream satisfies UniformRandomBitGenerator, but uniformInt()
+ *          should be preferred for game rolls: unlike the standard
+ *          distributions it gives the same results on every standard library.
+ */
+class RandomStream {
+public:
+    /** @brief Type of the generated words */
+    using result_type = uint32_t;
+
+private:
+    /** @brief Key derived from the seed */
+    Philox4x32::Key key;
+
+    /** @brief Counter of the next block: block index, turn and battle id */
+    Philox4x32::Counter counter;
+
+    /** @brief Most recently generated block */
+    Philox4x32::Counter block{};
+
+    /** @brief Number of words of the block already handed out */
+    size_t position = 4;
+
+public:
+    /**
+     * @brief Constructor for RandomStream
+     * @param seed Seed of the session
+     * @param battleId Identifier of the battle
+     * @param turn Turn within the battle
+     */
+    RandomStream(uint64_t seed = 0, uint64_t battleId = 0, uint32_t turn = 0);
+
+    /**
+     * @brief Draw the next 32-bit word
+     * @return A uniformly distributed word
+     */
+    uint32_t next() {
+        if (position == block.size()) {
+            refill();
+        }
+        return block[position++];
+    }
+
+    /**
+     * @brief Draw the next 32-bit word
+     * @return A uniformly distributed word
+     */
+    result_type operator()() { return next(); }
+
+    /**
+     * @brief Smallest value the stream produces
+     * @return 0
+     */
+    static constexpr result_type min() { return 0; }
+
+    /**
+     * @brief Largest value the stream produces
+     * @return 2^32 - 1
+     */
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    /**
+     * @brief Draw a uniformly distributed integer
+     * @param min Smallest possible value
+     * @param max Largest possible value
+     * @return A value in [min, max]
+     */
+    int uniformInt(int min, int max);
+
+    /**
+     * @brief Draw a batch of uniformly distributed integers
+     * @param min Smallest possible value
+     * @param max Largest possible value
+     * @param out Array receiving the values
+     * @param count Number of values to draw
+     * @details Produces the same values as count calls to uniformInt(),
+     *          converting whole blocks of words together
+     */
+    void fillUniform(int min, int max, int* out, size_t count);
+
+private:
+    /**
+     * @brief Generate the block of the current counter and advance it
+     */
+    void refill();
+};
+
+/**
+ * @class RandomService
+ * @brief Source of independent random streams for a seeded session
+ */
+class RandomService {
+private:
+    /** @brief Seed all streams are derived from */
+    uint64_t seed;
+
+public:
+    /**
+     * @brief Constructor for RandomService
+     * @param seed Seed all streams are derived from
+     */
+    explicit RandomService(uint64_t seed = 0) : seed(seed) {}
+
+    /**
+     * @brief Get the seed of the service
+     * @return The seed all streams are derived from
+     */
+    uint64_t getSeed() const { return seed; }
+
+    /**
+     * @brief Get the stream of a turn
+     * @param battleId Identifier of the battle
+     * @param turn Turn within the battle
+     * @return A stream independent of every other (battle id, turn) pair
+     */
+    RandomStream stream(uint64_t battleId, uint32_t turn) const {
+        return RandomStream(seed, battleId, turn);
+    }
+};
@@ -25,10 +25,12 @@ public:
     /**
      * @brief Play this card on a target
      * @param target The entity targeted by this card
+     * @param context Session the card is played in
      * @details Applies a regeneration effect that heals 10 health per turn
      *          for 3 turns (total 30 health)
      */
-    void play(Entity & target) override;
+    void play(Entity& target, GameContext& context) override;
+    using Card::play;
     
     /**
      * @brief Get the mana cost of this card
@@ -25,8 +25,10 @@ public:
     /**
      * @brief Play this card on a target
      * @param target The entity targeted by this card
+     * @param context Session the card is played in
      * @details Increases the target's defense by a fixed amount,
      *          making them more resistant to damage
      */
-    void play(Entity & target) override;
+    void play(Entity& target, GameContext& context) override;
+    using Card::play;
 };
\ No newline at end of file
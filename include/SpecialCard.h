@@ -25,8 +25,10 @@ public:
     /**
      * @brief Play this card on a target
      * @param target The entity targeted by this card
+     * @param context Session the card is played in
      * @details Restores mana to the target and potentially
      *          provides other beneficial effects
      */
-    void play(Entity& target) override;
+    void play(Entity& target, GameContext& context) override;
+    using Card::play;
 };
\ No newline at end of file
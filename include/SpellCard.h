@@ -25,10 +25,12 @@ public:
     /**
      * @brief Play this card on a target
      * @param target The entity targeted by this card
+     * @param context Session the card is played in
      * @details Applies a slowing effect to the target,
      *          reducing their speed for several turns
      */
-    void play(Entity& target) override;
+    void play(Entity& target, GameContext& context) override;
+    using Card::play;
     
     /**
      * @brief Get the mana cost of this card
@@ -0,0 +1,115 @@
+/**
+ * @file TranspositionTable.h
+ * @brief Definition of the transposition table
+ * @details This file defines the TranspositionTable class, a fixed-size,
+ *          lock-free cache of position evaluations keyed by BattleHash that
+ *          search threads and AI controllers can share.
+ */
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @class TranspositionTable
+ * @brief Lock-free cache of battle state evaluations
+ * @details The table has a power-of-two number of slots and each hash maps
+ *          to exactly one of them; a newer state replaces whatever the slot
+ *          held. A slot is two 64-bit atomics: the packed evaluation and the
+ *          hash XOR the evaluation. A reader accepts a slot only if the two
+ *          words XOR back to the hash it looks for, so a slot torn by two
+ *          concurrent writers reads as a miss instead of as a wrong value.
+ *          Readers and writers never block; concurrent updates of one state
+ *          may lose a sample, which only makes the cached mean slightly
+ *          less precise.
+ */
+class TranspositionTable {
+public:
+    /** @brief Number of slots of a default-constructed table */
+    static constexpr size_t DEFAULT_SLOTS = 1 << 16;
+
+    /**
+     * @struct Evaluation
+     * @brief Mean outcome of the samples taken from one state
+     */
+    struct Evaluation {
+        /** @brief Number of samples */
+        uint32_t samples = 0;
+
+        /** @brief Mean outcome, 0 for a loss and 1 for a win of side 0 */
+        float value = 0.0f;
+    };
+
+private:
+    /**
+     * @struct Slot
+     * @brief One entry of the table
+     */
+    struct Slot {
+        /** @brief Hash XOR data, 0 for an empty slot */
+        std::atomic<uint64_t> check{0};
+
+        /** @brief Packed Evaluation */
+        std::atomic<uint64_t> data{0};
+    };
+
+    /** @brief The slots */
+    std::unique_ptr<Slot[]> slots;
+
+    /** @brief Number of slots minus one */
+    size_t mask;
+
+public:
+    /**
+     * @brief Constructor for TranspositionTable
+     * @param slotCount Requested number of slots, rounded up to a power of two
+     */
+    explicit TranspositionTable(size_t slotCount = DEFAULT_SLOTS);
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    /**
+     * @brief Get the number of slots
+     * @return Capacity of the table
+     */
+    size_t capacity() const { return mask + 1; }
+
+    /**
+     * @brief Look up a state
+     * @param hash Hash of the state
+     * @param evaluation Receives the cached evaluation on a hit
+     * @return True if the state is in the table
+     */
+    bool probe(uint64_t hash, Evaluation& evaluation) const;
+
+    /**
+     * @brief Store the evaluation of a state
+     * @param hash Hash of the state
+     * @param evaluation The evaluation; replaces what the slot held
+     */
+    void store(uint64_t hash, const Evaluation& evaluation);
+
+    /**
+     * @brief Add one sample to the evaluation of a state
+     * @param hash Hash of the state
+     * @param outcome Outcome of the sample
+     * @details Starts a new evaluation if the state is not in the table
+     */
+    void record(uint64_t hash, double outcome);
+
+    /**
+     * @brief Empty the table
+     * @details Must not run concurrently with other calls
+     */
+    void clear();
+
+private:
+    /**
+     * @brief Get the slot of a hash
+     * @param hash The hash
+     * @return The slot the hash maps to
+     */
+    Slot& slotOf(uint64_t hash) const { return slots[hash & mask]; }
+};
@@ -8,6 +8,7 @@
 #pragma once
 #include "Character.h"
 #include "Entity.h"
+#include "GameContext.h"
 #include <string>
 #include <iostream>
 #include <thread>
@@ -75,26 +76,29 @@ namespace UI {
      * @brief Display the battle interface
      * @param player The player character
      * @param enemy The enemy entity
+     * @param context Session whose battle log is shown
      * @details Shows health bars, status effects, and other battle information
      */
-    void battleInterface(const Character& player, const Entity& enemy);
+    void battleInterface(const Character& player, const Entity& enemy, const GameContext& context);
 
     /**
      * @brief Display an attack animation
+     * @param context Session whose clock paces the animation
      * @param attackerName Name of the attacking entity
      * @param abilityName Optional name of the ability being used
      * @details Shows a visual animation for attack actions
      */
-    void attackAnimation(const std::string& attackerName, const std::string& abilityName = "");
+    void attackAnimation(GameContext& context, const std::string& attackerName, const std::string& abilityName = "");
 
     /**
      * @brief Display damage numbers
-     * @param target Name of the entity receiving damage/healing
+     * @param context Session whose battle log receives the message
+     * @param target The entity receiving damage/healing
      * @param amount Amount of damage or healing
      * @param isHeal Whether this is healing (true) or damage (false)
      * @details Shows damage or healing amounts with appropriate colors
      */
-    void displayDamage(const std::string& target, int amount, bool isHeal = false);
+    void displayDamage(GameContext& context, const Entity& target, int amount, bool isHeal = false);
 
     /**
      * @brief Create a mana bar with numeric values
@@ -107,32 +111,55 @@ namespace UI {
 
     /**
      * @brief Log an enemy action
+     * @param context Session whose battle log receives the message
      * @param action The action being taken
      * @param details Additional details about the action
      * @details Adds an enemy action to the battle log
      */
-    void enemyActionLog(const std::string& action, const std::string& details = "");
+    void enemyActionLog(GameContext& context, const std::string& action, const std::string& details = "");
 
     /**
      * @brief Display an enemy attack animation
+     * @param context Session whose clock paces the animation
      * @param attacker Name of the attacking enemy
      * @details Shows a visual animation for enemy attack actions
      */
-    void enemyAttackAnimation(const std::string& attacker);
-
-    /** @brief Battle log containing recent actions */
-    extern std::vector<std::string> battleLog;
+    void enemyAttackAnimation(GameContext& context, const std::string& attacker);
     
     /**
      * @brief Add a message to the battle log
+     * @param context Session whose battle log receives the message
      * @param message The message to add
      * @details Adds a new entry to the battle log, maintaining a maximum size
      */
-    void addToLog(const std::string& message);
+    void addToLog(GameContext& context, const std::string& message);
+
+    /**
+     * @brief Add an action to the battle log
+     * @param context Session whose battle log receives the entry
+     * @param kind What the entry reports
+     * @param actor The acting character, nullptr if none
+     * @param other The other character, nullptr if none
+     * @param amount Figure of the entry
+     * @param card Card involved
+     * @details Records the action without formatting it; the text is made
+     *          when the log is displayed
+     */
+    void addToLog(GameContext& context, BattleLog::Kind kind, const Entity* actor = nullptr,
+                  const Entity* other = nullptr, int amount = 0, CardId card = CardId::NONE);
+
+    /**
+     * @brief Format a battle log entry
+     * @param log The battle log
+     * @param i Position of the entry, 0 for the oldest
+     * @return The colored text of the entry
+     */
+    std::string formatLogEntry(const BattleLog& log, size_t i);
     
     /**
      * @brief Display the battle log
+     * @param context Session whose battle log is shown
      * @details Shows the most recent battle log entries
      */
-    void displayLog();
+    void displayLog(const GameContext& context);
 }
\ No newline at end of file
@@ -0,0 +1,85 @@
+/**
+ * @file WorkerPool.h
+ * @brief Definition of the WorkerPool class
+ * @details This file defines a small pool of threads that run one job at a
+ *          time beside the calling thread, for searches and solvers that
+ *          split repeated rounds of work between threads.
+ */
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class WorkerPool
+ * @brief Threads that run one job beside the calling thread
+ * @details The threads are started once and sleep on a condition variable
+ *          between jobs, so handing out a job does not create threads. A
+ *          job is called once on every thread with the number of the
+ *          thread, 0 being the caller's.
+ */
+class WorkerPool {
+private:
+    /** @brief The threads, numbered from 1 */
+    std::vector<std::thread> workers;
+
+    /** @brief Guards all members below */
+    std::mutex mutex;
+
+    /** @brief Wakes the threads for a new job or to stop */
+    std::condition_variable wake;
+
+    /** @brief Wakes the caller when the last thread finished the job */
+    std::condition_variable finished;
+
+    /** @brief Job of the current generation, nullptr between jobs */
+    const std::function<void(unsigned)>* job = nullptr;
+
+    /** @brief Number of jobs handed out so far */
+    uint64_t generation = 0;
+
+    /** @brief Threads that have not finished the current job */
+    size_t pending = 0;
+
+    /** @brief Whether the threads should exit */
+    bool stopping = false;
+
+    /**
+     * @brief Run jobs until the pool stops
+     * @param worker Number of the thread
+     */
+    void serve(unsigned worker);
+
+public:
+    /**
+     * @brief Constructor for WorkerPool
+     * @param helpers Number of threads to start besides the caller
+     */
+    explicit WorkerPool(unsigned helpers);
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @brief Destructor for WorkerPool
+     * @details Stops and joins the threads
+     */
+    ~WorkerPool();
+
+    /**
+     * @brief Get the number of threads a job runs on
+     * @return The pool's threads plus the caller
+     */
+    unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    /**
+     * @brief Run a job on every thread and on the caller
+     * @param task The job, called with the number of the thread
+     * @details Returns when all threads have finished it
+     */
+    void run(const std::function<void(unsigned)>& task);
+};
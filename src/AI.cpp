@@ -0,0 +1,19 @@
+/**
+ * @file AI.cpp
+ * @brief Implementation of the AI class
+ * @details Contains the non-virtual helpers shared by all AI controllers
+ */
+
+#include "AI.h"
+#include "Character.h"
+
+/**
+ * @brief Makes a decision in the session of the controlled character
+ * @param self The character controlled by this AI
+ * @param target The target entity (usually an opponent)
+ * @details Forwards to the context-aware overload with the context
+ *          the controlled character is bound to
+ */
+void AI::makeDecision(Character& self, Entity& target) {
+    makeDecision(self, target, self.getContext());
+}
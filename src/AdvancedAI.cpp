@@ -8,7 +8,7 @@
 #include "AdvancedAI.h"
 #include "Fireball.h"
 #include "IceSpike.h"
-#include "Regeneration.h"
+#include "CardCatalog.h"
 #include "DefenseCard.h"
 #include <iostream>
 
@@ -21,57 +21,60 @@
  *          its target, and its deck of cards for making strategic decisions.
  */
 AdvancedAI::AdvancedAI(std::shared_ptr<Character> self, std::shared_ptr<Character> target, std::shared_ptr<Deck> deck)
-    : self(self), target(target), deck(deck) {}
+    : self(self), target(target), deck(deck) {
+    kind = AIKind::ADVANCED;
+}
 
 /**
  * @brief Makes a strategic decision for the AI-controlled character
  * @param self Reference to the character controlled by this AI
  * @param target Reference to the target entity
+ * @param context Session the decision is made in
  * @details Evaluates the current game state and makes decisions based on multiple factors:
  *          - Uses healing abilities when health is low
  *          - Uses offensive spells when target has high health
  *          - Uses defensive abilities when necessary
  *          - Falls back to basic attacks when other options aren't viable
  */
-void AdvancedAI::makeDecision(Character& self, Entity& target) {
+void AdvancedAI::makeDecision(Character& self, Entity& target, GameContext& context) {
     if (self.getHealth() < 30 && deck->size() > 0) {
-        useBestCard();
+        useBestCard(context);
     } else {
-        attackOrDefend();
+        attackOrDefend(context);
     }
 }
 
 /**
  * @brief Selects and uses the best card from the deck based on the current situation
+ * @param context Session the decision is made in
  * @details This method prioritizes healing cards like Regeneration when available.
  *          If no specific tactical card is found, it draws a random card from the deck
  *          and plays it against the target. The method implements the strategic card
  *          selection logic for the AI.
  */
-void AdvancedAI::useBestCard() {
-    for (const auto& card : deck->getCards()) {
-        if (card->getName() == "Regeneration") {
-            card->play(*self);
-            return;
-        }
+void AdvancedAI::useBestCard(GameContext& context) {
+    if (deck->contains(CardId::REGENERATION)) {
+        CardCatalog::get(CardId::REGENERATION)->play(*self, context);
+        return;
     }
-    if (!deck->getCards().empty()) {
-        auto card = deck->drawCard();
-        card->play(*target);
+    if (!deck->empty()) {
+        auto card = deck->drawCard(context);
+        card->play(*target, context);
     }
 }
 
 /**
  * @brief Decides between attacking or using a defensive strategy
+ * @param context Session the decision is made in
  * @details This method compares the health of the AI-controlled character and its target.
  *          If the AI's health is lower than the target's, it plays a defensive card to 
  *          increase survivability. Otherwise, it performs a direct attack on the target.
  *          This implements the basic combat decision making for the AI.
  */
-void AdvancedAI::attackOrDefend() {
+void AdvancedAI::attackOrDefend(GameContext& context) {
     if (self->getHealth() < target->getHealth()) {
         DefenseCard defenseCard;
-        defenseCard.play(*self);
+        defenseCard.play(*self, context);
     } else {
         self->attack(*target);
     }
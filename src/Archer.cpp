@@ -7,9 +7,8 @@
 
 #include "Archer.h"
 #include "IceSpike.h"
-#include "TrapCard.h"
-#include "Poison.h"
-#include <iostream>
+#include "GameContext.h"
+#include "Logger.h"
 
 /**
  * @brief Constructor for Archer
@@ -23,10 +22,8 @@
  */
 Archer::Archer(const std::string& name, int health, int mana, int attackPower, int defense)
     : Character(name, health, mana, attackPower, defense) {
-    deck = std::make_shared<Deck>();
-    deck->addCard(std::make_shared<IceSpike>());
-    deck->addCard(std::make_shared<TrapCard>());
-    deck->addCard(std::make_shared<Poison>());
+    kind = EntityKind::ARCHER;
+    deck = std::make_shared<Deck>(Deck{CardId::ICE_SPIKE, CardId::TRAP, CardId::POISON});
 }
 
 /**
@@ -38,7 +35,7 @@ Archer::Archer(const std::string& name, int health, int mana, int attackPower, i
 void Archer::attack(Entity& target) {
     int damage = getAttackPower();
     target.takeDamage(damage);
-    std::cout << getName() << " shoots an arrow at " << target.getName() << " for " << damage << " damage!" << std::endl;
+    getContext().emit(CombatEvent::damage(CombatEvent::Cause::ARROW, damage), this, &target);
 }
 
 /**
@@ -50,11 +47,11 @@ void Archer::attack(Entity& target) {
  */
 void Archer::useAbility(Ability & ability, Entity & target) {
     if (auto* iceSpike = dynamic_cast<IceSpike*>(&ability)) {
-        std::cout << getName() << " uses Ice Spike to slow the enemy!" << std::endl;
+        getContext().out() << getName() << " uses Ice Spike to slow the enemy!\n";
         
-        iceSpike->play(target);
+        iceSpike->play(target, getContext());
     } else {
-        std::cout << "Unknown ability used!" << std::endl;
+        getContext().out() << "Unknown ability used!\n";
     }
 }
 
@@ -68,22 +65,22 @@ void Archer::performAIAction() {
     if (auto target = getTarget()) {
         if (target->isAlive()) {
             if (auto deck = getDeck()) {
-                if (!deck->getCards().empty()) {
-                    auto card = deck->drawCard();
+                if (!deck->empty()) {
+                    auto card = deck->drawCard(getContext());
                     if (card) {
-                        std::cout << "[DEBUG] " << getName() << " uses a card!" << std::endl;
-                        card->play(*target);
+                        getContext().emit(CombatEvent::cardPlayed(card->getId()), this, target.get());
+                        card->play(*target, getContext());
                         return;
                     }
                 }
             }
 
-            std::cout << "[DEBUG] " << getName() << " attacks!" << std::endl;
+            LOG_DEBUG(getName() << " attacks!");
             attack(*target);
         } else {
-            std::cout << "[DEBUG] " << getName() << " has no valid target!" << std::endl;
+            LOG_DEBUG(getName() << " has no valid target!");
         }
     } else {
-        std::cout << "[DEBUG] " << getName() << " has no target set!" << std::endl;
+        LOG_DEBUG(getName() << " has no target set!");
     }
 }
\ No newline at end of file
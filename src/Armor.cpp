@@ -5,7 +5,7 @@
  */
 
 #include "Armor.h"
-#include <iostream>
+#include "GameContext.h"
 
 /**
  * @brief Constructor for Armor
@@ -15,7 +15,9 @@
  * @details Initializes an armor item with the specified attributes
  */
 Armor::Armor(const std::string& name, const std::string& description, int defense)
-    : Item(name, description), defense(defense) {}
+    : Item(name, description), defense(defense) {
+    kind = ItemKind::ARMOR;
+}
 
 /**
  * @brief Apply the armor to a character
@@ -25,5 +27,5 @@ Armor::Armor(const std::string& name, const std::string& description, int defens
  */
 void Armor::apply(Character& target) {
     target.setDefense(target.getDefense() + defense);
-    std::cout << target.getName() << " equipped " << name << " and increased defense by " << defense << "!" << std::endl;
+    target.getContext().out() << target.getName() << " equipped " << name << " and increased defense by " << defense << "!\n";
 }
\ No newline at end of file
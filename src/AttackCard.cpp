@@ -5,22 +5,23 @@
  */
 
 #include "AttackCard.h"
-#include <iostream>
+#include "GameContext.h"
 
 /**
  * @brief Constructor for AttackCard
  * @details Initializes an attack card with a predefined name and description
  */
 AttackCard::AttackCard()
-    : Card("Attack Card", "Deals 15 damage to the target.") {}
+    : Card(CardId::ATTACK, "Attack Card", "Deals 15 damage to the target.") {}
 
 /**
  * @brief Implements the effect of playing an AttackCard
  * @param target The entity targeted by the attack
+ * @param context Session the card is played in
  * @details Deals 15 damage to the target and displays a message
  */
-void AttackCard::play(Entity& target) {
+void AttackCard::play(Entity& target, GameContext& context) {
     int damage = 15;
     target.takeDamage(damage);
-    std::cout << "Attack Card deals " << damage << " damage to " << target.getName() << "!" << std::endl;
+    context.emit(CombatEvent::damage(CombatEvent::Cause::CARD, damage, getId()), nullptr, &target);
 }
\ No newline at end of file
@@ -0,0 +1,445 @@
+/**
+ * @file BattleEngine.cpp
+ * @brief Implementation of the BattleEngine class
+ * @details Contains the headless combat loop shared by all battle-based game modes
+ */
+
+#include "BattleEngine.h"
+#include "BattleReplay.h"
+#include "CombatantStore.h"
+#include "CommandLog.h"
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace {
+    /**
+     * @brief Count the effects currently active on both combatants
+     * @param a First combatant
+     * @param b Second combatant
+     * @return Total number of active effects
+     */
+    int countEffects(const Character& a, const Character& b) {
+        return static_cast<int>(a.getActiveEffects().size() + b.getActiveEffects().size());
+    }
+
+    /**
+     * @brief Check whether a character acting on its own only attacks
+     * @param character The character
+     * @return True if its AI, or without one the routine of its class,
+     *         does nothing but call attack() for the rest of the battle
+     * @details Warriors' routines always attack; Archers, Healers and Mages
+     *          draw cards while their deck lasts
+     */
+    bool decidesToAttack(const Character& character) {
+        if (auto ai = character.getAI()) {
+            return ai->onlyAttacks(character);
+        }
+        if (character.getKind() == EntityKind::WARRIOR) {
+            return true;
+        }
+        auto deck = character.getDeck();
+        return !deck || deck->empty();
+    }
+
+    /**
+     * @brief Find the damage of a character's actions if it can only attack
+     * @param character The acting character
+     * @param target Its opponent
+     * @param onItsOwn Whether it decides for itself rather than being told to attack()
+     * @param damage Receives the damage of each attack before the target's defense
+     * @return False if the character may still do something else, its
+     *         attack may be a Fireball, or its class is unknown
+     * @details A Mage's attack is a Fireball while it has 20 mana. None of
+     *          the attacks depend on the speed modifier.
+     */
+    bool basicAttackOnly(const Character& character, const Character& target, bool onItsOwn, int& damage) {
+        if (onItsOwn && !decidesToAttack(character)) {
+            return false;
+        }
+        EntityKind kind = character.getKind();
+        if (kind == EntityKind::WARRIOR) {
+            damage = std::max(character.getAttackPower() - target.getDefense(), 0);
+            return true;
+        }
+        if (kind != EntityKind::MAGE && kind != EntityKind::ARCHER && kind != EntityKind::HEALER) {
+            return false;
+        }
+        if (kind == EntityKind::MAGE && character.getMana() >= 20) {
+            return false;
+        }
+        damage = character.getAttackPower();
+        return true;
+    }
+
+    /**
+     * @class ContextBinding
+     * @brief Binds a character to a context and restores the previous binding on destruction
+     */
+    class ContextBinding {
+    private:
+        /** @brief The bound character */
+        Character& character;
+
+        /** @brief Context the character was bound to before */
+        GameContext* previous;
+
+    public:
+        /**
+         * @brief Constructor for ContextBinding
+         * @param character Character to bind
+         * @param context Context to bind it to
+         */
+        ContextBinding(Character& character, GameContext& context)
+            : character(character), previous(character.setContext(&context)) {}
+
+        /**
+         * @brief Destructor for ContextBinding
+         */
+        ~ContextBinding() { character.setContext(previous); }
+
+        ContextBinding(const ContextBinding&) = delete;
+        ContextBinding& operator=(const ContextBinding&) = delete;
+    };
+
+    /**
+     * @class CommandLogBinding
+     * @brief Attaches a command log to a context and restores the previous one on destruction
+     */
+    class CommandLogBinding {
+    private:
+        /** @brief The context */
+        GameContext& context;
+
+        /** @brief Log the context had before */
+        CommandLog* previous;
+
+    public:
+        /**
+         * @brief Constructor for CommandLogBinding
+         * @param context Context to attach the log to
+         * @param log Log to attach
+         */
+        CommandLogBinding(GameContext& context, CommandLog* log)
+            : context(context), previous(context.setCommandLog(log)) {}
+
+        /**
+         * @brief Destructor for CommandLogBinding
+         */
+        ~CommandLogBinding() { context.setCommandLog(previous); }
+
+        CommandLogBinding(const CommandLogBinding&) = delete;
+        CommandLogBinding& operator=(const CommandLogBinding&) = delete;
+    };
+}
+
+/**
+ * @brief Constructor for BattleEngine
+ * @param player Player character
+ * @param enemy Enemy character
+ * @param context Session the battle runs in
+ */
+BattleEngine::BattleEngine(std::shared_ptr<Character> player, std::shared_ptr<Character> enemy,
+                           GameContext& context)
+    : player(player), enemy(enemy), context(context) {}
+
+/**
+ * @brief Run the battle to completion
+ * @param source Supplier of the player's actions
+ * @param observer Optional observer notified about the battle's progress
+ * @return Outcome and statistics of the battle
+ * @details Each round the player acts, the enemy answers unless the player's
+ *          action kept the initiative, and then effects tick on both sides.
+ *          Damage is credited to the side whose action or lingering effect
+ *          removed the opponent's health. Random draws of each round come from
+ *          the context's stream for this battle and round. With a command
+ *          log every round starts with a turn mark, and an UNDO choice rolls
+ *          the characters and the statistics back to the previous mark.
+ *          A replay recorder is told about the start of every played round.
+ */
+BattleResult BattleEngine::run(ActionSource& source, BattleObserver* observer) {
+    std::optional<GameContext::Mute> mute;
+    if (quiet) {
+        mute.emplace(context);
+    }
+    ContextBinding playerBinding(*player, context);
+    ContextBinding enemyBinding(*enemy, context);
+    std::optional<CommandLogBinding> logBinding;
+    std::vector<BattleResult> roundStarts;
+    if (commandLog) {
+        commandLog->clear();
+        logBinding.emplace(context, commandLog);
+    }
+
+    player->setTarget(enemy);
+    enemy->setTarget(player);
+
+    BattleResult result = progress;
+    if (battleId != 0) {
+        context.beginBattle(battleId);
+        result.battleId = battleId;
+    } else {
+        result.battleId = context.beginBattle();
+    }
+
+    bool unwatched = fastForward && quiet && !observer && !commandLog && source.isAutomatic();
+    while (player->isAlive() && enemy->isAlive() && (maxTurns <= 0 || result.turns < maxTurns)) {
+        if (unwatched && skipAttackRounds(result) > 0) {
+            continue;
+        }
+        if (recorder) {
+            recorder->startRound(*player, *enemy, result);
+        }
+        result.turns++;
+        context.beginTurn(static_cast<uint32_t>(result.turns));
+
+        BattleChoice choice = source.chooseAction(*player, *enemy);
+        if (choice.action == BattleAction::UNDO) {
+            bool undone = commandLog && !roundStarts.empty() && commandLog->undoTurn();
+            if (undone) {
+                result = roundStarts.back();
+                roundStarts.pop_back();
+            } else {
+                result.turns--;
+            }
+            if (observer) {
+                observer->onUndo(*player, *enemy, undone);
+            }
+            continue;
+        }
+        if (commandLog) {
+            roundStarts.push_back(result);
+            roundStarts.back().turns--;
+            commandLog->markTurn();
+        }
+
+        int enemyHealth = enemy->getHealth();
+        int effects = countEffects(*player, *enemy);
+        bool endTurn = playerTurn(choice, observer);
+        result.playerDamageDealt += std::max(0, enemyHealth - enemy->getHealth());
+        result.playerEffectsApplied += std::max(0, countEffects(*player, *enemy) - effects);
+
+        if (endTurn && enemy->isAlive()) {
+            int playerHealth = player->getHealth();
+            effects = countEffects(*player, *enemy);
+            enemyTurn(observer);
+            result.enemyDamageDealt += std::max(0, playerHealth - player->getHealth());
+            result.enemyEffectsApplied += std::max(0, countEffects(*player, *enemy) - effects);
+        }
+
+        int playerHealth = player->getHealth();
+        enemyHealth = enemy->getHealth();
+        if (player->isAlive()) {
+            player->updateEffect();
+        }
+        if (enemy->isAlive()) {
+            enemy->updateEffect();
+        }
+        result.enemyDamageDealt += std::max(0, playerHealth - player->getHealth());
+        result.playerDamageDealt += std::max(0, enemyHealth - enemy->getHealth());
+    }
+
+    if (!enemy->isAlive()) {
+        result.winner = BattleResult::Winner::PLAYER;
+    } else if (!player->isAlive()) {
+        result.winner = BattleResult::Winner::ENEMY;
+    }
+    return result;
+}
+
+/**
+ * @brief Resolve the player's action
+ * @param choice The action to perform
+ * @param observer Optional observer to notify
+ * @return True if the enemy gets to answer this round
+ * @details Playing a card or using an item keeps the initiative with the player,
+ *          every other action hands the turn over to the enemy
+ */
+bool BattleEngine::playerTurn(const BattleChoice& choice, BattleObserver* observer) {
+    bool endTurn = true;
+    bool succeeded = true;
+    const Card* played = nullptr;
+
+    switch (choice.action) {
+        case BattleAction::ATTACK:
+            player->attack(*enemy);
+            break;
+
+        case BattleAction::ABILITY: {
+            auto deck = player->getDeck();
+            std::shared_ptr<Card> card;
+            if (deck && choice.index < deck->size()) {
+                card = deck->at(choice.index);
+            }
+            played = card.get();
+            if (card && player->getMana() >= card->getManaCost()) {
+                card->play(*enemy);
+                player->reduceMana(card->getManaCost());
+                endTurn = false;
+            } else {
+                succeeded = false;
+            }
+            break;
+        }
+
+        case BattleAction::DEFEND:
+            player->setDefense(player->getDefense() + 5);
+            break;
+
+        case BattleAction::ITEM: {
+            endTurn = false;
+            auto inventory = player->getInventory();
+            if (inventory && choice.index < inventory->getItems().size()) {
+                Item* item = inventory->getItems()[choice.index];
+                item->apply(*player);
+                inventory->removeItem(item);
+            } else {
+                succeeded = false;
+            }
+            break;
+        }
+
+        case BattleAction::AUTO:
+            actOnOwn(*player, *enemy);
+            break;
+
+        case BattleAction::UNDO:
+            succeeded = false;
+            break;
+    }
+
+    if (observer) {
+        observer->onPlayerAction(*player, *enemy, choice, played, succeeded);
+    }
+    return endTurn;
+}
+
+/**
+ * @brief Let the enemy act
+ * @param observer Optional observer to notify
+ * @details Enemies with an AI let it decide, others simply attack
+ */
+void BattleEngine::enemyTurn(BattleObserver* observer) {
+    if (observer) {
+        observer->onEnemyTurn(*enemy, *player);
+    }
+
+    if (enemy->getAI()) {
+        actOnOwn(*enemy, *player);
+    } else {
+        enemy->attack(*player);
+    }
+}
+
+/**
+ * @brief Let a character act on its own
+ * @param self The acting character
+ * @param opponent The character it fights
+ * @details A character with an AI hands the decision to it; one without
+ *          follows the AI routine of its class
+ */
+void BattleEngine::actOnOwn(Character& self, Character& opponent) {
+    if (auto ai = self.getAI()) {
+        ai->makeDecision(self, opponent, context);
+    } else {
+        self.performAIAction();
+    }
+}
+
+/**
+ * @brief Resolve the coming attack-only rounds in closed form
+ * @param result Result to add the skipped rounds and their damage to
+ * @return Number of rounds skipped
+ * @details The battle is copied into a CombatantStore. While effects are
+ *          active, which lasts at most as long as the longest of them, rounds
+ *          are resolved one by one on the copy. After that every round deals
+ *          the same damage, so the number of rounds both sides survive
+ *          follows from the health and the per-round damage by division.
+ *          Only rounds that nobody falls in are skipped: the deciding round
+ *          is left to the normal loop, so kills and experience are handled
+ *          as usual. Skipped rounds draw no random numbers, and later rounds
+ *          draw from their own turn streams, so the battle is unchanged.
+ */
+int BattleEngine::skipAttackRounds(BattleResult& result) {
+    int playerHit = 0;
+    int enemyHit = 0;
+    if (!basicAttackOnly(*player, *enemy, true, playerHit) ||
+        !basicAttackOnly(*enemy, *player, enemy->getAI() != nullptr, enemyHit)) {
+        return 0;
+    }
+    int remaining = maxTurns > 0 ? maxTurns - result.turns : std::numeric_limits<int>::max();
+
+    CombatantStore store;
+    CombatantHandle p = store.add(*player);
+    CombatantHandle e = store.add(*enemy);
+    auto hasEffects = [&store](CombatantHandle handle) {
+        auto range = store.getEffectRange(handle);
+        return range.first != range.second;
+    };
+
+    int rounds = 0;
+    int playerDealt = 0;
+    int enemyDealt = 0;
+    while (rounds < remaining && (hasEffects(p) || hasEffects(e))) {
+        CombatantStore round = store;
+        int enemyHealth = round.getHealth(e);
+        round.takeDamage(e, playerHit);
+        if (!round.isAlive(e)) {
+            break;
+        }
+        int playerHealth = round.getHealth(p);
+        round.takeDamage(p, enemyHit);
+        if (!round.isAlive(p)) {
+            break;
+        }
+        int byPlayer = enemyHealth - round.getHealth(e);
+        int byEnemy = playerHealth - round.getHealth(p);
+
+        enemyHealth = round.getHealth(e);
+        playerHealth = round.getHealth(p);
+        round.updateEffects(p);
+        round.updateEffects(e);
+        if (!round.isAlive(p) || !round.isAlive(e)) {
+            break;
+        }
+        byPlayer += std::max(0, enemyHealth - round.getHealth(e));
+        byEnemy += std::max(0, playerHealth - round.getHealth(p));
+
+        playerDealt += byPlayer;
+        enemyDealt += byEnemy;
+        store = std::move(round);
+        rounds++;
+    }
+
+    if (rounds < remaining && !hasEffects(p) && !hasEffects(e)) {
+        int enemyLoss = std::max(playerHit - store.getDamageReduction(e), 0);
+        int playerLoss = std::max(enemyHit - store.getDamageReduction(p), 0);
+        int safe = remaining - rounds;
+        if (enemyLoss > 0) {
+            safe = std::min(safe, (store.getHealth(e) - 1) / enemyLoss);
+        }
+        if (playerLoss > 0) {
+            safe = std::min(safe, (store.getHealth(p) - 1) / playerLoss);
+        }
+        if (enemyLoss == 0 && playerLoss == 0 && maxTurns <= 0) {
+            safe = 0;
+        }
+
+        store.takeRepeatedDamage(e, playerHit, safe);
+        store.takeRepeatedDamage(p, enemyHit, safe);
+        playerDealt += enemyLoss * safe;
+        enemyDealt += playerLoss * safe;
+        rounds += safe;
+    }
+
+    if (rounds > 0) {
+        store.writeBack(p, *player);
+        store.writeBack(e, *enemy);
+        result.turns += rounds;
+        result.fastForwardedTurns += rounds;
+        result.playerDamageDealt += playerDealt;
+        result.enemyDamageDealt += enemyDealt;
+    }
+    return rounds;
+}
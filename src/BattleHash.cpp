@@ -0,0 +1,172 @@
+/**
+ * @file BattleHash.cpp
+ * @brief Implementation of the BattleHash class
+ * @details Contains the key derivation and the definitions of all methods
+ *          declared in BattleHash.h
+ */
+
+#include "BattleHash.h"
+#include "BattleState.h"
+#include "CardCatalog.h"
+#include <array>
+#include <cstring>
+
+namespace {
+    /**
+     * @enum KeyKind
+     * @brief Kind of key, kept apart so that no two features share keys
+     */
+    enum class KeyKind : uint64_t {
+        STAT = 1,
+        EFFECT,
+        CARDS,
+        SIDE_TO_MOVE,
+        CUSTOM
+    };
+
+    /**
+     * @brief Scramble a 64-bit word
+     * @param x The word
+     * @return SplitMix64 finalizer of the word
+     */
+    uint64_t mix(uint64_t x) {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    /**
+     * @brief Derive a key
+     * @param kind Kind of key
+     * @param side Side the feature belongs to
+     * @param feature Feature within the kind
+     * @param payload Value of the feature
+     * @return The key
+     */
+    uint64_t deriveKey(KeyKind kind, uint32_t side, uint32_t feature, uint64_t payload) {
+        uint64_t header = (static_cast<uint64_t>(kind) << 56) | (static_cast<uint64_t>(side & 0xFF) << 48) |
+                          (static_cast<uint64_t>(feature) & 0xFFFFFFFFFFFFULL);
+        return mix(mix(header) ^ payload);
+    }
+}
+
+/**
+ * @brief Get the key of a stat value
+ * @param feature The stat
+ * @param side Side the stat belongs to
+ * @param statValue Value of the stat
+ * @return Key of the stat having that value
+ */
+uint64_t BattleHash::stat(Feature feature, uint32_t side, int statValue) {
+    return deriveKey(KeyKind::STAT, side, static_cast<uint32_t>(feature), static_cast<uint32_t>(statValue));
+}
+
+/**
+ * @brief Get the key of an active effect
+ * @param side Side the effect is active on
+ * @param slot Position of the effect in the side's effect list
+ * @param effect The effect
+ * @return Key of the effect at that position
+ * @details Keying by position keeps two identical effects from cancelling
+ *          each other out
+ */
+uint64_t BattleHash::effect(uint32_t side, size_t slot, const ActiveEffect& effect) {
+    uint32_t speedBits;
+    std::memcpy(&speedBits, &effect.speedModifier, sizeof(speedBits));
+    uint64_t counters = static_cast<uint64_t>(static_cast<uint16_t>(effect.duration)) |
+                        (static_cast<uint64_t>(static_cast<uint16_t>(effect.damagePerTurn)) << 16) |
+                        (static_cast<uint64_t>(static_cast<uint16_t>(effect.healPerTurn)) << 32) |
+                        (static_cast<uint64_t>(effect.type) << 48);
+    return deriveKey(KeyKind::EFFECT, side, static_cast<uint32_t>(slot), mix(counters) ^ speedBits);
+}
+
+/**
+ * @brief Get the key of a deck holding some cards of a kind
+ * @param side Side the deck belongs to
+ * @param card Kind of card
+ * @param count Number of cards of that kind
+ * @return Key of the count, 0 for no cards
+ */
+uint64_t BattleHash::cards(uint32_t side, CardId card, uint32_t count) {
+    return count == 0 ? 0 : deriveKey(KeyKind::CARDS, side, static_cast<uint32_t>(card), count);
+}
+
+/**
+ * @brief Get the key of the side to move
+ * @param side Side to move
+ * @return Key of that side being to move
+ */
+uint64_t BattleHash::sideToMove(uint32_t side) {
+    return deriveKey(KeyKind::SIDE_TO_MOVE, side, 0, 0);
+}
+
+/**
+ * @brief Get the key of a caller-defined feature
+ * @param side Side the feature belongs to
+ * @param tag Value of the feature
+ * @return Key distinct from every built-in feature
+ */
+uint64_t BattleHash::custom(uint32_t side, uint64_t tag) {
+    return deriveKey(KeyKind::CUSTOM, side, 0, tag);
+}
+
+/**
+ * @brief Hash the stats and effects of a combatant
+ * @param store Store holding the combatant
+ * @param handle The combatant
+ * @param side Side the combatant plays
+ * @return XOR of the combatant's stat and effect keys
+ */
+uint64_t BattleHash::combatant(const CombatantStore& store, CombatantHandle handle, uint32_t side) {
+    uint64_t hash = stat(Feature::HEALTH, side, store.getHealth(handle)) ^
+                    stat(Feature::MANA, side, store.getMana(handle)) ^
+                    stat(Feature::DEFENSE, side, store.getDefense(handle)) ^
+                    stat(Feature::DAMAGE_REDUCTION, side, store.getDamageReduction(handle)) ^
+                    stat(Feature::ATTACK_POWER, side, store.getAttackPower(handle));
+    auto range = store.getEffectRange(handle);
+    for (size_t i = 0; i < range.second - range.first; ++i) {
+        hash ^= effect(side, i, store.getEffect(handle, i));
+    }
+    return hash;
+}
+
+/**
+ * @brief Hash the stats, effects and deck of a snapshot
+ * @param snapshot The snapshot
+ * @param side Side the character plays
+ * @return XOR of the snapshot's stat, effect and card keys
+ * @details Matches combatant() of a store row added from the same character
+ *          combined with the cards() keys of its deck
+ */
+uint64_t BattleHash::combatant(const CombatantSnapshot& snapshot, uint32_t side) {
+    uint64_t hash = stat(Feature::HEALTH, side, snapshot.health) ^
+                    stat(Feature::MANA, side, snapshot.mana) ^
+                    stat(Feature::DEFENSE, side, snapshot.defense) ^
+                    stat(Feature::DAMAGE_REDUCTION, side, snapshot.damageReduction) ^
+                    stat(Feature::ATTACK_POWER, side, snapshot.attackPower);
+    for (size_t i = 0; i < snapshot.effectCount; ++i) {
+        hash ^= effect(side, i, snapshot.effects[i]);
+    }
+
+    std::array<uint32_t, CardCatalog::size()> counts{};
+    for (size_t i = 0; i < snapshot.cardCount; ++i) {
+        counts[static_cast<size_t>(snapshot.cards[i])]++;
+    }
+    for (size_t kind = 0; kind < counts.size(); ++kind) {
+        hash ^= cards(side, static_cast<CardId>(kind), counts[kind]);
+    }
+    return hash;
+}
+
+/**
+ * @brief Hash a captured battle
+ * @param state The battle, with the player as side 0
+ * @param toMove Side to move
+ * @return Hash of the battle
+ */
+BattleHash BattleHash::of(const BattleState& state, uint32_t toMove) {
+    BattleHash hash;
+    hash.toggle(combatant(state.player, 0) ^ combatant(state.enemy, 1) ^ sideToMove(toMove));
+    return hash;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file BattleLog.cpp
+ * @brief Implementation of the BattleLog class
+ * @details Contains the definitions of all methods declared in BattleLog.h
+ */
+
+#include "BattleLog.h"
+#include <algorithm>
+
+namespace {
+    /** @brief Text of entries without any */
+    const std::string blank;
+}
+
+/**
+ * @brief Check whether a live entry mentions an actor
+ * @param id Actor id
+ * @return True if some kept entry refers to it
+ */
+bool BattleLog::mentioned(uint32_t id) const {
+    for (size_t i = 0; i < count; ++i) {
+        const Entry& entry = (*this)[i];
+        if (entry.actor == id || entry.other == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Remember the name of a character
+ * @param entity The character
+ * @return Its actor id
+ * @details Reuses the slot of a name no kept entry mentions. Such a slot
+ *          always exists, since the entries mention at most NAME_SLOTS
+ *          characters, including the one being added. The name is copied
+ *          into the slot's fixed buffer, cut to MAX_NAME_LENGTH characters,
+ *          so remembering never allocates.
+ */
+uint32_t BattleLog::remember(const Entity& entity) {
+    uint32_t id = entity.getActorId();
+    size_t free = NAME_SLOTS;
+    for (size_t i = 0; i < NAME_SLOTS; ++i) {
+        if (nameIds[i] == id) {
+            return id;
+        }
+        if (free == NAME_SLOTS && (nameIds[i] == 0 || !mentioned(nameIds[i]))) {
+            free = i;
+        }
+    }
+    const std::string& name = entity.getName();
+    size_t length = std::min(name.size(), MAX_NAME_LENGTH);
+    name.copy(names[free].data(), length);
+    names[free][length] = '\0';
+    nameIds[free] = id;
+    return id;
+}
+
+/**
+ * @brief Take the slot of the next entry
+ * @return The slot, emptied and counted as kept
+ */
+BattleLog::Entry& BattleLog::claim() {
+    Entry& entry = entries[next];
+    entry = Entry();
+    next = (next + 1) % CAPACITY;
+    if (count < CAPACITY) {
+        count++;
+    }
+    return entry;
+}
+
+/**
+ * @brief Add an entry
+ * @param kind What it reports
+ * @param actor The acting character, nullptr if none
+ * @param other The other character, nullptr if none
+ * @param amount Figure of the entry
+ * @param card Card involved
+ */
+void BattleLog::add(Kind kind, const Entity* actor, const Entity* other, int amount, CardId card) {
+    Entry& entry = claim();
+    entry.kind = kind;
+    entry.card = card;
+    entry.amount = amount;
+    if (actor) {
+        entry.actor = remember(*actor);
+    }
+    if (other) {
+        entry.other = remember(*other);
+    }
+}
+
+/**
+ * @brief Add a free-text entry
+ * @param message The text
+ */
+void BattleLog::addText(const std::string& message) {
+    size_t slot = next;
+    claim();
+    texts[slot] = message;
+}
+
+/**
+ * @brief Get the text of a TEXT entry
+ * @param i Position among the kept entries, 0 for the oldest
+ * @return The text, empty for other kinds
+ */
+const std::string& BattleLog::text(size_t i) const {
+    size_t slot = slotOf(i);
+    return entries[slot].kind == Kind::TEXT ? texts[slot] : blank;
+}
+
+/**
+ * @brief Get the name of a character mentioned by a kept entry
+ * @param id Actor id
+ * @return The name, empty if the id is 0 or not mentioned; valid until
+ *         the next entry is added
+ */
+const char* BattleLog::nameOf(uint32_t id) const {
+    for (size_t i = 0; id != 0 && i < NAME_SLOTS; ++i) {
+        if (nameIds[i] == id) {
+            return names[i].data();
+        }
+    }
+    return "";
+}
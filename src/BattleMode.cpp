@@ -5,9 +5,12 @@
  */
 
 #include "BattleMode.h"
+#include "BattleReplay.h"
 #include "UI.h"
 #include "EasyAI.h"
+#include "Logger.h"
 #include <iostream>
+#include <optional>
 
 /**
  * @brief Constructor for BattleMode
@@ -19,106 +22,194 @@
 BattleMode::BattleMode(std::shared_ptr<Character> p, std::shared_ptr<Character> e, bool testMode)
     : player(p), enemy(e), isTestMode(testMode), testRoundCounter(0) {}
 
+/**
+ * @brief Constructor for a headless BattleMode
+ * @param p Shared pointer to the player character
+ * @param e Shared pointer to the enemy character
+ * @param autopilot Controller choosing the player's actions, or nullptr for interactive play
+ * @details Initializes a battle session whose player actions come from the given controller
+ */
+BattleMode::BattleMode(std::shared_ptr<Character> p, std::shared_ptr<Character> e, std::shared_ptr<ActionSource> autopilot)
+    : player(p), enemy(e), isTestMode(false), testRoundCounter(0), autopilot(autopilot) {}
+
 /**
  * @brief Starts the battle mode
- * @details Prints initial message and begins the battle loop
+ * @details Prints initial message, runs the battle on the BattleEngine
+ *          and hands out the rewards. Headless battles skip all output.
+ *          Interactive battles record a command log so rounds can be undone.
+ *          The battle is recorded if the context has a replay recorder.
  */
 void BattleMode::start() {
-    std::cout << "Battle started! " << player->getName() << " vs " << enemy->getName() << std::endl;
-
-    player->setTarget(enemy);
-    enemy->setTarget(player);
+    bool headless = autopilot != nullptr;
+    if (!headless) {
+        std::cout << "Battle started! " << player->getName() << " vs " << enemy->getName() << std::endl;
+    }
 
     if (!enemy->getAI()) {
-        std::cout << "[DEBUG] Setting AI for enemy!" << std::endl;
+        LOG_DEBUG("Setting AI for enemy!");
         enemy->setAI(std::make_shared<EasyAI>(enemy));
     }
 
-    while (!isFinished()) {
-        if (isTestMode) {
-            testRoundCounter++;
-        }
-        
-        bool endTurn = true;
+    BattleEngine engine(player, enemy, getContext());
+    int maxTurns = 0;
+    if (isTestMode) {
+        maxTurns = MAX_TEST_ROUNDS;
+    } else if (headless) {
+        maxTurns = MAX_HEADLESS_ROUNDS;
+    }
+    engine.setMaxTurns(maxTurns);
 
-        try {
-            UI::battleInterface(*player, *enemy);
-        } catch (const std::exception& e) {
-            std::cerr << "Error drawing interface: " << e.what() << std::endl;
-        }
+    ActionSource& chooser = headless ? *autopilot : static_cast<ActionSource&>(*this);
+    ActionSource* source = &chooser;
+    std::optional<RecordingActionSource> recording;
+    ReplayRecorder* recorder = getContext().getReplayRecorder();
+    if (recorder) {
+        recorder->beginBattle(getContext(), ReplayBattle::Mode::BATTLE, *player, *enemy, maxTurns, !headless,
+                              chooser.isAutomatic());
+        recording.emplace(chooser, *recorder);
+        source = &*recording;
+        engine.setReplayRecorder(recorder);
+    }
 
-        BattleAction action = getPlayerChoice();
-        switch (action) {
-            case BattleAction::ATTACK:
-                try {
-                    UI::attackAnimation(player->getName());
-                } catch (const std::exception& e) {
-                    std::cerr << "Error showing animation: " << e.what() << std::endl;
-                }
-                player->attack(*enemy);
-                UI::addToLog(COLOR_GREEN + player->getName() + " attacks " + enemy->getName() + "!" + COLOR_RESET);
-                break;
-
-            case BattleAction::ABILITY: {
-                auto card = selectAbilityCard(*player);
-                if (card && player->getMana() >= card->getManaCost()) {
-                    card->play(*enemy);
-                    player->reduceMana(card->getManaCost());
-                    UI::addToLog(COLOR_CYAN + player->getName() + " uses " + card->getName() + "!" + COLOR_RESET);
-                    endTurn = false;
-                } else {
-                    std::cout << "Can't use this ability!" << std::endl;
-                    UI::addToLog(COLOR_RED + "Not enough mana to use " + card->getName() + "!" + COLOR_RESET);
-                }
-                break;
+    if (headless) {
+        result = engine.run(*source);
+    } else {
+        engine.setQuiet(false);
+        engine.setCommandLog(&commandLog);
+        result = engine.run(*source, this);
+        commandLog.clear();
+    }
+
+    if (recorder) {
+        recorder->endBattle(result);
+    }
+
+    if (isTestMode) {
+        testRoundCounter = result.turns;
+    }
+
+    switch (result.winner) {
+        case BattleResult::Winner::PLAYER:
+            player->gainExp(30);
+            player->incrementKills();
+            if (!headless) {
+                std::cout << "You win!\n";
+                UI::addToLog(getContext(), BattleLog::Kind::VICTORY, player.get(), enemy.get(), 30);
+                UI::addToLog(getContext(), BattleLog::Kind::KILLS, player.get(), nullptr, player->getKills());
+            }
+            break;
+        case BattleResult::Winner::ENEMY:
+            if (!headless) {
+                std::cout << "You lose!\n";
+                UI::addToLog(getContext(), BattleLog::Kind::DEFEAT, player.get(), enemy.get());
             }
+            break;
+        case BattleResult::Winner::DRAW:
+            if (!headless) {
+                std::cout << "Battle ended in a draw!\n";
+                UI::addToLog(getContext(), BattleLog::Kind::DRAW, player.get(), enemy.get());
+            }
+            break;
+    }
+}
 
-            case BattleAction::DEFEND:
-                player->setDefense(player->getDefense() + 5);
-                UI::addToLog(COLOR_BLUE + player->getName() + " increases defense by 5!" + COLOR_RESET);
-                break;
+/**
+ * @brief Chooses the player's action for the current round
+ * @param self The player character
+ * @param opponent The enemy character
+ * @return The action selected by the player
+ * @details Draws the battle interface, asks for an action and, for cards
+ *          and items, for the card or item to use
+ */
+BattleChoice BattleMode::chooseAction(Character& self, Character& opponent) {
+    try {
+        UI::battleInterface(self, opponent, getContext());
+    } catch (const std::exception& e) {
+        LOG_ERROR("Error drawing interface: " << e.what());
+    }
 
-            case BattleAction::ITEM:
-                useItemFromInventory(*player);
-                endTurn = false;
-                break;
+    BattleAction action = getPlayerChoice();
+    switch (action) {
+        case BattleAction::ATTACK:
+            try {
+                UI::attackAnimation(getContext(), self.getName());
+            } catch (const std::exception& e) {
+                LOG_ERROR("Error showing animation: " << e.what());
+            }
+            return BattleChoice(action);
+        case BattleAction::ABILITY:
+            return BattleChoice(action, selectAbilityCard(self));
+        case BattleAction::ITEM:
+            return BattleChoice(action, selectItem(self));
+        default:
+            return BattleChoice(action);
+    }
+}
 
-            default:
-                std::cout << "Invalid action! Skipping turn.\n";
-                UI::addToLog(COLOR_RED + "Invalid action! Skipping turn." + COLOR_RESET);
-                break;
-        }
+/**
+ * @brief Reports the player's action in the battle log
+ * @param player The player character
+ * @param enemy The enemy character
+ * @param choice The action the player chose
+ * @param card The card that was played, or nullptr for non-card actions
+ * @param succeeded False if the action could not be performed
+ */
+void BattleMode::onPlayerAction(const Character& player, const Character& enemy,
+                                const BattleChoice& choice, const Card* card, bool succeeded) {
+    switch (choice.action) {
+        case BattleAction::ATTACK:
+            UI::addToLog(getContext(), BattleLog::Kind::ATTACK, &player, &enemy);
+            break;
 
-        if (endTurn && enemy->isAlive()) {
-            std::cout << "[DEBUG] Enemy's turn!" << std::endl;
-            if (enemy->getAI()) {
-                enemy->performAIAction();
+        case BattleAction::ABILITY:
+            if (succeeded) {
+                UI::addToLog(getContext(), BattleLog::Kind::CARD_USED, &player, &enemy, 0, card->getId());
             } else {
-                enemy->attack(*player);
-                UI::addToLog(COLOR_RED + enemy->getName() + " attacks " + player->getName() + "!" + COLOR_RESET);
+                std::cout << "Can't use this ability!" << std::endl;
+                if (card) {
+                    UI::addToLog(getContext(), BattleLog::Kind::NOT_ENOUGH_MANA, &player, nullptr, 0, card->getId());
+                }
             }
-        }
+            break;
 
-        if (player->isAlive()) {
-            player->updateEffect();
-        }
-        if (enemy->isAlive()) {
-            enemy->updateEffect();
-        }
+        case BattleAction::DEFEND:
+            UI::addToLog(getContext(), BattleLog::Kind::DEFEND, &player, nullptr, 5);
+            break;
+
+        case BattleAction::ITEM:
+            if (succeeded) {
+                std::cout << "Used item: " << selectedItemName << "\n";
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Announces the enemy's turn
+ * @param enemy The enemy character
+ * @param player The player character
+ */
+void BattleMode::onEnemyTurn(const Character& enemy, const Character& player) {
+    LOG_DEBUG("Enemy's turn!");
+    if (!enemy.getAI()) {
+        UI::addToLog(getContext(), BattleLog::Kind::ENEMY_ATTACK, &enemy, &player);
     }
+}
 
-    if (!enemy->isAlive()) {
-        std::cout << "You win!\n";
-        player->gainExp(30);
-        player->incrementKills();
-        UI::addToLog(COLOR_GREEN + "You gained 30 EXP and defeated " + enemy->getName() + "!" + COLOR_RESET);
-        UI::addToLog(COLOR_GREEN + "Total kills: " + std::to_string(player->getKills()) + COLOR_RESET);
-    } else if (!player->isAlive()) {
-        std::cout << "You lose!\n";
-        UI::addToLog(COLOR_RED + "You have been defeated by " + enemy->getName() + "!" + COLOR_RESET);
+/**
+ * @brief Reports an undo request in the battle log
+ * @param player The player character
+ * @param enemy The enemy character
+ * @param undone False if there was no round to take back
+ */
+void BattleMode::onUndo(const Character& player, const Character& enemy, bool undone) {
+    if (undone) {
+        UI::addToLog(getContext(), BattleLog::Kind::UNDO, &player, &enemy);
     } else {
-        std::cout << "Battle ended in a draw!\n";
-        UI::addToLog(COLOR_YELLOW + "The battle ended in a draw!" + COLOR_RESET);
+        UI::addToLog(getContext(), BattleLog::Kind::NOTHING_TO_UNDO, &player, &enemy);
     }
 }
 
@@ -147,6 +238,7 @@ BattleMode::BattleAction BattleMode::getPlayerChoice() const {
         std::cout << "2. Use Ability\n";
         std::cout << "3. Defend\n";
         std::cout << "4. Use Item\n";
+        std::cout << "5. Undo last turn\n";
 
         if (std::cin >> choice) {
             switch (choice) {
@@ -154,56 +246,39 @@ BattleMode::BattleAction BattleMode::getPlayerChoice() const {
                 case 2: return BattleAction::ABILITY;
                 case 3: return BattleAction::DEFEND;
                 case 4: return BattleAction::ITEM;
+                case 5: return BattleAction::UNDO;
                 default:
-                    std::cout << "Invalid choice! Please enter a number between 1 and 4.\n";
+                    std::cout << "Invalid choice! Please enter a number between 1 and 5.\n";
                     break;
             }
         } else {
             std::cin.clear();
             std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-            std::cout << "Invalid input! Please enter a number between 1 and 4.\n";
+            std::cout << "Invalid input! Please enter a number between 1 and 5.\n";
         }
     }
 }
 
-std::shared_ptr<Ability> BattleMode::selectAbility(const Character& character) const {
-    auto deck = character.getDeck();
-    if (!deck || deck->size() == 0) {
-        std::cout << "No abilities available!\n";
-        return nullptr;
-    }
-
-    std::cout << "Choose an ability:\n";
-    const auto& cards = deck->getCards();
-    for (size_t i = 0; i < cards.size(); ++i) {
-        std::cout << i + 1 << ". " << cards[i]->getName() << "\n";
-    }
-
-    int choice;
-    std::cin >> choice;
-
-    if (choice > 0 && choice <= static_cast<int>(cards.size())) {
-        return std::dynamic_pointer_cast<Ability>(cards[choice - 1]);
-    } else {
-        std::cout << "Invalid choice!\n";
-        return nullptr;
-    }
-}
-
-std::shared_ptr<Card> BattleMode::selectAbilityCard(Character& character) {
+/**
+ * @brief Lets the player pick a card from their deck
+ * @param character The character selecting a card
+ * @return Index of the selected card, out of range if none was selected
+ * @details In test mode the first card is always selected
+ */
+size_t BattleMode::selectAbilityCard(Character& character) {
     auto deck = character.getDeck();
-    if (!deck || deck->getCards().empty()) {
+    if (!deck || deck->empty()) {
         std::cout << "No ability cards available!" << std::endl;
-        return nullptr;
+        return 0;
     }
     
     // В тестовом режиме всегда выбираем первую карту для ускорения
-    if (isTestMode && !deck->getCards().empty()) {
-        return deck->getCards()[0];
+    if (isTestMode) {
+        return 0;
     }
 
     std::cout << "Select an ability card to use:" << std::endl;
-    auto cards = deck->getCards();
+    Deck::CardView cards = deck->view();
     for (size_t i = 0; i < cards.size(); ++i) {
         std::cout << i << ". " << cards[i]->getName()
                   << " (Mana: " << cards[i]->getManaCost() << ")" << std::endl;
@@ -212,40 +287,37 @@ std::shared_ptr<Card> BattleMode::selectAbilityCard(Character& character) {
     int index;
     std::cin >> index;
     if (index >= 0 && index < static_cast<int>(cards.size())) {
-        auto selectedCard = cards[index];
-        return selectedCard;
+        return static_cast<size_t>(index);
     }
 
     std::cout << "Invalid card selection. Using basic attack instead." << std::endl;
-    return nullptr;
+    return cards.size();
 }
 
 /**
- * @brief Handles the process of a character using an item from their inventory
+ * @brief Lets the player pick an item from their inventory
  * @param character The character who is using an item
- * @details Displays inventory items, allows selection of an item to use, and applies its effects
+ * @return Index of the selected item, out of range if none was selected
+ * @details Displays inventory items and reads the player's selection.
+ *          In test mode the first item is always selected.
  */
-void BattleMode::useItemFromInventory(Character& character) {
+size_t BattleMode::selectItem(Character& character) {
+    selectedItemName.clear();
     auto inventory = character.getInventory();
     if (!inventory || inventory->getItems().empty()) {
         std::cout << "No items available!\n";
-        return;
+        return 0;
     }
     
+    const auto& items = inventory->getItems();
+
     // В тестовом режиме автоматически используем первый предмет
     if (isTestMode) {
-        const auto& items = inventory->getItems();
-        if (!items.empty()) {
-            Item* selectedItem = items[0];
-            selectedItem->apply(character);
-            inventory->removeItem(selectedItem);
-            std::cout << "Used item: " << selectedItem->getName() << "\n";
-        }
-        return;
+        selectedItemName = items[0]->getName();
+        return 0;
     }
 
     std::cout << "Choose an item:\n";
-    const auto& items = inventory->getItems();
     for (size_t i = 0; i < items.size(); ++i) {
         std::cout << i + 1 << ". " << items[i]->getName() << " - " << items[i]->getDescription() << "\n";
     }
@@ -255,15 +327,14 @@ void BattleMode::useItemFromInventory(Character& character) {
         std::cin.clear();
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         std::cout << "Invalid input! Please enter a number.\n";
-        return;
+        return items.size();
     }
 
     if (choice > 0 && choice <= static_cast<int>(items.size())) {
-        Item* selectedItem = items[choice - 1];
-        selectedItem->apply(character);
-        inventory->removeItem(selectedItem);
-        std::cout << "Used item: " << selectedItem->getName() << "\n";
-    } else {
-        std::cout << "Invalid choice!\n";
+        selectedItemName = items[choice - 1]->getName();
+        return static_cast<size_t>(choice - 1);
     }
-}
\ No newline at end of file
+
+    std::cout << "Invalid choice!\n";
+    return items.size();
+}
@@ -0,0 +1,1404 @@
+/**
+ * @file BattleReplay.cpp
+ * @brief Implementation of the battle replay format
+ * @details Contains the binary encoding of replays and the definitions of
+ *          all methods declared in BattleReplay.h
+ */
+
+#include "BattleReplay.h"
+#include "AdvancedAI.h"
+#include "Archer.h"
+#include "Armor.h"
+#include "BattleHash.h"
+#include "BossAI.h"
+#include "CommandLog.h"
+#include "EasyAI.h"
+#include "Healer.h"
+#include "HealthPotion.h"
+#include "Inventory.h"
+#include "Logger.h"
+#include "Mage.h"
+#include "ManaElixir.h"
+#include "PvPMode.h"
+#include "Warrior.h"
+#include "Weapon.h"
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    /** @brief First bytes of every replay file */
+    constexpr char MAGIC[8] = {'C', 'R', 'P', 'G', 'R', 'P', 'L', 'Y'};
+
+    /** @brief Version of the format written by this build */
+    constexpr uint64_t VERSION = 3;
+
+    /** @brief Oldest version this build reads; it has no keyframes or index */
+    constexpr uint64_t FIRST_VERSION = 1;
+
+    /** @brief Size of the trailer holding the offset of the index */
+    constexpr size_t TRAILER_SIZE = 8;
+
+    /** @brief Bytes of the seed in the header of a recorder's file */
+    constexpr size_t SEED_WIDTH = 10;
+
+    /** @brief Bytes of the battle count in the header of a recorder's file */
+    constexpr size_t COUNT_WIDTH = 5;
+
+    /** @brief Number of low bits of an encoded choice holding the action */
+    constexpr unsigned ACTION_BITS = 3;
+
+    /**
+     * @class Encoder
+     * @brief Appends values to a byte buffer
+     */
+    class Encoder {
+    private:
+        /** @brief Encoded bytes */
+        std::string& bytes;
+
+    public:
+        /**
+         * @brief Constructor for Encoder
+         * @param bytes Buffer to append to
+         */
+        explicit Encoder(std::string& bytes) : bytes(bytes) {}
+
+        /**
+         * @brief Append a byte
+         * @param value The byte
+         */
+        void byte(uint8_t value) { bytes.push_back(static_cast<char>(value)); }
+
+        /**
+         * @brief Append an unsigned value as a LEB128 varint
+         * @param value The value
+         */
+        void varint(uint64_t value) {
+            while (value >= 0x80) {
+                byte(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            byte(static_cast<uint8_t>(value));
+        }
+
+        /**
+         * @brief Append an unsigned value as a varint of a fixed size
+         * @param value The value; it must fit in seven bits per byte
+         * @param width Number of bytes
+         * @details Every byte but the last has its continuation bit set, so
+         *          the value can be overwritten in place as it grows
+         */
+        void paddedVarint(uint64_t value, size_t width) {
+            for (size_t i = 1; i < width; ++i) {
+                byte(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            byte(static_cast<uint8_t>(value & 0x7F));
+        }
+
+        /**
+         * @brief Append a signed value as a zigzag varint
+         * @param value The value
+         */
+        void signedVarint(int64_t value) {
+            varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+        }
+
+        /**
+         * @brief Append a float as its four bytes, least significant first
+         * @param value The value
+         */
+        void real(float value) {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            for (int i = 0; i < 4; ++i) {
+                byte(static_cast<uint8_t>(bits >> (8 * i)));
+            }
+        }
+
+        /**
+         * @brief Append a length-prefixed string
+         * @param value The string
+         */
+        void text(const std::string& value) {
+            varint(value.size());
+            bytes += value;
+        }
+
+        /**
+         * @brief Append a length-prefixed byte block
+         * @param value The bytes
+         */
+        void block(const std::vector<uint8_t>& value) {
+            varint(value.size());
+            bytes.append(value.begin(), value.end());
+        }
+    };
+
+    /**
+     * @class Decoder
+     * @brief Reads values written by Encoder from a stream
+     */
+    class Decoder {
+    private:
+        /** @brief Stream to read from */
+        std::istream& in;
+
+    public:
+        /**
+         * @brief Constructor for Decoder
+         * @param in Stream to read from
+         */
+        explicit Decoder(std::istream& in) : in(in) {}
+
+        /**
+         * @brief Read a byte
+         * @return The byte
+         * @throws std::runtime_error at the end of the data
+         */
+        uint8_t byte() {
+            int value = in.get();
+            if (value == std::char_traits<char>::eof()) {
+                throw std::runtime_error("Truncated replay");
+            }
+            return static_cast<uint8_t>(value);
+        }
+
+        /**
+         * @brief Read a LEB128 varint
+         * @return The value
+         * @throws std::runtime_error if it is truncated or too long
+         */
+        uint64_t varint() {
+            uint64_t value = 0;
+            for (unsigned shift = 0; shift < 64; shift += 7) {
+                uint8_t part = byte();
+                value |= static_cast<uint64_t>(part & 0x7F) << shift;
+                if (!(part & 0x80)) {
+                    return value;
+                }
+            }
+            throw std::runtime_error("Corrupt replay: varint too long");
+        }
+
+        /**
+         * @brief Read a varint no larger than a limit
+         * @param limit Largest valid value
+         * @return The value
+         * @throws std::runtime_error if it exceeds the limit
+         */
+        uint64_t bounded(uint64_t limit) {
+            uint64_t value = varint();
+            if (value > limit) {
+                throw std::runtime_error("Corrupt replay: value out of range");
+            }
+            return value;
+        }
+
+        /**
+         * @brief Read a zigzag varint
+         * @return The value
+         */
+        int64_t signedVarint() {
+            uint64_t value = varint();
+            return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+        }
+
+        /**
+         * @brief Read a zigzag varint that fits an int
+         * @return The value
+         * @throws std::runtime_error if it does not fit
+         */
+        int integer() {
+            int64_t value = signedVarint();
+            if (value < std::numeric_limits<int>::min() || value > std::numeric_limits<int>::max()) {
+                throw std::runtime_error("Corrupt replay: value out of range");
+            }
+            return static_cast<int>(value);
+        }
+
+        /**
+         * @brief Read a float written by Encoder::real
+         * @return The value
+         */
+        float real() {
+            uint32_t bits = 0;
+            for (int i = 0; i < 4; ++i) {
+                bits |= static_cast<uint32_t>(byte()) << (8 * i);
+            }
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        /**
+         * @brief Read an enumerator stored as one byte
+         * @tparam Enum The enumeration
+         * @param last Its last valid enumerator
+         * @return The enumerator
+         * @throws std::runtime_error if the byte is not a valid enumerator
+         */
+        template <typename Enum>
+        Enum enumerator(Enum last) {
+            uint8_t value = byte();
+            if (value > static_cast<uint8_t>(last)) {
+                throw std::runtime_error("Corrupt replay: unknown enumerator");
+            }
+            return static_cast<Enum>(value);
+        }
+
+        /**
+         * @brief Read a length-prefixed byte block
+         * @param out Receives the bytes
+         * @throws std::runtime_error if it is truncated
+         */
+        void block(std::string& out) {
+            uint64_t length = bounded(1u << 24);
+            out.resize(length);
+            if (!in.read(&out[0], static_cast<std::streamsize>(length))) {
+                throw std::runtime_error("Truncated replay");
+            }
+        }
+
+        /**
+         * @brief Read a length-prefixed string
+         * @return The string
+         */
+        std::string text() {
+            std::string value;
+            block(value);
+            return value;
+        }
+    };
+
+    /**
+     * @brief Encode the combat state of a character, without its items
+     * @param out Encoder to append to
+     * @param state The state
+     */
+    void writeState(Encoder& out, const CombatantSnapshot& state) {
+        for (int value : {state.health, state.mana, state.damageReduction, state.defense, state.attackPower,
+                          state.level, state.experience, state.kills}) {
+            out.signedVarint(value);
+        }
+        out.byte(static_cast<uint8_t>(state.hasDeck | (state.hasInventory << 1)));
+
+        out.varint(state.effectCount);
+        for (size_t i = 0; i < state.effectCount; ++i) {
+            const ActiveEffect& effect = state.effects[i];
+            out.byte(static_cast<uint8_t>(effect.type));
+            out.real(effect.speedModifier);
+            out.signedVarint(effect.duration);
+            out.signedVarint(effect.damagePerTurn);
+            out.signedVarint(effect.healPerTurn);
+        }
+
+        out.varint(state.cardCount);
+        for (size_t i = 0; i < state.cardCount; ++i) {
+            out.byte(static_cast<uint8_t>(state.cards[i]));
+        }
+    }
+
+    /**
+     * @brief Encode a character configuration
+     * @param out Encoder to append to
+     * @param combatant The configuration
+     */
+    void writeCombatant(Encoder& out, const ReplayCombatant& combatant) {
+        out.byte(static_cast<uint8_t>(combatant.characterClass));
+        out.byte(static_cast<uint8_t>(combatant.brain));
+        out.text(combatant.name);
+        writeState(out, combatant.state);
+
+        out.varint(combatant.items.size());
+        for (const ReplayItem& item : combatant.items) {
+            out.byte(static_cast<uint8_t>(item.kind));
+            if (item.kind == ReplayItem::Kind::WEAPON || item.kind == ReplayItem::Kind::ARMOR) {
+                out.text(item.name);
+                out.text(item.description);
+                out.signedVarint(item.value);
+            }
+        }
+    }
+
+    /**
+     * @brief Encode a keyframe
+     * @param out Encoder to append to
+     * @param keyframe The keyframe
+     */
+    void writeKeyframe(Encoder& out, const ReplayKeyframe& keyframe) {
+        const BattleResult& progress = keyframe.progress;
+        for (int value : {progress.turns, progress.playerDamageDealt, progress.enemyDamageDealt,
+                          progress.playerEffectsApplied, progress.enemyEffectsApplied, progress.fastForwardedTurns}) {
+            out.signedVarint(value);
+        }
+        out.varint(keyframe.choiceOffset);
+        writeState(out, keyframe.state.player);
+        writeState(out, keyframe.state.enemy);
+        out.block(keyframe.playerItems);
+        out.block(keyframe.enemyItems);
+    }
+
+    /**
+     * @brief Decode the combat state of a character, without its items
+     * @param in Decoder to read from
+     * @param state Receives the state
+     */
+    void readState(Decoder& in, CombatantSnapshot& state) {
+        for (int* value : {&state.health, &state.mana, &state.damageReduction, &state.defense, &state.attackPower,
+                           &state.level, &state.experience, &state.kills}) {
+            *value = in.integer();
+        }
+        uint8_t flags = in.byte();
+        state.hasDeck = flags & 1;
+        state.hasInventory = (flags & 2) != 0;
+
+        state.effectCount = static_cast<uint8_t>(in.bounded(CombatantSnapshot::MAX_EFFECTS));
+        for (size_t i = 0; i < state.effectCount; ++i) {
+            ActiveEffect& effect = state.effects[i];
+            effect.type = in.enumerator(EffectType::REGENERATION);
+            effect.speedModifier = in.real();
+            effect.duration = in.integer();
+            effect.damagePerTurn = in.integer();
+            effect.healPerTurn = in.integer();
+        }
+
+        state.cardCount = static_cast<uint16_t>(in.bounded(CombatantSnapshot::MAX_CARDS));
+        for (size_t i = 0; i < state.cardCount; ++i) {
+            CardId card = static_cast<CardId>(in.byte());
+            if (card >= CardId::COUNT) {
+                throw std::runtime_error("Corrupt replay: unknown card");
+            }
+            state.cards[i] = card;
+        }
+    }
+
+    /**
+     * @brief Decode a character configuration
+     * @param in Decoder to read from
+     * @return The configuration
+     */
+    ReplayCombatant readCombatant(Decoder& in) {
+        ReplayCombatant combatant;
+        combatant.characterClass = in.enumerator(ReplayCombatant::Class::HEALER);
+        combatant.brain = in.enumerator(ReplayCombatant::Brain::SEARCHING_BOSS);
+        combatant.name = in.text();
+        readState(in, combatant.state);
+
+        combatant.items.resize(in.bounded(CombatantSnapshot::MAX_ITEMS));
+        for (ReplayItem& item : combatant.items) {
+            item.kind = in.enumerator(ReplayItem::Kind::ARMOR);
+            if (item.kind == ReplayItem::Kind::WEAPON || item.kind == ReplayItem::Kind::ARMOR) {
+                item.name = in.text();
+                item.description = in.text();
+                item.value = in.integer();
+            }
+        }
+        combatant.state.itemCount = static_cast<uint8_t>(combatant.items.size());
+        return combatant;
+    }
+
+    /**
+     * @brief Decode the inventory of a keyframe
+     * @param in Decoder to read from
+     * @param recorded Number of items the character was recorded with
+     * @param items Receives the positions of the items in the recorded ones
+     * @param state Receives the item count
+     * @throws std::runtime_error if a position is out of range
+     */
+    void readKeyframeItems(Decoder& in, size_t recorded, std::vector<uint8_t>& items, CombatantSnapshot& state) {
+        std::string bytes;
+        in.block(bytes);
+        if (bytes.size() > CombatantSnapshot::MAX_ITEMS) {
+            throw std::runtime_error("Corrupt replay: too many items");
+        }
+        items.assign(bytes.begin(), bytes.end());
+        for (uint8_t item : items) {
+            if (item >= recorded) {
+                throw std::runtime_error("Corrupt replay: unknown item");
+            }
+        }
+        state.itemCount = static_cast<uint8_t>(items.size());
+    }
+
+    /**
+     * @brief Decode a keyframe
+     * @param in Decoder to read from
+     * @param battle Battle the keyframe belongs to, its configurations already read
+     * @return The keyframe
+     */
+    ReplayKeyframe readKeyframe(Decoder& in, const ReplayBattle& battle) {
+        ReplayKeyframe keyframe;
+        BattleResult& progress = keyframe.progress;
+        for (int* value : {&progress.turns, &progress.playerDamageDealt, &progress.enemyDamageDealt,
+                           &progress.playerEffectsApplied, &progress.enemyEffectsApplied,
+                           &progress.fastForwardedTurns}) {
+            *value = in.integer();
+        }
+        progress.battleId = battle.battleId;
+        keyframe.choiceOffset = static_cast<uint32_t>(in.bounded(battle.choices.size()));
+        readState(in, keyframe.state.player);
+        readState(in, keyframe.state.enemy);
+        readKeyframeItems(in, battle.player.items.size(), keyframe.playerItems, keyframe.state.player);
+        readKeyframeItems(in, battle.enemy.items.size(), keyframe.enemyItems, keyframe.state.enemy);
+        return keyframe;
+    }
+
+    /**
+     * @brief Encode a battle
+     * @param out Encoder to append to
+     * @param battle The battle
+     */
+    void writeBattle(Encoder& out, const ReplayBattle& battle) {
+        out.byte(static_cast<uint8_t>(battle.mode));
+        out.varint(battle.battleId);
+        out.signedVarint(battle.maxTurns);
+        out.byte(static_cast<uint8_t>(battle.undo | (battle.automatic << 1)));
+        writeCombatant(out, battle.player);
+        writeCombatant(out, battle.enemy);
+        out.byte(static_cast<uint8_t>(battle.winner));
+        out.signedVarint(battle.turns);
+        out.block(battle.choices);
+        out.varint(battle.keyframes.size());
+        for (const ReplayKeyframe& keyframe : battle.keyframes) {
+            writeKeyframe(out, keyframe);
+        }
+        out.varint(battle.roundHashes.size());
+        for (uint32_t hash : battle.roundHashes) {
+            for (int i = 0; i < 4; ++i) {
+                out.byte(static_cast<uint8_t>(hash >> (8 * i)));
+            }
+        }
+    }
+
+    /**
+     * @brief Encode the index entry of a battle
+     * @param out Encoder to append to
+     * @param offset Offset of the battle in the file
+     * @param battle The battle
+     */
+    void writeIndexEntry(Encoder& out, uint64_t offset, const ReplayBattle& battle) {
+        out.varint(offset);
+        out.signedVarint(battle.turns);
+        out.varint(battle.keyframes.size());
+        for (const ReplayKeyframe& keyframe : battle.keyframes) {
+            out.signedVarint(keyframe.progress.turns);
+        }
+    }
+
+    /**
+     * @brief Encode the trailer that ends a file
+     * @param out Encoder to append to
+     * @param indexOffset Offset of the index in the file
+     */
+    void writeTrailer(Encoder& out, uint64_t indexOffset) {
+        for (size_t i = 0; i < TRAILER_SIZE; ++i) {
+            out.byte(static_cast<uint8_t>(indexOffset >> (8 * i)));
+        }
+    }
+
+    /**
+     * @brief Decode a battle
+     * @param in Decoder to read from
+     * @param version Format version of the data
+     * @return The battle
+     */
+    ReplayBattle readBattle(Decoder& in, uint64_t version) {
+        ReplayBattle battle;
+        battle.mode = in.enumerator(ReplayBattle::Mode::PVP);
+        battle.battleId = in.varint();
+        battle.maxTurns = in.integer();
+        uint8_t flags = in.byte();
+        battle.undo = flags & 1;
+        battle.automatic = (flags & 2) != 0;
+        battle.player = readCombatant(in);
+        battle.enemy = readCombatant(in);
+        battle.winner = in.enumerator(BattleResult::Winner::DRAW);
+        battle.turns = in.integer();
+        std::string choices;
+        in.block(choices);
+        battle.choices.assign(choices.begin(), choices.end());
+        if (version >= 2) {
+            uint64_t count = in.bounded(static_cast<uint64_t>(std::max(battle.turns, 0)));
+            int previous = 0;
+            for (uint64_t i = 0; i < count; ++i) {
+                battle.keyframes.push_back(readKeyframe(in, battle));
+                if (battle.keyframes.back().progress.turns <= previous) {
+                    throw std::runtime_error("Corrupt replay: keyframes out of order");
+                }
+                previous = battle.keyframes.back().progress.turns;
+            }
+        }
+        if (version >= 3) {
+            for (uint64_t count = in.varint(); count > 0; --count) {
+                uint32_t hash = 0;
+                for (int i = 0; i < 4; ++i) {
+                    hash |= static_cast<uint32_t>(in.byte()) << (8 * i);
+                }
+                battle.roundHashes.push_back(hash);
+            }
+        }
+        return battle;
+    }
+
+    /**
+     * @brief Read and check the start of a replay
+     * @param in Stream positioned at the start of the replay
+     * @return Format version of the replay
+     * @throws std::runtime_error if the data is not a replay of a known version
+     */
+    uint64_t readHeader(std::istream& in) {
+        char magic[sizeof(MAGIC)];
+        if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+            throw std::runtime_error("Not a replay");
+        }
+        uint64_t version = Decoder(in).varint();
+        if (version < FIRST_VERSION || version > VERSION) {
+            throw std::runtime_error("Unsupported replay version");
+        }
+        return version;
+    }
+
+    /**
+     * @brief Play a recorded battle from a given point
+     * @param battle The battle
+     * @param context Session to play it in, seeded like the original
+     * @param first The player, or the first player of a PvP battle, in the state of that point
+     * @param second The enemy, or the second player of a PvP battle, in the state of that point
+     * @param progress Statistics of the rounds played up to that point
+     * @param choiceOffset Position of the next recorded choice; advanced past the choices played
+     * @param limit Round count to stop at
+     * @return Statistics when the battle ended or reached the limit
+     * @details A recorder attached to the context records the battle, as
+     *          the game modes do
+     */
+    BattleResult resume(const ReplayBattle& battle, GameContext& context, const std::shared_ptr<Character>& first,
+                        const std::shared_ptr<Character>& second, const BattleResult& progress,
+                        size_t& choiceOffset, int limit) {
+        std::shared_ptr<ReplayActionSource> recorded;
+        std::shared_ptr<ActionSource> source;
+        if (battle.automatic) {
+            source = std::make_shared<AutoActionSource>();
+        } else {
+            recorded = std::make_shared<ReplayActionSource>(battle.choices, choiceOffset);
+            source = recorded;
+        }
+        BattleResult result;
+
+        if (battle.mode == ReplayBattle::Mode::PVP) {
+            PvPMode pvp(first, second, source);
+            pvp.setContext(&context);
+            pvp.setMaxTurns(limit);
+            pvp.setBattleId(battle.battleId);
+            pvp.resumeFrom(progress);
+            pvp.start();
+            result = pvp.getResult();
+        } else {
+            CommandLog log;
+            BattleEngine engine(first, second, context);
+            engine.setMaxTurns(limit);
+            engine.setBattleId(battle.battleId);
+            engine.resumeFrom(progress);
+            if (battle.undo) {
+                engine.setCommandLog(&log);
+            }
+            ReplayRecorder* recorder = context.getReplayRecorder();
+            if (recorder) {
+                recorder->beginBattle(context, ReplayBattle::Mode::BATTLE, *first, *second, battle.maxTurns,
+                                      battle.undo, battle.automatic);
+                engine.setReplayRecorder(recorder);
+            }
+            result = engine.run(*source);
+            if (recorder) {
+                recorder->endBattle(result);
+            }
+            log.clear();
+        }
+        if (recorded) {
+            choiceOffset = recorded->getPosition();
+        }
+        return result;
+    }
+
+    /**
+     * @brief Translate the inventory of a character into positions in its recorded items
+     * @param state Current state of the character
+     * @param recorded State the character was recorded with
+     * @param positions Receives the positions
+     * @return False if the inventory holds an item that was not recorded
+     */
+    bool itemPositions(const CombatantSnapshot& state, const CombatantSnapshot& recorded,
+                       std::vector<uint8_t>& positions) {
+        positions.clear();
+        for (size_t i = 0; i < state.itemCount; ++i) {
+            const auto end = recorded.items.begin() + recorded.itemCount;
+            const auto found = std::find(recorded.items.begin(), end, state.items[i]);
+            if (found == end) {
+                return false;
+            }
+            positions.push_back(static_cast<uint8_t>(found - recorded.items.begin()));
+        }
+        return true;
+    }
+
+    /**
+     * @brief Point a state at the live items of a character
+     * @param positions Positions of the items in the recorded ones
+     * @param items Live items, in recorded order
+     * @param state State to update
+     */
+    void placeItems(const std::vector<uint8_t>& positions, const std::vector<Item*>& items, CombatantSnapshot& state) {
+        state.itemCount = static_cast<uint8_t>(positions.size());
+        for (size_t i = 0; i < positions.size(); ++i) {
+            state.items[i] = items[positions[i]];
+        }
+    }
+}
+
+/**
+ * @brief Record the current configuration of a character
+ * @param character The character
+ * @return Its configuration
+ * @throws std::invalid_argument if its class, its AI or an item cannot be recorded
+ * @throws std::length_error if it does not fit in a snapshot
+ * @details The class, AI and items are identified by their kind tags, so
+ *          subclasses without a tag of their own are refused rather than
+ *          recorded as something else
+ */
+ReplayCombatant ReplayCombatant::capture(const Character& character) {
+    ReplayCombatant combatant;
+    switch (character.getKind()) {
+        case EntityKind::WARRIOR:
+            combatant.characterClass = Class::WARRIOR;
+            break;
+        case EntityKind::MAGE:
+            combatant.characterClass = Class::MAGE;
+            break;
+        case EntityKind::ARCHER:
+            combatant.characterClass = Class::ARCHER;
+            break;
+        case EntityKind::HEALER:
+            combatant.characterClass = Class::HEALER;
+            break;
+        default:
+            throw std::invalid_argument(character.getName() + " is of a class replays cannot record");
+    }
+
+    const AI* ai = character.getAI().get();
+    switch (ai ? ai->getKind() : AIKind::CUSTOM) {
+        case AIKind::EASY:
+            combatant.brain = Brain::EASY;
+            break;
+        case AIKind::ADVANCED:
+            combatant.brain = Brain::ADVANCED;
+            break;
+        case AIKind::BOSS:
+            combatant.brain = static_cast<const BossAI*>(ai)->getSearch() ? Brain::SEARCHING_BOSS : Brain::BOSS;
+            break;
+        default:
+            if (ai) {
+                throw std::invalid_argument(character.getName() + " has an AI replays cannot record");
+            }
+            combatant.brain = Brain::NONE;
+            break;
+    }
+
+    combatant.name = character.getName();
+    combatant.state = CombatantSnapshot::capture(character);
+    for (size_t i = 0; i < combatant.state.itemCount; ++i) {
+        const Item* item = combatant.state.items[i];
+        ReplayItem recorded;
+        switch (item->getKind()) {
+            case ItemKind::HEALTH_POTION:
+                recorded.kind = ReplayItem::Kind::HEALTH_POTION;
+                break;
+            case ItemKind::MANA_ELIXIR:
+                recorded.kind = ReplayItem::Kind::MANA_ELIXIR;
+                break;
+            case ItemKind::WEAPON: {
+                auto weapon = static_cast<const Weapon*>(item);
+                recorded = {ReplayItem::Kind::WEAPON, weapon->getName(), weapon->getDescription(), weapon->getDamage()};
+                break;
+            }
+            case ItemKind::ARMOR: {
+                auto armor = static_cast<const Armor*>(item);
+                recorded = {ReplayItem::Kind::ARMOR, armor->getName(), armor->getDescription(), armor->getDefense()};
+                break;
+            }
+            default:
+                throw std::invalid_argument(item->getName() + " is an item replays cannot record");
+        }
+        combatant.items.push_back(recorded);
+    }
+    return combatant;
+}
+
+/**
+ * @brief Build a character with the recorded configuration
+ * @param context Session to bind the character to
+ * @return The character, without AI or target
+ * @details The character owns fresh copies of the recorded items. Messages
+ *          of class constructors, which run before the character is bound,
+ *          are muted.
+ */
+std::shared_ptr<Character> ReplayCombatant::create(GameContext& context) const {
+    std::shared_ptr<Character> character;
+    {
+        GameContext::Mute mute(GameContext::threadDefault());
+        switch (characterClass) {
+            case Class::WARRIOR:
+                character = std::make_shared<Warrior>(name, state.health, state.mana, state.attackPower, state.defense);
+                break;
+            case Class::MAGE:
+                character = std::make_shared<Mage>(name, state.health, state.mana, state.attackPower, state.defense);
+                break;
+            case Class::ARCHER:
+                character = std::make_shared<Archer>(name, state.health, state.mana, state.attackPower, state.defense);
+                break;
+            case Class::HEALER:
+                character = std::make_shared<Healer>(name, state.health, state.mana, state.attackPower, state.defense);
+                break;
+        }
+    }
+    character->setContext(&context);
+
+    CombatantSnapshot restored = state;
+    auto inventory = std::make_shared<Inventory>();
+    inventory->setContext(&context);
+    for (size_t i = 0; i < items.size(); ++i) {
+        std::unique_ptr<Item> item;
+        switch (items[i].kind) {
+            case ReplayItem::Kind::HEALTH_POTION:
+                item = std::make_unique<HealthPotion>();
+                break;
+            case ReplayItem::Kind::MANA_ELIXIR:
+                item = std::make_unique<ManaElixir>();
+                break;
+            case ReplayItem::Kind::WEAPON:
+                item = std::make_unique<Weapon>(items[i].name, items[i].description, items[i].value);
+                break;
+            case ReplayItem::Kind::ARMOR:
+                item = std::make_unique<Armor>(items[i].name, items[i].description, items[i].value);
+                break;
+        }
+        restored.items[i] = item.get();
+        inventory->addItem(std::move(item));
+    }
+    character->setInventory(inventory);
+    restored.restore(*character);
+    return character;
+}
+
+/**
+ * @brief Give a character built by create() its recorded AI
+ * @param self The character
+ * @param opponent The character it fights
+ * @details AdvancedAI and BossAI play the character's own deck, as the
+ *          dungeon sets them up
+ */
+void ReplayCombatant::attachBrain(const std::shared_ptr<Character>& self,
+                                  const std::shared_ptr<Character>& opponent) const {
+    switch (brain) {
+        case Brain::NONE:
+            self->setAI(nullptr);
+            break;
+        case Brain::EASY:
+            self->setAI(std::make_shared<EasyAI>(self));
+            break;
+        case Brain::ADVANCED:
+            self->setAI(std::make_shared<AdvancedAI>(self, opponent, self->getDeck()));
+            break;
+        case Brain::BOSS:
+            self->setAI(std::make_shared<BossAI>(self, opponent, self->getDeck()));
+            break;
+        case Brain::SEARCHING_BOSS: {
+            auto ai = std::make_shared<BossAI>(self, opponent, self->getDeck());
+            ai->enableSearch();
+            self->setAI(ai);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Append a choice to the recorded ones
+ * @param choice The choice
+ */
+void ReplayBattle::addChoice(const BattleChoice& choice) {
+    uint64_t value = (static_cast<uint64_t>(choice.index) << ACTION_BITS) | static_cast<uint64_t>(choice.action);
+    while (value >= 0x80) {
+        choices.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    choices.push_back(static_cast<uint8_t>(value));
+}
+
+/**
+ * @brief Play the battle again
+ * @param seed Seed of the session it was recorded in
+ * @param recorder Recorder to record the replayed battle into, nullptr for none
+ * @return Outcome of the replayed battle
+ */
+BattleResult ReplayBattle::replay(uint64_t seed, ReplayRecorder* recorder) const {
+    GameContext context(seed, nullptr, GameContext::ClockMode::VIRTUAL);
+    context.setReplayRecorder(recorder);
+    auto first = player.create(context);
+    auto second = enemy.create(context);
+    player.attachBrain(first, second);
+    enemy.attachBrain(second, first);
+
+    size_t choiceOffset = 0;
+    int limit = maxTurns > 0 ? maxTurns : turns + 1;
+    BattleResult result = resume(*this, context, first, second, BattleResult(), choiceOffset, limit);
+
+    first->setAI(nullptr);
+    second->setAI(nullptr);
+    return result;
+}
+
+/**
+ * @brief Play the battle again and compare its round hashes with the recorded ones
+ * @param seed Seed of the session it was recorded in
+ * @return The replayed outcome and the first round that differs
+ * @details The replay is recorded by a checking recorder, which compares
+ *          every round hash as it is produced
+ */
+ReplayCheck ReplayBattle::verify(uint64_t seed) const {
+    ReplayCheck check;
+    if (roundHashes.empty()) {
+        check.result = replay(seed);
+        return check;
+    }
+    ReplayRecorder checker;
+    checker.expect(roundHashes);
+    check.result = replay(seed, &checker);
+    check.divergence = checker.getDivergence();
+    check.rounds = check.divergence ? check.divergence->round + 1 : roundHashes.size();
+    return check;
+}
+
+/**
+ * @brief Find the last keyframe at or before a round
+ * @param turn Number of rounds played
+ * @return The keyframe, nullptr if the first one comes later
+ */
+const ReplayKeyframe* ReplayBattle::keyframeAt(int turn) const {
+    auto after = std::upper_bound(keyframes.begin(), keyframes.end(), turn,
+                                  [](int value, const ReplayKeyframe& keyframe) {
+                                      return value < keyframe.progress.turns;
+                                  });
+    return after == keyframes.begin() ? nullptr : &*(after - 1);
+}
+
+/**
+ * @brief Write the replay in its binary format
+ * @param out Stream to write to
+ * @details The file starts with MAGIC, the format version, the seed and
+ *          the number of battles. Each battle holds its mode, id, round
+ *          limit, flags, both configurations, the recorded outcome, the
+ *          choices, the keyframes and the round hashes, four bytes each.
+ *          The index follows the battles, and the file ends with the offset
+ *          of the index as eight bytes, least significant first. Other
+ *          integers are varints, signed ones zigzag-encoded.
+ */
+void BattleReplay::write(std::ostream& out) const {
+    std::string bytes(MAGIC, sizeof(MAGIC));
+    Encoder encoder(bytes);
+    encoder.varint(VERSION);
+    encoder.varint(seed);
+    encoder.varint(battles.size());
+    std::vector<uint64_t> offsets;
+    for (const ReplayBattle& battle : battles) {
+        offsets.push_back(bytes.size());
+        writeBattle(encoder, battle);
+    }
+
+    uint64_t indexOffset = bytes.size();
+    encoder.varint(battles.size());
+    for (size_t i = 0; i < battles.size(); ++i) {
+        writeIndexEntry(encoder, offsets[i], battles[i]);
+    }
+    writeTrailer(encoder, indexOffset);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+/**
+ * @brief Read a replay in its binary format
+ * @param in Stream to read from
+ * @return The replay
+ * @throws std::runtime_error if the data is not a valid replay
+ * @details Also reads files of earlier versions: the first has no
+ *          keyframes or index, the second no round hashes. The index is
+ *          skipped, but a file cut short in it is still rejected.
+ */
+BattleReplay BattleReplay::read(std::istream& in) {
+    uint64_t version = readHeader(in);
+    Decoder decoder(in);
+    BattleReplay replay;
+    replay.seed = decoder.varint();
+    uint64_t count = decoder.varint();
+    for (uint64_t i = 0; i < count; ++i) {
+        replay.battles.push_back(::readBattle(decoder, version));
+    }
+    if (version >= 2) {
+        if (decoder.varint() != count) {
+            throw std::runtime_error("Corrupt replay: index does not match");
+        }
+        for (const ReplayBattle& battle : replay.battles) {
+            decoder.varint();
+            decoder.integer();
+            for (uint64_t k = decoder.bounded(battle.keyframes.size()); k > 0; --k) {
+                decoder.integer();
+            }
+        }
+        for (size_t i = 0; i < TRAILER_SIZE; ++i) {
+            decoder.byte();
+        }
+    }
+    return replay;
+}
+
+/**
+ * @brief Read the index at the end of a replay
+ * @param in Seekable stream holding the replay
+ * @return The index
+ * @throws std::runtime_error if the data is not a replay with an index
+ */
+ReplayIndex BattleReplay::readIndex(std::istream& in) {
+    in.seekg(0);
+    if (readHeader(in) < 2) {
+        throw std::runtime_error("Replay has no index");
+    }
+    ReplayIndex index;
+    index.seed = Decoder(in).varint();
+
+    in.seekg(-static_cast<std::streamoff>(TRAILER_SIZE), std::ios::end);
+    uint64_t indexOffset = 0;
+    for (size_t i = 0; i < TRAILER_SIZE; ++i) {
+        int part = in.get();
+        if (part == std::char_traits<char>::eof()) {
+            throw std::runtime_error("Truncated replay");
+        }
+        indexOffset |= static_cast<uint64_t>(part) << (8 * i);
+    }
+    if (!in.seekg(static_cast<std::streamoff>(indexOffset))) {
+        throw std::runtime_error("Corrupt replay: index out of range");
+    }
+
+    Decoder decoder(in);
+    uint64_t count = decoder.bounded(indexOffset);
+    for (uint64_t i = 0; i < count; ++i) {
+        ReplayIndex::Entry entry;
+        entry.offset = decoder.bounded(indexOffset);
+        entry.turns = decoder.integer();
+        uint64_t keyframes = decoder.bounded(static_cast<uint64_t>(std::max(entry.turns, 0)));
+        for (uint64_t k = 0; k < keyframes; ++k) {
+            entry.keyframeTurns.push_back(decoder.integer());
+        }
+        index.battles.push_back(std::move(entry));
+    }
+    return index;
+}
+
+/**
+ * @brief Read a single battle of a replay
+ * @param in Seekable stream holding the replay
+ * @param offset Offset of the battle, as listed in the index
+ * @return The battle
+ * @throws std::runtime_error if no valid battle starts at the offset
+ */
+ReplayBattle BattleReplay::readBattle(std::istream& in, uint64_t offset) {
+    in.seekg(0);
+    uint64_t version = readHeader(in);
+    if (!in.seekg(static_cast<std::streamoff>(offset))) {
+        throw std::runtime_error("Corrupt replay: battle out of range");
+    }
+    Decoder decoder(in);
+    return ::readBattle(decoder, version);
+}
+
+/**
+ * @brief Write the replay to a file
+ * @param path Path of the file
+ * @throws std::runtime_error if the file cannot be written
+ */
+void BattleReplay::save(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (file) {
+        write(file);
+    }
+    if (!file) {
+        throw std::runtime_error("Cannot write replay " + path);
+    }
+}
+
+/**
+ * @brief Read a replay from a file
+ * @param path Path of the file
+ * @return The replay
+ * @throws std::runtime_error if the file cannot be read or is not a replay
+ */
+BattleReplay BattleReplay::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open replay " + path);
+    }
+    try {
+        return read(file);
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(path + ": " + e.what());
+    }
+}
+
+/**
+ * @brief Start recording a battle
+ * @param context Session the battle is fought in
+ * @param mode Game mode of the battle
+ * @param player The player, or the first player of a PvP battle
+ * @param enemy The enemy, or the second player of a PvP battle
+ * @param maxTurns Round limit of the battle, 0 for none
+ * @param undo Whether rounds can be undone
+ * @param automatic Whether every turn is handed to the character's AI
+ */
+void ReplayRecorder::beginBattle(const GameContext& context, ReplayBattle::Mode mode, const Character& player,
+                                 const Character& enemy, int maxTurns, bool undo, bool automatic) {
+    ReplayBattle battle;
+    try {
+        battle.player = ReplayCombatant::capture(player);
+        battle.enemy = ReplayCombatant::capture(enemy);
+    } catch (const std::exception& e) {
+        LOG_WARNING("Battle not recorded: " << e.what());
+        recording = false;
+        return;
+    }
+    battle.mode = mode;
+    battle.maxTurns = maxTurns;
+    battle.undo = undo;
+    battle.automatic = automatic;
+    replay.seed = context.getSeed();
+    replay.battles.push_back(std::move(battle));
+    recording = true;
+    nextKeyframe = KEYFRAME_INTERVAL;
+    lastKeyframe = 0;
+    reached = 0;
+    this->context = &context;
+    this->player = &player;
+    this->enemy = &enemy;
+    playerActor = player.getActorId();
+    enemyActor = enemy.getActorId();
+    rollingHash = 0;
+    eventsHashed = context.getEvents().total();
+}
+
+/**
+ * @brief Extend the rolling hash by the current round
+ * @param turns Number of rounds played so far
+ * @details Mixes in the round count, the Zobrist hash of both sides and
+ *          every combat event since the previous round, with the actors
+ *          of an event identified by side, since actor ids differ between
+ *          processes. Sides are told apart by the ids noted at the start of
+ *          the latest round, since characters are numbered again when the
+ *          battle hands them back to their previous session. Events that
+ *          already left the session's event stream are not hashed.
+ */
+void ReplayRecorder::hashRound(int turns) {
+    uint64_t hash = BattleHash::custom(0, rollingHash ^ static_cast<uint32_t>(turns));
+    try {
+        hash ^= BattleHash::of(BattleState::capture(*player, *enemy), 0).get();
+    } catch (const std::exception&) {
+        hash ^= BattleHash::stat(BattleHash::Feature::HEALTH, 0, player->getHealth()) ^
+                BattleHash::stat(BattleHash::Feature::HEALTH, 1, enemy->getHealth());
+    }
+
+    const CombatEventStream& events = context->getEvents();
+    uint64_t first = std::max(eventsHashed, events.total() - events.size());
+    auto sideOf = [this](uint32_t actor) -> uint64_t {
+        return actor == playerActor ? 0 : actor == enemyActor ? 1 : 2;
+    };
+    for (uint64_t i = first; i < events.total(); ++i) {
+        const CombatEvent& event = events[static_cast<size_t>(i - (events.total() - events.size()))];
+        uint64_t kind = static_cast<uint64_t>(event.type) | static_cast<uint64_t>(event.cause) << 8 |
+                        static_cast<uint64_t>(event.card) << 16 | static_cast<uint64_t>(event.effect) << 24 |
+                        sideOf(event.source) << 32 | sideOf(event.target) << 34;
+        uint64_t figures = static_cast<uint64_t>(static_cast<uint32_t>(event.amount)) << 32 |
+                           static_cast<uint32_t>(event.value);
+        hash = BattleHash::custom(1, hash ^ BattleHash::custom(2, kind) ^ figures);
+    }
+
+    rollingHash = hash;
+    uint32_t low = static_cast<uint32_t>(hash);
+    std::vector<uint32_t>& hashes = replay.battles.back().roundHashes;
+    if (expected && !divergence &&
+        (hashes.size() >= expected->size() || (*expected)[hashes.size()] != low)) {
+        diverge(turns, low);
+    }
+    hashes.push_back(low);
+    eventsHashed = events.total();
+}
+
+/**
+ * @brief Note the first round that differs from the expected hashes
+ * @param turns Number of rounds played so far
+ * @param actual The round's hash, 0 if the battle ended
+ * @details Keeps the events of the round that led to it, named after the sides
+ */
+void ReplayRecorder::diverge(int turns, uint32_t actual) {
+    ReplayDivergence found;
+    found.round = replay.battles.back().roundHashes.size();
+    found.turn = turns;
+    found.expected = found.round < expected->size() ? (*expected)[found.round] : 0;
+    found.actual = actual;
+
+    static const std::string nobody;
+    auto nameOf = [this](uint32_t actor) -> const std::string& {
+        return actor == playerActor ? player->getName() : actor == enemyActor ? enemy->getName() : nobody;
+    };
+    const CombatEventStream& events = context->getEvents();
+    uint64_t oldest = events.total() - events.size();
+    for (uint64_t i = std::max(eventsHashed, oldest); i < events.total(); ++i) {
+        const CombatEvent& event = events[static_cast<size_t>(i - oldest)];
+        std::ostringstream text;
+        event.render(text, nameOf(event.source), nameOf(event.target));
+        std::string line = text.str();
+        while (!line.empty() && line.back() == '\n') {
+            line.pop_back();
+        }
+        found.events.push_back(line);
+    }
+    divergence = std::move(found);
+}
+
+/**
+ * @brief Take a keyframe, or drop those an undo made invalid
+ * @param player The player, or the first player of a PvP battle
+ * @param enemy The enemy, or the second player of a PvP battle
+ * @param progress Statistics of the rounds played so far
+ * @details A side holding an item it was not recorded with cannot be
+ *          described by the keyframe, which is then skipped
+ */
+void ReplayRecorder::keyframe(const Character& player, const Character& enemy, const BattleResult& progress) {
+    ReplayBattle& battle = replay.battles.back();
+    if (progress.turns < lastKeyframe) {
+        while (!battle.keyframes.empty() && battle.keyframes.back().progress.turns > progress.turns) {
+            battle.keyframes.pop_back();
+        }
+        lastKeyframe = battle.keyframes.empty() ? 0 : battle.keyframes.back().progress.turns;
+        nextKeyframe = lastKeyframe + KEYFRAME_INTERVAL;
+        return;
+    }
+
+    ReplayKeyframe keyframe;
+    try {
+        keyframe.state = BattleState::capture(player, enemy);
+    } catch (const std::exception& e) {
+        LOG_DEBUG("Keyframe skipped: " << e.what());
+        return;
+    }
+    if (!itemPositions(keyframe.state.player, battle.player.state, keyframe.playerItems) ||
+        !itemPositions(keyframe.state.enemy, battle.enemy.state, keyframe.enemyItems)) {
+        LOG_DEBUG("Keyframe skipped: unrecorded item");
+        return;
+    }
+    keyframe.progress = progress;
+    keyframe.choiceOffset = static_cast<uint32_t>(battle.choices.size());
+    battle.keyframes.push_back(std::move(keyframe));
+    lastKeyframe = progress.turns;
+    nextKeyframe = lastKeyframe + KEYFRAME_INTERVAL;
+}
+
+/**
+ * @brief Append the battles not yet in the file to it
+ * @throws std::runtime_error if the file cannot be written
+ * @details The new battles overwrite the old index, which is written again
+ *          after them together with the trailer, and the seed and battle
+ *          count are patched in the header. They are written as padded
+ *          varints so their size never changes. A battle thus costs its own
+ *          size plus the index, instead of the whole file. After a failure
+ *          the next save writes the file from scratch.
+ */
+void ReplayRecorder::save() {
+    std::string header(MAGIC, sizeof(MAGIC));
+    Encoder headerEncoder(header);
+    headerEncoder.varint(VERSION);
+    headerEncoder.paddedVarint(replay.seed, SEED_WIDTH);
+    headerEncoder.paddedVarint(replay.battles.size(), COUNT_WIDTH);
+
+    std::ios::openmode mode = std::ios::binary | std::ios::in | std::ios::out;
+    if (savedBattles == 0) {
+        mode |= std::ios::trunc;
+        indexOffset = header.size();
+        indexEntries.clear();
+    }
+
+    std::string bytes;
+    Encoder encoder(bytes);
+    Encoder indexEncoder(indexEntries);
+    for (size_t i = savedBattles; i < replay.battles.size(); ++i) {
+        writeIndexEntry(indexEncoder, indexOffset + bytes.size(), replay.battles[i]);
+        writeBattle(encoder, replay.battles[i]);
+    }
+    uint64_t newIndexOffset = indexOffset + bytes.size();
+    encoder.varint(replay.battles.size());
+    bytes += indexEntries;
+    writeTrailer(encoder, newIndexOffset);
+
+    std::fstream file(path, mode);
+    if (file) {
+        file.write(header.data(), static_cast<std::streamsize>(header.size()));
+        file.seekp(static_cast<std::streamoff>(indexOffset));
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        file.flush();
+    }
+    if (!file) {
+        savedBattles = 0;
+        throw std::runtime_error("Cannot write replay " + path);
+    }
+    savedBattles = replay.battles.size();
+    indexOffset = newIndexOffset;
+}
+
+/**
+ * @brief Finish recording a battle
+ * @param result Its outcome
+ */
+void ReplayRecorder::endBattle(const BattleResult& result) {
+    if (!recording) {
+        return;
+    }
+    hashRound(result.turns);
+    ReplayBattle& battle = replay.battles.back();
+    if (expected && !divergence && battle.roundHashes.size() < expected->size()) {
+        diverge(result.turns, 0);
+    }
+    expected = nullptr;
+    recording = false;
+    battle.battleId = result.battleId;
+    battle.winner = result.winner;
+    battle.turns = result.turns;
+
+    if (!path.empty()) {
+        try {
+            save();
+        } catch (const std::exception& e) {
+            LOG_ERROR(e.what());
+        }
+    }
+}
+
+/**
+ * @brief Choose the next action for a character
+ * @param self The character whose turn it is
+ * @param opponent The opposing character
+ * @return The next recorded choice, BattleAction::AUTO once they run out
+ */
+BattleChoice ReplayActionSource::chooseAction(Character& self, Character& opponent) {
+    uint64_t value = 0;
+    unsigned shift = 0;
+    while (position < choices.size() && shift < 64) {
+        uint8_t part = choices[position++];
+        value |= static_cast<uint64_t>(part & 0x7F) << shift;
+        shift += 7;
+        if (!(part & 0x80)) {
+            uint64_t action = value & ((1u << ACTION_BITS) - 1);
+            if (action > static_cast<uint64_t>(BattleAction::UNDO)) {
+                break;
+            }
+            return BattleChoice(static_cast<BattleAction>(action), static_cast<size_t>(value >> ACTION_BITS));
+        }
+    }
+    return BattleChoice(BattleAction::AUTO);
+}
+
+/**
+ * @brief Constructor for ReplayCursor
+ * @param battle The battle; it must outlive the cursor
+ * @param seed Seed of the session it was recorded in
+ */
+ReplayCursor::ReplayCursor(const ReplayBattle& battle, uint64_t seed)
+    : battle(battle), context(seed, nullptr, GameContext::ClockMode::VIRTUAL) {
+    player = battle.player.create(context);
+    enemy = battle.enemy.create(context);
+    battle.player.attachBrain(player, enemy);
+    battle.enemy.attachBrain(enemy, player);
+
+    CombatantSnapshot playerState = CombatantSnapshot::capture(*player);
+    CombatantSnapshot enemyState = CombatantSnapshot::capture(*enemy);
+    playerItems.assign(playerState.items.begin(), playerState.items.begin() + playerState.itemCount);
+    enemyItems.assign(enemyState.items.begin(), enemyState.items.begin() + enemyState.itemCount);
+    progress.battleId = battle.battleId;
+}
+
+/**
+ * @brief Destructor for ReplayCursor
+ * @details Breaks the ownership cycle between the sides and their AIs
+ */
+ReplayCursor::~ReplayCursor() {
+    player->setAI(nullptr);
+    enemy->setAI(nullptr);
+}
+
+/**
+ * @brief Move to the state after a number of rounds
+ * @param turn Number of rounds played, clamped to the battle's length
+ */
+void ReplayCursor::seek(int turn) {
+    turn = std::max(0, std::min(turn, battle.turns));
+    const ReplayKeyframe* keyframe = battle.keyframeAt(turn);
+    int from = keyframe ? keyframe->progress.turns : 0;
+
+    bool continues = !battle.undo && progress.turns <= turn && progress.turns >= from;
+    if (!continues) {
+        BattleState state;
+        if (keyframe) {
+            state = keyframe->state;
+            placeItems(keyframe->playerItems, playerItems, state.player);
+            placeItems(keyframe->enemyItems, enemyItems, state.enemy);
+            progress = keyframe->progress;
+            choiceOffset = keyframe->choiceOffset;
+        } else {
+            state.player = battle.player.state;
+            state.enemy = battle.enemy.state;
+            for (size_t i = 0; i < playerItems.size(); ++i) {
+                state.player.items[i] = playerItems[i];
+            }
+            for (size_t i = 0; i < enemyItems.size(); ++i) {
+                state.enemy.items[i] = enemyItems[i];
+            }
+            progress = BattleResult();
+            progress.battleId = battle.battleId;
+            choiceOffset = 0;
+        }
+        state.restore(*player, *enemy);
+    }
+
+    if (progress.turns < turn && player->isAlive() && enemy->isAlive()) {
+        progress = resume(battle, context, player, enemy, progress, choiceOffset, turn);
+    }
+}
+
+/**
+ * @brief Play the next round
+ * @return False if the battle was already over
+ */
+bool ReplayCursor::stepForward() {
+    if (progress.turns >= battle.turns) {
+        return false;
+    }
+    seek(progress.turns + 1);
+    return true;
+}
+
+/**
+ * @brief Take back the last round
+ * @return False if no round was played
+ */
+bool ReplayCursor::stepBackward() {
+    if (progress.turns <= 0) {
+        return false;
+    }
+    seek(progress.turns - 1);
+    return true;
+}
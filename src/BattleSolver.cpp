@@ -0,0 +1,292 @@
+/**
+ * @file BattleSolver.cpp
+ * @brief Implementation of the BattleSolver class
+ * @details Contains the enumeration of random draws, the per-round state
+ *          distribution and the definitions of all methods declared in
+ *          BattleSolver.h
+ */
+
+#include "BattleSolver.h"
+#include "BattleEngine.h"
+#include "BattleHash.h"
+#include "BattleState.h"
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace {
+    /**
+     * @class DrawEnumerator
+     * @brief Chance source that walks through every combination of draw outcomes
+     * @details Works like an odometer over the draws of one round: each
+     *          replay of the round takes the recorded values, and advance()
+     *          moves to the next combination. Draws made after a changed
+     *          value are forgotten and recorded afresh, since later draws may
+     *          depend on earlier outcomes.
+     */
+    class DrawEnumerator : public ChanceSource {
+    private:
+        /**
+         * @struct Draw
+         * @brief One draw of the current combination
+         */
+        struct Draw {
+            /** @brief Offset of the chosen value from the smallest one */
+            int offset;
+
+            /** @brief Number of possible values */
+            int outcomes;
+        };
+
+        /** @brief Draws of the current combination, in the order they are made */
+        std::vector<Draw> draws;
+
+        /** @brief Number of draws made in the current replay */
+        size_t position = 0;
+
+    public:
+        /**
+         * @brief Decide a draw from the current combination
+         * @param min Smallest possible value
+         * @param max Largest possible value
+         * @return The value chosen for this draw
+         */
+        int draw(int min, int max) override {
+            if (position == draws.size()) {
+                draws.push_back({0, std::max(1, max - min + 1)});
+            }
+            return min + draws[position++].offset;
+        }
+
+        /**
+         * @brief Get the probability of the current combination
+         * @return Product of the probabilities of its draws
+         */
+        double probability() const {
+            double p = 1.0;
+            for (const Draw& d : draws) {
+                p /= d.outcomes;
+            }
+            return p;
+        }
+
+        /**
+         * @brief Move to the next combination
+         * @return False once every combination has been visited
+         */
+        bool advance() {
+            draws.resize(position);
+            position = 0;
+            while (!draws.empty()) {
+                if (++draws.back().offset < draws.back().outcomes) {
+                    return true;
+                }
+                draws.pop_back();
+            }
+            return false;
+        }
+    };
+
+    /**
+     * @class ChanceBinding
+     * @brief Attaches a chance source to a context and restores the previous one on destruction
+     */
+    class ChanceBinding {
+    private:
+        /** @brief The context */
+        GameContext& context;
+
+        /** @brief Source the context had before */
+        ChanceSource* previous;
+
+    public:
+        /**
+         * @brief Constructor for ChanceBinding
+         * @param context Context to attach the source to
+         * @param source Source to attach
+         */
+        ChanceBinding(GameContext& context, ChanceSource* source)
+            : context(context), previous(context.setChanceSource(source)) {}
+
+        /**
+         * @brief Destructor for ChanceBinding
+         */
+        ~ChanceBinding() { context.setChanceSource(previous); }
+
+        ChanceBinding(const ChanceBinding&) = delete;
+        ChanceBinding& operator=(const ChanceBinding&) = delete;
+    };
+
+    /**
+     * @class Distribution
+     * @brief Probability of each distinct battle state after some round
+     */
+    class Distribution {
+    private:
+        /** @brief Distinct states */
+        std::vector<BattleState> states;
+
+        /** @brief Probability of each state */
+        std::vector<double> probabilities;
+
+        /** @brief Next state with the same hash, or npos */
+        std::vector<size_t> chain;
+
+        /** @brief First state of each hash */
+        std::unordered_map<uint64_t, size_t> buckets;
+
+    public:
+        /** @brief End of a hash chain */
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        /**
+         * @brief Get the number of distinct states
+         * @return Number of states
+         */
+        size_t size() const { return states.size(); }
+
+        /**
+         * @brief Get a state
+         * @param i Index of the state
+         * @return The state
+         */
+        const BattleState& state(size_t i) const { return states[i]; }
+
+        /**
+         * @brief Get the probability of a state
+         * @param i Index of the state
+         * @return Its probability
+         */
+        double probability(size_t i) const { return probabilities[i]; }
+
+        /**
+         * @brief Add probability to a state, merging it with an equal one
+         * @param state The state
+         * @param p Probability to add
+         */
+        void add(const BattleState& state, double p) {
+            uint64_t hash = BattleHash::of(state, 0).get();
+            auto bucket = buckets.find(hash);
+            size_t head = bucket == buckets.end() ? npos : bucket->second;
+            for (size_t i = head; i != npos; i = chain[i]) {
+                if (states[i] == state) {
+                    probabilities[i] += p;
+                    return;
+                }
+            }
+            states.push_back(state);
+            probabilities.push_back(p);
+            chain.push_back(head);
+            buckets[hash] = states.size() - 1;
+        }
+
+        /**
+         * @brief Get the total probability of all states
+         * @return Sum of the probabilities
+         */
+        double total() const {
+            double sum = 0.0;
+            for (double p : probabilities) {
+                sum += p;
+            }
+            return sum;
+        }
+
+        /**
+         * @brief Remove all states, keeping the allocated storage
+         */
+        void clear() {
+            states.clear();
+            probabilities.clear();
+            chain.clear();
+            buckets.clear();
+        }
+
+        /**
+         * @brief Exchange the contents with another distribution
+         * @param other The other distribution
+         */
+        void swap(Distribution& other) {
+            states.swap(other.states);
+            probabilities.swap(other.probabilities);
+            chain.swap(other.chain);
+            buckets.swap(other.buckets);
+        }
+    };
+}
+
+/**
+ * @brief Constructor for BattleSolver
+ * @param player Player character
+ * @param enemy Enemy character
+ * @param context Session the rounds are played in
+ */
+BattleSolver::BattleSolver(std::shared_ptr<Character> player, std::shared_ptr<Character> enemy,
+                           GameContext& context)
+    : player(player), enemy(enemy), context(context) {}
+
+/**
+ * @brief Compute the outcome distribution of the battle
+ * @return Exact probabilities, up to floating-point rounding
+ * @details Every round expands each distinct surviving state of the
+ *          previous round. Outcomes where a side falls are added to the
+ *          result with the round they happened in; the probability left
+ *          after the turn limit is the draw probability.
+ */
+BattleOdds BattleSolver::solve() {
+    BattleOdds odds;
+    BattleState start = BattleState::capture(*player, *enemy);
+    if (!enemy->isAlive()) {
+        odds.playerWins = 1.0;
+        return odds;
+    }
+    if (!player->isAlive()) {
+        odds.enemyWins = 1.0;
+        return odds;
+    }
+
+    DrawEnumerator enumerator;
+    ChanceBinding binding(context, &enumerator);
+    BattleEngine engine(player, enemy, context);
+    engine.setMaxTurns(1);
+    AutoActionSource autopilot;
+
+    Distribution current;
+    Distribution next;
+    current.add(start, 1.0);
+
+    try {
+        for (int turn = 1; turn <= maxTurns && current.size() > 0; ++turn) {
+            next.clear();
+            for (size_t i = 0; i < current.size(); ++i) {
+                odds.states++;
+                do {
+                    current.state(i).restore(*player, *enemy);
+                    engine.run(autopilot);
+                    odds.branches++;
+
+                    double p = current.probability(i) * enumerator.probability();
+                    if (!enemy->isAlive()) {
+                        odds.playerWins += p;
+                        odds.meanTurns += p * turn;
+                    } else if (!player->isAlive()) {
+                        odds.enemyWins += p;
+                        odds.meanTurns += p * turn;
+                    } else {
+                        next.add(BattleState::capture(*player, *enemy), p);
+                    }
+                } while (enumerator.advance());
+            }
+            current.swap(next);
+        }
+    } catch (...) {
+        start.restore(*player, *enemy);
+        throw;
+    }
+
+    odds.draws = current.total();
+    odds.meanTurns += odds.draws * maxTurns;
+    start.restore(*player, *enemy);
+    return odds;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file BattleState.cpp
+ * @brief Implementation of the battle state snapshot
+ * @details Contains the definitions of all methods declared in BattleState.h
+ */
+
+#include "BattleState.h"
+#include "Character.h"
+#include "Deck.h"
+#include "Inventory.h"
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * @brief Capture the state of a character
+ * @param character The character
+ * @return Snapshot of the character
+ * @details Reads the fields directly, including the Entity defense that
+ *          Character shadows, so restore() reproduces the character exactly
+ */
+CombatantSnapshot CombatantSnapshot::capture(const Character& character) {
+    const auto& activeEffects = character.activeEffects;
+    auto deck = character.getDeck();
+    const auto& inventory = character.inventory;
+    if (activeEffects.size() > MAX_EFFECTS || (deck && deck->size() > MAX_CARDS) ||
+        (inventory && inventory->getItems().size() > MAX_ITEMS)) {
+        throw std::length_error("Character does not fit in a battle state snapshot");
+    }
+
+    CombatantSnapshot snapshot;
+    snapshot.health = character.health;
+    snapshot.mana = character.mana;
+    snapshot.damageReduction = character.Entity::defense;
+    snapshot.defense = character.defense;
+    snapshot.attackPower = character.attackPower;
+    snapshot.level = character.level;
+    snapshot.experience = character.experience;
+    snapshot.kills = character.kills;
+
+    snapshot.effectCount = static_cast<uint8_t>(activeEffects.size());
+    std::copy(activeEffects.begin(), activeEffects.end(), snapshot.effects.begin());
+
+    snapshot.hasDeck = deck != nullptr;
+    if (deck) {
+        const auto& ids = deck->getCardIds();
+        snapshot.cardCount = static_cast<uint16_t>(ids.size());
+        std::copy(ids.begin(), ids.end(), snapshot.cards.begin());
+    }
+
+    snapshot.hasInventory = inventory != nullptr;
+    if (inventory) {
+        const auto& items = inventory->getItems();
+        snapshot.itemCount = static_cast<uint8_t>(items.size());
+        std::copy(items.begin(), items.end(), snapshot.items.begin());
+    }
+    return snapshot;
+}
+
+/**
+ * @brief Write the snapshot back into a character
+ * @param character The character to update
+ */
+void CombatantSnapshot::restore(Character& character) const {
+    character.health = health;
+    character.mana = mana;
+    character.Entity::defense = damageReduction;
+    character.defense = defense;
+    character.attackPower = attackPower;
+    character.level = level;
+    character.experience = experience;
+    character.kills = kills;
+    character.activeEffects.assign(effects.begin(), effects.begin() + effectCount);
+
+    auto deck = character.getDeck();
+    if (!deck && hasDeck) {
+        deck = std::make_shared<Deck>();
+        character.setDeck(deck);
+    }
+    if (deck) {
+        deck->assign(cards.data(), cardCount);
+    }
+
+    if (!character.inventory && hasInventory) {
+        character.inventory = std::make_shared<Inventory>();
+    }
+    if (character.inventory) {
+        character.inventory->assignItems(items.data(), itemCount);
+    }
+}
+
+/**
+ * @brief Compare two snapshots
+ * @param other Snapshot to compare with
+ * @return True if both hold the same state
+ * @details Compares field by field, since padding bytes make memcmp unreliable
+ */
+bool CombatantSnapshot::operator==(const CombatantSnapshot& other) const {
+    if (health != other.health || mana != other.mana || damageReduction != other.damageReduction ||
+        defense != other.defense || attackPower != other.attackPower || level != other.level ||
+        experience != other.experience || kills != other.kills || effectCount != other.effectCount ||
+        itemCount != other.itemCount || cardCount != other.cardCount || hasDeck != other.hasDeck ||
+        hasInventory != other.hasInventory) {
+        return false;
+    }
+    auto sameEffect = [](const ActiveEffect& a, const ActiveEffect& b) {
+        return a.type == b.type && a.speedModifier == b.speedModifier && a.duration == b.duration &&
+               a.damagePerTurn == b.damagePerTurn && a.healPerTurn == b.healPerTurn;
+    };
+    return std::equal(effects.begin(), effects.begin() + effectCount, other.effects.begin(), sameEffect) &&
+           std::equal(cards.begin(), cards.begin() + cardCount, other.cards.begin()) &&
+           std::equal(items.begin(), items.begin() + itemCount, other.items.begin());
+}
@@ -0,0 +1,483 @@
+/**
+ * @file BenchmarkBaseline.cpp
+ * @brief Implementation of the benchmark baseline store and comparator
+ * @details Contains a reader for the JSON output of Google Benchmark and
+ *          the definitions of all functions declared in BenchmarkBaseline.h
+ */
+
+#include "BenchmarkBaseline.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+    /**
+     * @struct JsonValue
+     * @brief Parsed JSON value
+     */
+    struct JsonValue {
+        /**
+         * @enum Type
+         * @brief Kind of value
+         */
+        enum class Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+        /** @brief Kind of value */
+        Type type = Type::NUL;
+
+        /** @brief Value of a number or boolean */
+        double number = 0;
+
+        /** @brief Value of a string */
+        std::string text;
+
+        /** @brief Elements of an array */
+        std::vector<JsonValue> elements;
+
+        /** @brief Members of an object, in document order */
+        std::vector<std::pair<std::string, JsonValue>> members;
+
+        /**
+         * @brief Find a member of an object
+         * @param key Name of the member
+         * @return The member, nullptr if absent or not an object
+         */
+        const JsonValue* find(const std::string& key) const {
+            for (const auto& member : members) {
+                if (member.first == key) {
+                    return &member.second;
+                }
+            }
+            return nullptr;
+        }
+    };
+
+    /**
+     * @class JsonReader
+     * @brief Recursive-descent JSON parser
+     */
+    class JsonReader {
+    private:
+        /** @brief The document */
+        const std::string& text;
+
+        /** @brief Position of the next character */
+        size_t position = 0;
+
+        /**
+         * @brief Report malformed input
+         * @param what Description of the problem
+         */
+        [[noreturn]] void fail(const std::string& what) const {
+            throw std::runtime_error("Malformed benchmark JSON at offset " + std::to_string(position) + ": " + what);
+        }
+
+        /**
+         * @brief Skip whitespace
+         */
+        void skipSpace() {
+            while (position < text.size() && std::isspace(static_cast<unsigned char>(text[position]))) {
+                position++;
+            }
+        }
+
+        /**
+         * @brief Consume an expected character
+         * @param expected The character
+         */
+        void expect(char expected) {
+            skipSpace();
+            if (position >= text.size() || text[position] != expected) {
+                fail(std::string("expected '") + expected + "'");
+            }
+            position++;
+        }
+
+        /**
+         * @brief Consume a literal word
+         * @param word The word
+         */
+        void literal(const char* word) {
+            size_t length = std::char_traits<char>::length(word);
+            if (text.compare(position, length, word) != 0) {
+                fail("unknown literal");
+            }
+            position += length;
+        }
+
+        /**
+         * @brief Parse a string
+         * @return Its contents; Unicode escapes are kept as written
+         */
+        std::string string() {
+            expect('"');
+            std::string value;
+            while (position < text.size() && text[position] != '"') {
+                char c = text[position++];
+                if (c == '\\' && position < text.size()) {
+                    char escaped = text[position++];
+                    switch (escaped) {
+                        case 'n':
+                            value += '\n';
+                            break;
+                        case 't':
+                            value += '\t';
+                            break;
+                        case 'r':
+                            value += '\r';
+                            break;
+                        case 'u':
+                            value += "\\u";
+                            break;
+                        default:
+                            value += escaped;
+                            break;
+                    }
+                } else {
+                    value += c;
+                }
+            }
+            expect('"');
+            return value;
+        }
+
+    public:
+        /**
+         * @brief Constructor for JsonReader
+         * @param text The document; it must outlive the reader
+         */
+        explicit JsonReader(const std::string& text) : text(text) {}
+
+        /**
+         * @brief Parse the next value
+         * @return The value
+         */
+        JsonValue value() {
+            skipSpace();
+            if (position >= text.size()) {
+                fail("unexpected end");
+            }
+            JsonValue result;
+            char c = text[position];
+            if (c == '{') {
+                result.type = JsonValue::Type::OBJECT;
+                position++;
+                skipSpace();
+                if (position < text.size() && text[position] == '}') {
+                    position++;
+                    return result;
+                }
+                while (true) {
+                    std::string key = string();
+                    expect(':');
+                    result.members.emplace_back(std::move(key), value());
+                    skipSpace();
+                    if (position >= text.size() || text[position] != ',') {
+                        break;
+                    }
+                    position++;
+                }
+                expect('}');
+            } else if (c == '[') {
+                result.type = JsonValue::Type::ARRAY;
+                position++;
+                skipSpace();
+                if (position < text.size() && text[position] == ']') {
+                    position++;
+                    return result;
+                }
+                while (true) {
+                    result.elements.push_back(value());
+                    skipSpace();
+                    if (position >= text.size() || text[position] != ',') {
+                        break;
+                    }
+                    position++;
+                }
+                expect(']');
+            } else if (c == '"') {
+                result.type = JsonValue::Type::STRING;
+                result.text = string();
+            } else if (c == 't' || c == 'f') {
+                result.type = JsonValue::Type::BOOLEAN;
+                result.number = c == 't';
+                literal(c == 't' ? "true" : "false");
+            } else if (c == 'n') {
+                literal("null");
+            } else {
+                result.type = JsonValue::Type::NUMBER;
+                const char* start = text.c_str() + position;
+                char* end = nullptr;
+                result.number = std::strtod(start, &end);
+                if (end == start) {
+                    fail("unexpected character");
+                }
+                position += static_cast<size_t>(end - start);
+            }
+            return result;
+        }
+
+        /**
+         * @brief Check that nothing but whitespace follows
+         */
+        void finish() {
+            skipSpace();
+            if (position != text.size()) {
+                fail("trailing data");
+            }
+        }
+    };
+
+    /**
+     * @brief Get the number of nanoseconds in a Google Benchmark time unit
+     * @param unit The unit: ns, us, ms or s
+     * @return Nanoseconds per unit
+     */
+    double nanosecondsPer(const std::string& unit) {
+        if (unit == "ns") {
+            return 1;
+        }
+        if (unit == "us") {
+            return 1e3;
+        }
+        if (unit == "ms") {
+            return 1e6;
+        }
+        if (unit == "s") {
+            return 1e9;
+        }
+        throw std::runtime_error("Unknown benchmark time unit " + unit);
+    }
+
+    /**
+     * @brief Get the median of a sample
+     * @param values The sample, not empty
+     * @return Its median
+     */
+    double median(std::vector<double> values) {
+        size_t middle = values.size() / 2;
+        std::nth_element(values.begin(), values.begin() + middle, values.end());
+        double upper = values[middle];
+        if (values.size() % 2 == 1) {
+            return upper;
+        }
+        return (upper + *std::max_element(values.begin(), values.begin() + middle)) / 2;
+    }
+}
+
+/**
+ * @brief Read the JSON output of a Google Benchmark run
+ * @param in Stream holding the output
+ * @return The run
+ * @throws std::runtime_error if the data is not benchmark output
+ * @details Repetitions are grouped by run_name, which is the same for every
+ *          repetition of a benchmark; output without it falls back to name
+ */
+BenchmarkRun BenchmarkRun::parse(std::istream& in) {
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    std::string text = buffer.str();
+    JsonReader reader(text);
+    JsonValue document = reader.value();
+    reader.finish();
+
+    const JsonValue* benchmarks = document.find("benchmarks");
+    if (!benchmarks || benchmarks->type != JsonValue::Type::ARRAY) {
+        throw std::runtime_error("Not benchmark output: no benchmarks array");
+    }
+
+    BenchmarkRun run;
+    for (const JsonValue& entry : benchmarks->elements) {
+        const JsonValue* runType = entry.find("run_type");
+        if (runType && runType->text != "iteration") {
+            continue;
+        }
+        const JsonValue* name = entry.find("run_name");
+        if (!name) {
+            name = entry.find("name");
+        }
+        const JsonValue* cpuTime = entry.find("cpu_time");
+        const JsonValue* unit = entry.find("time_unit");
+        if (!name || name->type != JsonValue::Type::STRING || !cpuTime || cpuTime->type != JsonValue::Type::NUMBER) {
+            throw std::runtime_error("Not benchmark output: entry without name or cpu_time");
+        }
+        double scale = unit ? nanosecondsPer(unit->text) : 1;
+        run.samples[name->text].push_back(cpuTime->number * scale);
+    }
+    return run;
+}
+
+/**
+ * @brief Read the JSON output of a Google Benchmark run from a file
+ * @param path Path of the file
+ * @return The run
+ * @throws std::runtime_error if the file cannot be read or is not benchmark output
+ */
+BenchmarkRun BenchmarkRun::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    try {
+        return parse(file);
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(path + ": " + e.what());
+    }
+}
+
+/**
+ * @brief Two-sided p-value of the Mann-Whitney U test
+ * @param a First sample
+ * @param b Second sample
+ * @return Probability of a rank difference at least this large if both come
+ *         from the same distribution, 1 if a sample is empty
+ * @details Tied values share the mean of their ranks, and the variance of
+ *          U is reduced by the usual tie term
+ */
+double mannWhitneyPValue(const std::vector<double>& a, const std::vector<double>& b) {
+    if (a.empty() || b.empty()) {
+        return 1;
+    }
+    std::vector<std::pair<double, bool>> pooled;
+    pooled.reserve(a.size() + b.size());
+    for (double value : a) {
+        pooled.emplace_back(value, true);
+    }
+    for (double value : b) {
+        pooled.emplace_back(value, false);
+    }
+    std::sort(pooled.begin(), pooled.end());
+
+    double n1 = static_cast<double>(a.size());
+    double n2 = static_cast<double>(b.size());
+    double n = n1 + n2;
+    double rankSumA = 0;
+    double tieTerm = 0;
+    for (size_t first = 0; first < pooled.size();) {
+        size_t last = first;
+        while (last + 1 < pooled.size() && pooled[last + 1].first == pooled[first].first) {
+            last++;
+        }
+        double rank = (static_cast<double>(first + last) + 2) / 2;
+        double ties = static_cast<double>(last - first + 1);
+        tieTerm += ties * ties * ties - ties;
+        for (size_t i = first; i <= last; ++i) {
+            if (pooled[i].second) {
+                rankSumA += rank;
+            }
+        }
+        first = last + 1;
+    }
+
+    double u = rankSumA - n1 * (n1 + 1) / 2;
+    double variance = n1 * n2 / 12 * ((n + 1) - tieTerm / (n * (n - 1)));
+    if (variance <= 0) {
+        return 1;
+    }
+    double z = std::max(0.0, std::fabs(u - n1 * n2 / 2) - 0.5) / std::sqrt(variance);
+    return std::erfc(z / std::sqrt(2.0));
+}
+
+/**
+ * @brief Compare the benchmarks two runs have in common
+ * @param baseline The earlier run
+ * @param current The run to check
+ * @param threshold Smallest relative change of the median that counts, 0.05 for 5%
+ * @param alpha Significance level of the test
+ * @return One comparison per common benchmark, in name order
+ */
+std::vector<BenchmarkComparison> compareBenchmarkRuns(const BenchmarkRun& baseline, const BenchmarkRun& current,
+                                                      double threshold, double alpha) {
+    std::vector<BenchmarkComparison> comparisons;
+    for (const auto& entry : current.samples) {
+        auto before = baseline.samples.find(entry.first);
+        if (before == baseline.samples.end() || before->second.empty() || entry.second.empty()) {
+            continue;
+        }
+        BenchmarkComparison comparison;
+        comparison.name = entry.first;
+        comparison.baselineMedian = median(before->second);
+        comparison.currentMedian = median(entry.second);
+        if (comparison.baselineMedian > 0) {
+            comparison.change = comparison.currentMedian / comparison.baselineMedian - 1;
+        }
+
+        if (before->second.size() < MIN_BENCHMARK_SAMPLES || entry.second.size() < MIN_BENCHMARK_SAMPLES) {
+            comparison.verdict = BenchmarkComparison::Verdict::TOO_FEW_SAMPLES;
+        } else {
+            comparison.pValue = mannWhitneyPValue(before->second, entry.second);
+            if (comparison.pValue < alpha && comparison.change > threshold) {
+                comparison.verdict = BenchmarkComparison::Verdict::REGRESSION;
+            } else if (comparison.pValue < alpha && comparison.change < -threshold) {
+                comparison.verdict = BenchmarkComparison::Verdict::IMPROVEMENT;
+            }
+        }
+        comparisons.push_back(std::move(comparison));
+    }
+    return comparisons;
+}
+
+/**
+ * @brief Constructor for BenchmarkBaseline
+ * @param directory Directory holding the runs; created when a run is stored
+ */
+BenchmarkBaseline::BenchmarkBaseline(std::string directory) : directory(std::move(directory)) {}
+
+/**
+ * @brief Get the file of a commit's run
+ * @param commit Full commit hash
+ * @return Path of the file
+ */
+std::string BenchmarkBaseline::pathFor(const std::string& commit) const {
+    return (std::filesystem::path(directory) / (commit + ".json")).string();
+}
+
+/**
+ * @brief Check whether a commit has a stored run
+ * @param commit Full commit hash
+ * @return True if it has
+ */
+bool BenchmarkBaseline::has(const std::string& commit) const {
+    std::error_code error;
+    return std::filesystem::is_regular_file(pathFor(commit), error);
+}
+
+/**
+ * @brief Store the output of a run for a commit, replacing any earlier one
+ * @param commit Full commit hash
+ * @param resultPath JSON output of the run
+ * @throws std::runtime_error if the output is not benchmark output or cannot be stored
+ * @details The output is checked before it is copied, so the store only
+ *          holds readable runs
+ */
+void BenchmarkBaseline::store(const std::string& commit, const std::string& resultPath) const {
+    BenchmarkRun::load(resultPath);
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (!error) {
+        std::filesystem::copy_file(resultPath, pathFor(commit), std::filesystem::copy_options::overwrite_existing,
+                                   error);
+    }
+    if (error) {
+        throw std::runtime_error("Cannot store " + resultPath + " in " + directory + ": " + error.message());
+    }
+}
+
+/**
+ * @brief Read the stored run of a commit
+ * @param commit Full commit hash
+ * @return The run
+ * @throws std::runtime_error if the commit has no readable run
+ */
+BenchmarkRun BenchmarkBaseline::load(const std::string& commit) const {
+    if (!has(commit)) {
+        throw std::runtime_error("No stored benchmark run for commit " + commit);
+    }
+    return BenchmarkRun::load(pathFor(commit));
+}
@@ -6,14 +6,12 @@
  */
 
 #include "BossAI.h"
-#include "Fireball.h"
-#include "IceSpike.h"
-#include "BurningEffect.h"
-#include "SpellCard.h"
-#include "Regeneration.h"
+#include "CardCatalog.h"
+#include "EndgameTablebase.h"
+#include "MctsAI.h"
 #include <algorithm>
-#include <random>
-#include <iostream>
+#include "GameContext.h"
+#include "Logger.h"
 
 /**
  * @brief Constructor for BossAI
@@ -24,64 +22,116 @@
  *          its target, and its deck of cards for making strategic decisions
  */
 BossAI::BossAI(std::shared_ptr<Character> self, std::shared_ptr<Character> target, std::shared_ptr<Deck> deck)
-    : self(self), target(target), deck(deck) {}
+    : self(self), target(target), deck(deck) {
+    kind = AIKind::BOSS;
+}
 
 /**
  * @brief Decision-making method for the Boss AI
  * @param self Reference to the character controlled by this AI
  * @param target Reference to the target entity
- * @details Main decision-making method that sequentially calls health check
- *          and chooses between attack or ability usage
+ * @param context Session the decision is made in
+ * @details Plays the tablebase move when one is available, then the
+ *          searched move when the search is enabled; otherwise sequentially
+ *          calls health check and chooses between attack or ability usage
  */
-void BossAI::makeDecision(Character& self, Entity& target) {
-    checkHealthAndAct();
-    useAbilityOrAttack();
+void BossAI::makeDecision(Character& self, Entity& target, GameContext& context) {
+    if (playEndgameMove(context)) {
+        return;
+    }
+    if (search) {
+        search->makeDecision(*this->self, *this->target, context);
+        return;
+    }
+    checkHealthAndAct(context);
+    useAbilityOrAttack(context);
 }
 
 /**
  * @brief Checks health level and takes appropriate actions
+ * @param context Session the decision is made in
  * @details If the boss's health falls below 30, attempts to use a regeneration card from the deck.
  *          If no such card is available, outputs a message about its absence
  */
-void BossAI::checkHealthAndAct() {
+void BossAI::checkHealthAndAct(GameContext& context) {
     if (self->isAlive() && self->getHealth() < 30) {
-        for (const auto& card : deck->getCards()) {
-            if (card->getName() == "Regeneration") {
-                card->play(*self);
-                deck->removeCard(card);
-                return;
-            }
+        if (deck->contains(CardId::REGENERATION)) {
+            context.emit(CombatEvent::cardPlayed(CardId::REGENERATION), self.get(), self.get());
+            CardCatalog::get(CardId::REGENERATION)->play(*self, context);
+            deck->removeCard(CardId::REGENERATION, context);
+            return;
         }
-        std::cout << "No Regeneration card available!" << std::endl;
+        context.out() << "No Regeneration card available!\n";
     }
 }
 
 /**
  * @brief Chooses between using a special ability or a regular attack
- * @details Randomly chooses between a regular attack and using a card from the deck.
+ * @param context Session the decision is made in
+ * @details Randomly chooses between a regular attack and using a card from the deck,
+ *          drawing from the session's generator.
  *          If the deck is empty or unable to draw a card, uses Fireball as a fallback option
  */
-void BossAI::useAbilityOrAttack() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 1);
-
-    int action = dis(gen);
+void BossAI::useAbilityOrAttack(GameContext& context) {
+    int action = context.randomInt(0, 1);
 
     if (action == 0) {
         self->attack(*target);
-        std::cout << "Boss attacks!" << std::endl;
+        LOG_DEBUG("Boss attacks!");
     } else {
-        if (deck && !deck->getCards().empty()) {
-            auto card = deck->drawCard();
+        if (deck && !deck->empty()) {
+            auto card = deck->drawCard(context);
             if (card) {
-                card->play(*target);
-                std::cout << "Boss uses " << card->getName() << std::endl;
+                context.emit(CombatEvent::cardPlayed(card->getId()), self.get(), target.get());
+                card->play(*target, context);
                 return;
             }
         }
-        Fireball fireball;
-        fireball.play(*target);
-        std::cout << "Boss uses Fireball as fallback!" << std::endl;
+        context.emit(CombatEvent::cardPlayed(CardId::FIREBALL), self.get(), target.get());
+        CardCatalog::get(CardId::FIREBALL)->play(*target, context);
+    }
+}
+
+/**
+ * @brief Plays the tablebase move if the endgame is covered
+ * @param context Session the decision is made in
+ * @return False if the session has no tablebase or it does not cover the battle
+ * @details Cards are played from the boss's own deck and removed from it,
+ *          Regeneration on the boss and the others on the target
+ */
+bool BossAI::playEndgameMove(GameContext& context) {
+    const EndgameTablebase* tablebase = context.getEndgameTablebase();
+    EndgameTablebase::Move move;
+    if (!tablebase || !deck || !tablebase->lookup(*self, *target, *deck, move)) {
+        return false;
     }
-}
\ No newline at end of file
+    endgameMoves++;
+
+    if (move == EndgameTablebase::Move::ATTACK) {
+        self->attack(*target);
+        LOG_DEBUG("Boss attacks!");
+        return true;
+    }
+
+    CardId id = move == EndgameTablebase::Move::FIREBALL  ? CardId::FIREBALL
+              : move == EndgameTablebase::Move::LIGHTNING ? CardId::LIGHTNING
+                                                          : CardId::REGENERATION;
+    auto card = CardCatalog::get(id);
+    if (id == CardId::REGENERATION) {
+        context.emit(CombatEvent::cardPlayed(id), self.get(), self.get());
+        card->play(*self, context);
+    } else {
+        context.emit(CombatEvent::cardPlayed(id), self.get(), target.get());
+        card->play(*target, context);
+    }
+    deck->removeCard(id, context);
+    return true;
+}
+
+/**
+ * @brief Choose the moves outside the tablebase with a Monte Carlo search
+ */
+void BossAI::enableSearch() {
+    search = std::make_shared<MctsAI>(SEARCH_BUDGET, SEARCH_THREADS);
+    search->setMaxIterations(SEARCH_ITERATIONS);
+}
@@ -6,24 +6,24 @@
 
 #include "BurningEffect.h"
 #include "Character.h"
-#include <iostream>
+#include "GameContext.h"
 
 /**
  * @brief Constructor for BurningEffect
  * @details Initializes a burning effect card with a predefined name and description
  */
 BurningEffect::BurningEffect()
-    : Card("Burning Effect", "Deals 5 damage per turn for 3 turns.") {}
+    : Card(CardId::BURNING_EFFECT, "Burning Effect", "Deals 5 damage per turn for 3 turns.") {}
 
 /**
  * @brief Implements the effect of playing a BurningEffect card
  * @param target The entity targeted by the burning effect
+ * @param context Session the card is played in
  * @details Applies a burning effect to the target if it's a Character,
  *          dealing 5 damage per turn for 3 turns
  */
-void BurningEffect::play(Entity & target) {
-    if (auto* character = dynamic_cast<Character*>(&target)) {
+void BurningEffect::play(Entity& target, GameContext& context) {
+    if (auto* character = Character::from(target)) {
         character->applyEffect(EffectType::BURN, 1.0f, 3, 5);
-        std::cout << "Burning Effect Card activates on " << target.getName() << std::endl;
     }
 }
\ No newline at end of file
@@ -0,0 +1,66 @@
+/**
+ * @file CardCatalog.cpp
+ * @brief Implementation of the CardCatalog class
+ * @details Contains the card prototypes and the definitions of all methods
+ *          declared in CardCatalog.h
+ */
+
+#include "CardCatalog.h"
+#include "AttackCard.h"
+#include "BurningEffect.h"
+#include "DefenseCard.h"
+#include "Fireball.h"
+#include "IceSpike.h"
+#include "LightningCard.h"
+#include "Poison.h"
+#include "Regeneration.h"
+#include "Shield.h"
+#include "SpecialCard.h"
+#include "SpellCard.h"
+#include "TrapCard.h"
+#include <array>
+#include <stdexcept>
+
+namespace {
+    /**
+     * @brief Wrap a static prototype in a shared pointer that does not own it
+     * @param card The prototype
+     * @return Shared pointer without a control block
+     */
+    std::shared_ptr<Card> prototype(Card& card) {
+        return std::shared_ptr<Card>(std::shared_ptr<Card>(), &card);
+    }
+}
+
+/**
+ * @brief Get the prototype of a card kind
+ * @param id Identifier of the card kind, must be a catalog card
+ * @return Non-owning shared pointer to the prototype
+ * @details The prototypes are created on first use, in CardId order
+ */
+const std::shared_ptr<Card>& CardCatalog::get(CardId id) {
+    static AttackCard attack;
+    static DefenseCard defense;
+    static SpellCard spell;
+    static TrapCard trap;
+    static SpecialCard special;
+    static Fireball fireball;
+    static IceSpike iceSpike;
+    static LightningCard lightning;
+    static BurningEffect burningEffect;
+    static Poison poison;
+    static Regeneration regeneration;
+    static Shield shield;
+
+    static const std::array<std::shared_ptr<Card>, size()> prototypes = {
+        prototype(attack), prototype(defense), prototype(spell), prototype(trap),
+        prototype(special), prototype(fireball), prototype(iceSpike), prototype(lightning),
+        prototype(burningEffect), prototype(poison), prototype(regeneration), prototype(shield)
+    };
+
+    size_t index = static_cast<size_t>(id);
+    if (index >= prototypes.size()) {
+        throw std::out_of_range("Card is not part of the catalog");
+    }
+    return prototypes[index];
+}
@@ -7,7 +7,8 @@
 #include "Character.h"
 #include "Ability.h"
 #include "AI.h"
-#include <iostream>
+#include "CommandLog.h"
+#include "GameContext.h"
 #include <algorithm>
 
 /**
@@ -17,7 +18,8 @@
  * @param mana Initial mana value
  * @param attackPower The attack power of the character
  * @param defense The defense value of the character
- * @details Initializes a character with the specified attributes
+ * @details Initializes a character with the specified attributes and tags
+ *          it as a character for RTTI-free target resolution
  */
 Character::Character(const std::string& name, int health, int mana, int attackPower, int defense)
     : Entity(name, std::min(health, Entity::MAX_HEALTH), 
@@ -26,13 +28,15 @@ Character::Character(const std::string& name, int health, int mana, int attackPo
       defense(defense), 
       kills(0), 
       deck(std::make_shared<Deck>()),
-      inventory(std::make_shared<Inventory>()) {}
+      inventory(std::make_shared<Inventory>()) {
+    kind = EntityKind::CHARACTER;
+}
 
 /**
  * @brief Performs an attack on a target
  * @param target The entity to attack
  * @details Checks if the target is alive, calculates damage based on speed modifiers,
- *          applies damage to the target, and outputs a message about the result.
+ *          applies damage to the target, and emits a damage event.
  *          Grants experience and increases kill count if the target dies.
  */
 void Character::attack(Entity& target) {
@@ -40,14 +44,14 @@ void Character::attack(Entity& target) {
         float speedMod = getCurrentSpeedModifier();
         int damage = static_cast<int>(attackPower * speedMod);
         target.takeDamage(damage);
-        std::cout << getName() << " attacks for " << damage << " damage!" << std::endl;
+        getContext().emit(CombatEvent::damage(CombatEvent::Cause::ATTACK, damage), this, &target);
 
         if (!target.isAlive()) {
             gainExp(30);
             incrementKills();
         }
     } else {
-        std::cout << getName() << " tries to attack a dead target!" << std::endl;
+        getContext().out() << getName() << " tries to attack a dead target!\n";
     }
 }
 
@@ -61,10 +65,11 @@ void Character::attack(Entity& target) {
 void Character::useAbility(Ability& ability, Entity& target) {
     if (ability.getManaCost() <= getMana()) {
         reduceMana(ability.getManaCost());
+        getContext().emit(CombatEvent::manaSpent(ability.getManaCost()), this, nullptr);
         ability.activate(*this, target);
-        std::cout << getName() << " uses " << ability.getName() << "!" << std::endl;
+        getContext().out() << getName() << " uses " << ability.getName() << "!\n";
     } else {
-        std::cout << "Not enough mana to use " << ability.getName() << "!" << std::endl;
+        getContext().out() << "Not enough mana to use " << ability.getName() << "!\n";
     }
 }
 
@@ -76,37 +81,29 @@ void Character::useAbility(Ability& ability, Entity& target) {
  * @param dmg The damage per turn caused by the effect
  * @param heal The healing per turn provided by the effect
  * @details Creates and applies an effect of the specified type with the given parameters.
- *          Displays appropriate messages based on the effect type.
+ *          Emits an event naming the effect.
  */
 void Character::applyEffect(EffectType type, float mod, int dur, int dmg, int heal) {
     activeEffects.emplace_back(type, mod, dur, dmg, heal);
-    
-    switch(type) {
-        case EffectType::SLOW:
-            std::cout << getName() << "'s speed reduced to " 
-                      << mod*100 << "% for " << dur << " turns!" << std::endl;
-            break;
-        case EffectType::BURN:
-            std::cout << getName() << " is burning for " << dur << " turns!" << std::endl;
-            break;
-        case EffectType::POISON:
-            std::cout << getName() << " is poisoned for " << dur << " turns!" << std::endl;
-            break;
-        case EffectType::REGENERATION:
-            std::cout << getName() << " regenerates for " << dur << " turns!" << std::endl;
-            break;
-        default:
-            break;
+    CommandLog* log = getContext().getCommandLog();
+    if (log) {
+        log->recordEffectApplied(*this);
     }
+    getContext().emit(CombatEvent::effectApplied(type, dur, mod), nullptr, this);
 }
 
 /**
  * @brief Updates all active effects on the character
  * @details Applies the effects of each active status and decreases their duration.
- *          Removes expired effects and displays appropriate messages.
+ *          Removes expired effects and emits an event for every damage or healing tick.
  *          Handles damage from burns/poison and healing from regeneration.
+ *          The tick and every expiry are recorded in the session's command log.
  */
 void Character::updateEffect() {
+    CommandLog* log = getContext().getCommandLog();
+    if (log && !activeEffects.empty()) {
+        log->recordEffectsTicked(*this);
+    }
     for(auto it = activeEffects.begin(); it != activeEffects.end();) {
         it->duration--;
         
@@ -114,20 +111,23 @@ void Character::updateEffect() {
             case EffectType::BURN:
             case EffectType::POISON:
                 takeDamage(it->damagePerTurn);
-                std::cout << getName() << " takes " 
-                          << it->damagePerTurn << " damage from effect!" << std::endl;
+                getContext().emit(CombatEvent::damage(CombatEvent::Cause::EFFECT, it->damagePerTurn), nullptr, this);
                 break;
             case EffectType::REGENERATION:
                 heal(it->healPerTurn);
-                std::cout << getName() << " heals " 
-                          << it->healPerTurn << " from regeneration!" << std::endl;
+                getContext().emit(CombatEvent::heal(CombatEvent::Cause::EFFECT, it->healPerTurn), nullptr, this);
                 break;
             default:
                 break;
         }
         
         if(it->duration <= 0) {
+            ActiveEffect expired = *it;
+            size_t index = static_cast<size_t>(it - activeEffects.begin());
             it = activeEffects.erase(it);
+            if (log) {
+                log->recordEffectExpired(*this, index, expired);
+            }
         } else {
             ++it;
         }
@@ -141,7 +141,7 @@ void Character::updateEffect() {
  */
 void Character::performAIAction() {
     if(ai && target && target->isAlive()) {
-        ai->makeDecision(*this, *target);
+        ai->makeDecision(*this, *target, getContext());
     }
 }
 
@@ -0,0 +1,215 @@
+/**
+ * @file CombatEvents.cpp
+ * @brief Implementation of the CombatEvent and CombatEventStream classes
+ * @details Contains the event constructors, the text of every event and the
+ *          definitions of all methods declared in CombatEvents.h
+ */
+
+#include "CombatEvents.h"
+#include "CardCatalog.h"
+#include <cmath>
+
+namespace {
+    /**
+     * @brief Make an event of a type
+     * @param type Kind of action
+     * @param cause What brought it about
+     * @param amount Main figure
+     * @return The event
+     */
+    CombatEvent make(CombatEvent::Type type, CombatEvent::Cause cause, int amount) {
+        CombatEvent event;
+        event.type = type;
+        event.cause = cause;
+        event.amount = amount;
+        return event;
+    }
+
+    /**
+     * @brief Get the display name of a card
+     * @param card The card
+     * @return Its name, or "Card" for cards outside the catalog
+     */
+    const std::string& cardName(CardId card) {
+        static const std::string unknown = "Card";
+        return card < CardId::COUNT ? CardCatalog::get(card)->getName() : unknown;
+    }
+}
+
+/**
+ * @brief Make a damage event
+ * @param cause What dealt the damage
+ * @param amount Damage dealt
+ * @param card Card that dealt it, for Cause::CARD
+ * @return The event
+ */
+CombatEvent CombatEvent::damage(Cause cause, int amount, CardId card) {
+    CombatEvent event = make(Type::DAMAGE, cause, amount);
+    event.card = card;
+    return event;
+}
+
+/**
+ * @brief Make a healing event
+ * @param cause What healed
+ * @param amount Health restored
+ * @return The event
+ */
+CombatEvent CombatEvent::heal(Cause cause, int amount) {
+    return make(Type::HEAL, cause, amount);
+}
+
+/**
+ * @brief Make an effect event
+ * @param type The effect
+ * @param duration Its duration in turns
+ * @param speedModifier Its speed modifier, kept as a whole percentage
+ * @return The event
+ */
+CombatEvent CombatEvent::effectApplied(EffectType type, int duration, float speedModifier) {
+    CombatEvent event = make(Type::EFFECT_APPLIED, Cause::EFFECT, duration);
+    event.effect = static_cast<uint8_t>(type);
+    event.value = static_cast<int32_t>(std::lround(speedModifier * 100.0f));
+    return event;
+}
+
+/**
+ * @brief Make a card event
+ * @param card The card played
+ * @return The event
+ */
+CombatEvent CombatEvent::cardPlayed(CardId card) {
+    CombatEvent event = make(Type::CARD_PLAYED, Cause::CARD, 0);
+    event.card = card;
+    return event;
+}
+
+/**
+ * @brief Make a mana cost event
+ * @param amount Mana spent
+ * @return The event
+ */
+CombatEvent CombatEvent::manaSpent(int amount) {
+    return make(Type::MANA_SPENT, Cause::NONE, amount);
+}
+
+/**
+ * @brief Make a mana event
+ * @param amount Mana restored
+ * @param card Card that restored it
+ * @return The event
+ */
+CombatEvent CombatEvent::manaRestored(int amount, CardId card) {
+    CombatEvent event = make(Type::MANA_RESTORED, Cause::CARD, amount);
+    event.card = card;
+    return event;
+}
+
+/**
+ * @brief Make a defense event
+ * @param amount Defense gained
+ * @param card Card that raised it
+ * @return The event
+ */
+CombatEvent CombatEvent::defenseRaised(int amount, CardId card) {
+    CombatEvent event = make(Type::DEFENSE_RAISED, Cause::CARD, amount);
+    event.card = card;
+    return event;
+}
+
+/**
+ * @brief Make a level event
+ * @param level The new level
+ * @return The event
+ */
+CombatEvent CombatEvent::levelUp(int level) {
+    return make(Type::LEVEL_UP, Cause::NONE, level);
+}
+
+/**
+ * @brief Write the text of an event
+ * @param out Stream to write to
+ * @param sourceName Name of the acting character
+ * @param targetName Name of the affected character
+ */
+void CombatEvent::render(std::ostream& out, const std::string& sourceName, const std::string& targetName) const {
+    switch (type) {
+        case Type::DAMAGE:
+            switch (cause) {
+                case Cause::SWORD:
+                    out << sourceName << " attacks with a sword for " << amount << " damage!\n";
+                    break;
+                case Cause::STAFF:
+                    out << sourceName << " hits with a staff for " << amount << " damage!\n";
+                    break;
+                case Cause::ARROW:
+                    out << sourceName << " shoots an arrow at " << targetName << " for " << amount << " damage!\n";
+                    break;
+                case Cause::HEALING_STRIKE:
+                    out << sourceName << " heals while attacking for " << amount << " damage!\n";
+                    break;
+                case Cause::CARD:
+                    out << cardName(card) << " deals " << amount << " damage to " << targetName << "!\n";
+                    break;
+                case Cause::EFFECT:
+                    out << targetName << " takes " << amount << " damage from effect!\n";
+                    break;
+                default:
+                    out << sourceName << " attacks for " << amount << " damage!\n";
+                    break;
+            }
+            break;
+        case Type::HEAL:
+            if (cause == Cause::EFFECT) {
+                out << targetName << " heals " << amount << " from regeneration!\n";
+            } else {
+                out << sourceName << " heals " << targetName << " for " << amount << " points!\n";
+            }
+            break;
+        case Type::EFFECT_APPLIED:
+            switch (static_cast<EffectType>(effect)) {
+                case EffectType::SLOW:
+                    out << targetName << "'s speed reduced to " << value << "% for " << amount << " turns!\n";
+                    break;
+                case EffectType::BURN:
+                    out << targetName << " is burning for " << amount << " turns!\n";
+                    break;
+                case EffectType::POISON:
+                    out << targetName << " is poisoned for " << amount << " turns!\n";
+                    break;
+                case EffectType::REGENERATION:
+                    out << targetName << " regenerates for " << amount << " turns!\n";
+                    break;
+                default:
+                    break;
+            }
+            break;
+        case Type::CARD_PLAYED:
+            out << sourceName << " plays " << cardName(card) << "!\n";
+            break;
+        case Type::MANA_SPENT:
+            out << sourceName << " spends " << amount << " mana!\n";
+            break;
+        case Type::MANA_RESTORED:
+            out << cardName(card) << " restores " << amount << " mana to " << targetName << "!\n";
+            break;
+        case Type::DEFENSE_RAISED:
+            out << cardName(card) << " raises the defense of " << targetName << " by " << amount << "!\n";
+            break;
+        case Type::LEVEL_UP:
+            out << "\n=== LEVEL UP! ===\n"
+                << sourceName << " reached level " << amount << "!\n"
+                << "==================\n\n";
+            break;
+    }
+}
+
+/**
+ * @brief Constructor for CombatEventStream
+ * @param capacity Number of events to keep, rounded up to a power of two
+ */
+CombatEventStream::CombatEventStream(size_t capacity) : capacity(1) {
+    while (this->capacity < capacity) {
+        this->capacity <<= 1;
+    }
+}
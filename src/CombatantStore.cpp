@@ -0,0 +1,437 @@
+/**
+ * @file CombatantStore.cpp
+ * @brief Implementation of the CombatantStore class
+ * @details Contains the definitions of all methods declared in CombatantStore.h
+ */
+
+#include "CombatantStore.h"
+#include "Character.h"
+#include <algorithm>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define CARD_RPG_HAS_AVX2_KERNEL 1
+#include <immintrin.h>
+#else
+#define CARD_RPG_HAS_AVX2_KERNEL 0
+#endif
+
+static_assert(sizeof(EffectType) == sizeof(int), "the AVX2 kernel gathers effect types as 32-bit lanes");
+
+#if CARD_RPG_HAS_AVX2_KERNEL
+namespace {
+    /**
+     * @brief Tick the effects of whole groups of eight combatants with AVX2
+     * @param health Health of each combatant
+     * @param damageReduction Defense subtracted from incoming damage
+     * @param effectCount Number of active effects of each combatant
+     * @param effectType Type of each effect slot
+     * @param effectDuration Remaining duration of each effect slot
+     * @param effectDamage Damage per turn of each effect slot
+     * @param effectHeal Healing per turn of each effect slot
+     * @param rows Number of combatants
+     * @param capacity Number of effect slots per combatant
+     * @return Number of leading combatants processed, a multiple of eight
+     * @details Each lane follows one combatant through its effect slots in
+     *          order, so damage and healing are clamped after every effect
+     *          exactly like in the scalar path. The durations of all slots of a
+     *          group, used or not, are decremented with plain vector arithmetic;
+     *          expired effects are left in place for the caller to drop.
+     */
+    __attribute__((target("avx2")))
+    size_t tickEffectsAvx2(int* health, const int* damageReduction, const uint32_t* effectCount,
+                           const int* effectType, int* effectDuration, const int* effectDamage,
+                           const int* effectHeal, size_t rows, size_t capacity) {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i maxHealth = _mm256_set1_epi32(Entity::MAX_HEALTH);
+        const __m256i burn = _mm256_set1_epi32(static_cast<int>(EffectType::BURN));
+        const __m256i poison = _mm256_set1_epi32(static_cast<int>(EffectType::POISON));
+        const __m256i regeneration = _mm256_set1_epi32(static_cast<int>(EffectType::REGENERATION));
+        const __m256i laneOffsets = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                                       _mm256_set1_epi32(static_cast<int>(capacity)));
+
+        size_t groups = rows / 8;
+        for (size_t group = 0; group < groups; ++group) {
+            size_t row = group * 8;
+            __m256i hp = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(health + row));
+            __m256i reduction = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(damageReduction + row));
+            __m256i count = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(effectCount + row));
+
+            uint32_t maxCount = 0;
+            for (size_t lane = 0; lane < 8; ++lane) {
+                maxCount = std::max(maxCount, effectCount[row + lane]);
+            }
+
+            const int* typeBase = effectType + row * capacity;
+            const int* damageBase = effectDamage + row * capacity;
+            const int* healBase = effectHeal + row * capacity;
+            for (uint32_t i = 0; i < maxCount; ++i) {
+                __m256i active = _mm256_cmpgt_epi32(count, _mm256_set1_epi32(static_cast<int>(i)));
+                __m256i index = _mm256_add_epi32(laneOffsets, _mm256_set1_epi32(static_cast<int>(i)));
+                __m256i type = _mm256_mask_i32gather_epi32(zero, typeBase, index, active, 4);
+                __m256i damage = _mm256_mask_i32gather_epi32(zero, damageBase, index, active, 4);
+                __m256i healing = _mm256_mask_i32gather_epi32(zero, healBase, index, active, 4);
+
+                __m256i hurts = _mm256_or_si256(_mm256_cmpeq_epi32(type, burn), _mm256_cmpeq_epi32(type, poison));
+                hurts = _mm256_andnot_si256(_mm256_cmpgt_epi32(zero, damage), _mm256_and_si256(hurts, active));
+                __m256i dealt = _mm256_max_epi32(_mm256_sub_epi32(damage, reduction), zero);
+                __m256i hurt = _mm256_max_epi32(_mm256_sub_epi32(hp, dealt), zero);
+                hp = _mm256_blendv_epi8(hp, hurt, hurts);
+
+                __m256i heals = _mm256_and_si256(_mm256_cmpeq_epi32(type, regeneration), active);
+                heals = _mm256_andnot_si256(_mm256_cmpgt_epi32(zero, healing), heals);
+                __m256i healed = _mm256_min_epi32(_mm256_add_epi32(hp, healing), maxHealth);
+                hp = _mm256_blendv_epi8(hp, healed, heals);
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(health + row), hp);
+
+            int* duration = effectDuration + row * capacity;
+            for (size_t slot = 0; slot < 8 * capacity; slot += 8) {
+                __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(duration + slot));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(duration + slot), _mm256_sub_epi32(value, one));
+            }
+        }
+        return groups * 8;
+    }
+}
+#endif
+
+/**
+ * @brief Reserve room for a number of combatants
+ * @param count Expected number of combatants
+ */
+void CombatantStore::reserve(size_t count) {
+    names.reserve(count);
+    health.reserve(count);
+    mana.reserve(count);
+    defense.reserve(count);
+    damageReduction.reserve(count);
+    attackPower.reserve(count);
+    level.reserve(count);
+    effectCount.reserve(count);
+    effectType.reserve(count * effectCapacity);
+    effectSpeedModifier.reserve(count * effectCapacity);
+    effectDuration.reserve(count * effectCapacity);
+    effectDamage.reserve(count * effectCapacity);
+    effectHeal.reserve(count * effectCapacity);
+}
+
+/**
+ * @brief Remove all combatants
+ * @details Keeps the allocated memory so the store can be refilled cheaply
+ */
+void CombatantStore::clear() {
+    names.clear();
+    health.clear();
+    mana.clear();
+    defense.clear();
+    damageReduction.clear();
+    attackPower.clear();
+    level.clear();
+    effectCount.clear();
+    effectType.clear();
+    effectSpeedModifier.clear();
+    effectDuration.clear();
+    effectDamage.clear();
+    effectHeal.clear();
+}
+
+/**
+ * @brief Add a combatant with the given stats
+ * @param name Combatant name
+ * @param hp Initial health
+ * @param mp Initial mana
+ * @param attack Attack power
+ * @param def Defense value, also subtracted from incoming damage
+ * @return Handle of the new combatant
+ */
+CombatantHandle CombatantStore::add(const std::string& name, int hp, int mp, int attack, int def) {
+    CombatantHandle handle{static_cast<uint32_t>(size())};
+    names.push_back(name);
+    health.push_back(std::clamp(hp, 0, Entity::MAX_HEALTH));
+    mana.push_back(std::clamp(mp, 0, Entity::MAX_MANA));
+    defense.push_back(std::max(def, 0));
+    damageReduction.push_back(std::max(def, 0));
+    attackPower.push_back(attack);
+    level.push_back(1);
+    effectCount.push_back(0);
+
+    size_t slots = effectType.size() + effectCapacity;
+    effectType.resize(slots, EffectType::NONE);
+    effectSpeedModifier.resize(slots, 1.0f);
+    effectDuration.resize(slots, 0);
+    effectDamage.resize(slots, 0);
+    effectHeal.resize(slots, 0);
+    return handle;
+}
+
+/**
+ * @brief Add a snapshot of a character
+ * @param character The character to copy
+ * @return Handle of the new combatant
+ * @details Character shadows Entity's defense: getDefense() reports its own
+ *          field, while takeDamage() still subtracts Entity's. Both are kept.
+ */
+CombatantHandle CombatantStore::add(const Character& character) {
+    CombatantHandle handle = add(character.getName(), character.getHealth(), character.getMana(),
+                                 character.getAttackPower(), character.getDefense());
+    damageReduction[handle.index] = character.Entity::defense;
+    level[handle.index] = character.getLevel();
+    for (const auto& effect : character.getActiveEffects()) {
+        applyEffect(handle, effect.type, effect.speedModifier, effect.duration,
+                    effect.damagePerTurn, effect.healPerTurn);
+    }
+    return handle;
+}
+
+/**
+ * @brief Copy a combatant's state back into a character
+ * @param handle The combatant to copy
+ * @param character The character to update
+ */
+void CombatantStore::writeBack(CombatantHandle handle, Character& character) const {
+    character.health = health[handle.index];
+    character.mana = mana[handle.index];
+    character.Character::defense = defense[handle.index];
+    character.Entity::defense = damageReduction[handle.index];
+    character.attackPower = attackPower[handle.index];
+
+    character.activeEffects.clear();
+    for (size_t i = 0; i < effectCount[handle.index]; ++i) {
+        character.activeEffects.push_back(getEffect(handle, i));
+    }
+}
+
+/**
+ * @brief Get an active effect of a combatant
+ * @param handle The combatant
+ * @param i Position of the effect, in the order it was applied
+ * @return Copy of the effect
+ */
+ActiveEffect CombatantStore::getEffect(CombatantHandle handle, size_t i) const {
+    size_t slot = handle.index * effectCapacity + i;
+    return ActiveEffect(effectType[slot], effectSpeedModifier[slot], effectDuration[slot],
+                        effectDamage[slot], effectHeal[slot]);
+}
+
+/**
+ * @brief Apply damage to a combatant
+ * @param handle The combatant
+ * @param damage Damage before defense
+ * @details Negative damage is ignored, defense is subtracted and health
+ *          does not drop below 0
+ */
+void CombatantStore::takeDamage(CombatantHandle handle, int damage) {
+    if (damage < 0) return;
+    int actualDamage = std::max(damage - damageReduction[handle.index], 0);
+    health[handle.index] = std::max(health[handle.index] - actualDamage, 0);
+}
+
+/**
+ * @brief Apply the same damage to a combatant several times
+ * @param handle The combatant
+ * @param damage Damage of each hit before defense
+ * @param hits Number of hits
+ */
+void CombatantStore::takeRepeatedDamage(CombatantHandle handle, int damage, int hits) {
+    if (damage < 0 || hits <= 0) return;
+    int64_t actualDamage = static_cast<int64_t>(std::max(damage - damageReduction[handle.index], 0)) * hits;
+    health[handle.index] = static_cast<int>(std::max<int64_t>(health[handle.index] - actualDamage, 0));
+}
+
+/**
+ * @brief Heal a combatant
+ * @param handle The combatant
+ * @param amount Amount of health to restore
+ * @details Negative amounts are ignored and health does not exceed the maximum
+ */
+void CombatantStore::heal(CombatantHandle handle, int amount) {
+    if (amount < 0) return;
+    health[handle.index] = std::min(health[handle.index] + amount, Entity::MAX_HEALTH);
+}
+
+/**
+ * @brief Reduce the mana of a combatant
+ * @param handle The combatant
+ * @param amount Amount of mana to consume
+ */
+void CombatantStore::reduceMana(CombatantHandle handle, int amount) {
+    mana[handle.index] = std::clamp(mana[handle.index] - amount, 0, Entity::MAX_MANA);
+}
+
+/**
+ * @brief Apply an effect to a combatant
+ * @param handle The combatant
+ * @param type Effect type
+ * @param speedMod Speed modifier
+ * @param duration Duration in turns
+ * @param damage Damage per turn
+ * @param healing Healing per turn
+ * @details Doubles the slots of every combatant if this one has none left
+ */
+void CombatantStore::applyEffect(CombatantHandle handle, EffectType type, float speedMod, int duration,
+                                 int damage, int healing) {
+    if (effectCount[handle.index] == effectCapacity) {
+        growEffectCapacity(effectCapacity * 2);
+    }
+    size_t slot = handle.index * effectCapacity + effectCount[handle.index]++;
+    effectType[slot] = type;
+    effectSpeedModifier[slot] = speedMod;
+    effectDuration[slot] = duration;
+    effectDamage[slot] = damage;
+    effectHeal[slot] = healing;
+}
+
+/**
+ * @brief Tick the active effects of a combatant
+ * @param handle The combatant
+ * @details Effects are processed in the order they were applied: each loses
+ *          a turn, BURN and POISON deal damage and REGENERATION heals.
+ *          Expired effects are dropped afterwards.
+ */
+void CombatantStore::updateEffects(CombatantHandle handle) {
+    auto range = getEffectRange(handle);
+    for (size_t slot = range.first; slot < range.second; ++slot) {
+        effectDuration[slot]--;
+
+        switch (effectType[slot]) {
+            case EffectType::BURN:
+            case EffectType::POISON:
+                takeDamage(handle, effectDamage[slot]);
+                break;
+            case EffectType::REGENERATION:
+                heal(handle, effectHeal[slot]);
+                break;
+            default:
+                break;
+        }
+    }
+    compactEffects(handle.index);
+}
+
+/**
+ * @brief Tick the active effects of every combatant
+ * @param kernel Implementation to use
+ * @details The AVX2 kernel covers whole groups of eight combatants; the
+ *          remaining rows and CPUs without AVX2 use the scalar path
+ */
+void CombatantStore::updateAllEffects(TickKernel kernel) {
+    size_t row = 0;
+#if CARD_RPG_HAS_AVX2_KERNEL
+    if (kernel == TickKernel::AUTO && hasSimdKernel()) {
+        row = tickEffectsAvx2(health.data(), damageReduction.data(), effectCount.data(),
+                              reinterpret_cast<const int*>(effectType.data()), effectDuration.data(),
+                              effectDamage.data(), effectHeal.data(), size(), effectCapacity);
+        for (size_t done = 0; done < row; ++done) {
+            compactEffects(done);
+        }
+    }
+#endif
+    for (; row < size(); ++row) {
+        updateEffects(CombatantHandle{static_cast<uint32_t>(row)});
+    }
+}
+
+/**
+ * @brief Check whether the AVX2 effect kernel can run on this CPU
+ * @return True if updateAllEffects() uses AVX2 with TickKernel::AUTO
+ */
+bool CombatantStore::hasSimdKernel() {
+#if CARD_RPG_HAS_AVX2_KERNEL
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Drop the expired effects of a combatant
+ * @param row Row of the combatant
+ * @details Moves every effect with turns left towards the start of the
+ *          combatant's range in a single pass
+ */
+void CombatantStore::compactEffects(size_t row) {
+    size_t first = row * effectCapacity;
+    size_t last = first + effectCount[row];
+    size_t kept = first;
+
+    for (size_t slot = first; slot < last; ++slot) {
+        if (effectDuration[slot] > 0) {
+            if (kept != slot) {
+                effectType[kept] = effectType[slot];
+                effectSpeedModifier[kept] = effectSpeedModifier[slot];
+                effectDuration[kept] = effectDuration[slot];
+                effectDamage[kept] = effectDamage[slot];
+                effectHeal[kept] = effectHeal[slot];
+            }
+            ++kept;
+        }
+    }
+    effectCount[row] = static_cast<uint32_t>(kept - first);
+}
+
+/**
+ * @brief Get the combined speed modifier of a combatant
+ * @param handle The combatant
+ * @return Product of the modifiers of all SLOW effects
+ */
+float CombatantStore::getSpeedModifier(CombatantHandle handle) const {
+    float total = 1.0f;
+    auto range = getEffectRange(handle);
+    for (size_t slot = range.first; slot < range.second; ++slot) {
+        if (effectType[slot] == EffectType::SLOW) {
+            total *= effectSpeedModifier[slot];
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Perform a basic attack
+ * @param attacker The attacking combatant
+ * @param target The attacked combatant
+ * @return Damage dealt before the target's defense, 0 if the target was dead
+ * @details Attack power is scaled by the attacker's speed modifier
+ */
+int CombatantStore::attack(CombatantHandle attacker, CombatantHandle target) {
+    if (!isAlive(target)) {
+        return 0;
+    }
+    int damage = static_cast<int>(attackPower[attacker.index] * getSpeedModifier(attacker));
+    takeDamage(target, damage);
+    return damage;
+}
+
+/**
+ * @brief Give every combatant more effect slots
+ * @param capacity New number of slots per combatant
+ * @details Moves each combatant's effects to the start of its new range
+ */
+void CombatantStore::growEffectCapacity(size_t capacity) {
+    size_t slots = size() * capacity;
+    std::vector<EffectType> types(slots, EffectType::NONE);
+    std::vector<float> speedModifiers(slots, 1.0f);
+    std::vector<int> durations(slots, 0);
+    std::vector<int> damages(slots, 0);
+    std::vector<int> heals(slots, 0);
+
+    for (size_t row = 0; row < size(); ++row) {
+        size_t from = row * effectCapacity;
+        size_t to = row * capacity;
+        for (size_t i = 0; i < effectCount[row]; ++i) {
+            types[to + i] = effectType[from + i];
+            speedModifiers[to + i] = effectSpeedModifier[from + i];
+            durations[to + i] = effectDuration[from + i];
+            damages[to + i] = effectDamage[from + i];
+            heals[to + i] = effectHeal[from + i];
+        }
+    }
+
+    effectType = std::move(types);
+    effectSpeedModifier = std::move(speedModifiers);
+    effectDuration = std::move(durations);
+    effectDamage = std::move(damages);
+    effectHeal = std::move(heals);
+    effectCapacity = capacity;
+}
@@ -0,0 +1,264 @@
+/**
+ * @file CommandLog.cpp
+ * @brief Implementation of the CommandLog class
+ * @details Contains the definitions of all methods declared in CommandLog.h
+ */
+
+#include "CommandLog.h"
+#include "Character.h"
+#include "Deck.h"
+#include "Inventory.h"
+
+/**
+ * @brief Append a command, dropping the undone ones
+ * @param command The command
+ * @details Shrinking the vector keeps its capacity, so a log that has
+ *          reserved enough room never allocates
+ */
+void CommandLog::push(const Command& command) {
+    commands.resize(applied);
+    commands.push_back(command);
+    applied++;
+}
+
+/**
+ * @brief Record a change of an integer field
+ * @param field The field
+ * @param value Its new value
+ */
+void CommandLog::recordField(int& field, int value) {
+    Command command;
+    command.type = Command::Type::FIELD;
+    command.object = &field;
+    command.before = field;
+    command.after = value;
+    push(command);
+}
+
+/**
+ * @brief Record that an effect was appended to a character
+ * @param character The character, with the effect already appended
+ */
+void CommandLog::recordEffectApplied(Character& character) {
+    Command command;
+    command.type = Command::Type::EFFECT_APPLIED;
+    command.object = &character;
+    command.effect = character.activeEffects.back();
+    push(command);
+}
+
+/**
+ * @brief Record that every effect of a character lost one turn
+ * @param character The character
+ */
+void CommandLog::recordEffectsTicked(Character& character) {
+    Command command;
+    command.type = Command::Type::EFFECTS_TICKED;
+    command.object = &character;
+    push(command);
+}
+
+/**
+ * @brief Record that an effect expired
+ * @param character The character, with the effect already removed
+ * @param index Position the effect had
+ * @param effect The removed effect
+ */
+void CommandLog::recordEffectExpired(Character& character, size_t index, const ActiveEffect& effect) {
+    Command command;
+    command.type = Command::Type::EFFECT_EXPIRED;
+    command.object = &character;
+    command.index = static_cast<uint32_t>(index);
+    command.effect = effect;
+    push(command);
+}
+
+/**
+ * @brief Record that the top card was drawn from a deck
+ * @param deck The deck, with the card already drawn
+ * @param card The drawn card
+ */
+void CommandLog::recordCardDrawn(Deck& deck, CardId card) {
+    Command command;
+    command.type = Command::Type::CARD_DRAWN;
+    command.object = &deck;
+    command.card = card;
+    push(command);
+}
+
+/**
+ * @brief Record that a card was removed from a deck
+ * @param deck The deck, with the card already removed
+ * @param index Position the card had
+ * @param card The removed card
+ */
+void CommandLog::recordCardRemoved(Deck& deck, size_t index, CardId card) {
+    Command command;
+    command.type = Command::Type::CARD_REMOVED;
+    command.object = &deck;
+    command.index = static_cast<uint32_t>(index);
+    command.card = card;
+    push(command);
+}
+
+/**
+ * @brief Record that an item was removed from an inventory
+ * @param inventory The inventory, with the item already removed
+ * @param index Position the item had
+ * @param item The removed item
+ */
+void CommandLog::recordItemRemoved(Inventory& inventory, size_t index, Item* item) {
+    Command command;
+    command.type = Command::Type::ITEM_REMOVED;
+    command.object = &inventory;
+    command.index = static_cast<uint32_t>(index);
+    command.item = item;
+    push(command);
+}
+
+/**
+ * @brief Mark the start of a turn
+ */
+void CommandLog::markTurn() {
+    push(Command());
+}
+
+/**
+ * @brief Undo the most recent applied command
+ * @return False if there was nothing to undo
+ */
+bool CommandLog::undo() {
+    if (applied == 0) {
+        return false;
+    }
+    revert(commands[--applied]);
+    return true;
+}
+
+/**
+ * @brief Redo the oldest undone command
+ * @return False if there was nothing to redo
+ */
+bool CommandLog::redo() {
+    if (applied == commands.size()) {
+        return false;
+    }
+    reapply(commands[applied++]);
+    return true;
+}
+
+/**
+ * @brief Undo commands until the log is at a position
+ * @param target Position returned by position() earlier
+ */
+void CommandLog::undoTo(size_t target) {
+    while (applied > target) {
+        undo();
+    }
+}
+
+/**
+ * @brief Undo everything since the most recent turn mark, including the mark
+ * @return False if no turn mark was applied
+ */
+bool CommandLog::undoTurn() {
+    size_t mark = applied;
+    while (mark > 0 && commands[mark - 1].type != Command::Type::TURN) {
+        mark--;
+    }
+    if (mark == 0) {
+        return false;
+    }
+    undoTo(mark - 1);
+    return true;
+}
+
+/**
+ * @brief Redo the next undone turn
+ * @return False if there was no undone turn mark
+ */
+bool CommandLog::redoTurn() {
+    if (applied == commands.size() || commands[applied].type != Command::Type::TURN) {
+        return false;
+    }
+    do {
+        redo();
+    } while (applied < commands.size() && commands[applied].type != Command::Type::TURN);
+    return true;
+}
+
+/**
+ * @brief Reverse a command
+ * @param command The command
+ */
+void CommandLog::revert(const Command& command) {
+    switch (command.type) {
+        case Command::Type::FIELD:
+            *static_cast<int*>(command.object) = command.before;
+            break;
+        case Command::Type::EFFECT_APPLIED:
+            static_cast<Character*>(command.object)->activeEffects.pop_back();
+            break;
+        case Command::Type::EFFECTS_TICKED:
+            for (auto& effect : static_cast<Character*>(command.object)->activeEffects) {
+                effect.duration++;
+            }
+            break;
+        case Command::Type::EFFECT_EXPIRED: {
+            auto& effects = static_cast<Character*>(command.object)->activeEffects;
+            effects.insert(effects.begin() + command.index, command.effect);
+            break;
+        }
+        case Command::Type::CARD_DRAWN:
+            static_cast<Deck*>(command.object)->addCard(command.card);
+            break;
+        case Command::Type::CARD_REMOVED:
+            static_cast<Deck*>(command.object)->insertCard(command.index, command.card);
+            break;
+        case Command::Type::ITEM_REMOVED: {
+            auto& items = static_cast<Inventory*>(command.object)->items;
+            items.insert(items.begin() + command.index, command.item);
+            break;
+        }
+        case Command::Type::TURN:
+            break;
+    }
+}
+
+/**
+ * @brief Perform a command again
+ * @param command The command
+ */
+void CommandLog::reapply(const Command& command) {
+    switch (command.type) {
+        case Command::Type::FIELD:
+            *static_cast<int*>(command.object) = command.after;
+            break;
+        case Command::Type::EFFECT_APPLIED:
+            static_cast<Character*>(command.object)->activeEffects.push_back(command.effect);
+            break;
+        case Command::Type::EFFECTS_TICKED:
+            for (auto& effect : static_cast<Character*>(command.object)->activeEffects) {
+                effect.duration--;
+            }
+            break;
+        case Command::Type::EFFECT_EXPIRED: {
+            auto& effects = static_cast<Character*>(command.object)->activeEffects;
+            effects.erase(effects.begin() + command.index);
+            break;
+        }
+        case Command::Type::CARD_DRAWN:
+            static_cast<Deck*>(command.object)->drawCard();
+            break;
+        case Command::Type::CARD_REMOVED:
+            static_cast<Deck*>(command.object)->removeAt(command.index);
+            break;
+        case Command::Type::ITEM_REMOVED: {
+            auto& items = static_cast<Inventory*>(command.object)->items;
+            items.erase(items.begin() + command.index);
+            break;
+        }
+        case Command::Type::TURN:
+            break;
+    }
+}
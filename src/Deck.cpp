@@ -5,39 +5,192 @@
  */
 
 #include "Deck.h"
+#include "CardCatalog.h"
+#include "CommandLog.h"
+#include "GameContext.h"
 #include <algorithm>
+#include <stdexcept>
+
+/**
+ * @brief Constructor for a Deck holding the given cards
+ * @param ids The cards of the deck, bottom first
+ */
+Deck::Deck(std::initializer_list<CardId> ids) {
+    cards.reserve(ids.size());
+    for (CardId id : ids) {
+        addCard(id);
+    }
+}
 
 /**
  * @brief Add a card to the deck
  * @param card The card to be added
- * @details Adds the specified card to the end of the deck
+ * @details Adds a card of the same kind to the end of the deck
  */
 void Deck::addCard(std::shared_ptr<Card> card) {
-    cards.push_back(card);
+    if (!card) {
+        throw std::invalid_argument("Only catalog cards can be added to a deck");
+    }
+    addCard(card->getId());
+}
+
+/**
+ * @brief Add a card to the deck
+ * @param id The kind of card to be added
+ * @details Adds the card to the end of the deck
+ */
+void Deck::addCard(CardId id) {
+    size_t kind = static_cast<size_t>(id);
+    if (kind >= kindCounts.size()) {
+        throw std::invalid_argument("Only catalog cards can be added to a deck");
+    }
+    cards.push_back(id);
+    kindCounts[kind]++;
+}
+
+/**
+ * @brief Replace the contents of the deck
+ * @param ids The new cards, bottom first
+ * @param count Number of cards
+ * @details Validates every card before changing the deck, so a failed call
+ *          leaves it untouched
+ */
+void Deck::assign(const CardId* ids, size_t count) {
+    std::array<uint32_t, CardCatalog::size()> counts{};
+    for (size_t i = 0; i < count; ++i) {
+        size_t kind = static_cast<size_t>(ids[i]);
+        if (kind >= counts.size()) {
+            throw std::invalid_argument("Only catalog cards can be added to a deck");
+        }
+        counts[kind]++;
+    }
+    cards.assign(ids, ids + count);
+    kindCounts = counts;
 }
 
 /**
  * @brief Draw a card from the deck
  * @return The drawn card, or nullptr if the deck is empty
- * @details Removes and returns the top card from the deck
+ * @details Removes the top card from the deck and returns its prototype
  */
 std::shared_ptr<Card> Deck::drawCard() {
     if (!cards.empty()) {
-        std::shared_ptr<Card> card = cards.back();
+        CardId id = cards.back();
         cards.pop_back();
-        return card;
+        kindCounts[static_cast<size_t>(id)]--;
+        return CardCatalog::get(id);
     }
     return nullptr;
 }
 
+/**
+ * @brief Draw a card from the deck during combat
+ * @param context Session the card is drawn in
+ * @return The drawn card, or nullptr if the deck is empty
+ */
+std::shared_ptr<Card> Deck::drawCard(GameContext& context) {
+    if (cards.empty()) {
+        return nullptr;
+    }
+    CardId id = cards.back();
+    auto card = drawCard();
+    if (CommandLog* log = context.getCommandLog()) {
+        log->recordCardDrawn(*this, id);
+    }
+    return card;
+}
+
+/**
+ * @brief Get all cards in the deck
+ * @return Vector containing the prototypes of all cards in the deck
+ */
+std::vector<std::shared_ptr<Card>> Deck::getCards() const {
+    std::vector<std::shared_ptr<Card>> result;
+    result.reserve(cards.size());
+    for (CardId id : cards) {
+        result.push_back(CardCatalog::get(id));
+    }
+    return result;
+}
+
 /**
  * @brief Remove a specific card from the deck
  * @param card The card to be removed
- * @details Searches for and removes the specified card from the deck
+ * @details Searches for and removes a card of the same kind
  */
 void Deck::removeCard(std::shared_ptr<Card> card) {
-    auto it = std::find(cards.begin(), cards.end(), card);
-    if (it != cards.end()) {
-        cards.erase(it);
+    if (card) {
+        removeCard(card->getId());
     }
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Remove a specific card from the deck
+ * @param id The kind of card to be removed
+ * @details Removes the first card of this kind. The kind counts let a deck
+ *          without such a card answer without searching.
+ */
+void Deck::removeCard(CardId id) {
+    size_t index = find(id);
+    if (index != npos) {
+        removeAt(index);
+    }
+}
+
+/**
+ * @brief Remove a specific card from the deck during combat
+ * @param id The kind of card to be removed
+ * @param context Session the card is removed in
+ */
+void Deck::removeCard(CardId id, GameContext& context) {
+    size_t index = find(id);
+    if (index != npos) {
+        removeAt(index);
+        if (CommandLog* log = context.getCommandLog()) {
+            log->recordCardRemoved(*this, index, id);
+        }
+    }
+}
+
+/**
+ * @brief Insert a card at a position
+ * @param index Position of the new card, bottom first
+ * @param id The kind of card to insert
+ */
+void Deck::insertCard(size_t index, CardId id) {
+    size_t kind = static_cast<size_t>(id);
+    if (kind >= kindCounts.size()) {
+        throw std::invalid_argument("Only catalog cards can be added to a deck");
+    }
+    if (index > cards.size()) {
+        throw std::out_of_range("Card position is outside the deck");
+    }
+    cards.insert(cards.begin() + static_cast<std::ptrdiff_t>(index), id);
+    kindCounts[kind]++;
+}
+
+/**
+ * @brief Remove the card at a position
+ * @param index Position of the card, bottom first
+ * @details The cards above it move down by one, keeping the drawing order
+ */
+void Deck::removeAt(size_t index) {
+    if (index >= cards.size()) {
+        throw std::out_of_range("Card position is outside the deck");
+    }
+    kindCounts[static_cast<size_t>(cards[index])]--;
+    cards.erase(cards.begin() + static_cast<std::ptrdiff_t>(index));
+}
+
+/**
+ * @brief Find a card of a kind
+ * @param id The kind of card
+ * @return Position of the first card of this kind, or npos if there is none
+ * @details Returns without searching when the kind count is zero
+ */
+size_t Deck::find(CardId id) const {
+    if (!contains(id)) {
+        return npos;
+    }
+    return static_cast<size_t>(std::find(cards.begin(), cards.end(), id) - cards.begin());
+}
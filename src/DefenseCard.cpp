@@ -5,22 +5,23 @@
  */
 
 #include "DefenseCard.h"
-#include <iostream>
+#include "GameContext.h"
 
 /**
  * @brief Constructor for DefenseCard
  * @details Initializes a defense card with a predefined name and description
  */
 DefenseCard::DefenseCard()
-    : Card("Defense Card", "Creates a shield that absorbs 20 damage.") {}
+    : Card(CardId::DEFENSE, "Defense Card", "Creates a shield that absorbs 20 damage.") {}
 
 /**
  * @brief Implements the effect of playing a DefenseCard
  * @param target The entity targeted by the defense effect
+ * @param context Session the card is played in
  * @details Increases the target's defense by 20 points and displays a message
  */
-void DefenseCard::play(Entity& target) {
+void DefenseCard::play(Entity& target, GameContext& context) {
     int shieldAmount = 20;
     target.setDefense(target.getDefense() + shieldAmount);
-    std::cout << "Defense Card creates a shield for " << shieldAmount << " damage!" << std::endl;
+    context.emit(CombatEvent::defenseRaised(shieldAmount, getId()), nullptr, &target);
 }
\ No newline at end of file
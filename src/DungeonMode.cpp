@@ -10,25 +10,22 @@
 #include "Mage.h"
 #include "Archer.h"
 #include "BattleMode.h"
-#include "AttackCard.h"
-#include "Fireball.h"
 #include "EasyAI.h"
 #include "BossAI.h"
-#include "Regeneration.h"
-#include "DefenseCard.h"
 #include "AdvancedAI.h"
-#include "LightningCard.h"
 #include "Deck.h"
-#include <iostream>
+#include "GameContext.h"
+#include <optional>
 
 /**
  * @brief Constructor for DungeonMode
  * @param p Shared pointer to the player character
+ * @param autopilot Controller choosing the player's actions, or nullptr for interactive play
  * @details Initializes a dungeon with the player character and creates
  *          a set of predefined enemies with various difficulty levels and a boss
  */
-DungeonMode::DungeonMode(std::shared_ptr<Character> p)
-    : player(p) {}
+DungeonMode::DungeonMode(std::shared_ptr<Character> p, std::shared_ptr<ActionSource> autopilot)
+    : player(p), autopilot(autopilot) {}
 
 /**
  * @brief Starts the dungeon mode
@@ -36,9 +33,15 @@ DungeonMode::DungeonMode(std::shared_ptr<Character> p)
  *          Guides the player through multiple combat encounters against
  *          increasingly difficult enemies, culminating in a boss battle.
  *          Includes narrative elements and rewards the player for progress.
+ *          With an autopilot the whole run is headless.
  */
 void DungeonMode::start() {
-    std::cout << "You entered a dungeon! Prepare for battle..." << std::endl;
+    std::optional<GameContext::Mute> mute;
+    if (autopilot) {
+        mute.emplace(getContext());
+    }
+
+    getContext().out() << "You entered a dungeon! Prepare for battle...\n";
     generateEnemies();
     generateBoss();
     battlePhase();
@@ -134,12 +137,12 @@ void DungeonMode::addEnemy(const std::string& name, int health, int mana,
     
     switch (aiType) {
         case AI_Type::Easy:
-            deck->addCard(std::make_shared<AttackCard>());
+            deck->addCard(CardId::ATTACK);
             enemy->setAI(std::make_shared<EasyAI>(enemy));
             break;
         case AI_Type::Advanced:
-            deck->addCard(std::make_shared<Fireball>());
-            deck->addCard(std::make_shared<DefenseCard>());
+            deck->addCard(CardId::FIREBALL);
+            deck->addCard(CardId::DEFENSE);
             enemy->setAI(std::make_shared<AdvancedAI>(enemy, player, deck));
             break;
     }
@@ -152,17 +155,27 @@ void DungeonMode::addEnemy(const std::string& name, int health, int mana,
  * @brief Generates the dungeon boss
  * @details Creates a powerful boss character with a unique set of abilities.
  *          The boss is initialized as a high-level Mage with enhanced stats and
- *          a specialized deck of powerful cards. A BossAI is assigned to control
- *          the boss's behavior in battle.
+ *          a specialized deck of powerful cards. A BossAI with its search
+ *          enabled is assigned to control the boss's behavior in battle.
  */
 void DungeonMode::generateBoss() {
-    boss = std::make_shared<Mage>("Dragon Lord", 200, 150, 30, 20);
+    boss = createBoss();
     auto bossDeck = std::make_shared<Deck>();
-    bossDeck->addCard(std::make_shared<Fireball>());
-    bossDeck->addCard(std::make_shared<LightningCard>());
-    bossDeck->addCard(std::make_shared<Regeneration>());
+    bossDeck->addCard(CardId::FIREBALL);
+    bossDeck->addCard(CardId::LIGHTNING);
+    bossDeck->addCard(CardId::REGENERATION);
     boss->setDeck(bossDeck);
-    boss->setAI(std::make_shared<BossAI>(boss, player, bossDeck));
+    auto ai = std::make_shared<BossAI>(boss, player, bossDeck);
+    ai->enableSearch();
+    boss->setAI(ai);
+}
+
+/**
+ * @brief Creates the dungeon boss character
+ * @return The Dragon Lord, without deck or AI
+ */
+std::shared_ptr<Character> DungeonMode::createBoss() {
+    return std::make_shared<Mage>("Dragon Lord", 200, 150, 30, 20);
 }
 
 /**
@@ -173,34 +186,36 @@ void DungeonMode::generateBoss() {
  *          Displays appropriate messages based on battle outcomes.
  */
 void DungeonMode::battlePhase() {
-    std::cout << "Fighting enemies..." << std::endl;
+    getContext().out() << "Fighting enemies...\n";
 
     for (const auto& enemy : enemies) {
         if (!player->isAlive()) {
-            std::cout << "Player has been defeated! Game over." << std::endl;
+            getContext().out() << "Player has been defeated! Game over.\n";
             return;
         }
 
-        BattleMode battle(player, enemy);
+        BattleMode battle(player, enemy, autopilot);
+        battle.setContext(&getContext());
         battle.start();
 
         if (!enemy->isAlive()) {
-            std::cout << enemy->getName() << " has been defeated!" << std::endl;
+            getContext().out() << enemy->getName() << " has been defeated!\n";
         }
     }
 
     if (boss && player->isAlive()) {
-        std::cout << "Final battle against the boss!" << std::endl;
-        BattleMode finalBattle(player, boss);
+        getContext().out() << "Final battle against the boss!\n";
+        BattleMode finalBattle(player, boss, autopilot);
+        finalBattle.setContext(&getContext());
         finalBattle.start();
 
         if (!boss->isAlive()) {
-            std::cout << "Congratulations! You have defeated " << boss->getName() << "!" << std::endl;
+            getContext().out() << "Congratulations! You have defeated " << boss->getName() << "!\n";
         } else {
-            std::cout << "You have been defeated by " << boss->getName() << ". Game over." << std::endl;
+            getContext().out() << "You have been defeated by " << boss->getName() << ". Game over.\n";
         }
     } else if (!player->isAlive()) {
-        std::cout << "Player has been defeated! Game over." << std::endl;
+        getContext().out() << "Player has been defeated! Game over.\n";
     }
 }
 
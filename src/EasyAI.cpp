@@ -7,44 +7,50 @@
 
 #include "EasyAI.h"
 #include "AttackCard.h"
-#include <cstdlib>
-#include <ctime>
-#include <iostream>
+#include "GameContext.h"
+#include "Logger.h"
 
 /**
  * @brief Constructor for EasyAI
  * @param t Shared pointer to the target character
  * @details Initializes a basic AI controller with a reference to the target character
  */
-EasyAI::EasyAI(std::shared_ptr<Character> t) : target(t) {}
+EasyAI::EasyAI(std::shared_ptr<Character> t) : target(t) {
+    kind = AIKind::EASY;
+}
 
 /**
  * @brief Makes a decision for the AI-controlled character
  * @param self Reference to the character controlled by this AI
  * @param target Reference to the target entity
+ * @param context Session the decision is made in
  * @details Implements simple decision-making logic for the easy AI:
  *          - First tries to use cards from the deck if available
  *          - Falls back to basic attack if no cards are available
- *          - Initializes random seed on first call for any randomized decisions
  */
-void EasyAI::makeDecision(Character& self, Entity& target) {
-    static bool seeded = false;
-    if (!seeded) {
-        std::srand(std::time(nullptr));
-        seeded = true;
-    }
-
+void EasyAI::makeDecision(Character& self, Entity& target, GameContext& context) {
     if (auto deck = self.getDeck()) {
-        if (!deck->getCards().empty()) {
-            auto card = deck->drawCard();
+        if (!deck->empty()) {
+            auto card = deck->drawCard(context);
             if (card) {
-                std::cout << "[DEBUG] " << self.getName() << " uses a card!" << std::endl;
-                card->play(target);
+                context.emit(CombatEvent::cardPlayed(card->getId()), &self, &target);
+                card->play(target, context);
                 return;
             }
         }
     }
 
-    std::cout << "[DEBUG] " << self.getName() << " attacks!" << std::endl;
+    LOG_DEBUG(self.getName() << " attacks!");
     self.attack(target);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Check whether every decision from now on is a basic attack
+ * @param self The character controlled by this AI
+ * @return True once the character's deck is empty
+ * @details Cards are drawn, and so leave the deck, before any attack
+ */
+bool EasyAI::onlyAttacks(const Character& self) const {
+    auto deck = self.getDeck();
+    return !deck || deck->empty();
+}
@@ -0,0 +1,736 @@
+/**
+ * @file EndgameTablebase.cpp
+ * @brief Implementation of the EndgameTablebase class
+ * @details Contains the endgame model, the parallel retrograde solver, the
+ *          file layout and the definitions of all methods declared in
+ *          EndgameTablebase.h
+ */
+
+#include "EndgameTablebase.h"
+#include "Character.h"
+#include "Deck.h"
+#include "LightningCard.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+    /** @brief First bytes of every tablebase file */
+    constexpr char MAGIC[8] = {'C', 'R', 'P', 'G', 'E', 'G', 'T', 'B'};
+
+    /** @brief Version of the file layout */
+    constexpr uint32_t VERSION = 1;
+
+    /** @brief Written in native byte order to reject files from other machines */
+    constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    /** @brief Damage of a Fireball hit, as dealt by Fireball::play */
+    constexpr int FIREBALL_DAMAGE = 25;
+
+    /** @brief Mana a Mage spends on a Fireball attack */
+    constexpr int FIREBALL_MANA = 20;
+
+    /** @brief Damage per tick of a burn, as applied by BurningEffect */
+    constexpr int BURN_DAMAGE = 5;
+
+    /** @brief Healing per tick of Regeneration */
+    constexpr int REGENERATION_HEAL = 10;
+
+    /** @brief Ticks of a freshly played Regeneration */
+    constexpr int REGENERATION_TURNS = 3;
+
+    /** @brief Health the boss can regain from one Regeneration card */
+    constexpr int HEADROOM = REGENERATION_HEAL * REGENERATION_TURNS;
+
+    /** @brief Hand bit of a Fireball card */
+    constexpr int HAND_FIREBALL = 1;
+
+    /** @brief Hand bit of a Lightning card */
+    constexpr int HAND_LIGHTNING = 2;
+
+    /** @brief Hand bit of a Regeneration card */
+    constexpr int HAND_REGENERATION = 4;
+
+    /** @brief Number of hands: every subset of the three cards */
+    constexpr int HAND_STATES = 8;
+
+    /** @brief Burn bit of a stack with one tick left */
+    constexpr int BURN_LAST = 1;
+
+    /** @brief Burn bit of a stack with two ticks left, applied the round before */
+    constexpr int BURN_FRESH = 2;
+
+    /** @brief Number of burn combinations on the hero */
+    constexpr int BURN_STATES = 4;
+
+    /** @brief Regeneration ticks left on the boss: none, one or two */
+    constexpr int REGENERATION_STATES = REGENERATION_TURNS;
+
+    /** @brief Number of Fireball attacks the boss's mana can pay for, plus one */
+    constexpr int CHARGE_STATES = Entity::MAX_MANA / FIREBALL_MANA + 1;
+
+    /** @brief Expected battle length values are capped at, so zero-damage loops settle */
+    constexpr double MAX_ROUNDS = 1000.0;
+
+    /** @brief Win probabilities closer than this are equal when choosing a move */
+    constexpr double WIN_EPSILON = 1e-12;
+
+    /** @brief Battle lengths closer than this are equal when choosing a move */
+    constexpr double ROUND_EPSILON = 1e-9;
+
+    /**
+     * @struct TableEntry
+     * @brief Directory entry of one table
+     */
+    struct TableEntry {
+        /** @brief Hero health below which the table covers states */
+        int32_t healthLimit;
+
+        /** @brief EndgameRules::heroHit */
+        int32_t heroHit;
+
+        /** @brief EndgameRules::bossHit */
+        int32_t bossHit;
+
+        /** @brief EndgameRules::heroReduction */
+        int32_t heroReduction;
+
+        /** @brief EndgameRules::bossCastsFireballs, 0 or 1 */
+        int32_t bossCastsFireballs;
+
+        /** @brief Unused, zero */
+        int32_t reserved;
+
+        /** @brief Position of the table in the file, a multiple of PAGE_SIZE */
+        uint64_t offset;
+
+        /** @brief Length of the table in bytes */
+        uint64_t bytes;
+    };
+
+    /**
+     * @struct FileHeader
+     * @brief First page of a tablebase file
+     */
+    struct FileHeader {
+        /** @brief MAGIC */
+        char magic[8];
+
+        /** @brief VERSION */
+        uint32_t version;
+
+        /** @brief BYTE_ORDER_MARK */
+        uint32_t byteOrder;
+
+        /** @brief Number of tables */
+        uint32_t tableCount;
+
+        /** @brief Unused, zero */
+        uint32_t reserved;
+
+        /** @brief Directory of the tables */
+        TableEntry tables[EndgameTablebase::MAX_TABLES];
+    };
+
+    static_assert(sizeof(FileHeader) <= EndgameTablebase::PAGE_SIZE, "the directory fits in one page");
+
+    /**
+     * @struct Position
+     * @brief State of an endgame with the boss to move
+     */
+    struct Position {
+        /** @brief Hero health */
+        int hero;
+
+        /** @brief Boss health */
+        int boss;
+
+        /** @brief Fireball attacks left, always 0 for bosses that do not cast them */
+        int charges;
+
+        /** @brief Cards left in the boss deck, HAND_* bits */
+        int hand;
+
+        /** @brief Burns on the hero, BURN_* bits */
+        int burn;
+
+        /** @brief Regeneration ticks left on the boss */
+        int regen;
+    };
+
+    /**
+     * @class Layout
+     * @brief Numbering of the positions of one table
+     * @details Positions sharing a hero health are contiguous, so the
+     *          solver can work through the table one layer at a time
+     */
+    class Layout {
+    private:
+        /** @brief Hero health below which positions are covered */
+        int limit;
+
+    public:
+        /**
+         * @brief Constructor for Layout
+         * @param limit Hero health below which positions are covered
+         */
+        explicit Layout(int limit) : limit(limit) {}
+
+        /**
+         * @brief Get the number of boss health values
+         * @return Health range of the boss, room to regenerate included
+         */
+        int bossStates() const { return limit + HEADROOM; }
+
+        /**
+         * @brief Get the number of positions sharing a hero health
+         * @return Size of a layer
+         */
+        size_t layerSize() const {
+            return static_cast<size_t>(bossStates()) * CHARGE_STATES * HAND_STATES * BURN_STATES * REGENERATION_STATES;
+        }
+
+        /**
+         * @brief Get the number of positions
+         * @return Size of the table in positions
+         */
+        size_t size() const { return layerSize() * static_cast<size_t>(limit); }
+
+        /**
+         * @brief Get the length of the packed table in the file
+         * @return Two bits per position, rounded up to whole pages
+         */
+        size_t bytes() const {
+            size_t packed = (size() + 3) / 4;
+            return (packed + EndgameTablebase::PAGE_SIZE - 1) / EndgameTablebase::PAGE_SIZE * EndgameTablebase::PAGE_SIZE;
+        }
+
+        /**
+         * @brief Number a position
+         * @param p The position
+         * @return Its index in the table
+         */
+        size_t index(const Position& p) const {
+            size_t i = static_cast<size_t>(p.hero);
+            i = i * bossStates() + p.boss;
+            i = i * CHARGE_STATES + p.charges;
+            i = i * HAND_STATES + p.hand;
+            i = i * BURN_STATES + p.burn;
+            return i * REGENERATION_STATES + p.regen;
+        }
+
+        /**
+         * @brief Find the position of an index
+         * @param i Index in the table
+         * @return The position numbered i
+         */
+        Position position(size_t i) const {
+            Position p;
+            p.regen = static_cast<int>(i % REGENERATION_STATES);
+            i /= REGENERATION_STATES;
+            p.burn = static_cast<int>(i % BURN_STATES);
+            i /= BURN_STATES;
+            p.hand = static_cast<int>(i % HAND_STATES);
+            i /= HAND_STATES;
+            p.charges = static_cast<int>(i % CHARGE_STATES);
+            i /= CHARGE_STATES;
+            p.boss = static_cast<int>(i % bossStates());
+            p.hero = static_cast<int>(i / bossStates());
+            return p;
+        }
+    };
+
+    /**
+     * @struct Outcome
+     * @brief Value of a position or of a move
+     */
+    struct Outcome {
+        /** @brief Probability that the boss wins */
+        double win = 0.0;
+
+        /** @brief Expected number of rounds until the battle ends */
+        double rounds = 0.0;
+    };
+
+    /**
+     * @brief Check whether one outcome is preferable to another
+     * @param a Candidate outcome
+     * @param b Best outcome so far
+     * @return True if a wins more often, or as often and sooner when
+     *         winning is possible, or as often and later when it is not
+     */
+    bool better(const Outcome& a, const Outcome& b) {
+        if (a.win > b.win + WIN_EPSILON) return true;
+        if (a.win < b.win - WIN_EPSILON) return false;
+        return a.win > WIN_EPSILON ? a.rounds < b.rounds - ROUND_EPSILON : a.rounds > b.rounds + ROUND_EPSILON;
+    }
+
+    /**
+     * @class Solver
+     * @brief Solves one table by retrograde analysis
+     * @details Rounds follow BattleEngine with the hero as the player. A
+     *          position is the moment the boss answers: its move lands, the
+     *          hero's burns tick, the boss's Regeneration ticks, and the
+     *          hero opens the next round with a basic attack.
+     */
+    class Solver {
+    private:
+        /** @brief Pairing the table is solved for */
+        EndgameRules rules;
+
+        /** @brief Numbering of the positions */
+        Layout layout;
+
+        /** @brief Boss win probability of every position */
+        std::vector<double> win;
+
+        /** @brief Expected battle length of every position */
+        std::vector<double> rounds;
+
+        /** @brief Best move of every position */
+        std::vector<uint8_t> moves;
+
+    public:
+        /**
+         * @brief Constructor for Solver
+         * @param rules Pairing to solve
+         * @param limit Hero health below which positions are covered
+         */
+        Solver(const EndgameRules& rules, int limit)
+            : rules(rules), layout(limit), win(layout.size(), 0.0), rounds(layout.size(), 0.0),
+              moves(layout.size(), 0) {}
+
+        /**
+         * @brief Solve every position
+         * @param threads Number of worker threads
+         * @details A layer only depends on itself and on the layers below
+         *          it, which are final by the time it is solved. Within the
+         *          layer, workers sweep disjoint ranges, reading the values of
+         *          the previous sweep, until a sweep changes nothing. The
+         *          workers are started once for the table and handed one
+         *          sweep after another.
+         */
+        void solve(unsigned threads) {
+            size_t layerSize = layout.layerSize();
+            std::vector<double> nextWin(layerSize);
+            std::vector<double> nextRounds(layerSize);
+            std::vector<char> changed(threads);
+            size_t chunk = (layerSize + threads - 1) / threads;
+            WorkerPool pool(threads - 1);
+
+            for (size_t first = layerSize; first < layout.size(); first += layerSize) {
+                std::function<void(unsigned)> job = [&](unsigned t) {
+                    size_t begin = std::min(t * chunk, layerSize);
+                    size_t end = std::min(begin + chunk, layerSize);
+                    changed[t] = sweep(first, begin, end, nextWin, nextRounds);
+                };
+                for (bool settled = false; !settled;) {
+                    pool.run(job);
+                    std::copy(nextWin.begin(), nextWin.end(), win.begin() + first);
+                    std::copy(nextRounds.begin(), nextRounds.end(), rounds.begin() + first);
+                    settled = std::none_of(changed.begin(), changed.end(), [](char c) { return c != 0; });
+                }
+            }
+        }
+
+        /**
+         * @brief Pack the moves two bits each
+         * @return The table as stored in the file, without page padding
+         */
+        std::vector<uint8_t> pack() const {
+            std::vector<uint8_t> packed((moves.size() + 3) / 4, 0);
+            for (size_t i = 0; i < moves.size(); ++i) {
+                packed[i / 4] |= static_cast<uint8_t>(moves[i] << (2 * (i % 4)));
+            }
+            return packed;
+        }
+
+    private:
+        /**
+         * @brief Evaluate one range of a layer
+         * @param first Index of the first position of the layer
+         * @param begin Start of the range within the layer
+         * @param end End of the range within the layer
+         * @param nextWin Receives the new win probabilities of the layer
+         * @param nextRounds Receives the new battle lengths of the layer
+         * @return True if any value of the range changed
+         */
+        bool sweep(size_t first, size_t begin, size_t end,
+                   std::vector<double>& nextWin, std::vector<double>& nextRounds) {
+            bool changed = false;
+            for (size_t i = begin; i < end; ++i) {
+                size_t index = first + i;
+                Position p = layout.position(index);
+                Outcome best;
+                uint8_t bestMove = 0;
+                if (p.boss > 0) {
+                    best = play(p, EndgameTablebase::Move::ATTACK);
+                    const EndgameTablebase::Move cards[] = {EndgameTablebase::Move::FIREBALL,
+                                                            EndgameTablebase::Move::LIGHTNING,
+                                                            EndgameTablebase::Move::REGENERATION};
+                    const int bits[] = {HAND_FIREBALL, HAND_LIGHTNING, HAND_REGENERATION};
+                    for (int c = 0; c < 3; ++c) {
+                        if (p.hand & bits[c]) {
+                            Outcome outcome = play(p, cards[c]);
+                            if (better(outcome, best)) {
+                                best = outcome;
+                                bestMove = static_cast<uint8_t>(cards[c]);
+                            }
+                        }
+                    }
+                }
+                if (std::fabs(best.win - win[index]) > WIN_EPSILON ||
+                    std::fabs(best.rounds - rounds[index]) > ROUND_EPSILON) {
+                    changed = true;
+                }
+                nextWin[i] = best.win;
+                nextRounds[i] = best.rounds;
+                moves[index] = bestMove;
+            }
+            return changed;
+        }
+
+        /**
+         * @brief Evaluate a move
+         * @param p Position the boss moves in
+         * @param move The move; cards must be in the hand
+         * @return Expected outcome of the move
+         */
+        Outcome play(const Position& p, EndgameTablebase::Move move) const {
+            switch (move) {
+                case EndgameTablebase::Move::ATTACK:
+                    if (rules.bossCastsFireballs && p.charges > 0) {
+                        return follow(p, p.hero - reduced(FIREBALL_DAMAGE), p.hand, p.charges - 1, true, false);
+                    }
+                    return follow(p, p.hero - rules.bossHit, p.hand, p.charges, false, false);
+                case EndgameTablebase::Move::FIREBALL:
+                    return follow(p, p.hero - reduced(FIREBALL_DAMAGE), p.hand & ~HAND_FIREBALL, p.charges, true, false);
+                case EndgameTablebase::Move::LIGHTNING: {
+                    Outcome total;
+                    int outcomes = LightningCard::MAX_DAMAGE - LightningCard::MIN_DAMAGE + 1;
+                    for (int damage = LightningCard::MIN_DAMAGE; damage <= LightningCard::MAX_DAMAGE; ++damage) {
+                        Outcome outcome = follow(p, p.hero - reduced(damage), p.hand & ~HAND_LIGHTNING,
+                                                 p.charges, false, false);
+                        total.win += outcome.win / outcomes;
+                        total.rounds += outcome.rounds / outcomes;
+                    }
+                    return total;
+                }
+                case EndgameTablebase::Move::REGENERATION:
+                    return follow(p, p.hero, p.hand & ~HAND_REGENERATION, p.charges, false, true);
+            }
+            return Outcome();
+        }
+
+        /**
+         * @brief Finish the round after the boss's move
+         * @param p Position the boss moved in
+         * @param hero Hero health after the move
+         * @param hand Cards left after the move
+         * @param charges Fireball attacks left after the move
+         * @param burned Whether the move set the hero on fire
+         * @param regenerated Whether the move was Regeneration
+         * @return Outcome from the end of the move on
+         */
+        Outcome follow(const Position& p, int hero, int hand, int charges, bool burned, bool regenerated) const {
+            if (hero <= 0) {
+                return {1.0, 1.0};
+            }
+            int stacks = (p.burn & BURN_LAST ? 1 : 0) + (p.burn & BURN_FRESH ? 1 : 0) + (burned ? 1 : 0);
+            hero -= stacks * reduced(BURN_DAMAGE);
+            if (hero <= 0) {
+                return {1.0, 1.0};
+            }
+
+            int heal = p.regen > 0 ? REGENERATION_HEAL : 0;
+            int regen = std::max(p.regen - 1, 0);
+            if (regenerated) {
+                heal += REGENERATION_HEAL;
+                regen = REGENERATION_TURNS - 1;
+            }
+            int boss = std::min({p.boss + heal, Entity::MAX_HEALTH, layout.bossStates() - 1}) - rules.heroHit;
+            if (boss <= 0) {
+                return {0.0, 1.0};
+            }
+
+            Position next{hero, boss, charges, hand, (burned ? BURN_FRESH : 0) | (p.burn & BURN_FRESH ? BURN_LAST : 0), regen};
+            size_t index = layout.index(next);
+            return {win[index], std::min(rounds[index] + 1.0, MAX_ROUNDS)};
+        }
+
+        /**
+         * @brief Apply the hero's defense to card and effect damage
+         * @param damage Damage before defense
+         * @return Damage the hero takes
+         */
+        int reduced(int damage) const { return std::max(damage - rules.heroReduction, 0); }
+    };
+
+    /**
+     * @brief Find the position of a live endgame
+     * @param boss The boss
+     * @param hero The hero
+     * @param deck Cards the boss can still play
+     * @param limit Hero health below which the table covers positions
+     * @param castsFireballs Whether the boss's attacks spend mana on Fireballs
+     * @param p Receives the position
+     * @return False if the battle is outside the endgame model
+     */
+    bool positionOf(const Character& boss, const Character& hero, const Deck& deck, int limit,
+                    bool castsFireballs, Position& p) {
+        p.hero = hero.getHealth();
+        p.boss = boss.getHealth();
+        if (p.hero >= limit) {
+            return false;
+        }
+
+        size_t fireballs = deck.count(CardId::FIREBALL);
+        size_t lightnings = deck.count(CardId::LIGHTNING);
+        size_t regenerations = deck.count(CardId::REGENERATION);
+        if (fireballs > 1 || lightnings > 1 || regenerations > 1 ||
+            fireballs + lightnings + regenerations != deck.size()) {
+            return false;
+        }
+        p.hand = (fireballs ? HAND_FIREBALL : 0) | (lightnings ? HAND_LIGHTNING : 0) |
+                 (regenerations ? HAND_REGENERATION : 0);
+
+        p.burn = 0;
+        for (const auto& effect : hero.getActiveEffects()) {
+            int bit = effect.duration == 1 ? BURN_LAST : effect.duration == 2 ? BURN_FRESH : 0;
+            if (effect.type != EffectType::BURN || effect.damagePerTurn != BURN_DAMAGE ||
+                effect.healPerTurn != 0 || effect.speedModifier != 1.0f || bit == 0 || (p.burn & bit)) {
+                return false;
+            }
+            p.burn |= bit;
+        }
+
+        p.regen = 0;
+        for (const auto& effect : boss.getActiveEffects()) {
+            if (effect.type != EffectType::REGENERATION || effect.healPerTurn != REGENERATION_HEAL ||
+                effect.damagePerTurn != 0 || effect.speedModifier != 1.0f ||
+                effect.duration < 1 || effect.duration >= REGENERATION_STATES || p.regen != 0) {
+                return false;
+            }
+            p.regen = effect.duration;
+        }
+        if (p.regen > 0 && (p.hand & HAND_REGENERATION)) {
+            return false;
+        }
+
+        int potential = p.regen + (p.hand & HAND_REGENERATION ? REGENERATION_TURNS : 0);
+        if (p.boss + potential * REGENERATION_HEAL >= limit + HEADROOM) {
+            return false;
+        }
+
+        p.charges = castsFireballs ? boss.getMana() / FIREBALL_MANA : 0;
+        return p.charges < CHARGE_STATES;
+    }
+}
+
+/**
+ * @brief Work out the rules of a pairing
+ * @param boss The boss
+ * @param hero The hero it fights
+ * @param rules Receives the rules
+ * @return False if the hero's attack is not a fixed amount of damage
+ * @details Attacks follow the attack() of each class: a Warrior's is
+ *          lowered by the target's reported defense, Archer, Healer and
+ *          Mage staff hits use the attack power, and plain characters scale
+ *          it by their speed modifier; the target's defense then applies.
+ */
+bool EndgameRules::between(const Character& boss, const Character& hero, EndgameRules& rules) {
+    if (hero.getKind() == EntityKind::MAGE) {
+        return false;
+    }
+
+    auto basicDamage = [](const Character& attacker, const Character& target) {
+        switch (attacker.getKind()) {
+            case EntityKind::WARRIOR:
+                return std::max(attacker.getAttackPower() - target.getDefense(), 0);
+            case EntityKind::MAGE:
+            case EntityKind::ARCHER:
+            case EntityKind::HEALER:
+                return attacker.getAttackPower();
+            default:
+                return static_cast<int>(attacker.getAttackPower() * attacker.getCurrentSpeedModifier());
+        }
+    };
+
+    rules.heroReduction = hero.Entity::defense;
+    rules.heroHit = std::max(basicDamage(hero, boss) - boss.Entity::defense, 0);
+    rules.bossHit = std::max(basicDamage(boss, hero) - rules.heroReduction, 0);
+    rules.bossCastsFireballs = boss.getKind() == EntityKind::MAGE;
+    return true;
+}
+
+/**
+ * @brief Destructor for EndgameTablebase
+ */
+EndgameTablebase::~EndgameTablebase() {
+    close();
+}
+
+/**
+ * @brief Map a tablebase file
+ * @param path File to map
+ * @throws std::runtime_error if the file cannot be mapped or is not a tablebase
+ */
+void EndgameTablebase::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open tablebase " + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < PAGE_SIZE) {
+        ::close(fd);
+        throw std::runtime_error("Tablebase " + path + " is too short");
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Cannot map tablebase " + path);
+    }
+
+    const FileHeader& header = *static_cast<const FileHeader*>(mapping);
+    bool valid = std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == VERSION &&
+                 header.byteOrder == BYTE_ORDER_MARK && header.tableCount <= MAX_TABLES;
+    for (uint32_t i = 0; valid && i < header.tableCount; ++i) {
+        const TableEntry& table = header.tables[i];
+        valid = table.healthLimit > 1 && table.healthLimit + HEADROOM <= Entity::MAX_HEALTH + 1 &&
+                table.offset % PAGE_SIZE == 0 && table.offset >= PAGE_SIZE && table.offset <= size &&
+                table.bytes <= size - table.offset && table.bytes >= Layout(table.healthLimit).bytes();
+    }
+    if (!valid) {
+        munmap(mapping, size);
+        throw std::runtime_error(path + " is not a tablebase");
+    }
+
+    data = static_cast<const uint8_t*>(mapping);
+    length = size;
+}
+
+/**
+ * @brief Unmap the file
+ */
+void EndgameTablebase::close() {
+    if (data) {
+        munmap(const_cast<uint8_t*>(data), length);
+        data = nullptr;
+        length = 0;
+    }
+}
+
+/**
+ * @brief Get the number of tables in the file
+ * @return Number of tables, 0 if no file is open
+ */
+size_t EndgameTablebase::tableCount() const {
+    return data ? reinterpret_cast<const FileHeader*>(data)->tableCount : 0;
+}
+
+/**
+ * @brief Look up the best boss move
+ * @param boss The boss, about to move
+ * @param hero The hero it fights
+ * @param bossDeck Cards the boss can still play
+ * @param move Receives the move on a hit
+ * @return False if the state or the pairing is not covered
+ * @details Picks the first table whose rules match the live characters
+ */
+bool EndgameTablebase::lookup(const Character& boss, const Character& hero, const Deck& bossDeck, Move& move) const {
+    EndgameRules rules;
+    if (!data || !boss.isAlive() || !hero.isAlive() || !EndgameRules::between(boss, hero, rules)) {
+        return false;
+    }
+
+    const FileHeader& header = *reinterpret_cast<const FileHeader*>(data);
+    for (uint32_t i = 0; i < header.tableCount; ++i) {
+        const TableEntry& table = header.tables[i];
+        if (table.heroHit != rules.heroHit || table.bossHit != rules.bossHit ||
+            table.heroReduction != rules.heroReduction ||
+            (table.bossCastsFireballs != 0) != rules.bossCastsFireballs) {
+            continue;
+        }
+
+        Position p;
+        if (!positionOf(boss, hero, bossDeck, table.healthLimit, rules.bossCastsFireballs, p)) {
+            return false;
+        }
+        size_t index = Layout(table.healthLimit).index(p);
+        uint8_t packed = data[table.offset + index / 4];
+        move = static_cast<Move>((packed >> (2 * (index % 4))) & 3);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Solve tables and write them to a file
+ * @param path File to write
+ * @param rules Pairings to solve, one table each
+ * @param healthLimit Health of both sides below which states are covered
+ * @param threads Number of worker threads, 0 for one per hardware thread
+ * @throws std::invalid_argument for invalid rules or limit
+ * @throws std::runtime_error if the file cannot be written
+ */
+void EndgameTablebase::generate(const std::string& path, const std::vector<EndgameRules>& rules,
+                                int healthLimit, unsigned threads) {
+    if (rules.empty() || rules.size() > MAX_TABLES) {
+        throw std::invalid_argument("A tablebase holds between 1 and " + std::to_string(MAX_TABLES) + " tables");
+    }
+    if (healthLimit < 2 || healthLimit + HEADROOM > Entity::MAX_HEALTH + 1) {
+        throw std::invalid_argument("Health limit out of range");
+    }
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    Layout layout(healthLimit);
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.tableCount = static_cast<uint32_t>(rules.size());
+    for (size_t i = 0; i < rules.size(); ++i) {
+        TableEntry& table = header.tables[i];
+        table.healthLimit = healthLimit;
+        table.heroHit = rules[i].heroHit;
+        table.bossHit = rules[i].bossHit;
+        table.heroReduction = rules[i].heroReduction;
+        table.bossCastsFireballs = rules[i].bossCastsFireballs ? 1 : 0;
+        table.offset = PAGE_SIZE + i * layout.bytes();
+        table.bytes = layout.bytes();
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Cannot write tablebase " + path);
+    }
+    std::vector<char> page(PAGE_SIZE, 0);
+    std::memcpy(page.data(), &header, sizeof(header));
+    file.write(page.data(), static_cast<std::streamsize>(page.size()));
+
+    for (const EndgameRules& pairing : rules) {
+        Solver solver(pairing, healthLimit);
+        solver.solve(threads);
+        std::vector<uint8_t> packed = solver.pack();
+        packed.resize(layout.bytes(), 0);
+        file.write(reinterpret_cast<const char*>(packed.data()), static_cast<std::streamsize>(packed.size()));
+    }
+    if (!file.flush()) {
+        throw std::runtime_error("Cannot write tablebase " + path);
+    }
+}
@@ -5,6 +5,8 @@
  */
 
 #include "Entity.h"
+#include "CommandLog.h"
+#include "GameContext.h"
 #include <algorithm>
 
 /**
@@ -13,13 +15,15 @@
  * @param health Initial health points
  * @param mana Initial mana points
  * @param defense Initial defense value
- * @details Initializes an entity with provided values, clamping them to valid ranges
+ * @details Initializes an entity with provided values, clamping them to valid ranges,
+ *          and numbers it in the calling thread's default session
  */
 Entity::Entity(const std::string& name, int health, int mana, int defense)
     : name(name),
       health(std::clamp(health, 0, MAX_HEALTH)),
       mana(std::clamp(mana, 0, MAX_MANA)),
-      defense(std::max(defense, 0)) {}
+      defense(std::max(defense, 0)),
+      actorId(GameContext::threadDefault().takeActorId()) {}
 
 /**
  * @brief Heal the entity by a specified amount
@@ -28,7 +32,7 @@ Entity::Entity(const std::string& name, int health, int mana, int defense)
  */
 void Entity::heal(int amount) {
     if (amount < 0) return;
-    health = std::min(health + amount, MAX_HEALTH);
+    assignField(health, std::min(health + amount, MAX_HEALTH));
 }
 
 /**
@@ -39,7 +43,7 @@ void Entity::heal(int amount) {
 void Entity::takeDamage(int damage) {
     if (damage < 0) return;
     int actualDamage = std::max(damage - defense, 0);
-    health = std::max(health - actualDamage, 0);
+    assignField(health, std::max(health - actualDamage, 0));
 }
 
 /**
@@ -48,7 +52,7 @@ void Entity::takeDamage(int damage) {
  * @details Updates the defense value, ensuring it's not negative
  */
 void Entity::setDefense(int def) {
-    defense = std::max(def, 0);
+    assignField(defense, std::max(def, 0));
 }
 
 /**
@@ -73,7 +77,7 @@ int Entity::getMana() const {
  * @details Decreases mana by the specified amount, ensuring it stays in valid range
  */
 void Entity::reduceMana(int amount) {
-    mana = std::clamp(mana - amount, 0, MAX_MANA);
+    assignField(mana, std::clamp(mana - amount, 0, MAX_MANA));
 }
 
 /**
@@ -83,5 +87,47 @@ void Entity::reduceMana(int amount) {
  */
 void Entity::restoreHealth(int amount) {
     if (amount < 0) return;
-    health = std::min(health + amount, MAX_HEALTH);
-}
\ No newline at end of file
+    assignField(health, std::min(health + amount, MAX_HEALTH));
+}
+
+/**
+ * @brief Bind the entity to a game session
+ * @param newContext Context of the session, nullptr for the thread default
+ * @return The previously bound context, nullptr if there was none
+ * @details Messages, random draws and card plays made on behalf of the
+ *          entity go through the bound context. Moving to another session
+ *          numbers the entity again in that session, so the actor ids of its
+ *          events are unique there.
+ */
+GameContext* Entity::setContext(GameContext* newContext) {
+    GameContext* previous = context;
+    GameContext& current = getContext();
+    context = newContext;
+    if (&getContext() != &current) {
+        actorId = getContext().takeActorId();
+    }
+    return previous;
+}
+
+/**
+ * @brief Get the context of the session the entity takes part in
+ * @return The bound context, or the calling thread's default context
+ */
+GameContext& Entity::getContext() const {
+    return context ? *context : GameContext::threadDefault();
+}
+/**
+ * @brief Change an integer field of the entity
+ * @param field The field
+ * @param value Its new value
+ * @details Unchanged values are not recorded
+ */
+void Entity::assignField(int& field, int value) {
+    if (field == value) {
+        return;
+    }
+    if (CommandLog* log = getContext().getCommandLog()) {
+        log->recordField(field, value);
+    }
+    field = value;
+}
@@ -7,29 +7,24 @@
 
 #include "ExplorationMode.h"
 #include "BattleMode.h"
-#include "AttackCard.h"
-#include "DefenseCard.h"
-#include "Fireball.h"
-#include "IceSpike.h"
 #include "Warrior.h"
 #include "Mage.h"
 #include "Archer.h"
 #include "EasyAI.h"
-#include "Shield.h"
+#include "GameContext.h"
 #include <iostream>
-#include <cstdlib>
-#include <ctime>
+#include <optional>
 
 /**
  * @brief Constructor for ExplorationMode
  * @param p Shared pointer to the player character
- * @details Initializes the exploration mode with the player character
- *          and seeds the random number generator for encounter generation
+ * @param autopilot Controller choosing the player's actions, or nullptr for interactive play
+ * @details Initializes the exploration mode with the player character.
+ *          Encounters are drawn from the random number generator of the
+ *          session the mode runs in.
  */
-ExplorationMode::ExplorationMode(std::shared_ptr<Character> p)
-    : player(p) {
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
-}
+ExplorationMode::ExplorationMode(std::shared_ptr<Character> p, std::shared_ptr<ActionSource> autopilot)
+    : player(p), autopilot(autopilot) {}
 
 /**
  * @brief Starts the exploration mode
@@ -61,49 +56,57 @@ void ExplorationMode::start() {
  * @details Creates a random event for the player during exploration.
  *          Possible events include: finding new cards, encountering enemies,
  *          discovering health potions, or nothing happening.
- *          Combat encounters are handled through the BattleMode class.
+ *          Combat encounters are handled through the BattleMode class,
+ *          headless when an autopilot is set.
  */
 void ExplorationMode::generateRandomEvent() {
-    int event = std::rand() % 4;
+    GameContext& context = getContext();
+    std::optional<GameContext::Mute> mute;
+    if (autopilot) {
+        mute.emplace(context);
+    }
+
+    int event = context.randomInt(0, 3);
     std::shared_ptr<Character> enemy;
     switch (event) {
         case 0: {
-            std::cout << "You found an Attack Card!\n";
-            player->getDeck()->addCard(std::make_shared<AttackCard>());
+            context.out() << "You found an Attack Card!\n";
+            player->getDeck()->addCard(CardId::ATTACK);
             break;
         }
         case 1: {
-            std::cout << "You found a Defense Card!\n";
-            player->getDeck()->addCard(std::make_shared<DefenseCard>());
+            context.out() << "You found a Defense Card!\n";
+            player->getDeck()->addCard(CardId::DEFENSE);
             break;
         }
         case 2: {
-            std::cout << "An enemy attacks you!\n";
+            context.out() << "An enemy attacks you!\n";
             auto enemy = generateRandomEnemy();
             
             #ifdef TESTING
             // В тестовой среде используем тестовый режим для BattleMode
-            BattleMode battle(player, enemy, true);
+            BattleMode battle = autopilot ? BattleMode(player, enemy, autopilot) : BattleMode(player, enemy, true);
             #else
-            BattleMode battle(player, enemy);
+            BattleMode battle(player, enemy, autopilot);
             #endif
             
+            battle.setContext(&context);
             battle.start();
 
             if (!enemy->isAlive()) {
-                std::cout << "Enemy defeated! Gained 30 EXP.\n";
-                std::cout << "Total kills: " << player->getKills() << "\n";
+                context.out() << "Enemy defeated! Gained 30 EXP.\n";
+                context.out() << "Total kills: " << player->getKills() << "\n";
             }
 
             break;
         }
         case 3: {
-            std::cout << "You found a health potion!\n";
+            context.out() << "You found a health potion!\n";
             player->heal(20);
             break;
         }
         default:
-            std::cout << "Nothing happens.\n";
+            context.out() << "Nothing happens.\n";
             break;
     }
 }
@@ -117,7 +120,7 @@ void ExplorationMode::generateRandomEvent() {
  *          The enemy's AI is also initialized for combat.
  */
 std::shared_ptr<Character> ExplorationMode::generateRandomEnemy() {
-    int enemyType = std::rand() % 3;
+    int enemyType = getContext().randomInt(0, 2);
     std::shared_ptr<Character> enemy;
 
     switch (enemyType) {
@@ -136,7 +139,7 @@ std::shared_ptr<Character> ExplorationMode::generateRandomEnemy() {
     }
 
     auto enemyDeck = std::make_shared<Deck>();
-    enemyDeck->addCard(std::make_shared<AttackCard>());
+    enemyDeck->addCard(CardId::ATTACK);
     enemy->setDeck(enemyDeck);
 
     
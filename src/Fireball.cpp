@@ -5,30 +5,30 @@
  */
 
 #include "Fireball.h"
-#include "BurningEffect.h"
+#include "CardCatalog.h"
 #include "Character.h"
-#include <iostream>
+#include "GameContext.h"
 
 /**
  * @brief Constructor for Fireball
  * @details Initializes a fireball card with a predefined name and description
  */
 Fireball::Fireball()
-    : Card("Fireball", "Deals 25 damage and applies a burning effect.") {}
+    : Card(CardId::FIREBALL, "Fireball", "Deals 25 damage and applies a burning effect.") {}
 
 /**
  * @brief Implements the effect of playing a Fireball card
  * @param target The entity targeted by the fireball
+ * @param context Session the card is played in
  * @details Deals 25 damage to the target and applies a burning effect
  *          that continues to damage the target over several turns
  */
-void Fireball::play(Entity& target) {
+void Fireball::play(Entity& target, GameContext& context) {
     if (!target.isAlive()) return;
         
     int damage = 25;
     target.takeDamage(damage);
-    std::cout << "Fireball deals " << damage << " damage to " << target.getName() << "!" << std::endl;
+    context.emit(CombatEvent::damage(CombatEvent::Cause::CARD, damage, getId()), nullptr, &target);
     
-    BurningEffect burningEffect;
-    burningEffect.play(target);
+    CardCatalog::get(CardId::BURNING_EFFECT)->play(target, context);
 }
\ No newline at end of file
@@ -0,0 +1,132 @@
+/**
+ * @file GameContext.cpp
+ * @brief Implementation of the GameContext class
+ * @details Contains the definitions of all methods declared in GameContext.h
+ */
+
+#include "GameContext.h"
+#include "Entity.h"
+#include <iostream>
+#include <random>
+#include <thread>
+
+/**
+ * @brief Constructor for an interactive GameContext
+ * @details Seeds the session from std::random_device, writes combat
+ *          messages to std::cout and runs on the real clock
+ */
+GameContext::GameContext()
+    : GameContext((static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}(),
+                  &std::cout, ClockMode::REAL_TIME) {}
+
+/**
+ * @brief Constructor for GameContext
+ * @param seed Seed all random streams of the session are derived from
+ * @param sink Stream for combat messages, nullptr to discard them
+ * @param clockMode How the session clock advances
+ * @details Draws made outside of any battle come from the stream of battle 0
+ */
+GameContext::GameContext(uint64_t seed, std::ostream* sink, ClockMode clockMode)
+    : random(seed), stream(random.stream(0, 0)), sink(sink), nullStream(nullptr), clockMode(clockMode),
+      startTime(std::chrono::steady_clock::now()) {}
+
+/**
+ * @brief Get the context of the current thread
+ * @return A context private to the calling thread
+ * @details The context is created on first use in each thread, so threads
+ *          that never touch it pay nothing and never share its state
+ */
+GameContext& GameContext::threadDefault() {
+    thread_local GameContext context;
+    return context;
+}
+
+/**
+ * @brief Start drawing from the streams of a new battle
+ * @return The identifier assigned to the battle
+ */
+uint64_t GameContext::beginBattle() {
+    uint64_t id = nextBattleId;
+    beginBattle(id);
+    return id;
+}
+
+/**
+ * @brief Start drawing from the streams of a given battle
+ * @param id Identifier of the battle, must not be 0
+ * @details Switches to the stream of turn 0, which covers draws made
+ *          while the battle is being set up
+ */
+void GameContext::beginBattle(uint64_t id) {
+    battleId = id;
+    nextBattleId = id + 1;
+    beginTurn(0);
+}
+
+/**
+ * @brief Number an entity of the session
+ * @return An actor id no other entity numbered by the session holds, never 0
+ * @details The counter skips 0 when it wraps around
+ */
+uint32_t GameContext::takeActorId() {
+    uint32_t id = nextActorId++;
+    if (nextActorId == 0) {
+        nextActorId = 1;
+    }
+    return id;
+}
+
+/**
+ * @brief Record a combat event
+ * @param event The event; its actor ids are filled in here
+ * @param source The acting character, nullptr if none
+ * @param target The affected character, nullptr if none
+ */
+void GameContext::emit(CombatEvent event, const Entity* source, const Entity* target) {
+    static const std::string nobody;
+    event.source = source ? source->getActorId() : 0;
+    event.target = target ? target->getActorId() : 0;
+    events.push(event);
+    if (sink) {
+        event.render(*sink, source ? source->getName() : nobody, target ? target->getName() : nobody);
+    }
+}
+
+/**
+ * @brief Wait as part of an animation or pacing delay
+ * @param duration Length of the delay
+ */
+void GameContext::sleepFor(std::chrono::milliseconds duration) {
+    if (clockMode == ClockMode::REAL_TIME) {
+        std::this_thread::sleep_for(duration);
+    } else {
+        virtualTime += duration;
+    }
+}
+
+/**
+ * @brief Get the time elapsed in this session
+ * @return Wall time since creation, or accumulated delays on a virtual clock
+ */
+std::chrono::milliseconds GameContext::elapsed() const {
+    if (clockMode == ClockMode::VIRTUAL) {
+        return virtualTime;
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime);
+}
+
+/**
+ * @brief Constructor for Mute
+ * @param context The context to silence
+ */
+GameContext::Mute::Mute(GameContext& context) : context(context), previous(context.getSink()) {
+    context.setSink(nullptr);
+}
+
+/**
+ * @brief Destructor for Mute
+ * @details Restores the sink the context had before this guard was created
+ */
+GameContext::Mute::~Mute() {
+    context.setSink(previous);
+}
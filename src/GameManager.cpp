@@ -10,16 +10,6 @@
 #include "TradingMode.h"
 #include "DungeonMode.h"
 #include "ExplorationMode.h"
-#include "AttackCard.h"
-#include "DefenseCard.h"
-#include "Fireball.h"
-#include "IceSpike.h"
-#include "Poison.h"
-#include "LightningCard.h"
-#include "TrapCard.h"
-#include "SpecialCard.h"
-#include "Regeneration.h"
-#include "Shield.h"
 #include "Warrior.h"
 #include "PvPMode.h"
 #include "Mage.h"
@@ -28,6 +18,8 @@
 #include "HealthPotion.h"
 #include "ManaElixir.h"
 #include "UI.h"
+#include "Logger.h"
+#include <fstream>
 #include <iostream>
 
 /**
@@ -58,44 +50,81 @@ std::shared_ptr<Character> createPlayer(bool testMode) {
 
     switch (choice) {
         case 1:
-            return std::make_shared<Warrior>(name, 200, 50, 20, 10);
+            return createCharacter("Warrior", name);
         case 2:
-            return std::make_shared<Mage>(name, 100, 100, 15, 5);
+            return createCharacter("Mage", name);
         case 3:
-            return std::make_shared<Archer>(name, 150, 50, 18, 8);
+            return createCharacter("Archer", name);
         case 4:
-            return std::make_shared<Healer>(name, 120, 80, 10, 10);
+            return createCharacter("Healer", name);
         default:
             std::cout << "Invalid choice. Defaulting to Warrior.\n";
-            return std::make_shared<Warrior>(name, 200, 50, 20, 10);
+            return createCharacter("Warrior", name);
     }
 }
 
+/**
+ * @brief Creates a character of the given class
+ * @param className One of "Warrior", "Mage", "Archer" or "Healer"
+ * @param name The character's name
+ * @return A shared pointer to the created Character, or nullptr for an unknown class
+ * @details Every class starts with its standard stats, the same ones
+ *          the player gets when choosing that class in createPlayer
+ */
+std::shared_ptr<Character> createCharacter(const std::string& className, const std::string& name) {
+    if (className == "Warrior") {
+        return std::make_shared<Warrior>(name, 200, 50, 20, 10);
+    }
+    if (className == "Mage") {
+        return std::make_shared<Mage>(name, 100, 100, 15, 5);
+    }
+    if (className == "Archer") {
+        return std::make_shared<Archer>(name, 150, 50, 18, 8);
+    }
+    if (className == "Healer") {
+        return std::make_shared<Healer>(name, 120, 80, 10, 10);
+    }
+    return nullptr;
+}
+
 /**
  * @brief Constructor for GameManager
  * @param p Shared pointer to the player character
  * @details Initializes a GameManager with the player character and creates
  *          a trader NPC. Sets up the initial game state and welcome message.
+ *          Maps the boss endgame tablebase if EndgameTablebase::DEFAULT_PATH
+ *          exists; a broken file is reported and ignored.
  */
 GameManager::GameManager(std::shared_ptr<Character> p)
     : player(p), currentMode(nullptr), isGameRunning(true) 
 {
+    if (std::ifstream(EndgameTablebase::DEFAULT_PATH)) {
+        try {
+            endgame.open(EndgameTablebase::DEFAULT_PATH);
+            context.setEndgameTablebase(&endgame);
+        } catch (const std::exception& e) {
+            LOG_WARNING("Ignoring endgame tablebase: " << e.what());
+        }
+    }
+
+    player->setContext(&context);
     trader = std::make_shared<Warrior>("Trader", 100, 0, 0, 0);
+    trader->setContext(&context);
     auto traderDeck = std::make_shared<Deck>();
-    traderDeck->addCard(std::make_shared<AttackCard>());
-    traderDeck->addCard(std::make_shared<DefenseCard>());
-    traderDeck->addCard(std::make_shared<Fireball>());
-    traderDeck->addCard(std::make_shared<IceSpike>());
-    traderDeck->addCard(std::make_shared<Poison>());
-    traderDeck->addCard(std::make_shared<LightningCard>());
-    traderDeck->addCard(std::make_shared<TrapCard>());
-    traderDeck->addCard(std::make_shared<SpecialCard>());
-    traderDeck->addCard(std::make_shared<Regeneration>());
-    traderDeck->addCard(std::make_shared<Shield>());
+    traderDeck->addCard(CardId::ATTACK);
+    traderDeck->addCard(CardId::DEFENSE);
+    traderDeck->addCard(CardId::FIREBALL);
+    traderDeck->addCard(CardId::ICE_SPIKE);
+    traderDeck->addCard(CardId::POISON);
+    traderDeck->addCard(CardId::LIGHTNING);
+    traderDeck->addCard(CardId::TRAP);
+    traderDeck->addCard(CardId::SPECIAL);
+    traderDeck->addCard(CardId::REGENERATION);
+    traderDeck->addCard(CardId::SHIELD);
     trader->setDeck(traderDeck);
 
-    player->getInventory()->addItem(new HealthPotion());
-    player->getInventory()->addItem(new ManaElixir());
+    player->getInventory()->addItem(std::make_unique<HealthPotion>());
+    player->getInventory()->addItem(std::make_unique<ManaElixir>());
 }
 
 /**
@@ -118,24 +147,30 @@ void GameManager::run() {
         switch (choice) {
             case 1:                        
                 currentMode = std::make_shared<BattleMode>(player, std::make_shared<Warrior>("Goblin", 50, 0, 10, 5));
+                currentMode->setContext(&context);
                 currentMode->start();
                 break;
             case 2: {
                 currentMode = std::make_shared<TradingMode>(player, trader);
+                currentMode->setContext(&context);
                 currentMode->start();
                 break;
             }
             case 3:
                 currentMode = std::make_shared<DungeonMode>(player);
+                currentMode->setContext(&context);
                 currentMode->start();
                 break;
             case 4:
                 currentMode = std::make_shared<ExplorationMode>(player);
+                currentMode->setContext(&context);
                 currentMode->start();
                 break;
             case 5: {
                 auto player2 = createPlayer();
+                player2->setContext(&context);
                 currentMode = std::make_shared<PvPMode>(player, player2);
+                currentMode->setContext(&context);
                 currentMode->start();
                 break;
             }
@@ -167,6 +202,7 @@ void GameManager::switchMode(std::shared_ptr<GameMode> mode) {
  */
 void GameManager::runTestMode() {
     currentMode = std::make_shared<BattleMode>(player, std::make_shared<Warrior>("TestEnemy", 50, 0, 10, 5));
+    currentMode->setContext(&context);
     currentMode->start();
 
     if (!player->isAlive()) {
@@ -1,8 +1,17 @@
-/**
- * @file GameMode.cpp
- * @brief Implementation of the GameMode class
- * @details Contains the minimal implementation of the abstract GameMode class,
- *          which serves as a base for all specific game modes
- */
-
-#include "GameMode.h"
\ No newline at end of file
+/**
+ * @file GameMode.cpp
+ * @brief Implementation of the GameMode class
+ * @details Contains the minimal implementation of the abstract GameMode class,
+ *          which serves as a base for all specific game modes
+ */
+
+#include "GameMode.h"
+#include "GameContext.h"
+
+/**
+ * @brief Get the context of the session the mode runs in
+ * @return The bound context, or the calling thread's default context
+ */
+GameContext& GameMode::getContext() const {
+    return context ? *context : GameContext::threadDefault();
+}
\ No newline at end of file
@@ -6,10 +6,10 @@
  */
 
 #include "Healer.h"
-#include "Regeneration.h"
-#include "SpecialCard.h"
 #include "HealthPotion.h"
 #include "Inventory.h"
+#include "GameContext.h"
+#include "Logger.h"
 #include <iostream>
 
 /**
@@ -25,17 +25,16 @@
  */
 Healer::Healer(const std::string& name, int health, int mana, int attackPower, int defense)
     : Character(name, health, mana, attackPower, defense) {
-    deck = std::make_shared<Deck>();
-    deck->addCard(std::make_shared<Regeneration>());
-    deck->addCard(std::make_shared<SpecialCard>());
+    kind = EntityKind::HEALER;
+    deck = std::make_shared<Deck>(Deck{CardId::REGENERATION, CardId::SPECIAL});
 
     setInventory(std::make_shared<Inventory>());
 
     auto inventory = getInventory();
     if (inventory) {
-        inventory->addItem(new HealthPotion());
+        inventory->addItem(std::make_unique<HealthPotion>());
     } else {
-        std::cerr << "Inventory is not initialized!" << std::endl;
+        LOG_ERROR("Inventory is not initialized!");
     }
 }
 
@@ -48,19 +47,19 @@ Healer::Healer(const std::string& name, int health, int mana, int attackPower, i
 void Healer::attack(Entity& target) {
     int damage = getAttackPower();
     target.takeDamage(damage);
-    std::cout << getName() << " heals while attacking for " << damage << " damage!" << std::endl;
+    getContext().emit(CombatEvent::damage(CombatEvent::Cause::HEALING_STRIKE, damage), this, &target);
 }
 
 /**
  * @brief Heals an ally character
  * @param ally The ally character to heal
  * @details Restores a fixed amount of health (20) to the specified ally,
- *          displaying a message about the healing performed.
+ *          emitting a healing event.
  */
 void Healer::healAllies(Character& ally) {
     int healingAmount = 20;
     ally.heal(healingAmount);
-    std::cout << getName() << " heals " << ally.getName() << " for " << healingAmount << " points!" << std::endl;
+    getContext().emit(CombatEvent::heal(CombatEvent::Cause::ABILITY, healingAmount), this, &ally);
 }
 
 /**
@@ -74,10 +73,11 @@ void Healer::healAllies(Character& ally) {
 void Healer::useAbility(Ability& ability, Entity& target) {
     if (getMana() >= ability.getManaCost()) {
         reduceMana(ability.getManaCost());
+        getContext().emit(CombatEvent::manaSpent(ability.getManaCost()), this, nullptr);
         ability.activate(*this, target);
-        std::cout << getName() << " uses " << ability.getName() << "!" << std::endl;
+        getContext().out() << getName() << " uses " << ability.getName() << "!\n";
     } else {
-        std::cout << "Not enough mana to use " << ability.getName() << "!" << std::endl;
+        getContext().out() << "Not enough mana to use " << ability.getName() << "!\n";
     }
 }
 
@@ -102,22 +102,22 @@ void Healer::performAIAction() {
     if (auto target = getTarget()) {
         if (target->isAlive()) {
             if (auto deck = getDeck()) {
-                if (!deck->getCards().empty()) {
-                    auto card = deck->drawCard();
+                if (!deck->empty()) {
+                    auto card = deck->drawCard(getContext());
                     if (card) {
-                        std::cout << "[DEBUG] " << getName() << " uses a card!" << std::endl;
-                        card->play(*target);
+                        getContext().emit(CombatEvent::cardPlayed(card->getId()), this, target.get());
+                        card->play(*target, getContext());
                         return;
                     }
                 }
             }
 
-            std::cout << "[DEBUG] " << getName() << " attacks!" << std::endl;
+            LOG_DEBUG(getName() << " attacks!");
             attack(*target);
         } else {
-            std::cout << "[DEBUG] " << getName() << " has no valid target!" << std::endl;
+            LOG_DEBUG(getName() << " has no valid target!");
         }
     } else {
-        std::cout << "[DEBUG] " << getName() << " has no target set!" << std::endl;
+        LOG_DEBUG(getName() << " has no target set!");
     }
 }
\ No newline at end of file
@@ -6,7 +6,8 @@
 
 #include "Inventory.h"
 #include <algorithm>
-#include <iostream>
+#include "CommandLog.h"
+#include "GameContext.h"
 
 /**
  * @brief Add an item to the inventory
@@ -15,7 +16,18 @@
  */
 void Inventory::addItem(Item* item) {
     items.push_back(item);
-    std::cout << "Added item: " << item->getName() << std::endl;
+    getContext().out() << "Added item: " << item->getName() << "\n";
+}
+
+/**
+ * @brief Add an item to the inventory and take ownership of it
+ * @param item The item to add
+ * @details Keeps the item alive for the lifetime of the inventory,
+ *          so used or removed items are still released exactly once
+ */
+void Inventory::addItem(std::unique_ptr<Item> item) {
+    addItem(item.get());
+    ownedItems.push_back(std::move(item));
 }
 
 /**
@@ -30,10 +42,14 @@ void Inventory::useItem(Item* item, Character& target) {
 
     if (it != items.end()) {
         (*it)->apply(target);
-        items.erase(it);
-        std::cout << "Used item: " << item->getName() << std::endl;
+        size_t index = static_cast<size_t>(it - items.begin());
+        items.erase(items.begin() + index);
+        if (CommandLog* log = getContext().getCommandLog()) {
+            log->recordItemRemoved(*this, index, item);
+        }
+        getContext().out() << "Used item: " << item->getName() << "\n";
     } else {
-        std::cout << "Item not found in inventory!" << std::endl;
+        getContext().out() << "Item not found in inventory!\n";
     }
 }
 
@@ -46,9 +62,21 @@ void Inventory::useItem(Item* item, Character& target) {
 void Inventory::removeItem(Item* item) {
     auto it = std::find(items.begin(), items.end(), item);
     if (it != items.end()) {
+        size_t index = static_cast<size_t>(it - items.begin());
         items.erase(it);
-        std::cout << "Removed item: " << item->getName() << "\n";
+        if (CommandLog* log = getContext().getCommandLog()) {
+            log->recordItemRemoved(*this, index, item);
+        }
+        getContext().out() << "Removed item: " << item->getName() << "\n";
     } else {
-        std::cout << "Item not found in inventory!\n";
+        getContext().out() << "Item not found in inventory!\n";
     }
+}
+
+/**
+ * @brief Get the context inventory messages are written to
+ * @return The bound context, or the calling thread's default context
+ */
+GameContext& Inventory::getContext() const {
+    return context ? *context : GameContext::threadDefault();
 }
\ No newline at end of file
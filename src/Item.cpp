@@ -5,7 +5,8 @@
  */
 
 #include "Item.h"
-#include <iostream>
+#include "Character.h"
+#include "GameContext.h"
 
 /**
  * @brief Constructor for Item
@@ -23,5 +24,5 @@ Item::Item(const std::string& name, const std::string& description)
  *          Derived classes should override this to provide specific effects.
  */
 void Item::apply(Character& target) {
-    std::cout << "Applying item: " << name << std::endl;
+    target.getContext().out() << "Applying item: " << name << "\n";
 }
\ No newline at end of file
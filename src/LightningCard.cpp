@@ -5,25 +5,37 @@
  */
 
 #include "LightningCard.h"
-#include <iostream>
-#include <cstdlib>
-#include <ctime>
+#include "GameContext.h"
 
 /**
  * @brief Constructor for LightningCard
  * @details Initializes a lightning card with a predefined name and description
  */
 LightningCard::LightningCard()
-    : Card("Lightning Card", "Deals random damage between 10 and 30.") {}
+    : Card(CardId::LIGHTNING, "Lightning Card", "Deals random damage between 10 and 30.") {}
 
 /**
  * @brief Implements the effect of playing a LightningCard
  * @param target The entity targeted by the lightning
- * @details Deals a random amount of damage between 10 and 30 to the target
- *          and displays a message with the damage dealt
+ * @param context Session the card is played in
+ * @details Deals a random amount of damage between 10 and 30 to the target,
+ *          drawn from the session's generator, and displays a message with
+ *          the damage dealt
  */
-void LightningCard::play(Entity& target) {
-    int damage = 10 + (std::rand() % 21);
+void LightningCard::play(Entity& target, GameContext& context) {
+    int damage = context.randomInt(MIN_DAMAGE, MAX_DAMAGE);
     target.takeDamage(damage);
-    std::cout << "Lightning Card deals " << damage << " damage to " << target.getName() << "!\n";
+    context.emit(CombatEvent::damage(CombatEvent::Cause::CARD, damage, getId()), nullptr, &target);
+}
+
+/**
+ * @brief Roll the damage of several lightning strikes at once
+ * @param context Session the strikes happen in
+ * @param out Array receiving the damage of each strike
+ * @param count Number of strikes
+ * @details Fills the array straight from the session's current stream,
+ *          without a per-strike call into the context
+ */
+void LightningCard::rollDamage(GameContext& context, int* out, size_t count) {
+    context.randomInts(MIN_DAMAGE, MAX_DAMAGE, out, count);
 }
\ No newline at end of file
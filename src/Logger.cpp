@@ -0,0 +1,210 @@
+/**
+ * @file Logger.cpp
+ * @brief Implementation of the Logger class
+ * @details Contains the bounded multi-producer queue, the writer thread and
+ *          the definitions of all methods declared in Logger.h
+ */
+
+#include "Logger.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+std::atomic<LogLevel> Logger::threshold{LogLevel::INFO};
+
+namespace {
+    /** @brief Mask turning a queue position into a slot index */
+    constexpr uint64_t SLOT_MASK = Logger::QUEUE_CAPACITY - 1;
+
+    static_assert((Logger::QUEUE_CAPACITY & SLOT_MASK) == 0, "Queue capacity must be a power of two");
+
+    /**
+     * @brief Get the prefix of a level
+     * @param level The level
+     * @return Tag written in front of messages of that level
+     */
+    const char* prefix(LogLevel level) {
+        switch (level) {
+            case LogLevel::DEBUG:
+                return "[DEBUG] ";
+            case LogLevel::INFO:
+                return "[INFO] ";
+            case LogLevel::WARNING:
+                return "[WARNING] ";
+            case LogLevel::ERROR:
+                return "[ERROR] ";
+            default:
+                return "";
+        }
+    }
+}
+
+/**
+ * @brief Constructor for Logger
+ * @details Prepares the slots for the first lap of positions and starts the writer
+ */
+Logger::Logger() : slots(new Slot[QUEUE_CAPACITY]), output(&std::clog) {
+    for (size_t i = 0; i < QUEUE_CAPACITY; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    writer = std::thread(&Logger::drain, this);
+}
+
+/**
+ * @brief Destructor for Logger
+ * @details Writes the messages still queued and stops the writer
+ */
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(waitMutex);
+        stopping.store(true, std::memory_order_release);
+    }
+    wake.notify_one();
+    writer.join();
+}
+
+/**
+ * @brief Get the logger of the process
+ * @return The logger, created on first use
+ */
+Logger& Logger::instance() {
+    static Logger logger;
+    return logger;
+}
+
+/**
+ * @brief Parse a level name
+ * @param name "debug", "info", "warning", "error" or "off"
+ * @return The level
+ * @throws std::invalid_argument if the name is not a level
+ */
+LogLevel Logger::parseLevel(const std::string& name) {
+    if (name == "debug") return LogLevel::DEBUG;
+    if (name == "info") return LogLevel::INFO;
+    if (name == "warning") return LogLevel::WARNING;
+    if (name == "error") return LogLevel::ERROR;
+    if (name == "off") return LogLevel::OFF;
+    throw std::invalid_argument("Unknown log level " + name);
+}
+
+/**
+ * @brief Queue a message
+ * @param level Its severity
+ * @param message Its text, without a trailing newline
+ * @details A producer claims the next position with a compare-and-swap once
+ *          the slot's sequence shows the writer has released it, copies
+ *          the message in and publishes it by advancing the sequence. If the
+ *          slot still holds a message from the previous lap the queue is
+ *          full and the message is dropped. The writer is only notified if
+ *          it is parked on an empty queue; the fence pairs with the one in
+ *          drain() so either the writer sees the message or the producer
+ *          sees it parked.
+ */
+void Logger::write(LogLevel level, const std::string& message) {
+    uint64_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots[pos & SLOT_MASK];
+        uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int64_t lag = static_cast<int64_t>(sequence - pos);
+        if (lag == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (lag < 0) {
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->level = level;
+    slot->length = static_cast<uint16_t>(std::min(message.size(), MAX_MESSAGE));
+    std::memcpy(slot->text, message.data(), slot->length);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (parked.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(waitMutex);
+        wake.notify_one();
+    }
+}
+
+/**
+ * @brief Check whether the writer's next message is published
+ * @return True if it is
+ */
+bool Logger::ready() const {
+    return slots[dequeuePos & SLOT_MASK].sequence.load(std::memory_order_acquire) == dequeuePos + 1;
+}
+
+/**
+ * @brief Write queued messages until the logger stops
+ * @details Writes every published message, flushes the stream once per
+ *          batch and wakes any flusher. When the queue is empty the writer
+ *          parks until a producer or the destructor wakes it.
+ */
+void Logger::drain() {
+    while (true) {
+        std::ostream* out = output.load(std::memory_order_acquire);
+        uint64_t batch = 0;
+        while (ready()) {
+            Slot& slot = slots[dequeuePos & SLOT_MASK];
+            *out << prefix(slot.level);
+            out->write(slot.text, slot.length);
+            *out << '\n';
+            slot.sequence.store(dequeuePos + QUEUE_CAPACITY, std::memory_order_release);
+            dequeuePos++;
+            batch++;
+        }
+
+        if (batch > 0) {
+            out->flush();
+            written.fetch_add(batch, std::memory_order_release);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (flushers.load(std::memory_order_relaxed) > 0) {
+                std::lock_guard<std::mutex> lock(waitMutex);
+                drained.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(waitMutex);
+        parked.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        wake.wait(lock, [this] { return ready() || stopping.load(std::memory_order_acquire); });
+        parked.store(false, std::memory_order_relaxed);
+        if (!ready()) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Wait until every message queued so far is written out
+ * @details Sleeps until the writer reports a batch that reaches the
+ *          messages queued before the call
+ */
+void Logger::flush() {
+    uint64_t target = enqueuePos.load(std::memory_order_acquire);
+    if (written.load(std::memory_order_acquire) >= target) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(waitMutex);
+    flushers.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    drained.wait(lock, [&] { return written.load(std::memory_order_acquire) >= target; });
+    flushers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Redirect the log
+ * @param stream Stream to write to; it must outlive its use
+ * @return The previous stream
+ */
+std::ostream* Logger::setOutput(std::ostream& stream) {
+    flush();
+    return output.exchange(&stream, std::memory_order_acq_rel);
+}
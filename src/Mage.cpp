@@ -6,10 +6,9 @@
  */
 
 #include "Mage.h"
-#include "Fireball.h"
-#include "LightningCard.h"
-#include "SpellCard.h"
-#include <iostream>
+#include "CardCatalog.h"
+#include "GameContext.h"
+#include "Logger.h"
 
 /**
  * @brief Constructor for Mage
@@ -23,10 +22,8 @@
  */
 Mage::Mage(const std::string& name, int health, int mana, int attackPower, int defense)
     : Character(name, health, mana, attackPower, defense) {
-    deck = std::make_shared<Deck>();
-    deck->addCard(std::make_shared<Fireball>());
-    deck->addCard(std::make_shared<LightningCard>());
-    deck->addCard(std::make_shared<SpellCard>());
+    kind = EntityKind::MAGE;
+    deck = std::make_shared<Deck>(Deck{CardId::FIREBALL, CardId::LIGHTNING, CardId::SPELL});
 }
 
 /**
@@ -38,13 +35,13 @@ Mage::Mage(const std::string& name, int health, int mana, int attackPower, int d
  */
 void Mage::attack(Entity& target) {
     if (getMana() >= 20) {
-        Fireball fireball;
-        fireball.play(target);
+        CardCatalog::get(CardId::FIREBALL)->play(target, getContext());
         reduceMana(20);
+        getContext().emit(CombatEvent::manaSpent(20), this, nullptr);
     } else {
         int damage = getAttackPower();
         target.takeDamage(damage);
-        std::cout << getName() << " hits with a staff for " << damage << " damage!" << std::endl;
+        getContext().emit(CombatEvent::damage(CombatEvent::Cause::STAFF, damage), this, &target);
     }
 }
 
@@ -59,10 +56,11 @@ void Mage::attack(Entity& target) {
 void Mage::useAbility(Ability& ability, Entity& target) {
     if (getMana() >= ability.getManaCost()) {
         reduceMana(ability.getManaCost());
+        getContext().emit(CombatEvent::manaSpent(ability.getManaCost()), this, nullptr);
         ability.applyEffect(target);
-        std::cout << getName() << " uses " << ability.getName() << " on " << target.getName() << "!" << std::endl;
+        getContext().out() << getName() << " uses " << ability.getName() << " on " << target.getName() << "!\n";
     } else {
-        std::cout << "Not enough mana to use " << ability.getName() << "!" << std::endl;
+        getContext().out() << "Not enough mana to use " << ability.getName() << "!\n";
     }
 }
 
@@ -77,28 +75,27 @@ void Mage::performAIAction() {
     if (auto target = getTarget()) {
         if (target->isAlive()) {
             if (auto deck = getDeck()) {
-                if (!deck->getCards().empty()) {
-                    auto card = deck->drawCard();
+                if (!deck->empty()) {
+                    auto card = deck->drawCard(getContext());
                     if (card) {
-                        std::cout << "[DEBUG] " << getName() << " uses a card!" << std::endl;
-                        card->play(*target);
+                        getContext().emit(CombatEvent::cardPlayed(card->getId()), this, target.get());
+                        card->play(*target, getContext());
                         return;
                     }
                 }
             }
 
             if (getMana() >= 20) {
-                std::cout << "[DEBUG] " << getName() << " casts Fireball!" << std::endl;
-                Fireball fireball;
-                fireball.play(*target);
+                getContext().emit(CombatEvent::cardPlayed(CardId::FIREBALL), this, target.get());
+                CardCatalog::get(CardId::FIREBALL)->play(*target, getContext());
             } else {
-                std::cout << "[DEBUG] " << getName() << " attacks!" << std::endl;
+                LOG_DEBUG(getName() << " attacks!");
                 attack(*target);
             }
         } else {
-            std::cout << "[DEBUG] " << getName() << " has no valid target!" << std::endl;
+            LOG_DEBUG(getName() << " has no valid target!");
         }
     } else {
-        std::cout << "[DEBUG] " << getName() << " has no target set!" << std::endl;
+        LOG_DEBUG(getName() << " has no target set!");
     }
 }
\ No newline at end of file
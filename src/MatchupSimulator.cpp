@@ -0,0 +1,300 @@
+/**
+ * @file MatchupSimulator.cpp
+ * @brief Implementation of the MatchupSimulator class
+ * @details Contains the parallel battle loop and the statistics used
+ *          to summarize class-vs-class matchups
+ */
+
+#include "MatchupSimulator.h"
+#include "BattleEngine.h"
+#include "BattleSolver.h"
+#include "EasyAI.h"
+#include "GameContext.h"
+#include "GameManager.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+    /** @brief z-score of the 95% confidence level */
+    constexpr double Z_95 = 1.959964;
+
+    /** @brief Number of battles a worker claims at once */
+    constexpr uint64_t CHUNK_SIZE = 256;
+
+    /**
+     * @brief Derive the random value of a single battle
+     * @param seed Seed of the whole series
+     * @param index Index of the battle in the series
+     * @return A well-mixed 64-bit value (SplitMix64 finalizer)
+     * @details Depending only on the battle index keeps every battle
+     *          independent of which worker happens to play it
+     */
+    uint64_t battleSeed(uint64_t seed, uint64_t index) {
+        uint64_t z = seed + (index + 1) * 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+}
+
+/**
+ * @brief Record the outcome of one battle
+ * @param winner 0 if the first class won, 1 if the second class won, -1 for a draw
+ * @param turns Number of rounds the battle lasted
+ */
+void MatchupStats::record(int winner, int turns) {
+    battles++;
+    if (winner == 0) {
+        winsA++;
+    } else if (winner == 1) {
+        winsB++;
+    } else {
+        draws++;
+    }
+    turnSum += static_cast<uint64_t>(turns);
+    turnSquareSum += static_cast<uint64_t>(turns) * static_cast<uint64_t>(turns);
+}
+
+/**
+ * @brief Add the statistics of another series
+ * @param other Statistics to merge into this one
+ */
+void MatchupStats::merge(const MatchupStats& other) {
+    battles += other.battles;
+    winsA += other.winsA;
+    winsB += other.winsB;
+    draws += other.draws;
+    turnSum += other.turnSum;
+    turnSquareSum += other.turnSquareSum;
+}
+
+/**
+ * @brief Get the mean battle length
+ * @return Mean number of rounds, 0 if no battle was played
+ */
+double MatchupStats::meanTurns() const {
+    return battles ? static_cast<double>(turnSum) / battles : 0.0;
+}
+
+/**
+ * @brief Get the 95% confidence half-width of the mean battle length
+ * @return Half-width of the normal-approximation interval
+ */
+double MatchupStats::meanTurnsMargin() const {
+    if (battles < 2) {
+        return 0.0;
+    }
+    double n = static_cast<double>(battles);
+    double mean = meanTurns();
+    double variance = (static_cast<double>(turnSquareSum) - n * mean * mean) / (n - 1);
+    return Z_95 * std::sqrt(std::max(variance, 0.0) / n);
+}
+
+/**
+ * @brief Get the 95% Wilson score interval of a win rate
+ * @param wins Number of wins of the side of interest
+ * @return Lower and upper bound of the interval
+ * @details The Wilson interval stays inside [0, 1] and behaves well
+ *          for lopsided matchups, unlike the plain normal approximation
+ */
+std::pair<double, double> MatchupStats::winRateInterval(uint64_t wins) const {
+    if (battles == 0) {
+        return {0.0, 1.0};
+    }
+    double n = static_cast<double>(battles);
+    double p = static_cast<double>(wins) / n;
+    double z2 = Z_95 * Z_95;
+    double denominator = 1.0 + z2 / n;
+    double center = (p + z2 / (2.0 * n)) / denominator;
+    double margin = Z_95 * std::sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n)) / denominator;
+    return {std::max(0.0, center - margin), std::min(1.0, center + margin)};
+}
+
+/**
+ * @brief Constructor for MatchupSimulator
+ * @param classA Class of the first combatant
+ * @param classB Class of the second combatant
+ * @throws std::invalid_argument if either class is unknown
+ */
+MatchupSimulator::MatchupSimulator(const std::string& classA, const std::string& classB)
+    : classA(classA), classB(classB) {
+    GameContext::Mute mute(GameContext::threadDefault());
+    if (!createCharacter(classA, classA) || !createCharacter(classB, classB)) {
+        throw std::invalid_argument("Unknown class in matchup " + classA + ":" + classB);
+    }
+}
+
+/**
+ * @brief Simulate a series of battles
+ * @param battles Number of battles to play
+ * @param threads Number of worker threads, 0 for one per hardware thread
+ * @param seed Seed from which the random values of every battle are derived
+ * @return Aggregated statistics of all battles
+ * @details Workers claim battles in chunks from a shared counter and keep
+ *          their statistics private until they finish, so the only shared
+ *          write during the run is the counter itself. Every worker runs its
+ *          battles in a private quiet session seeded with the series seed, and
+ *          each battle draws from the streams keyed by its index, so the
+ *          outcome of a battle does not depend on the number of threads.
+ */
+MatchupStats MatchupSimulator::run(uint64_t battles, unsigned threads, uint64_t seed) const {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(std::min<uint64_t>(threads, std::max<uint64_t>(1, battles)));
+
+    std::atomic<uint64_t> next{0};
+    std::vector<MatchupStats> partial(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+
+    for (unsigned worker = 0; worker < threads; ++worker) {
+        workers.emplace_back([this, &next, &partial, battles, seed, worker]() {
+            GameContext::Mute mute(GameContext::threadDefault());
+            GameContext context(seed, nullptr, GameContext::ClockMode::VIRTUAL);
+            MatchupStats stats;
+
+            while (true) {
+                uint64_t begin = next.fetch_add(CHUNK_SIZE, std::memory_order_relaxed);
+                if (begin >= battles) {
+                    break;
+                }
+                uint64_t end = std::min(begin + CHUNK_SIZE, battles);
+                for (uint64_t i = begin; i < end; ++i) {
+                    playBattle(i, (battleSeed(seed, i) & 1) != 0, context, stats);
+                }
+            }
+            partial[worker] = stats;
+        });
+    }
+
+    MatchupStats total;
+    for (unsigned worker = 0; worker < threads; ++worker) {
+        workers[worker].join();
+        total.merge(partial[worker]);
+    }
+    return total;
+}
+
+/**
+ * @brief Play a single battle
+ * @param index Index of the battle in the series
+ * @param aMovesFirst Whether the first class takes the first move
+ * @param context Session the battle runs in
+ * @param stats Statistics to record the outcome into
+ * @details Both sides are driven by their class AI routines, exactly
+ *          like enemies in an ordinary battle
+ */
+void MatchupSimulator::playBattle(uint64_t index, bool aMovesFirst, GameContext& context, MatchupStats& stats) const {
+    auto a = createCharacter(classA, classA);
+    auto b = createCharacter(classB, classB);
+    auto first = aMovesFirst ? a : b;
+    auto second = aMovesFirst ? b : a;
+    second->setAI(std::make_shared<EasyAI>(second));
+
+    BattleEngine engine(first, second, context);
+    engine.setMaxTurns(maxTurns);
+    engine.setBattleId(index + 1);
+    AutoActionSource autopilot;
+    BattleResult result = engine.run(autopilot);
+
+    int winner = -1;
+    if (result.winner == BattleResult::Winner::PLAYER) {
+        winner = aMovesFirst ? 0 : 1;
+    } else if (result.winner == BattleResult::Winner::ENEMY) {
+        winner = aMovesFirst ? 1 : 0;
+    }
+    stats.record(winner, result.turns);
+}
+
+/**
+ * @brief Compute the exact outcome distribution of the matchup
+ * @return Odds with the first class as the player and the second as the enemy
+ */
+BattleOdds MatchupSimulator::solve() const {
+    GameContext::Mute mute(GameContext::threadDefault());
+    GameContext context(0, nullptr, GameContext::ClockMode::VIRTUAL);
+    BattleOdds first = solveOrder(true, context);
+    BattleOdds second = solveOrder(false, context);
+
+    BattleOdds odds;
+    odds.playerWins = 0.5 * (first.playerWins + second.playerWins);
+    odds.enemyWins = 0.5 * (first.enemyWins + second.enemyWins);
+    odds.draws = 0.5 * (first.draws + second.draws);
+    odds.meanTurns = 0.5 * (first.meanTurns + second.meanTurns);
+    odds.states = first.states + second.states;
+    odds.branches = first.branches + second.branches;
+    return odds;
+}
+
+/**
+ * @brief Compute the exact outcome distribution for one move order
+ * @param aMovesFirst Whether the first class takes the first move
+ * @param context Session the battle is solved in
+ * @return Odds with the first class as the player and the second as the enemy
+ * @details Sets the battle up exactly like playBattle()
+ */
+BattleOdds MatchupSimulator::solveOrder(bool aMovesFirst, GameContext& context) const {
+    auto a = createCharacter(classA, classA);
+    auto b = createCharacter(classB, classB);
+    auto first = aMovesFirst ? a : b;
+    auto second = aMovesFirst ? b : a;
+    second->setAI(std::make_shared<EasyAI>(second));
+
+    BattleSolver solver(first, second, context);
+    solver.setMaxTurns(maxTurns);
+    BattleOdds odds = solver.solve();
+    if (!aMovesFirst) {
+        std::swap(odds.playerWins, odds.enemyWins);
+    }
+    return odds;
+}
+
+/**
+ * @brief Print a summary of simulated battles
+ * @param out Stream to print to
+ * @param stats Statistics returned by run()
+ * @details Win rates are shown with their 95% Wilson intervals and the
+ *          mean battle length with its 95% confidence half-width
+ */
+void MatchupSimulator::printReport(std::ostream& out, const MatchupStats& stats) const {
+    auto line = [&](const std::string& label, uint64_t wins) {
+        auto interval = stats.winRateInterval(wins);
+        double rate = stats.battles ? static_cast<double>(wins) / stats.battles : 0.0;
+        out << std::left << std::setw(16) << label << std::right
+            << std::setw(8) << std::fixed << std::setprecision(2) << rate * 100 << "%  "
+            << "[" << interval.first * 100 << "%, " << interval.second * 100 << "%]\n";
+    };
+
+    out << "===== " << classA << " vs " << classB << " (" << stats.battles << " battles) =====\n";
+    line(classA + " wins", stats.winsA);
+    line(classB + " wins", stats.winsB);
+    line("Draws", stats.draws);
+    out << std::left << std::setw(16) << "Mean turns" << std::right
+        << std::setw(8) << std::fixed << std::setprecision(2) << stats.meanTurns()
+        << "   +/- " << stats.meanTurnsMargin() << "\n";
+}
+
+/**
+ * @brief Print an exact outcome distribution
+ * @param out Stream to print to
+ * @param odds Odds returned by solve()
+ */
+void MatchupSimulator::printReport(std::ostream& out, const BattleOdds& odds) const {
+    auto line = [&](const std::string& label, double probability) {
+        out << std::left << std::setw(16) << label << std::right
+            << std::setw(8) << std::fixed << std::setprecision(2) << probability * 100 << "%\n";
+    };
+
+    out << "===== " << classA << " vs " << classB << " (exact, " << odds.states << " states) =====\n";
+    line(classA + " wins", odds.playerWins);
+    line(classB + " wins", odds.enemyWins);
+    line("Draws", odds.draws);
+    out << std::left << std::setw(16) << "Mean turns" << std::right
+        << std::setw(8) << std::fixed << std::setprecision(2) << odds.meanTurns << "\n";
+}
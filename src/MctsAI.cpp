@@ -0,0 +1,847 @@
+/**
+ * @file MctsAI.cpp
+ * @brief Implementation of the MctsAI class
+ * @details Contains the search state, the search tree and the definitions
+ *          of all methods declared in MctsAI.h
+ */
+
+#include "MctsAI.h"
+#include "BattleHash.h"
+#include "CardCatalog.h"
+#include "CombatantStore.h"
+#include "GameContext.h"
+#include "LightningCard.h"
+#include "RandomService.h"
+#include "TranspositionTable.h"
+#include "WorkerPool.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace {
+    /** @brief Row of the searching character in the search state */
+    constexpr CombatantHandle SELF{0};
+
+    /** @brief Row of its opponent in the search state */
+    constexpr CombatantHandle OPPONENT{1};
+
+    /** @brief UCT exploration constant */
+    constexpr double EXPLORATION = 1.41421356;
+
+    /** @brief Mana a Mage spends to attack with a Fireball */
+    constexpr int MAGE_FIREBALL_MANA = 20;
+
+    /** @brief Number of card kinds */
+    constexpr size_t CARD_KINDS = CardCatalog::size();
+
+    /**
+     * @enum AttackRule
+     * @brief How a character class resolves a basic attack
+     */
+    enum class AttackRule : uint8_t {
+        CHARACTER, /**< Attack power scaled by the speed modifier */
+        WARRIOR,   /**< Attack power minus the target's defense */
+        MAGE,      /**< Fireball while mana lasts, staff hit otherwise */
+        PLAIN      /**< Attack power, as Archer and Healer */
+    };
+
+    /**
+     * @brief Find the attack rule of a character
+     * @param character The character
+     * @return The rule its attack() follows
+     */
+    AttackRule attackRuleOf(const Character& character) {
+        switch (character.getKind()) {
+            case EntityKind::WARRIOR:
+                return AttackRule::WARRIOR;
+            case EntityKind::MAGE:
+                return AttackRule::MAGE;
+            case EntityKind::ARCHER:
+            case EntityKind::HEALER:
+                return AttackRule::PLAIN;
+            default:
+                return AttackRule::CHARACTER;
+        }
+    }
+
+    /**
+     * @struct SearchState
+     * @brief Copy of a battle that the search plays moves on
+     * @details Row SELF is the searching character and row OPPONENT its
+     *          opponent. Rounds follow BattleEngine with the opponent as the
+     *          player: the opponent acts, the searching character answers and
+     *          effects tick. The search starts at the answer.
+     */
+    struct SearchState {
+        /** @brief Combat state of both sides */
+        CombatantStore store;
+
+        /** @brief Cards left in each side's deck, by kind */
+        std::array<std::array<uint16_t, CARD_KINDS>, 2> hands{};
+
+        /** @brief Attack rule of each side */
+        std::array<AttackRule, 2> attackRules{};
+
+        /** @brief Side to move, SELF.index or OPPONENT.index */
+        uint32_t side = SELF.index;
+
+        /** @brief Rounds left before playouts are scored by health */
+        int roundsLeft = 0;
+
+        /** @brief Zobrist hash of everything above */
+        BattleHash hash;
+    };
+
+    /**
+     * @brief Hash key of the rounds left before the horizon
+     * @param rounds Rounds left
+     * @return Key toggled in and out as the rounds count down
+     * @details Feature 2 follows the attack rules of sides 0 and 1
+     */
+    uint64_t roundsLeftKey(int rounds) {
+        return BattleHash::custom(2, static_cast<uint64_t>(rounds));
+    }
+
+    /**
+     * @brief Hash a search state from scratch
+     * @param state The state
+     * @return Hash the incremental updates must agree with
+     * @details The attack rules are mixed in so states of different
+     *          character classes never share table entries, and the rounds
+     *          left so a mean is only reused at the same distance from the
+     *          horizon it was sampled at
+     */
+    BattleHash hashState(const SearchState& state) {
+        BattleHash hash;
+        for (uint32_t side = 0; side < 2; ++side) {
+            hash.toggle(BattleHash::combatant(state.store, CombatantHandle{side}, side));
+            hash.toggle(BattleHash::custom(side, static_cast<uint64_t>(state.attackRules[side])));
+            for (size_t kind = 0; kind < CARD_KINDS; ++kind) {
+                hash.toggle(BattleHash::cards(side, static_cast<CardId>(kind), state.hands[side][kind]));
+            }
+        }
+        hash.toggle(roundsLeftKey(state.roundsLeft));
+        hash.toggle(BattleHash::sideToMove(state.side));
+        return hash;
+    }
+
+    /**
+     * @brief Deal damage on the search state
+     * @param state The state
+     * @param target The damaged combatant
+     * @param damage Damage before defense
+     */
+    void takeDamage(SearchState& state, CombatantHandle target, int damage) {
+        int before = state.store.getHealth(target);
+        state.store.takeDamage(target, damage);
+        state.hash.changeStat(BattleHash::Feature::HEALTH, target.index, before, state.store.getHealth(target));
+    }
+
+    /**
+     * @brief Change the defense of a combatant on the search state
+     * @param state The state
+     * @param target The combatant
+     * @param value New defense
+     */
+    void setDefense(SearchState& state, CombatantHandle target, int value) {
+        state.hash.changeStat(BattleHash::Feature::DEFENSE, target.index, state.store.getDefense(target), value);
+        state.store.setDefense(target, value);
+    }
+
+    /**
+     * @brief Change the mana of a combatant on the search state
+     * @param state The state
+     * @param target The combatant
+     * @param amount Mana to add, negative to spend
+     */
+    void changeMana(SearchState& state, CombatantHandle target, int amount) {
+        int before = state.store.getMana(target);
+        if (amount < 0) {
+            state.store.reduceMana(target, -amount);
+        } else {
+            state.store.increaseMana(target, amount);
+        }
+        state.hash.changeStat(BattleHash::Feature::MANA, target.index, before, state.store.getMana(target));
+    }
+
+    /**
+     * @brief Apply an effect on the search state
+     * @param state The state
+     * @param target The affected combatant
+     * @param type Effect type
+     * @param speedMod Speed modifier
+     * @param duration Duration in turns
+     * @param damage Damage per turn
+     * @param healing Healing per turn
+     */
+    void applyEffect(SearchState& state, CombatantHandle target, EffectType type, float speedMod,
+                     int duration, int damage = 0, int healing = 0) {
+        auto range = state.store.getEffectRange(target);
+        size_t slot = range.second - range.first;
+        state.store.applyEffect(target, type, speedMod, duration, damage, healing);
+        state.hash.toggle(BattleHash::effect(target.index, slot, state.store.getEffect(target, slot)));
+    }
+
+    /**
+     * @brief Toggle the keys of every effect of a combatant
+     * @param state The state
+     * @param target The combatant
+     */
+    void toggleEffects(SearchState& state, CombatantHandle target) {
+        auto range = state.store.getEffectRange(target);
+        for (size_t i = 0; i < range.second - range.first; ++i) {
+            state.hash.toggle(BattleHash::effect(target.index, i, state.store.getEffect(target, i)));
+        }
+    }
+
+    /**
+     * @brief Tick the effects of a combatant on the search state
+     * @param state The state
+     * @param target The combatant
+     * @details Every effect loses a turn, so all effect keys are replaced
+     */
+    void updateEffects(SearchState& state, CombatantHandle target) {
+        int before = state.store.getHealth(target);
+        toggleEffects(state, target);
+        state.store.updateEffects(target);
+        toggleEffects(state, target);
+        state.hash.changeStat(BattleHash::Feature::HEALTH, target.index, before, state.store.getHealth(target));
+    }
+
+    /**
+     * @brief Check whether a move has a random outcome
+     * @param move The move
+     * @return True for Lightning Card plays
+     */
+    bool isChance(const MctsMove& move) {
+        return move.action == BattleAction::ABILITY && move.card == CardId::LIGHTNING;
+    }
+
+    /**
+     * @brief Check whether the battle of a state is over
+     * @param state The state
+     * @return True if a side is defeated or the horizon is reached
+     */
+    bool isTerminal(const SearchState& state) {
+        return !state.store.isAlive(SELF) || !state.store.isAlive(OPPONENT) || state.roundsLeft <= 0;
+    }
+
+    /**
+     * @brief Score a state for the searching character
+     * @param state The state
+     * @return 1 for a win, 0 for a loss, the health balance in between otherwise
+     */
+    double evaluate(const SearchState& state) {
+        bool selfAlive = state.store.isAlive(SELF);
+        bool opponentAlive = state.store.isAlive(OPPONENT);
+        if (selfAlive != opponentAlive) {
+            return selfAlive ? 1.0 : 0.0;
+        }
+        int balance = state.store.getHealth(SELF) - state.store.getHealth(OPPONENT);
+        return 0.5 + 0.5 * balance / Entity::MAX_HEALTH;
+    }
+
+    /**
+     * @brief List the moves of the side to move
+     * @param state The state
+     * @param moves Vector receiving the moves
+     */
+    void legalMoves(const SearchState& state, std::vector<MctsMove>& moves) {
+        moves.clear();
+        moves.push_back({BattleAction::ATTACK, CardId::NONE});
+        moves.push_back({BattleAction::DEFEND, CardId::NONE});
+        const auto& hand = state.hands[state.side];
+        for (size_t kind = 0; kind < CARD_KINDS; ++kind) {
+            if (hand[kind] > 0) {
+                moves.push_back({BattleAction::ABILITY, static_cast<CardId>(kind)});
+            }
+        }
+    }
+
+    /**
+     * @brief Resolve a card on the search state
+     * @param state The state
+     * @param card The card
+     * @param target Combatant the card is played on
+     * @param roll Damage rolled for a Lightning Card
+     * @details Same rules as the cards' play() methods
+     */
+    void playCard(SearchState& state, CardId card, CombatantHandle target, int roll) {
+        const CombatantStore& store = state.store;
+        switch (card) {
+            case CardId::ATTACK:
+                takeDamage(state, target, 15);
+                break;
+            case CardId::DEFENSE:
+                setDefense(state, target, store.getDefense(target) + 20);
+                break;
+            case CardId::SPELL:
+                applyEffect(state, target, EffectType::SLOW, 0.7f, 3);
+                break;
+            case CardId::TRAP:
+                takeDamage(state, target, 10);
+                break;
+            case CardId::SPECIAL:
+                changeMana(state, target, 30);
+                break;
+            case CardId::FIREBALL:
+                if (store.isAlive(target)) {
+                    takeDamage(state, target, 25);
+                    applyEffect(state, target, EffectType::BURN, 1.0f, 3, 5);
+                }
+                break;
+            case CardId::ICE_SPIKE:
+                applyEffect(state, target, EffectType::SLOW, 0.7f, 2);
+                break;
+            case CardId::LIGHTNING:
+                takeDamage(state, target, roll);
+                break;
+            case CardId::BURNING_EFFECT:
+                applyEffect(state, target, EffectType::BURN, 1.0f, 3, 5);
+                break;
+            case CardId::POISON:
+                applyEffect(state, target, EffectType::POISON, 1.0f, 5, 5);
+                break;
+            case CardId::REGENERATION:
+                applyEffect(state, target, EffectType::REGENERATION, 1.0f, 3, 0, 10);
+                break;
+            case CardId::SHIELD:
+                setDefense(state, target, store.getDefense(target) + 10);
+                break;
+            default:
+                break;
+        }
+    }
+
+    /**
+     * @brief Resolve a basic attack on the search state
+     * @param state The state
+     * @param rule Attack rule of the attacker
+     * @param attacker The attacking combatant
+     * @param target The attacked combatant
+     */
+    void playAttack(SearchState& state, AttackRule rule, CombatantHandle attacker, CombatantHandle target) {
+        const CombatantStore& store = state.store;
+        switch (rule) {
+            case AttackRule::CHARACTER:
+                if (store.isAlive(target)) {
+                    takeDamage(state, target, static_cast<int>(store.getAttackPower(attacker) *
+                                                               store.getSpeedModifier(attacker)));
+                }
+                break;
+            case AttackRule::WARRIOR:
+                if (store.isAlive(target)) {
+                    takeDamage(state, target, std::max(store.getAttackPower(attacker) - store.getDefense(target), 0));
+                }
+                break;
+            case AttackRule::MAGE:
+                if (store.getMana(attacker) >= MAGE_FIREBALL_MANA) {
+                    playCard(state, CardId::FIREBALL, target, 0);
+                    changeMana(state, attacker, -MAGE_FIREBALL_MANA);
+                } else {
+                    takeDamage(state, target, store.getAttackPower(attacker));
+                }
+                break;
+            case AttackRule::PLAIN:
+                takeDamage(state, target, store.getAttackPower(attacker));
+                break;
+        }
+    }
+
+    /**
+     * @brief Play a move of the side to move
+     * @param state The state
+     * @param move The move
+     * @param roll Damage rolled if the move is a chance move
+     * @details Ends the round after the searching character's move
+     */
+    void applyMove(SearchState& state, const MctsMove& move, int roll) {
+        CombatantHandle mover{state.side};
+        CombatantHandle other{1 - state.side};
+
+        switch (move.action) {
+            case BattleAction::ABILITY: {
+                uint16_t& held = state.hands[mover.index][static_cast<size_t>(move.card)];
+                state.hash.changeCards(mover.index, move.card, held, held - 1u);
+                held--;
+                playCard(state, move.card, MctsAI::targetsSelf(move.card) ? mover : other, roll);
+                break;
+            }
+            case BattleAction::DEFEND:
+                playCard(state, CardId::DEFENSE, mover, 0);
+                break;
+            default:
+                playAttack(state, state.attackRules[mover.index], mover, other);
+                break;
+        }
+
+        if (mover == SELF) {
+            if (state.store.isAlive(OPPONENT)) {
+                updateEffects(state, OPPONENT);
+            }
+            if (state.store.isAlive(SELF)) {
+                updateEffects(state, SELF);
+            }
+            state.hash.toggle(roundsLeftKey(state.roundsLeft) ^ roundsLeftKey(state.roundsLeft - 1));
+            state.roundsLeft--;
+        }
+        state.hash.toggle(BattleHash::sideToMove(mover.index) ^ BattleHash::sideToMove(other.index));
+        state.side = other.index;
+    }
+
+    /**
+     * @brief Roll the damage of a Lightning Card
+     * @param rng Random stream of the search
+     * @return Damage of the strike
+     */
+    int rollLightning(RandomStream& rng) {
+        return rng.uniformInt(LightningCard::MIN_DAMAGE, LightningCard::MAX_DAMAGE);
+    }
+
+    /**
+     * @struct Node
+     * @brief Node of a search tree
+     * @details Decision nodes hold the state after a move. A chance move
+     *          gets a chance node whose children are its rolled outcomes.
+     */
+    struct Node {
+        /** @brief Move that led to this node */
+        MctsMove move;
+
+        /** @brief Damage roll that led to this outcome node, -1 otherwise */
+        int roll = -1;
+
+        /** @brief True if the children of this node are roll outcomes */
+        bool chance = false;
+
+        /** @brief True once the untried moves have been listed */
+        bool expanded = false;
+
+        /** @brief Index of the parent node */
+        uint32_t parent = 0;
+
+        /** @brief Indices of the child nodes */
+        std::vector<uint32_t> children;
+
+        /** @brief Moves of the side to move that have no child yet */
+        std::vector<MctsMove> untried;
+
+        /** @brief Number of iterations through this node */
+        uint32_t visits = 0;
+
+        /** @brief Sum of the outcomes of those iterations for the searching character */
+        double reward = 0.0;
+    };
+
+    /**
+     * @class SearchTree
+     * @brief One UCT search tree grown by a single thread
+     */
+    class SearchTree {
+    private:
+        /** @brief State at the root */
+        const SearchState& root;
+
+        /** @brief Nodes of the tree; node 0 is the root */
+        std::vector<Node> nodes;
+
+        /** @brief State an iteration plays moves on */
+        SearchState scratch;
+
+        /** @brief Move list reused by playouts */
+        std::vector<MctsMove> moves;
+
+        /** @brief Random stream of the thread */
+        RandomStream rng;
+
+        /** @brief Shared cache of playout outcomes, nullptr for none */
+        TranspositionTable* table;
+
+        /** @brief Number of playouts replaced by a cached evaluation */
+        uint64_t tableHits = 0;
+
+    public:
+        /**
+         * @brief Constructor for SearchTree
+         * @param root State at the root
+         * @param rng Random stream of the thread
+         * @param table Shared cache of playout outcomes, nullptr for none
+         */
+        SearchTree(const SearchState& root, RandomStream rng, TranspositionTable* table)
+            : root(root), scratch(root), rng(rng), table(table) {
+            nodes.emplace_back();
+        }
+
+        /**
+         * @brief Get the number of playouts replaced by a cached evaluation
+         * @return Transposition table hits of this tree
+         */
+        uint64_t getTableHits() const { return tableHits; }
+
+        /**
+         * @brief Get the nodes of the tree
+         * @return The nodes; node 0 is the root
+         */
+        const std::vector<Node>& getNodes() const { return nodes; }
+
+        /**
+         * @brief Run one select, expand, playout and backpropagate pass
+         */
+        void iterate() {
+            scratch = root;
+            uint32_t current = descend();
+            double reward = evaluateLeaf();
+            while (true) {
+                nodes[current].visits++;
+                nodes[current].reward += reward;
+                if (current == 0) break;
+                current = nodes[current].parent;
+            }
+        }
+
+    private:
+        /**
+         * @brief Add a node to the tree
+         * @param parent Index of the parent node
+         * @param move Move that leads to the node; taken by value, since
+         *        callers pass the move of a node and adding one may move them
+         * @param roll Damage roll that leads to the node, -1 if none
+         * @return Index of the new node
+         */
+        uint32_t addChild(uint32_t parent, MctsMove move, int roll) {
+            uint32_t index = static_cast<uint32_t>(nodes.size());
+            nodes.emplace_back();
+            nodes[index].move = move;
+            nodes[index].roll = roll;
+            nodes[index].parent = parent;
+            nodes[index].chance = roll < 0 && isChance(move);
+            nodes[parent].children.push_back(index);
+            return index;
+        }
+
+        /**
+         * @brief Walk down the tree, playing moves on the scratch state
+         * @return Index of the node the playout starts from
+         * @details Stops after adding one node, at a terminal state, or when
+         *          the tree is full
+         */
+        uint32_t descend() {
+            uint32_t current = 0;
+            while (true) {
+                if (nodes[current].chance) {
+                    int roll = rollLightning(rng);
+                    uint32_t next = findOutcome(current, roll);
+                    bool added = next == 0;
+                    if (added) {
+                        if (nodes.size() >= MctsAI::MAX_TREE_NODES) {
+                            applyMove(scratch, nodes[current].move, roll);
+                            return current;
+                        }
+                        next = addChild(current, nodes[current].move, roll);
+                    }
+                    applyMove(scratch, nodes[current].move, roll);
+                    current = next;
+                    if (added) return current;
+                    continue;
+                }
+
+                if (isTerminal(scratch)) return current;
+
+                if (!nodes[current].expanded) {
+                    legalMoves(scratch, nodes[current].untried);
+                    nodes[current].expanded = true;
+                }
+
+                auto& untried = nodes[current].untried;
+                if (!untried.empty() && nodes.size() < MctsAI::MAX_TREE_NODES) {
+                    size_t pick = rng.uniformInt(0, static_cast<int>(untried.size()) - 1);
+                    MctsMove move = untried[pick];
+                    untried[pick] = untried.back();
+                    untried.pop_back();
+                    current = addChild(current, move, -1);
+                    if (nodes[current].chance) continue;
+                    applyMove(scratch, move, 0);
+                    return current;
+                }
+
+                if (nodes[current].children.empty()) return current;
+                current = selectChild(current);
+                if (!nodes[current].chance) {
+                    applyMove(scratch, nodes[current].move, 0);
+                }
+            }
+        }
+
+        /**
+         * @brief Find the outcome child of a chance node
+         * @param node Index of the chance node
+         * @param roll The rolled damage
+         * @return Index of the child, 0 if the outcome has none yet
+         */
+        uint32_t findOutcome(uint32_t node, int roll) const {
+            for (uint32_t child : nodes[node].children) {
+                if (nodes[child].roll == roll) return child;
+            }
+            return 0;
+        }
+
+        /**
+         * @brief Pick the child with the highest UCT score
+         * @param node Index of the parent node
+         * @return Index of the chosen child
+         * @details Scores are taken from the point of view of the side to
+         *          move on the scratch state
+         */
+        uint32_t selectChild(uint32_t node) const {
+            bool opponentMoves = scratch.side == OPPONENT.index;
+            double logVisits = std::log(static_cast<double>(std::max<uint32_t>(nodes[node].visits, 1)));
+            uint32_t best = nodes[node].children.front();
+            double bestScore = -1.0;
+            for (uint32_t child : nodes[node].children) {
+                const Node& candidate = nodes[child];
+                double value = candidate.reward / candidate.visits;
+                if (opponentMoves) value = 1.0 - value;
+                double score = value + EXPLORATION * std::sqrt(logVisits / candidate.visits);
+                if (score > bestScore) {
+                    bestScore = score;
+                    best = child;
+                }
+            }
+            return best;
+        }
+
+        /**
+         * @brief Score the scratch state
+         * @return Outcome for the searching character
+         * @details A state the table has seen often enough is scored with its
+         *          cached mean; any other state gets a playout, which is added
+         *          to the table
+         */
+        double evaluateLeaf() {
+            if (!table) {
+                return playout();
+            }
+            uint64_t key = scratch.hash.get();
+            TranspositionTable::Evaluation cached;
+            if (table->probe(key, cached) && cached.samples >= MctsAI::MIN_REUSE_SAMPLES) {
+                tableHits++;
+                return cached.value;
+            }
+            double reward = playout();
+            table->record(key, reward);
+            return reward;
+        }
+
+        /**
+         * @brief Play random moves from the scratch state to the end
+         * @return Outcome for the searching character
+         */
+        double playout() {
+            while (!isTerminal(scratch)) {
+                legalMoves(scratch, moves);
+                const MctsMove& move = moves[rng.uniformInt(0, static_cast<int>(moves.size()) - 1)];
+                applyMove(scratch, move, isChance(move) ? rollLightning(rng) : 0);
+            }
+            return evaluate(scratch);
+        }
+    };
+
+    /**
+     * @struct RootMove
+     * @brief Statistics of one root move merged over all trees
+     */
+    struct RootMove {
+        /** @brief The move */
+        MctsMove move;
+
+        /** @brief Total visits */
+        uint64_t visits = 0;
+
+        /** @brief Total reward */
+        double reward = 0.0;
+    };
+}
+
+/**
+ * @brief Constructor for MctsAI
+ * @param budget Time allowed for one decision
+ * @param threads Number of search threads, 0 for one per hardware thread
+ */
+MctsAI::MctsAI(std::chrono::microseconds budget, unsigned threads)
+    : budget(budget), threads(threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads) {
+    kind = AIKind::MCTS;
+}
+
+/**
+ * @brief Destructor for MctsAI
+ * @details Defined here, where WorkerPool is complete
+ */
+MctsAI::~MctsAI() = default;
+
+/**
+ * @brief Check whether a card is played on its owner
+ * @param card The card
+ * @return True for healing, protective and mana cards
+ */
+bool MctsAI::targetsSelf(CardId card) {
+    switch (card) {
+        case CardId::DEFENSE:
+        case CardId::SPECIAL:
+        case CardId::REGENERATION:
+        case CardId::SHIELD:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Search for the best move
+ * @param self The character controlled by this AI
+ * @param target The opposing character
+ * @param context Session the decision is made in
+ * @return The most visited move at the root
+ * @details Every thread draws from its own stream of a seed taken from the
+ *          session, so a search with an iteration limit is reproducible.
+ *          The caller searches as thread 0 beside the pool's threads.
+ *          Ties in visits go to the move with the higher expected outcome.
+ */
+MctsMove MctsAI::chooseMove(const Character& self, const Character& target, GameContext& context) {
+    SearchState root;
+    root.store.add(self);
+    root.store.add(target);
+    root.attackRules = {attackRuleOf(self), attackRuleOf(target)};
+    root.roundsLeft = horizon;
+    const Character* sides[] = {&self, &target};
+    for (size_t side = 0; side < 2; ++side) {
+        if (auto deck = sides[side]->getDeck()) {
+            for (size_t kind = 0; kind < CARD_KINDS; ++kind) {
+                root.hands[side][kind] = static_cast<uint16_t>(deck->count(static_cast<CardId>(kind)));
+            }
+        }
+    }
+    root.hash = hashState(root);
+
+    RandomStream& stream = context.getRandomStream();
+    uint64_t seed = (static_cast<uint64_t>(stream.next()) << 32) | stream.next();
+
+    lastStats = MctsSearchStats();
+    lastStats.threads = threads;
+    if (isTerminal(root)) {
+        return MctsMove();
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + budget;
+    std::vector<std::vector<RootMove>> partial(threads);
+    std::vector<uint64_t> iterations(threads, 0);
+    std::vector<uint64_t> treeSizes(threads, 0);
+    std::vector<uint64_t> tableHits(threads, 0);
+
+    std::function<void(unsigned)> search = [&](unsigned worker) {
+        SearchTree tree(root, RandomStream(seed, 0, worker), table.get());
+        uint64_t done = 0;
+        while ((maxIterations == 0 || done < maxIterations) && std::chrono::steady_clock::now() < deadline) {
+            tree.iterate();
+            done++;
+        }
+        const auto& nodes = tree.getNodes();
+        for (uint32_t child : nodes[0].children) {
+            partial[worker].push_back({nodes[child].move, nodes[child].visits, nodes[child].reward});
+        }
+        iterations[worker] = done;
+        treeSizes[worker] = nodes.size();
+        tableHits[worker] = tree.getTableHits();
+    };
+
+    if (threads == 1) {
+        search(0);
+    } else {
+        if (!pool) {
+            pool = std::make_unique<WorkerPool>(threads - 1);
+        }
+        pool->run(search);
+    }
+
+    std::vector<RootMove> merged;
+    for (unsigned worker = 0; worker < threads; ++worker) {
+        lastStats.iterations += iterations[worker];
+        lastStats.nodes += treeSizes[worker];
+        lastStats.tableHits += tableHits[worker];
+        for (const RootMove& move : partial[worker]) {
+            auto it = std::find_if(merged.begin(), merged.end(),
+                                   [&](const RootMove& m) { return m.move == move.move; });
+            if (it == merged.end()) {
+                merged.push_back(move);
+            } else {
+                it->visits += move.visits;
+                it->reward += move.reward;
+            }
+        }
+    }
+
+    const RootMove* best = nullptr;
+    for (const RootMove& move : merged) {
+        if (move.visits == 0) continue;
+        if (!best || move.visits > best->visits ||
+            (move.visits == best->visits && move.reward > best->reward)) {
+            best = &move;
+        }
+    }
+    if (!best) {
+        return MctsMove();
+    }
+    lastStats.bestVisits = best->visits;
+    lastStats.bestValue = best->reward / best->visits;
+    return best->move;
+}
+
+/**
+ * @brief Search for the best move and play it
+ * @param self The character controlled by this AI
+ * @param target The target entity
+ * @param context Session the decision is made in
+ */
+void MctsAI::makeDecision(Character& self, Entity& target, GameContext& context) {
+    const Character* opponent = Character::from(target);
+    MctsMove move = opponent ? chooseMove(self, *opponent, context) : MctsMove();
+    playMove(move, self, target, context);
+}
+
+/**
+ * @brief Play a move in the real battle
+ * @param move The move to play
+ * @param self The character making the move
+ * @param target The opposing entity
+ * @param context Session the move is played in
+ * @details Defending plays a Defense Card on the character, like AdvancedAI.
+ *          A card missing from the deck falls back to a basic attack.
+ */
+void MctsAI::playMove(const MctsMove& move, Character& self, Entity& target, GameContext& context) {
+    switch (move.action) {
+        case BattleAction::DEFEND:
+            CardCatalog::get(CardId::DEFENSE)->play(self, context);
+            return;
+        case BattleAction::ABILITY: {
+            auto deck = self.getDeck();
+            if (deck && deck->contains(move.card)) {
+                deck->removeCard(move.card, context);
+                const auto& card = CardCatalog::get(move.card);
+                if (targetsSelf(move.card)) {
+                    context.emit(CombatEvent::cardPlayed(move.card), &self, &self);
+                    card->play(self, context);
+                } else {
+                    context.emit(CombatEvent::cardPlayed(move.card), &self, &target);
+                    card->play(target, context);
+                }
+                return;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    self.attack(target);
+}
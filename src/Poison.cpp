@@ -6,24 +6,24 @@
 
 #include "Poison.h"
 #include "Character.h"
-#include <iostream>
+#include "GameContext.h"
 
 /**
  * @brief Constructor for Poison
  * @details Initializes a poison card with a predefined name and description
  */
 Poison::Poison()
-    : Card("Poison", "Deals 5 damage per turn for 5 turns.") {}
+    : Card(CardId::POISON, "Poison", "Deals 5 damage per turn for 5 turns.") {}
 
 /**
  * @brief Implements the effect of playing a Poison card
  * @param target The entity targeted by the poison effect
+ * @param context Session the card is played in
  * @details Applies a poison effect to the target if it's a Character,
  *          dealing 5 damage per turn for 5 turns
  */
-void Poison::play(Entity & target) {
-    if (auto* character = dynamic_cast<Character*>(&target)) {
+void Poison::play(Entity& target, GameContext& context) {
+    if (auto* character = Character::from(target)) {
         character->applyEffect(EffectType::POISON, 1.0f, 5, 5);
-        std::cout << "Poison Card activates on " << target.getName() << std::endl;
     }
 }
\ No newline at end of file
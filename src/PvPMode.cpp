@@ -6,37 +6,41 @@
  */
 
 #include "PvPMode.h"
+#include "BattleReplay.h"
+#include "GameContext.h"
 #include "UI.h"
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <optional>
 
 /**
  * @brief Constructor for PvPMode
  * @param p1 Shared pointer to the first player character
  * @param p2 Shared pointer to the second player character
+ * @param autopilot Controller choosing both players' actions, or nullptr for interactive play
  * @details Initializes a PvP battle between two player-controlled characters
  */
-PvPMode::PvPMode(std::shared_ptr<Character> p1, std::shared_ptr<Character> p2)
-    : player1(p1), player2(p2) {}
+PvPMode::PvPMode(std::shared_ptr<Character> p1, std::shared_ptr<Character> p2, std::shared_ptr<ActionSource> autopilot)
+    : player1(p1), player2(p2), autopilot(autopilot) {}
 
 /**
- * @brief Selects an ability from a character's deck
- * @param character The character whose abilities to select from
- * @return A shared pointer to the selected ability, or nullptr if selection failed
- * @details Displays the available abilities in the character's deck and
- *          allows the player to choose one. Returns the selected ability
- *          or nullptr if the deck is empty or the selection is invalid.
+ * @brief Selects a card from a character's deck
+ * @param character The character whose cards to select from
+ * @return Index of the selected card, out of range if none was selected
+ * @details Displays the cards in the character's deck and allows the player
+ *          to choose one
  */
-std::shared_ptr<Ability> PvPMode::selectAbility(const Character& character) {
+size_t PvPMode::selectCard(const Character& character) {
     auto deck = character.getDeck();
     if (!deck || deck->size() == 0) {
         std::cout << "No abilities available!\n";
-        return nullptr;
+        return 0;
     }
 
     std::cout << "Choose an ability:\n";
-    const auto& cards = deck->getCards();
+    Deck::CardView cards = deck->view();
     for (size_t i = 0; i < cards.size(); ++i) {
         std::cout << i + 1 << ". " << cards[i]->getName() << "\n";
     }
@@ -45,25 +49,25 @@ std::shared_ptr<Ability> PvPMode::selectAbility(const Character& character) {
     std::cin >> choice;
 
     if (choice > 0 && choice <= static_cast<int>(cards.size())) {
-        return std::dynamic_pointer_cast<Ability>(cards[choice - 1]);
+        return static_cast<size_t>(choice - 1);
     } else {
         std::cout << "Invalid choice!\n";
-        return nullptr;
+        return cards.size();
     }
 }
 
 /**
- * @brief Allows a character to use an item from their inventory
+ * @brief Lets the player pick an item from a character's inventory
  * @param character The character who will use the item
- * @details Displays a list of available items in the character's inventory,
- *          lets the player select one, applies its effects to the character,
- *          and removes the item from the inventory after use.
+ * @return Index of the selected item, out of range if none was selected
+ * @details Displays a list of available items in the character's inventory
+ *          and reads the player's selection
  */
-void PvPMode::useItemFromInventory(Character& character) {
+size_t PvPMode::selectItem(const Character& character) {
     auto inventory = character.getInventory();
     if (!inventory || inventory->getItems().empty()) {
         std::cout << "No items available!\n";
-        return;
+        return 0;
     }
 
     std::cout << "Choose an item:\n";
@@ -77,76 +81,171 @@ void PvPMode::useItemFromInventory(Character& character) {
         std::cin.clear();
         std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
         std::cout << "Invalid input! Please enter a number.\n";
-        return;
+        return items.size();
     }
 
     if (choice > 0 && choice <= static_cast<int>(items.size())) {
-        Item* selectedItem = items[choice - 1];
-        selectedItem->apply(character);
-        inventory->removeItem(selectedItem);
-        std::cout << "Used item: " << selectedItem->getName() << "\n";
-    } else {
-        std::cout << "Invalid choice!\n";
+        return static_cast<size_t>(choice - 1);
+    }
+    std::cout << "Invalid choice!\n";
+    return items.size();
+}
+
+/**
+ * @brief Asks the player whose turn it is for an action
+ * @param self The character whose turn it is
+ * @param opponent The opposing character
+ * @return The chosen action
+ * @details Displays the turn menu until a valid action is entered and,
+ *          for abilities and items, asks which card or item to use
+ */
+BattleChoice PvPMode::chooseAction(Character& self, Character& opponent) {
+    UI::clearScreen();
+    while (true) {
+        std::cout << "=== " << self.getName() << "'s turn ===\n";
+        std::cout << "1. Attack\n2. Ability\n3. Item\n";
+
+        int choice;
+        if (std::cin >> choice) {
+            switch (choice) {
+                case 1: return BattleChoice(BattleAction::ATTACK);
+                case 2: return BattleChoice(BattleAction::ABILITY, selectCard(self));
+                case 3: return BattleChoice(BattleAction::ITEM, selectItem(self));
+                default:
+                    std::cout << "Invalid choice! Please enter a number between 1 and 3.\n";
+                    break;
+            }
+        } else {
+            std::cin.clear();
+            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+            std::cout << "Invalid input! Please enter a number between 1 and 3.\n";
+        }
     }
 }
 
 /**
  * @brief Handles a player's turn in the PvP battle
+ * @param source Supplier of the player's action
  * @param attacker The character taking their turn
  * @param defender The opposing character
- * @details Displays the battle interface, presents action options to the player,
- *          and processes the selected action (attack, ability, defend).
- *          Updates both characters' status after the action is completed.
+ * @details Starts the turn's random stream, resolves the chosen action
+ *          (attack, ability, item or the character's own AI routine) and
+ *          updates both characters' effects afterwards
  */
-void PvPMode::playerTurn(std::shared_ptr<Character> attacker, std::shared_ptr<Character> defender) {
-    UI::clearScreen();
-    std::cout << "=== " << attacker->getName() << "'s turn ===\n";
-    std::cout << "1. Attack\n2. Ability\n3. Item\n";
-    
-    int choice;
-    std::cin >> choice;
-    
-    switch (choice) {
-        case 1:
+void PvPMode::playerTurn(ActionSource& source, std::shared_ptr<Character> attacker, std::shared_ptr<Character> defender) {
+    result.turns++;
+    getContext().beginTurn(static_cast<uint32_t>(result.turns));
+    int defenderHealth = defender->getHealth();
+
+    BattleChoice choice = source.chooseAction(*attacker, *defender);
+    switch (choice.action) {
+        case BattleAction::ATTACK:
             attacker->attack(*defender);
             break;
-        case 2:
-            if (auto ability = selectAbility(*attacker)) {
-                attacker->useAbility(*ability, *defender);
+        case BattleAction::ABILITY: {
+            auto deck = attacker->getDeck();
+            if (!deck || choice.index >= deck->size()) {
+                break;
+            }
+            auto card = deck->at(choice.index);
+            if (attacker->getMana() >= card->getManaCost()) {
+                card->play(*defender, getContext());
+                attacker->reduceMana(card->getManaCost());
+            } else {
+                getContext().out() << "Not enough mana to use " << card->getName() << "!\n";
+            }
+            break;
+        }
+        case BattleAction::ITEM: {
+            auto inventory = attacker->getInventory();
+            if (inventory && choice.index < inventory->getItems().size()) {
+                Item* selectedItem = inventory->getItems()[choice.index];
+                selectedItem->apply(*attacker);
+                inventory->removeItem(selectedItem);
+                getContext().out() << "Used item: " << selectedItem->getName() << "\n";
             }
             break;
-        case 3:
-            useItemFromInventory(*attacker);
+        }
+        case BattleAction::AUTO:
+            attacker->performAIAction();
+            break;
+        default:
             break;
     }
-    
+
     attacker->updateEffect();
     defender->updateEffect();
+
+    int dealt = std::max(0, defenderHealth - defender->getHealth());
+    if (attacker == player1) {
+        result.playerDamageDealt += dealt;
+    } else {
+        result.enemyDamageDealt += dealt;
+    }
 }
 
 /**
  * @brief Starts the PvP battle
  * @details Initializes the battle between two player characters,
  *          sets up targeting, and manages the battle loop until
- *          one character is defeated. Alternates turns between players
- *          and displays the battle outcome at the end.
+ *          one character is defeated or the turn limit is reached.
+ *          Alternates turns between players, the first player moving on
+ *          odd turns, and displays the battle outcome at the end. With an
+ *          autopilot the battle is headless.
+ *          The battle is recorded if the context has a replay recorder.
  */
 void PvPMode::start() {
-    std::cout << "PvP Battle started! " << player1->getName() << " vs " << player2->getName() << std::endl;
+    std::optional<GameContext::Mute> mute;
+    if (autopilot) {
+        mute.emplace(getContext());
+    }
+    getContext().out() << "PvP Battle started! " << player1->getName() << " vs " << player2->getName() << std::endl;
 
     player1->setTarget(player2);
     player2->setTarget(player1);
 
-    while (player1->isAlive() && player2->isAlive()) {
-        playerTurn(player1, player2);
-        if (!player2->isAlive()) break;
+    ActionSource& chooser = autopilot ? *autopilot : static_cast<ActionSource&>(*this);
+    ActionSource* source = &chooser;
+    std::optional<RecordingActionSource> recording;
+    ReplayRecorder* recorder = getContext().getReplayRecorder();
+    if (recorder) {
+        recorder->beginBattle(getContext(), ReplayBattle::Mode::PVP, *player1, *player2, maxTurns, false,
+                              chooser.isAutomatic());
+        recording.emplace(chooser, *recorder);
+        source = &*recording;
+    }
+
+    result = progress;
+    if (battleId != 0) {
+        getContext().beginBattle(battleId);
+        result.battleId = battleId;
+    } else {
+        result.battleId = getContext().beginBattle();
+    }
 
-        playerTurn(player2, player1);
+    auto limitReached = [this]() { return maxTurns > 0 && result.turns >= maxTurns; };
+    while (player1->isAlive() && player2->isAlive() && !limitReached()) {
+        if (recorder) {
+            recorder->startRound(*player1, *player2, result);
+        }
+        if (result.turns % 2 == 0) {
+            playerTurn(*source, player1, player2);
+        } else {
+            playerTurn(*source, player2, player1);
+        }
     }
 
-    if (player1->isAlive()) {
-        std::cout << player1->getName() << " wins!" << std::endl;
+    if (!player2->isAlive() && player1->isAlive()) {
+        result.winner = BattleResult::Winner::PLAYER;
+        getContext().out() << player1->getName() << " wins!" << std::endl;
+    } else if (!player1->isAlive()) {
+        result.winner = BattleResult::Winner::ENEMY;
+        getContext().out() << player2->getName() << " wins!" << std::endl;
     } else {
-        std::cout << player2->getName() << " wins!" << std::endl;
+        getContext().out() << "Battle ended in a draw!" << std::endl;
     }
-}
\ No newline at end of file
+
+    if (recorder) {
+        recorder->endBattle(result);
+    }
+}
@@ -0,0 +1,134 @@
+/**
+ * @file RandomService.cpp
+ * @brief Implementation of the counter-based random number service
+ * @details Contains the definitions of all methods declared in RandomService.h
+ */
+
+#include "RandomService.h"
+
+namespace {
+    /** @brief Philox multiplier of the first word pair */
+    constexpr uint32_t PHILOX_M0 = 0xD2511F53;
+
+    /** @brief Philox multiplier of the second word pair */
+    constexpr uint32_t PHILOX_M1 = 0xCD9E8D57;
+
+    /** @brief Weyl increment of the first key word */
+    constexpr uint32_t PHILOX_W0 = 0x9E3779B9;
+
+    /** @brief Weyl increment of the second key word */
+    constexpr uint32_t PHILOX_W1 = 0xBB67AE85;
+
+    /** @brief Number of Philox rounds */
+    constexpr int PHILOX_ROUNDS = 10;
+}
+
+/**
+ * @brief Generate one block of random bits
+ * @param counter Counter of the block
+ * @param key Key of the generator
+ * @return Four random 32-bit words
+ * @details Each round multiplies two words, mixes the high halves with the
+ *          other words and the key, and bumps the key by the Weyl constants
+ */
+Philox4x32::Counter Philox4x32::generate(Counter counter, Key key) {
+    for (int round = 0; round < PHILOX_ROUNDS; ++round) {
+        uint64_t product0 = static_cast<uint64_t>(PHILOX_M0) * counter[0];
+        uint64_t product1 = static_cast<uint64_t>(PHILOX_M1) * counter[2];
+        counter = {
+            static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+            static_cast<uint32_t>(product1),
+            static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+            static_cast<uint32_t>(product0)
+        };
+        key[0] += PHILOX_W0;
+        key[1] += PHILOX_W1;
+    }
+    return counter;
+}
+
+/**
+ * @brief Constructor for RandomStream
+ * @param seed Seed of the session
+ * @param battleId Identifier of the battle
+ * @param turn Turn within the battle
+ * @details The seed becomes the key; the battle id and turn occupy the upper
+ *          three counter words and the lowest word counts blocks
+ */
+RandomStream::RandomStream(uint64_t seed, uint64_t battleId, uint32_t turn)
+    : key{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+      counter{0, turn, static_cast<uint32_t>(battleId), static_cast<uint32_t>(battleId >> 32)} {}
+
+/**
+ * @brief Generate the block of the current counter and advance it
+ */
+void RandomStream::refill() {
+    block = Philox4x32::generate(counter, key);
+    counter[0]++;
+    position = 0;
+}
+
+/**
+ * @brief Draw a uniformly distributed integer
+ * @param min Smallest possible value
+ * @param max Largest possible value
+ * @return A value in [min, max]
+ * @details Uses Lemire's multiply-and-reject method, which is unbiased and
+ *          needs a division only when a rejection is possible
+ */
+int RandomStream::uniformInt(int min, int max) {
+    uint32_t range = static_cast<uint32_t>(static_cast<int64_t>(max) - min) + 1;
+    if (range == 0) {
+        return static_cast<int>(static_cast<int64_t>(min) + next());
+    }
+
+    uint64_t product = static_cast<uint64_t>(next()) * range;
+    uint32_t low = static_cast<uint32_t>(product);
+    if (low < range) {
+        uint32_t threshold = -range % range;
+        while (low < threshold) {
+            product = static_cast<uint64_t>(next()) * range;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+    return static_cast<int>(min + static_cast<int64_t>(product >> 32));
+}
+
+/**
+ * @brief Draw a batch of uniformly distributed integers
+ * @param min Smallest possible value
+ * @param max Largest possible value
+ * @param out Array receiving the values
+ * @param count Number of values to draw
+ * @details Whole blocks are converted four words at a time against a
+ *          rejection threshold computed once for the batch. A block holding
+ *          a rejected word, and the words left over before and after whole
+ *          blocks, go through uniformInt() one by one, so the values match
+ *          those of single draws.
+ */
+void RandomStream::fillUniform(int min, int max, int* out, size_t count) {
+    uint32_t range = static_cast<uint32_t>(static_cast<int64_t>(max) - min) + 1;
+    uint32_t threshold = range == 0 ? 0 : -range % range;
+    size_t i = 0;
+    while (i < count) {
+        if (position == block.size() && count - i >= block.size()) {
+            refill();
+            uint64_t products[4];
+            bool rejected = false;
+            for (size_t k = 0; k < block.size(); ++k) {
+                products[k] = static_cast<uint64_t>(block[k]) * range;
+                rejected |= static_cast<uint32_t>(products[k]) < threshold;
+            }
+            if (!rejected) {
+                for (size_t k = 0; k < block.size(); ++k) {
+                    uint32_t offset = range == 0 ? block[k] : static_cast<uint32_t>(products[k] >> 32);
+                    out[i + k] = static_cast<int>(min + static_cast<int64_t>(offset));
+                }
+                i += block.size();
+                position = block.size();
+                continue;
+            }
+        }
+        out[i++] = uniformInt(min, max);
+    }
+}
@@ -6,24 +6,24 @@
 
 #include "Regeneration.h"
 #include "Character.h"
-#include <iostream>
+#include "GameContext.h"
 
 /**
  * @brief Constructor for Regeneration
  * @details Initializes a regeneration card with a predefined name and description
  */
 Regeneration::Regeneration()
-    : Card("Regeneration", "Restores 10 health per turn for 3 turns.") {}
+    : Card(CardId::REGENERATION, "Regeneration", "Restores 10 health per turn for 3 turns.") {}
 
 /**
  * @brief Implements the effect of playing a Regeneration card
  * @param target The entity targeted by the regeneration effect
+ * @param context Session the card is played in
  * @details Applies a regeneration effect to the target if it's a Character,
  *          restoring 10 health points per turn for 3 turns
  */
-void Regeneration::play(Entity & target) {
-    if (auto* character = dynamic_cast<Character*>(&target)) {
+void Regeneration::play(Entity& target, GameContext& context) {
+    if (auto* character = Character::from(target)) {
         character->applyEffect(EffectType::REGENERATION, 1.0f, 3, 0, 10);
-        std::cout << "Regeneration Card heals " << target.getName() << std::endl;
     }
 }
\ No newline at end of file
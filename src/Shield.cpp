@@ -6,25 +6,26 @@
 
 #include "Shield.h"
 #include "Character.h"
-#include <iostream>
+#include "GameContext.h"
 
 /**
  * @brief Constructor for Shield
  * @details Initializes a shield card with a predefined name and description
  */
 Shield::Shield()
-    : Card("Shield", "Blocks 50% incoming damage for 2 turns.") {}
+    : Card(CardId::SHIELD, "Shield", "Blocks 50% incoming damage for 2 turns.") {}
 
 /**
  * @brief Implements the effect of playing a Shield card
  * @param target The entity targeted by the shield effect
+ * @param context Session the card is played in
  * @details Increases the target's defense by 10 points if it's a Character,
  *          providing protection against incoming damage
  */
-void Shield::play(Entity & target) {
-    Character* characterTarget = dynamic_cast<Character*>(&target);
+void Shield::play(Entity& target, GameContext& context) {
+    Character* characterTarget = Character::from(target);
     if (characterTarget) {
         characterTarget->setDefense(characterTarget->getDefense() + 10);
-        std::cout << "Shield Card increases defense by 10 for " << target.getName() << std::endl;
+        context.emit(CombatEvent::defenseRaised(10, getId()), nullptr, &target);
     }
 }
\ No newline at end of file
@@ -5,22 +5,23 @@
  */
 
 #include "SpecialCard.h"
-#include <iostream>
+#include "GameContext.h"
 
 /**
  * @brief Constructor for SpecialCard
  * @details Initializes a special card with a predefined name and description
  */
 SpecialCard::SpecialCard()
-    : Card("Special Card", "Restores 30 mana to the target.") {}
+    : Card(CardId::SPECIAL, "Special Card", "Restores 30 mana to the target.") {}
 
 /**
  * @brief Implements the effect of playing a SpecialCard
  * @param target The entity targeted by the special effect
+ * @param context Session the card is played in
  * @details Restores 30 mana points to the target and displays a message
  */
-void SpecialCard::play(Entity& target) {
+void SpecialCard::play(Entity& target, GameContext& context) {
     int manaRestore = 30;
     target.increaseMana(manaRestore);
-    std::cout << "Special Card restores " << manaRestore << " mana to " << target.getName() << "!" << std::endl;
+    context.emit(CombatEvent::manaRestored(manaRestore, getId()), nullptr, &target);
 }
\ No newline at end of file
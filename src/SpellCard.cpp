@@ -5,26 +5,26 @@
  */
 
 #include "SpellCard.h"
-#include <iostream>
+#include "GameContext.h"
 
 /**
  * @brief Constructor for SpellCard
  * @details Initializes a spell card with a predefined name and description
  */
 SpellCard::SpellCard()
-    : Card("Spell Card", "Applies a magical effect to the target.") {}
+    : Card(CardId::SPELL, "Spell Card", "Applies a magical effect to the target.") {}
 
 /**
  * @brief Implements the effect of playing a SpellCard
  * @param target The entity targeted by the spell
+ * @param context Session the card is played in
  * @details Applies a slowing effect to the target if it's a Character,
  *          reducing its speed by 30% for 3 turns
  */
-void SpellCard::play(Entity& target) {
-    if (auto* character = dynamic_cast<Character*>(&target)) {
+void SpellCard::play(Entity& target, GameContext& context) {
+    if (auto* character = Character::from(target)) {
         character->applyEffect(EffectType::SLOW, 0.7f, 3);
-        std::cout << "Spell Card applies a magical effect to " << character->getName() << "!" << std::endl;
     } else {
-        std::cout << "Target is not a Character!" << std::endl;
+        context.out() << "Target is not a Character!\n";
     }
 }
\ No newline at end of file
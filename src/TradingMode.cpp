@@ -28,7 +28,7 @@ TradingMode::TradingMode(std::shared_ptr<Character> p, std::shared_ptr<Character
  */
 void TradingMode::start() {
     std::cout << "Trading started between " << player->getName() << " and " << trader->getName() << std::endl;
-    std::cout << "Trader's deck size: " << trader->getDeck()->getCards().size() << std::endl;
+    std::cout << "Trader's deck size: " << trader->getDeck()->size() << std::endl;
     std::cout << "Trading started between " << player->getName() << " and " << trader->getName() << std::endl;
 
     std::shared_ptr<Card> playerCard = selectCardFromDeck(player);
@@ -69,12 +69,12 @@ std::shared_ptr<Card> TradingMode::selectCardFromDeck(const std::shared_ptr<Char
     std::cout << character->getName() << ", select a card to trade (enter index): ";
 
     std::shared_ptr<Deck> deck = character->getDeck();
-    if (!deck || deck->getCards().empty()) {
+    if (!deck || deck->empty()) {
         std::cout << "No cards to trade." << std::endl;
         return nullptr;
     }
 
-    std::vector<std::shared_ptr<Card>> cards = deck->getCards();
+    Deck::CardView cards = deck->view();
     std::cout << "Available cards:" << std::endl;
     for (size_t i = 0; i < cards.size(); ++i) {
         std::cout << i << ". " << cards[i]->getName() << std::endl;
@@ -0,0 +1,109 @@
+/**
+ * @file TranspositionTable.cpp
+ * @brief Implementation of the TranspositionTable class
+ * @details Contains the definitions of all methods declared in TranspositionTable.h
+ */
+
+#include "TranspositionTable.h"
+#include <cstring>
+#include <limits>
+
+namespace {
+    /**
+     * @brief Pack an evaluation into a word
+     * @param evaluation The evaluation
+     * @return Samples in the low half, bits of the value in the high half
+     */
+    uint64_t pack(const TranspositionTable::Evaluation& evaluation) {
+        uint32_t valueBits;
+        std::memcpy(&valueBits, &evaluation.value, sizeof(valueBits));
+        return static_cast<uint64_t>(evaluation.samples) | (static_cast<uint64_t>(valueBits) << 32);
+    }
+
+    /**
+     * @brief Unpack an evaluation from a word
+     * @param data Word made by pack()
+     * @return The evaluation
+     */
+    TranspositionTable::Evaluation unpack(uint64_t data) {
+        TranspositionTable::Evaluation evaluation;
+        evaluation.samples = static_cast<uint32_t>(data);
+        uint32_t valueBits = static_cast<uint32_t>(data >> 32);
+        std::memcpy(&evaluation.value, &valueBits, sizeof(valueBits));
+        return evaluation;
+    }
+}
+
+/**
+ * @brief Constructor for TranspositionTable
+ * @param slotCount Requested number of slots, rounded up to a power of two
+ */
+TranspositionTable::TranspositionTable(size_t slotCount) {
+    size_t size = 1;
+    while (size < slotCount) {
+        size <<= 1;
+    }
+    slots.reset(new Slot[size]);
+    mask = size - 1;
+}
+
+/**
+ * @brief Look up a state
+ * @param hash Hash of the state
+ * @param evaluation Receives the cached evaluation on a hit
+ * @return True if the state is in the table
+ * @details Empty slots hold zero in both words and never match, since a
+ *          stored evaluation always has at least one sample
+ */
+bool TranspositionTable::probe(uint64_t hash, Evaluation& evaluation) const {
+    const Slot& slot = slotOf(hash);
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    if ((check ^ data) != hash || data == 0) {
+        return false;
+    }
+    evaluation = unpack(data);
+    return true;
+}
+
+/**
+ * @brief Store the evaluation of a state
+ * @param hash Hash of the state
+ * @param evaluation The evaluation; replaces what the slot held
+ */
+void TranspositionTable::store(uint64_t hash, const Evaluation& evaluation) {
+    Slot& slot = slotOf(hash);
+    uint64_t data = pack(evaluation);
+    slot.data.store(data, std::memory_order_relaxed);
+    slot.check.store(hash ^ data, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Add one sample to the evaluation of a state
+ * @param hash Hash of the state
+ * @param outcome Outcome of the sample
+ */
+void TranspositionTable::record(uint64_t hash, double outcome) {
+    Evaluation evaluation;
+    if (probe(hash, evaluation)) {
+        if (evaluation.samples == std::numeric_limits<uint32_t>::max()) {
+            return;
+        }
+        evaluation.value += static_cast<float>((outcome - evaluation.value) / (evaluation.samples + 1));
+        evaluation.samples++;
+    } else {
+        evaluation.samples = 1;
+        evaluation.value = static_cast<float>(outcome);
+    }
+    store(hash, evaluation);
+}
+
+/**
+ * @brief Empty the table
+ */
+void TranspositionTable::clear() {
+    for (size_t i = 0; i <= mask; ++i) {
+        slots[i].check.store(0, std::memory_order_relaxed);
+        slots[i].data.store(0, std::memory_order_relaxed);
+    }
+}
@@ -5,22 +5,23 @@
  */
 
 #include "TrapCard.h"
-#include <iostream>
+#include "GameContext.h"
 
 /**
  * @brief Constructor for TrapCard
  * @details Initializes a trap card with a predefined name and description
  */
 TrapCard::TrapCard()
-    : Card("Trap Card", "Deals 10 damage when triggered.") {}
+    : Card(CardId::TRAP, "Trap Card", "Deals 10 damage when triggered.") {}
 
 /**
  * @brief Implements the effect of playing a TrapCard
  * @param target The entity targeted by the trap
+ * @param context Session the card is played in
  * @details Deals 10 damage to the target and displays a message
  */
-void TrapCard::play(Entity& target) {
+void TrapCard::play(Entity& target, GameContext& context) {
     int damage = 10;
     target.takeDamage(damage);
-    std::cout << "Trap Card deals " << damage << " damage to " << target.getName() << "!" << std::endl;
+    context.emit(CombatEvent::damage(CombatEvent::Cause::CARD, damage, getId()), nullptr, &target);
 }
\ No newline at end of file
@@ -6,32 +6,92 @@
  */
 
 #include "UI.h"
+#include "CardCatalog.h"
+#include "Logger.h"
 #include <iostream>
 #include <chrono>
-#include <thread>
-
-std::vector<std::string> UI::battleLog;
 
 /**
  * @brief Adds a message to the battle log
+ * @param context Session whose battle log receives the message
  * @param message The message to add to the log
- * @details Adds the specified message to the battle log and manages the log size
- *          by removing the oldest messages when the log exceeds 5 entries.
+ * @details Adds the specified message to the session's battle log, which
+ *          overwrites the oldest entry once it holds 5 entries.
  */
-void UI::addToLog(const std::string& message) {
-    battleLog.push_back(message);
-    if (battleLog.size() > 5) battleLog.erase(battleLog.begin());
+void UI::addToLog(GameContext& context, const std::string& message) {
+    context.getBattleLog().addText(message);
+}
+
+/**
+ * @brief Adds an action to the battle log
+ * @param context Session whose battle log receives the entry
+ * @param kind What the entry reports
+ * @param actor The acting character, nullptr if none
+ * @param other The other character, nullptr if none
+ * @param amount Figure of the entry
+ * @param card Card involved
+ */
+void UI::addToLog(GameContext& context, BattleLog::Kind kind, const Entity* actor, const Entity* other,
+                  int amount, CardId card) {
+    context.getBattleLog().add(kind, actor, other, amount, card);
+}
+
+/**
+ * @brief Formats a battle log entry
+ * @param log The battle log
+ * @param i Position of the entry, 0 for the oldest
+ * @return The colored text of the entry
+ */
+std::string UI::formatLogEntry(const BattleLog& log, size_t i) {
+    const BattleLog::Entry& entry = log[i];
+    const char* actor = log.nameOf(entry.actor);
+    const char* other = log.nameOf(entry.other);
+    std::string card = entry.card < CardId::COUNT ? CardCatalog::get(entry.card)->getName() : "card";
+    std::string amount = std::to_string(entry.amount);
+
+    switch (entry.kind) {
+        case BattleLog::Kind::ATTACK:
+            return COLOR_GREEN + actor + " attacks " + other + "!" + COLOR_RESET;
+        case BattleLog::Kind::ENEMY_ATTACK:
+            return COLOR_RED + actor + " attacks " + other + "!" + COLOR_RESET;
+        case BattleLog::Kind::CARD_USED:
+            return COLOR_CYAN + actor + " uses " + card + "!" + COLOR_RESET;
+        case BattleLog::Kind::NOT_ENOUGH_MANA:
+            return COLOR_RED + "Not enough mana to use " + card + "!" + COLOR_RESET;
+        case BattleLog::Kind::DEFEND:
+            return COLOR_BLUE + actor + " increases defense by " + amount + "!" + COLOR_RESET;
+        case BattleLog::Kind::DAMAGE:
+            return COLOR_RED + actor + " takes " + amount + " damage!" + COLOR_RESET;
+        case BattleLog::Kind::HEAL:
+            return COLOR_GREEN + actor + " heals " + amount + " HP!" + COLOR_RESET;
+        case BattleLog::Kind::VICTORY:
+            return COLOR_GREEN + "You gained " + amount + " EXP and defeated " + other + "!" + COLOR_RESET;
+        case BattleLog::Kind::KILLS:
+            return COLOR_GREEN + "Total kills: " + amount + COLOR_RESET;
+        case BattleLog::Kind::DEFEAT:
+            return COLOR_RED + "You have been defeated by " + other + "!" + COLOR_RESET;
+        case BattleLog::Kind::DRAW:
+            return COLOR_YELLOW + "The battle ended in a draw!" + COLOR_RESET;
+        case BattleLog::Kind::UNDO:
+            return COLOR_YELLOW + actor + " takes back the last turn!" + COLOR_RESET;
+        case BattleLog::Kind::NOTHING_TO_UNDO:
+            return COLOR_RED + "There is no turn to undo!" + COLOR_RESET;
+        default:
+            return log.text(i);
+    }
 }
 
 /**
  * @brief Displays the battle log
- * @details Prints the entire battle log to the console,
- *          showing recent battle events and messages.
+ * @param context Session whose battle log is shown
+ * @details Formats and prints the entries of the session's battle log,
+ *          oldest first.
  */
-void UI::displayLog() {
+void UI::displayLog(const GameContext& context) {
     std::cout << COLOR_CYAN << "=== Battle Log ===" << COLOR_RESET << "\n";
-    for (const auto& msg : battleLog) {
-        std::cout << "> " << msg << "\n";
+    const BattleLog& log = context.getBattleLog();
+    for (size_t i = 0; i < log.size(); ++i) {
+        std::cout << "> " << formatLogEntry(log, i) << "\n";
     }
 }
 
@@ -125,16 +185,17 @@ std::string UI::effectsList(const std::vector<ActiveEffect>& effects) {
  * @brief Displays the battle interface
  * @param player The player character
  * @param enemy The enemy entity
+ * @param context Session whose battle log is shown
  * @details Creates and displays a formatted battle interface showing
  *          health, mana, attack, defense, and active effects for both
  *          the player and enemy. Also displays the battle log.
  */
-void UI::battleInterface(const Character& player, const Entity& enemy) {
+void UI::battleInterface(const Character& player, const Entity& enemy, const GameContext& context) {
     clearScreen();
     
-    const Character* enemyCharacter = dynamic_cast<const Character*>(&enemy);
+    const Character* enemyCharacter = Character::from(enemy);
     if (!enemyCharacter) {
-        std::cerr << "Error: Enemy is not a Character!" << std::endl;
+        LOG_ERROR("Enemy is not a Character!");
         return;
     }
 
@@ -160,19 +221,20 @@ void UI::battleInterface(const Character& player, const Entity& enemy) {
               << "Effects: " << effectsList(enemyCharacter->getActiveEffects()) << "\n"
               << COLOR_RESET << "\n";
 
-    displayLog();
+    displayLog(context);
     std::cout << "\n" << COLOR_YELLOW << "==================" << COLOR_RESET << "\n";
 }
 
 /**
  * @brief Displays an attack animation
+ * @param context Session whose clock paces the animation
  * @param attackerName The name of the attacking character
  * @param abilityName The name of the ability being used (optional)
  * @details Creates a simple text-based animation for attacks or ability use,
  *          with a delay between dots to simulate action. Uses colored text
  *          to enhance the visual effect.
  */
-void UI::attackAnimation(const std::string& attackerName, const std::string& abilityName) {
+void UI::attackAnimation(GameContext& context, const std::string& attackerName, const std::string& abilityName) {
     std::cout << COLOR_MAGENTA;
     if (!abilityName.empty()) {
         std::cout << attackerName << " uses " << abilityName << "!\n";
@@ -183,25 +245,22 @@ void UI::attackAnimation(const std::string& attackerName, const std::string& abi
     for (int i = 0; i < 3; ++i) {
         std::cout << ".";
         std::cout.flush();
-        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        context.sleepFor(std::chrono::milliseconds(300));
     }
     std::cout << COLOR_RESET << "\n";
 }
 
 /**
  * @brief Displays damage or healing messages
- * @param target The name of the target character
+ * @param context Session whose battle log receives the message
+ * @param target The target character
  * @param amount The amount of damage or healing
  * @param isHeal Whether this is healing (true) or damage (false)
  * @details Adds a colored message to the battle log indicating damage taken
  *          or health restored, with appropriate formatting based on the action type.
  */
-void UI::displayDamage(const std::string& target, int amount, bool isHeal) {
-    if (isHeal) {
-        addToLog(COLOR_GREEN + target + " heals " + std::to_string(amount) + " HP!" + COLOR_RESET);
-    } else {
-        addToLog(COLOR_RED + target + " takes " + std::to_string(amount) + " damage!" + COLOR_RESET);
-    }
+void UI::displayDamage(GameContext& context, const Entity& target, int amount, bool isHeal) {
+    addToLog(context, isHeal ? BattleLog::Kind::HEAL : BattleLog::Kind::DAMAGE, &target, nullptr, amount);
 }
 
 /**
@@ -224,31 +283,33 @@ std::string UI::manaBarWithNumbers(const Character& character, int width) {
 
 /**
  * @brief Logs enemy actions to the battle log
+ * @param context Session whose battle log receives the message
  * @param action The main action description
  * @param details Additional details about the action (optional)
  * @details Creates a formatted log entry for enemy actions with proper coloring,
  *          and adds it to the battle log for display in the interface.
  */
-void UI::enemyActionLog(const std::string& action, const std::string& details) {
+void UI::enemyActionLog(GameContext& context, const std::string& action, const std::string& details) {
     std::string message = COLOR_RED + "[Enemy] " + COLOR_RESET + action;
     if (!details.empty()) message += " (" + details + ")";
-    addToLog(message);
+    addToLog(context, message);
 }
 
 /**
  * @brief Displays an ASCII art animation for enemy attacks
+ * @param context Session whose clock paces the animation
  * @param attacker The name of the attacking enemy
  * @details Shows a simple ASCII art animation depicting an enemy attack,
  *          with colored text and a short delay for visual effect.
  *          Clears the screen after the animation completes.
  */
-void UI::enemyAttackAnimation(const std::string& attacker) {
+void UI::enemyAttackAnimation(GameContext& context, const std::string& attacker) {
     std::cout 
         << COLOR_RED << "  >> " << attacker << " attacks!\n"
         << "   \\\\\n"
         << "    \\\\_\\\n"
         << "     (•_•)\n"
         << "     / >💥" << COLOR_RESET;
-    std::this_thread::sleep_for(std::chrono::milliseconds(700));
+    context.sleepFor(std::chrono::milliseconds(700));
     clearScreen();
 }
\ No newline at end of file
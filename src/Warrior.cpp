@@ -6,10 +6,8 @@
  */
 
 #include "Warrior.h"
-#include "AttackCard.h"
-#include "DefenseCard.h"
-#include "Shield.h"
-#include <iostream>
+#include "GameContext.h"
+#include "Logger.h"
 
 /**
  * @brief Constructor for Warrior
@@ -23,10 +21,8 @@
  */
 Warrior::Warrior(const std::string& name, int health, int mana, int attackPower, int defense)
     : Character(name, health, mana, attackPower, defense) {
-    deck = std::make_shared<Deck>();
-    deck->addCard(std::make_shared<AttackCard>());
-    deck->addCard(std::make_shared<DefenseCard>());
-    deck->addCard(std::make_shared<Shield>());
+    kind = EntityKind::WARRIOR;
+    deck = std::make_shared<Deck>(Deck{CardId::ATTACK, CardId::DEFENSE, CardId::SHIELD});
 }
 
 /**
@@ -38,14 +34,14 @@ Warrior::Warrior(const std::string& name, int health, int mana, int attackPower,
  */
 void Warrior::attack(Entity& target) {
     if (!target.isAlive()) {
-        std::cout << "Target is already defeated!" << std::endl;
+        getContext().out() << "Target is already defeated!\n";
         return;
     }
     
     int damage = getAttackPower() - target.getDefense();
     if (damage < 0) damage = 0;
     target.takeDamage(damage);
-    std::cout << getName() << " attacks with a sword for " << damage << " damage!" << std::endl;
+    getContext().emit(CombatEvent::damage(CombatEvent::Cause::SWORD, damage), this, &target);
 }
 
 /**
@@ -58,10 +54,11 @@ void Warrior::attack(Entity& target) {
 void Warrior::useAbility(Ability& ability, Entity& target) {
     if (getMana() >= ability.getManaCost()) {
         reduceMana(ability.getManaCost());
+        getContext().emit(CombatEvent::manaSpent(ability.getManaCost()), this, nullptr);
         ability.applyEffect(target);
-        std::cout << getName() << " uses " << ability.getName() << " on " << target.getName() << "!" << std::endl;
+        getContext().out() << getName() << " uses " << ability.getName() << " on " << target.getName() << "!\n";
     } else {
-        std::cout << "Not enough mana to use " << ability.getName() << "!" << std::endl;
+        getContext().out() << "Not enough mana to use " << ability.getName() << "!\n";
     }
 }
 
@@ -74,12 +71,12 @@ void Warrior::useAbility(Ability& ability, Entity& target) {
 void Warrior::performAIAction() {
     if (auto target = getTarget()) {
         if (target->isAlive()) {
-            std::cout << "[DEBUG] " << getName() << " attacks " << target->getName() << std::endl;
+            LOG_DEBUG(getName() << " attacks " << target->getName());
             attack(*target);
         } else {
-            std::cout << "[DEBUG] " << getName() << " has no valid target!" << std::endl;
+            LOG_DEBUG(getName() << " has no valid target!");
         }
     } else {
-        std::cout << "[DEBUG] " << getName() << " has no target set!" << std::endl;
+        LOG_DEBUG(getName() << " has no target set!");
     }
 }
\ No newline at end of file
@@ -5,7 +5,7 @@
  */
 
 #include "Weapon.h"
-#include <iostream>
+#include "GameContext.h"
 
 /**
  * @brief Constructor for Weapon
@@ -15,7 +15,9 @@
  * @details Initializes a weapon item with the specified attributes
  */
 Weapon::Weapon(const std::string& name, const std::string& description, int damage)
-    : Item(name, description), damage(damage) {}
+    : Item(name, description), damage(damage) {
+    kind = ItemKind::WEAPON;
+}
 
 /**
  * @brief Apply the weapon to a character
@@ -25,5 +27,5 @@ Weapon::Weapon(const std::string& name, const std::string& description, int dama
  */
 void Weapon::apply(Character& target) {
     target.setAttackPower(target.getAttackPower() + damage);
-    std::cout << target.getName() << " equipped " << name << " and increased attack power by " << damage << "!" << std::endl;
+    target.getContext().out() << target.getName() << " equipped " << name << " and increased attack power by " << damage << "!\n";
 }
\ No newline at end of file
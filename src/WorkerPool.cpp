@@ -0,0 +1,77 @@
+/**
+ * @file WorkerPool.cpp
+ * @brief Implementation of the WorkerPool class
+ * @details Contains the definitions of all methods declared in WorkerPool.h
+ */
+
+#include "WorkerPool.h"
+
+/**
+ * @brief Constructor for WorkerPool
+ * @param helpers Number of threads to start besides the caller
+ */
+WorkerPool::WorkerPool(unsigned helpers) {
+    workers.reserve(helpers);
+    for (unsigned worker = 1; worker <= helpers; ++worker) {
+        workers.emplace_back(&WorkerPool::serve, this, worker);
+    }
+}
+
+/**
+ * @brief Destructor for WorkerPool
+ * @details Stops and joins the threads
+ */
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Run jobs until the pool stops
+ * @param worker Number of the thread
+ */
+void WorkerPool::serve(unsigned worker) {
+    uint64_t seen = 0;
+    while (true) {
+        const std::function<void(unsigned)>* current;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&]() { return stopping || generation != seen; });
+            if (stopping) {
+                return;
+            }
+            seen = generation;
+            current = job;
+        }
+        (*current)(worker);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0) {
+            finished.notify_one();
+        }
+    }
+}
+
+/**
+ * @brief Run a job on every thread and on the caller
+ * @param task The job, called with the number of the thread
+ * @details Returns when all threads have finished it
+ */
+void WorkerPool::run(const std::function<void(unsigned)>& task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job = &task;
+        pending = workers.size();
+        generation++;
+    }
+    wake.notify_all();
+    task(0);
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&]() { return pending == 0; });
+    job = nullptr;
+}
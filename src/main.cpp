@@ -4,30 +4,333 @@
  * @details Contains the main function that initializes and runs the game
  */
 
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <vector>
 #include "GameManager.h"
+#include "BattleReplay.h"
+#include "BattleSolver.h"
+#include "DungeonMode.h"
+#include "EndgameTablebase.h"
+#include "Logger.h"
+#include "MatchupSimulator.h"
 #include "Warrior.h"
 #include "Mage.h"
 #include "Archer.h"
 #include "Healer.h"
 
+/** @brief Largest thread count accepted on the command line */
+constexpr uint64_t MAX_THREADS = 256;
+
+/**
+ * @brief Parse the value of a numeric option
+ * @param option Name of the option, for the error message
+ * @param value Its value
+ * @param min Smallest accepted value
+ * @param max Largest accepted value
+ * @return The value
+ * @throws std::invalid_argument unless the value is a plain decimal number
+ *         in [min, max]; signs, such as the '-' that would make the
+ *         standard conversions wrap around, are rejected
+ */
+uint64_t parseNumber(const std::string& option, const std::string& value, uint64_t min, uint64_t max) {
+    bool digits = !value.empty() && std::all_of(value.begin(), value.end(), [](char c) {
+        return std::isdigit(static_cast<unsigned char>(c));
+    });
+    uint64_t number = 0;
+    try {
+        number = digits ? std::stoull(value) : 0;
+    } catch (const std::out_of_range&) {
+        digits = false;
+    }
+    if (!digits || number < min || number > max) {
+        throw std::invalid_argument(option + " must be a number from " + std::to_string(min) + " to " +
+                                    std::to_string(max) + ", not " + value);
+    }
+    return number;
+}
+
+/**
+ * @brief Run the Monte Carlo matchup simulation requested on the command line
+ * @param argc Number of command-line arguments
+ * @param argv Array of command-line arguments
+ * @return Exit code, 0 on success, 1 on invalid arguments
+ * @details Understands --simulate N (at least 1), --threads T (1 to
+ *          MAX_THREADS, all cores when omitted), --matchup ClassA:ClassB
+ *          and --seed S. With --solve ClassA:ClassB
+ *          the exact outcome distribution is computed instead of sampled.
+ */
+int runSimulation(int argc, char* argv[]) {
+    uint64_t battles = 0;
+    unsigned threads = 0;
+    uint64_t seed = 1;
+    std::string matchup = "Warrior:Mage";
+    bool exact = false;
+
+    try {
+        for (int i = 1; i < argc; i += 2) {
+            std::string option = argv[i];
+            if (i + 1 == argc) {
+                throw std::invalid_argument("Missing value of " + option);
+            }
+            std::string value = argv[i + 1];
+            if (option == "--simulate") {
+                battles = parseNumber(option, value, 1, std::numeric_limits<uint64_t>::max());
+            } else if (option == "--threads") {
+                threads = static_cast<unsigned>(parseNumber(option, value, 1, MAX_THREADS));
+            } else if (option == "--matchup") {
+                matchup = value;
+            } else if (option == "--seed") {
+                seed = parseNumber(option, value, 0, std::numeric_limits<uint64_t>::max());
+            } else if (option == "--solve") {
+                exact = true;
+                matchup = value;
+            } else {
+                throw std::invalid_argument("Unknown option " + option);
+            }
+        }
+
+        size_t separator = matchup.find(':');
+        if (separator == std::string::npos) {
+            throw std::invalid_argument("Matchup must look like Warrior:Mage");
+        }
+
+        MatchupSimulator simulator(matchup.substr(0, separator), matchup.substr(separator + 1));
+        if (exact) {
+            simulator.printReport(std::cout, simulator.solve());
+        } else {
+            MatchupStats stats = simulator.run(battles, threads, seed);
+            simulator.printReport(std::cout, stats);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        std::cerr << "Usage: card-rpg-lab --simulate N [--threads T] [--matchup ClassA:ClassB] [--seed S]" << std::endl;
+        std::cerr << "       card-rpg-lab --solve ClassA:ClassB" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Generate the boss endgame tablebase requested on the command line
+ * @param argc Number of command-line arguments
+ * @param argv Array of command-line arguments
+ * @return Exit code, 0 on success, 1 on invalid arguments or a write error
+ * @details Understands --tablebase PATH, --threads T (1 to MAX_THREADS,
+ *          all cores when omitted), --levels N (1 to 100) and --limit L. One table is solved for the dungeon
+ *          boss against every class but the Mage at each of the first N
+ *          levels, skipping pairings that share their damage figures.
+ *          Messages of the characters it builds are muted.
+ */
+int runTablebaseGenerator(int argc, char* argv[]) {
+    std::string path = EndgameTablebase::DEFAULT_PATH;
+    unsigned threads = 0;
+    int levels = 5;
+    int limit = EndgameTablebase::DEFAULT_HEALTH_LIMIT;
+
+    try {
+        for (int i = 1; i < argc; i += 2) {
+            std::string option = argv[i];
+            if (i + 1 == argc) {
+                throw std::invalid_argument("Missing value of " + option);
+            }
+            std::string value = argv[i + 1];
+            if (option == "--tablebase") {
+                path = value;
+            } else if (option == "--threads") {
+                threads = static_cast<unsigned>(parseNumber(option, value, 1, MAX_THREADS));
+            } else if (option == "--levels") {
+                levels = static_cast<int>(parseNumber(option, value, 1, 100));
+            } else if (option == "--limit") {
+                limit = static_cast<int>(parseNumber(option, value, 2, Entity::MAX_HEALTH));
+            } else {
+                throw std::invalid_argument("Unknown option " + option);
+            }
+        }
+
+        std::vector<EndgameRules> rules;
+        {
+            GameContext::Mute mute(GameContext::threadDefault());
+            auto boss = DungeonMode::createBoss();
+            for (const char* className : {"Warrior", "Mage", "Archer", "Healer"}) {
+                auto hero = createCharacter(className, className);
+                for (int level = 1; level <= levels; ++level) {
+                    EndgameRules pairing;
+                    if (EndgameRules::between(*boss, *hero, pairing) &&
+                        std::find(rules.begin(), rules.end(), pairing) == rules.end()) {
+                        rules.push_back(pairing);
+                    }
+                    hero->setAttackPower(hero->getAttackPower() + 2);
+                    hero->setDefense(hero->getDefense() + 1);
+                }
+            }
+        }
+
+        std::cout << "Solving " << rules.size() << " endgame tables..." << std::endl;
+        EndgameTablebase::generate(path, rules, limit, threads);
+        std::cout << "Wrote " << path << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        std::cerr << "Usage: card-rpg-lab --tablebase PATH [--threads T] [--levels N] [--limit L]" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Replay the battles of a recorded replay file
+ * @param argc Number of command-line arguments
+ * @param argv Array of command-line arguments
+ * @return Exit code, 0 if every battle ended as recorded, 1 on invalid
+ *         arguments, an unreadable file or a battle that diverged
+ * @details Understands --replay FILE [--turn N]. Every battle is re-run
+ *          headlessly, checked against its recorded round hashes and its
+ *          outcome printed next to the recorded one.
+ *          With --turn, the state of both sides after N turns of each
+ *          battle is printed too, found by seeking from the nearest keyframe.
+ */
+int runReplay(int argc, char* argv[]) {
+    try {
+        int seekTurn = -1;
+        if (argc == 5 && std::string(argv[3]) == "--turn") {
+            seekTurn = static_cast<int>(parseNumber("--turn", argv[4], 0, std::numeric_limits<int>::max()));
+        } else if (argc != 3) {
+            throw std::invalid_argument("Expected a single replay file");
+        }
+        BattleReplay replay = BattleReplay::load(argv[2]);
+        std::cout << "Replaying " << replay.battles.size() << " battles of session " << replay.seed << std::endl;
+
+        auto describe = [](const ReplayBattle& battle, BattleResult::Winner winner, int turns) {
+            std::string outcome = "draw";
+            if (winner == BattleResult::Winner::PLAYER) {
+                outcome = battle.player.name + " wins";
+            } else if (winner == BattleResult::Winner::ENEMY) {
+                outcome = battle.enemy.name + " wins";
+            }
+            return outcome + " after " + std::to_string(turns) + " turns";
+        };
+
+        bool diverged = false;
+        for (size_t i = 0; i < replay.battles.size(); ++i) {
+            const ReplayBattle& battle = replay.battles[i];
+            ReplayCheck check = battle.verify(replay.seed);
+            const BattleResult& result = check.result;
+            bool matches = !check.divergence && result.winner == battle.winner && result.turns == battle.turns;
+            diverged |= !matches;
+
+            std::cout << "Battle " << battle.battleId
+                      << (battle.mode == ReplayBattle::Mode::PVP ? " (PvP): " : ": ")
+                      << battle.player.name << " vs " << battle.enemy.name << ": "
+                      << describe(battle, result.winner, result.turns);
+            if (matches) {
+                std::cout << " (as recorded)" << std::endl;
+            } else {
+                std::cout << " (DIVERGED, recorded " << describe(battle, battle.winner, battle.turns);
+                if (check.divergence) {
+                    std::cout << "; first differs at turn " << check.divergence->turn;
+                }
+                std::cout << ")" << std::endl;
+            }
+
+            if (seekTurn >= 0) {
+                ReplayCursor cursor(battle, replay.seed);
+                cursor.seek(seekTurn);
+                std::cout << "  after " << cursor.getTurn() << " turns:";
+                for (const Character* side : {&cursor.getPlayer(), &cursor.getEnemy()}) {
+                    std::cout << " " << side->getName() << " " << side->getHealth() << " HP " << side->getMana()
+                              << " MP" << (side == &cursor.getPlayer() ? "," : "");
+                }
+                std::cout << std::endl;
+            }
+        }
+        return diverged ? 1 : 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        std::cerr << "Usage: card-rpg-lab --replay FILE [--turn N]" << std::endl;
+        return 1;
+    }
+}
+
+/**
+ * @brief Remove an option and its value from the command line
+ * @param args Command-line arguments
+ * @param name Option to look for
+ * @param value Receives the option's value
+ * @return True if the option was given
+ * @throws std::invalid_argument if the option has no value
+ */
+bool takeOption(std::vector<char*>& args, const std::string& name, std::string& value) {
+    auto option = std::find_if(args.begin(), args.end(), [&name](const char* arg) { return name == arg; });
+    if (option == args.end()) {
+        return false;
+    }
+    if (option + 1 == args.end()) {
+        throw std::invalid_argument("Missing value of " + name);
+    }
+    value = *(option + 1);
+    args.erase(option, option + 2);
+    return true;
+}
+
 /**
  * @brief Main entry point of the application
  * @param argc Number of command-line arguments
  * @param argv Array of command-line arguments
  * @return Exit code, 0 on normal termination
  * @details Initializes the game and runs it in normal mode or test mode
- *          depending on command-line arguments
+ *          depending on command-line arguments, or runs a headless
+ *          matchup simulation when started with --simulate or --solve,
+ *          or generates the boss endgame tablebase with --tablebase.
+ *          --replay FILE re-runs a recorded replay headlessly.
+ *          --log-level debug|info|warning|error|off may be given anywhere
+ *          to choose which diagnostics are logged, and --record FILE to
+ *          save a replay of every battle played.
  */
 int main(int argc, char* argv[]) {
     bool testMode = false;
 
+    std::vector<char*> args(argv, argv + argc);
+    std::string recordPath;
+    try {
+        std::string level;
+        if (takeOption(args, "--log-level", level)) {
+            Logger::setLevel(Logger::parseLevel(level));
+        }
+        takeOption(args, "--record", recordPath);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        std::cerr << "Usage: card-rpg-lab [--log-level debug|info|warning|error|off] [--record FILE] ..." << std::endl;
+        return 1;
+    }
+    argc = static_cast<int>(args.size());
+    argv = args.data();
+
+    if (argc > 1 && (std::string(argv[1]) == "--simulate" || std::string(argv[1]) == "--solve")) {
+        return runSimulation(argc, argv);
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--tablebase") {
+        return runTablebaseGenerator(argc, argv);
+    }
+
+    if (argc > 1 && std::string(argv[1]) == "--replay") {
+        return runReplay(argc, argv);
+    }
+
     if (argc > 1 && std::string(argv[1]) == "--test") {
         testMode = true;
     }
 
+    ReplayRecorder recorder(recordPath);
     auto player = createPlayer(testMode);
     GameManager gameManager(player);
+    if (!recordPath.empty()) {
+        gameManager.getContext().setReplayRecorder(&recorder);
+    }
 
     if (testMode) {
         gameManager.runTestMode();
@@ -11,7 +11,15 @@
  */
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <memory>
+#include <sstream>
+#include <thread>
+#include <tuple>
 #include "Entity.h"
 #include "Character.h"
 #include "Warrior.h"
@@ -32,7 +40,17 @@
 #include "PvPMode.h"
 #include "BattleMode.h"
 #include "BossAI.h"
+#include "MctsAI.h"
+#include "BattleReplay.h"
+#include "BenchmarkBaseline.h"
+#include "BattleState.h"
+#include "CommandLog.h"
+#include "BattleHash.h"
+#include "TranspositionTable.h"
+#include "BattleSolver.h"
+#include "EndgameTablebase.h"
 #include "AdvancedAI.h"
+#include "EasyAI.h"
 #include "Deck.h"
 #include "DungeonMode.h"
 #include "ExplorationMode.h"
@@ -44,6 +62,13 @@
 #include "HealthPotion.h"
 #include "UI.h"
 #include "GameManager.h"
+#include "BattleEngine.h"
+#include "CardCatalog.h"
+#include "CombatantStore.h"
+#include "GameContext.h"
+#include "Logger.h"
+#include "MatchupSimulator.h"
+#include "RandomService.h"
 
 /**
  * @brief Tests the basic health and mana management of the Entity class
@@ -579,11 +604,49 @@ TEST(GameManagerTest, InventoryInitialization) {
  *          - The log maintains only the most recent messages
  */
 TEST(UITest, BattleLogLimiting) {
-    UI::battleLog.clear();
+    GameContext context(1, nullptr);
     for (int i = 0; i < 10; i++) {
-        UI::addToLog("Message " + std::to_string(i));
+        UI::addToLog(context, "Message " + std::to_string(i));
     }
-    EXPECT_EQ(UI::battleLog.size(), 5);
+    EXPECT_EQ(context.getBattleLog().size(), 5);
+    EXPECT_EQ(UI::formatLogEntry(context.getBattleLog(), 0), "Message 5");
+}
+
+/**
+ * @brief Tests the records behind the battle log
+ * @details Verifies that:
+ *          - Actions are kept as small records and formatted when read
+ *          - Names of characters mentioned by kept entries survive while
+ *            many other characters pass through the log
+ *          - Names longer than MAX_NAME_LENGTH are cut short
+ */
+TEST(UITest, BattleLogRecordsActions) {
+    GameContext context(1, nullptr);
+    std::vector<std::unique_ptr<Warrior>> fighters;
+    for (int i = 0; i < 9; ++i) {
+        fighters.push_back(std::make_unique<Warrior>("Fighter" + std::to_string(i), 100, 0, 10, 0));
+    }
+    for (int i = 0; i < 40; ++i) {
+        UI::addToLog(context, BattleLog::Kind::ATTACK, fighters[i % 9].get(), fighters[(i * 4 + 1) % 9].get());
+    }
+    const BattleLog& log = context.getBattleLog();
+    ASSERT_EQ(log.size(), BattleLog::CAPACITY);
+    for (size_t k = 0; k < log.size(); ++k) {
+        int i = 35 + static_cast<int>(k);
+        EXPECT_EQ(UI::formatLogEntry(log, k), COLOR_GREEN + "Fighter" + std::to_string(i % 9) + " attacks Fighter" +
+                                                  std::to_string((i * 4 + 1) % 9) + "!" + COLOR_RESET);
+    }
+
+    UI::addToLog(context, BattleLog::Kind::CARD_USED, fighters[0].get(), fighters[1].get(), 0, CardId::FIREBALL);
+    UI::displayDamage(context, *fighters[2], 12);
+    EXPECT_EQ(UI::formatLogEntry(log, 3), COLOR_CYAN + "Fighter0 uses Fireball!" + COLOR_RESET);
+    EXPECT_EQ(UI::formatLogEntry(log, 4), COLOR_RED + "Fighter2 takes 12 damage!" + COLOR_RESET);
+    EXPECT_EQ(log[4].actor, fighters[2]->getActorId());
+    EXPECT_LE(sizeof(BattleLog::Entry), 16u);
+
+    Warrior titled("Fighter of the Unending Northern Wastes", 100, 0, 10, 0);
+    UI::addToLog(context, BattleLog::Kind::HEAL, &titled, nullptr, 7);
+    EXPECT_EQ(UI::formatLogEntry(log, 4), COLOR_GREEN + "Fighter of the Unending Norther heals 7 HP!" + COLOR_RESET);
 }
 TEST(EffectTest, CombinedEffects) {
     Warrior target("Warrior", 100, 50, 20, 5);
@@ -605,6 +668,32 @@ TEST(DeckTest, EmptyDeckHandling) {
     EXPECT_TRUE(deck.getCards().empty());
 }
 
+/**
+ * @brief Tests that deck views and indexed access return the catalog prototypes in place
+ */
+TEST(DeckTest, ViewAndIndexedAccess) {
+    Deck deck{CardId::ATTACK, CardId::POISON, CardId::SHIELD};
+    Deck::CardView view = deck.view();
+    ASSERT_EQ(view.size(), 3u);
+    EXPECT_FALSE(view.empty());
+    EXPECT_EQ(&view[1], &CardCatalog::get(CardId::POISON));
+    EXPECT_EQ(&deck.at(2), &CardCatalog::get(CardId::SHIELD));
+    EXPECT_THROW(deck.at(3), std::out_of_range);
+
+    std::vector<std::string> names;
+    for (const auto& card : view) {
+        names.push_back(card->getName());
+    }
+    EXPECT_EQ(names, (std::vector<std::string>{"Attack Card", "Poison", "Shield"}));
+    EXPECT_EQ(view.end() - view.begin(), 3);
+
+    deck.drawCard();
+    deck.drawCard();
+    deck.drawCard();
+    EXPECT_TRUE(deck.empty());
+    EXPECT_TRUE(deck.view().empty());
+}
+
 /**
  * @brief Tests the archer's initialization with correct attributes
  */
@@ -635,9 +724,10 @@ TEST(HealerTest, AttackMechanics) {
 class TestCard : public Card {
 public:
     TestCard() : Card("Test Card", "A card for testing") {}
-    void play(Entity& target) override {
+    void play(Entity& target, GameContext& context) override {
         target.heal(10);
     }
+    using Card::play;
     int getManaCost() const override { return 5; }
 };
 
@@ -656,4 +746,1604 @@ TEST(CardTest, BasicFunctionality) {
     Entity target("Target", 50, 0);
     testCard.play(target);
     EXPECT_EQ(target.getHealth(), 60);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Tests a headless battle between two AI-controlled characters
+ * @details Verifies that the battle engine:
+ *          - Runs the battle to completion without writing to stdout
+ *          - Reports the winner and the number of rounds played
+ *          - Credits the damage dealt to the winning side
+ */
+TEST(BattleEngineTest, HeadlessBattle) {
+    auto player = std::make_shared<Warrior>("Hero", 200, 50, 20, 10);
+    auto enemy = std::make_shared<Warrior>("Goblin", 50, 0, 10, 5);
+    BattleEngine engine(player, enemy);
+    AutoActionSource autopilot;
+
+    testing::internal::CaptureStdout();
+    BattleResult result = engine.run(autopilot);
+    std::string output = testing::internal::GetCapturedStdout();
+
+    EXPECT_TRUE(output.empty());
+    EXPECT_EQ(result.winner, BattleResult::Winner::PLAYER);
+    EXPECT_FALSE(enemy->isAlive());
+    EXPECT_GT(result.turns, 0);
+    EXPECT_GE(result.playerDamageDealt, 50);
+}
+
+/**
+ * @brief Tests the turn limit and card actions of the battle engine
+ * @details Ensures that:
+ *          - Playing a card keeps the initiative with the player
+ *          - Applied effects are counted for the acting side
+ *          - The battle ends in a draw once the turn limit is reached
+ */
+TEST(BattleEngineTest, TurnLimitAndCards) {
+    class FirstCardSource : public ActionSource {
+    public:
+        BattleChoice chooseAction(Character& self, Character& opponent) override {
+            return BattleChoice(BattleAction::ABILITY, 0);
+        }
+    };
+
+    auto player = std::make_shared<Archer>("Ranger", 150, 100, 18, 8);
+    auto enemy = std::make_shared<Warrior>("Dummy", 200, 0, 0, 0);
+    BattleEngine engine(player, enemy);
+    engine.setMaxTurns(2);
+    FirstCardSource source;
+
+    BattleResult result = engine.run(source);
+
+    EXPECT_EQ(result.winner, BattleResult::Winner::DRAW);
+    EXPECT_EQ(result.turns, 2);
+    EXPECT_EQ(result.enemyDamageDealt, 0);
+    EXPECT_EQ(result.playerEffectsApplied, 2);
+    EXPECT_EQ(player->getMana(), 70);
+}
+
+/**
+ * @brief Tests closed-form resolution of attack-only rounds
+ * @details Ensures that:
+ *          - Skipped rounds leave the result and both characters exactly as
+ *            playing them would, with effects ticking out on the way
+ *          - A turn limit reached while skipping still ends in a draw
+ *          - A stalemate runs to the turn limit without playing it out
+ */
+TEST(BattleEngineTest, FastForwardMatchesPlayedRounds) {
+    auto playOut = [](bool fastForward, int maxTurns, BattleState& end) {
+        GameContext context(11, nullptr);
+        auto hero = std::make_shared<Warrior>("Hero", 120, 0, 18, 4);
+        auto goblin = std::make_shared<Healer>("Goblin", 150, 0, 12, 3);
+        hero->setContext(&context);
+        goblin->setContext(&context);
+        goblin->setDeck(std::make_shared<Deck>(Deck{CardId::ATTACK}));
+        goblin->setAI(std::make_shared<EasyAI>(goblin));
+        hero->applyEffect(EffectType::BURN, 1.0f, 3, 5);
+        goblin->applyEffect(EffectType::REGENERATION, 1.0f, 2, 0, 10);
+
+        BattleEngine engine(hero, goblin, context);
+        engine.setFastForward(fastForward);
+        engine.setMaxTurns(maxTurns);
+        AutoActionSource autopilot;
+        BattleResult result = engine.run(autopilot);
+        end = BattleState::capture(*hero, *goblin);
+        return result;
+    };
+
+    for (int maxTurns : {0, 4}) {
+        BattleState playedState;
+        BattleState skippedState;
+        BattleResult played = playOut(false, maxTurns, playedState);
+        BattleResult skipped = playOut(true, maxTurns, skippedState);
+        EXPECT_EQ(played.fastForwardedTurns, 0);
+        EXPECT_GT(skipped.fastForwardedTurns, 0);
+        EXPECT_EQ(skipped.winner, played.winner);
+        EXPECT_EQ(skipped.turns, played.turns);
+        EXPECT_EQ(skipped.playerDamageDealt, played.playerDamageDealt);
+        EXPECT_EQ(skipped.enemyDamageDealt, played.enemyDamageDealt);
+        EXPECT_EQ(skipped.enemyEffectsApplied, played.enemyEffectsApplied);
+        // Inventories hold the items of each run's own characters
+        skippedState.player.items = playedState.player.items;
+        skippedState.enemy.items = playedState.enemy.items;
+        EXPECT_TRUE(skippedState == playedState);
+    }
+
+    auto left = std::make_shared<Healer>("Left", 50, 0, 0, 0);
+    auto right = std::make_shared<Healer>("Right", 50, 0, 0, 0);
+    left->setDeck(std::make_shared<Deck>());
+    right->setDeck(std::make_shared<Deck>());
+    GameContext context(1, nullptr);
+    BattleEngine stalemate(left, right, context);
+    stalemate.setMaxTurns(100000);
+    AutoActionSource autopilot;
+    BattleResult result = stalemate.run(autopilot);
+    EXPECT_EQ(result.winner, BattleResult::Winner::DRAW);
+    EXPECT_EQ(result.turns, 100000);
+    EXPECT_EQ(result.fastForwardedTurns, 100000);
+}
+
+/**
+ * @brief Tests that a headless BattleMode hands out rewards without any output
+ */
+TEST(BattleModeTest, HeadlessRewards) {
+    auto player = std::make_shared<Warrior>("Hero", 200, 50, 20, 10);
+    auto enemy = std::make_shared<Warrior>("Goblin", 50, 0, 10, 5);
+    BattleMode battle(player, enemy, std::make_shared<AutoActionSource>());
+
+    testing::internal::CaptureStdout();
+    battle.start();
+    std::string output = testing::internal::GetCapturedStdout();
+
+    EXPECT_TRUE(output.empty());
+    EXPECT_EQ(battle.getResult().winner, BattleResult::Winner::PLAYER);
+    EXPECT_EQ(player->getKills(), 1);
+    EXPECT_TRUE(battle.isFinished());
+}
+
+/**
+ * @brief Tests that context mutes nest and restore the previous sink
+ */
+TEST(GameContextTest, NestedMute) {
+    std::ostringstream sink;
+    GameContext context(1, &sink);
+    EXPECT_FALSE(context.isQuiet());
+    {
+        GameContext::Mute outer(context);
+        {
+            GameContext::Mute inner(context);
+            EXPECT_TRUE(context.isQuiet());
+        }
+        context.out() << "dropped";
+        EXPECT_TRUE(context.isQuiet());
+    }
+    context.out() << "kept";
+    EXPECT_EQ(sink.str(), "kept");
+}
+
+/**
+ * @brief Tests that cards and characters use the session they are given
+ * @details Equal seeds must give equal random draws, messages must go to the
+ *          session's sink and a virtual clock must not sleep
+ */
+TEST(GameContextTest, SessionOwnsRandomnessOutputAndClock) {
+    std::ostringstream firstSink;
+    std::ostringstream secondSink;
+    GameContext first(7, &firstSink, GameContext::ClockMode::VIRTUAL);
+    GameContext second(7, &secondSink, GameContext::ClockMode::VIRTUAL);
+
+    LightningCard lightning;
+    Entity a("Dummy", 200, 0);
+    Entity b("Dummy", 200, 0);
+    for (int i = 0; i < 5; ++i) {
+        lightning.play(a, first);
+        lightning.play(b, second);
+    }
+    EXPECT_EQ(a.getHealth(), b.getHealth());
+    EXPECT_EQ(firstSink.str(), secondSink.str());
+
+    Warrior warrior("Bound", 100, 0, 10, 0);
+    warrior.setContext(&first);
+    warrior.attack(a);
+    EXPECT_NE(firstSink.str().find("Bound attacks"), std::string::npos);
+    EXPECT_EQ(secondSink.str().find("Bound attacks"), std::string::npos);
+
+    first.sleepFor(std::chrono::milliseconds(1000));
+    EXPECT_EQ(first.elapsed().count(), 1000);
+}
+
+/**
+ * @brief Tests the combat event stream of a session
+ * @details Verifies that:
+ *          - Combat actions are recorded as typed events with actor ids
+ *          - Actor ids are numbered per session, and again when an entity
+ *            moves to another session
+ *          - A quiet session records events without writing any text
+ *          - Events render to the lines the actions print with a sink
+ *          - The stream keeps only its most recent events
+ */
+TEST(GameContextTest, CombatEventStream) {
+    GameContext quiet(3, nullptr);
+    auto caster = std::make_shared<Mage>("Caster", 100, 50, 10, 0);
+    auto target = std::make_shared<Warrior>("Target", 200, 0, 10, 0);
+    caster->setContext(&quiet);
+    target->setContext(&quiet);
+
+    caster->attack(*target);
+    target->updateEffect();
+    const CombatEventStream& events = quiet.getEvents();
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events[0].type, CombatEvent::Type::DAMAGE);
+    EXPECT_EQ(events[0].card, CardId::FIREBALL);
+    EXPECT_EQ(events[0].target, target->getActorId());
+    EXPECT_EQ(events[0].amount, 25);
+    EXPECT_EQ(events[1].type, CombatEvent::Type::EFFECT_APPLIED);
+    EXPECT_EQ(events[1].effect, static_cast<uint8_t>(EffectType::BURN));
+    EXPECT_EQ(events[2].type, CombatEvent::Type::MANA_SPENT);
+    EXPECT_EQ(events[2].source, caster->getActorId());
+    EXPECT_EQ(events[2].amount, 20);
+    EXPECT_EQ(events[3].type, CombatEvent::Type::DAMAGE);
+    EXPECT_EQ(events[3].cause, CombatEvent::Cause::EFFECT);
+    EXPECT_NE(caster->getActorId(), target->getActorId());
+    uint32_t casterId = caster->getActorId();
+    caster->setContext(&quiet);
+    EXPECT_EQ(caster->getActorId(), casterId);
+    GameContext other(4, nullptr);
+    caster->setContext(&other);
+    EXPECT_EQ(caster->getActorId(), 1u);
+    EXPECT_EQ(other.takeActorId(), 2u);
+
+    std::ostringstream text;
+    events[0].render(text, caster->getName(), target->getName());
+    events[3].render(text, "", target->getName());
+    EXPECT_EQ(text.str(), "Fireball deals 25 damage to Target!\nTarget takes 5 damage from effect!\n");
+
+    std::ostringstream sink;
+    GameContext loud(3, &sink);
+    Warrior warrior("Bound", 100, 0, 10, 0);
+    warrior.setContext(&loud);
+    warrior.attack(*target);
+    EXPECT_EQ(sink.str(), "Bound attacks with a sword for 10 damage!\n");
+    EXPECT_EQ(loud.getEvents().size(), 1u);
+
+    CombatEventStream ring(3);
+    EXPECT_EQ(ring.getCapacity(), 4u);
+    for (int i = 0; i < 6; ++i) {
+        ring.push(CombatEvent::damage(CombatEvent::Cause::ATTACK, i));
+    }
+    EXPECT_EQ(ring.size(), 4u);
+    EXPECT_EQ(ring.total(), 6u);
+    EXPECT_EQ(ring[0].amount, 2);
+    EXPECT_EQ(ring.back().amount, 5);
+    EXPECT_LE(sizeof(CombatEvent), 20u);
+}
+
+/**
+ * @brief Tests the asynchronous logger
+ * @details Verifies that:
+ *          - Messages below the level are neither formatted nor written
+ *          - Messages from several threads are written whole, each once
+ *          - Long messages are cut short and unknown level names rejected
+ */
+TEST(LoggerTest, LevelsThreadsAndFlush) {
+    std::ostringstream log;
+    Logger& logger = Logger::instance();
+    std::ostream* previousOutput = logger.setOutput(log);
+    LogLevel previousLevel = Logger::getLevel();
+
+    int formatted = 0;
+    auto format = [&formatted]() { return ++formatted; };
+    Logger::setLevel(LogLevel::WARNING);
+    LOG_INFO("hidden " << format());
+    LOG_WARNING("shown " << 42);
+    logger.flush();
+    EXPECT_EQ(formatted, 0);
+    EXPECT_EQ(log.str(), "[WARNING] shown 42\n");
+
+    log.str("");
+    Logger::setLevel(LogLevel::INFO);
+    uint64_t droppedBefore = logger.dropped();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < 200; ++i) {
+                LOG_INFO("thread " << t << " message " << i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    logger.flush();
+    std::istringstream lines(log.str());
+    std::string line;
+    size_t count = 0;
+    while (std::getline(lines, line)) {
+        EXPECT_EQ(line.rfind("[INFO] thread ", 0), 0u);
+        count++;
+    }
+    EXPECT_EQ(count + (logger.dropped() - droppedBefore), 800u);
+    EXPECT_GT(count, 0u);
+
+    log.str("");
+    LOG_ERROR(std::string(Logger::MAX_MESSAGE + 50, 'x'));
+    logger.flush();
+    EXPECT_EQ(log.str().size(), std::string("[ERROR] ").size() + Logger::MAX_MESSAGE + 1);
+    EXPECT_EQ(Logger::parseLevel("debug"), LogLevel::DEBUG);
+    EXPECT_THROW(Logger::parseLevel("verbose"), std::invalid_argument);
+
+    Logger::setLevel(previousLevel);
+    logger.setOutput(*previousOutput);
+}
+
+/**
+ * @brief Tests that battles in separate sessions can run concurrently
+ * @details Lightning battles on two threads must finish with the same outcome
+ *          as the same seeded battles run one after another
+ */
+TEST(GameContextTest, ConcurrentSessions) {
+    class LightningSource : public ActionSource {
+    public:
+        BattleChoice chooseAction(Character& self, Character& opponent) override {
+            return BattleChoice(BattleAction::ABILITY, 0);
+        }
+    };
+
+    auto playLightningBattle = [](uint32_t seed) {
+        GameContext context(seed, nullptr, GameContext::ClockMode::VIRTUAL);
+        auto player = std::make_shared<Warrior>("Hero", 200, 50, 20, 10);
+        auto enemy = std::make_shared<Warrior>("Golem", 200, 0, 10, 0);
+        auto deck = std::make_shared<Deck>();
+        deck->addCard(std::make_shared<LightningCard>());
+        player->setDeck(deck);
+
+        BattleEngine engine(player, enemy, context);
+        LightningSource source;
+        BattleResult result = engine.run(source);
+        return std::make_pair(result.turns, result.playerDamageDealt);
+    };
+
+    auto expectedFirst = playLightningBattle(11);
+    auto expectedSecond = playLightningBattle(12);
+
+    std::pair<int, int> first;
+    std::pair<int, int> second;
+    std::thread worker([&]() { first = playLightningBattle(11); });
+    second = playLightningBattle(12);
+    worker.join();
+
+    EXPECT_EQ(first, expectedFirst);
+    EXPECT_EQ(second, expectedSecond);
+}
+
+/**
+ * @brief Tests that a parallel matchup simulation accounts for every battle
+ */
+TEST(MatchupSimulatorTest, ParallelRunCountsAllBattles) {
+    MatchupSimulator simulator("Warrior", "Mage");
+    simulator.setMaxTurns(50);
+
+    testing::internal::CaptureStdout();
+    MatchupStats stats = simulator.run(600, 3, 42);
+    std::string output = testing::internal::GetCapturedStdout();
+
+    EXPECT_TRUE(output.empty());
+    EXPECT_EQ(stats.battles, 600u);
+    EXPECT_EQ(stats.winsA + stats.winsB + stats.draws, 600u);
+    EXPECT_GT(stats.meanTurns(), 0.0);
+    EXPECT_LE(stats.meanTurns(), 50.0);
+
+    MatchupStats singleThreaded = simulator.run(600, 1, 42);
+    EXPECT_EQ(singleThreaded.winsA, stats.winsA);
+    EXPECT_EQ(singleThreaded.turnSum, stats.turnSum);
+
+    auto interval = stats.winRateInterval(stats.winsA);
+    EXPECT_LE(interval.first, static_cast<double>(stats.winsA) / stats.battles);
+    EXPECT_GE(interval.second, static_cast<double>(stats.winsA) / stats.battles);
+}
+
+/**
+ * @brief Tests that the combatant table follows the character rules
+ * @details Effect ticks, slot growth, attacks and write-back must leave a
+ *          character in the same state as running the same steps on it directly
+ */
+TEST(CombatantStoreTest, MatchesCharacterRules) {
+    Warrior direct("Direct", 120, 30, 18, 4);
+    GameContext quiet(1, nullptr);
+    direct.setContext(&quiet);
+    direct.applyEffect(EffectType::BURN, 1.0f, 3, 7);
+    direct.applyEffect(EffectType::SLOW, 0.5f, 2);
+
+    CombatantStore store;
+    CombatantHandle hero = store.add(direct);
+    CombatantHandle dummy = store.add("Dummy", 200, 0, 0, 3);
+    EXPECT_EQ(store.size(), 2u);
+    EXPECT_EQ(store.getDefense(hero), 4);
+
+    for (int i = 0; i < 6; ++i) {
+        direct.applyEffect(EffectType::REGENERATION, 1.0f, 2 + i, 0, 5);
+        store.applyEffect(hero, EffectType::REGENERATION, 1.0f, 2 + i, 0, 5);
+    }
+    auto range = store.getEffectRange(hero);
+    EXPECT_EQ(range.second - range.first, 8u);
+
+    Entity target("Dummy", 200, 0, 3);
+    for (int turn = 0; turn < 5; ++turn) {
+        direct.Character::attack(target);
+        store.attack(hero, dummy);
+        direct.updateEffect();
+        store.updateEffects(hero);
+        EXPECT_EQ(store.getHealth(hero), direct.getHealth());
+        EXPECT_EQ(store.getHealth(dummy), target.getHealth());
+        EXPECT_FLOAT_EQ(store.getSpeedModifier(hero), direct.getCurrentSpeedModifier());
+    }
+
+    Warrior copy("Copy", 200, 0, 0, 0);
+    store.writeBack(hero, copy);
+    EXPECT_EQ(copy.getHealth(), direct.getHealth());
+    EXPECT_EQ(copy.getDefense(), direct.getDefense());
+    ASSERT_EQ(copy.getActiveEffects().size(), direct.getActiveEffects().size());
+    for (size_t i = 0; i < copy.getActiveEffects().size(); ++i) {
+        EXPECT_EQ(copy.getActiveEffects()[i].type, direct.getActiveEffects()[i].type);
+        EXPECT_EQ(copy.getActiveEffects()[i].duration, direct.getActiveEffects()[i].duration);
+    }
+}
+
+/**
+ * @brief Tests that the batch effect kernel matches the per-character path
+ * @details Hundreds of combatants with random effects are ticked through
+ *          the batch kernel, the scalar kernel and Character::updateEffect;
+ *          health and remaining effects must agree after every tick
+ */
+TEST(CombatantStoreTest, BatchEffectKernel) {
+    GameContext quiet(1, nullptr);
+    RandomStream random(2024, 1, 0);
+    const EffectType types[] = {EffectType::SLOW, EffectType::BURN, EffectType::POISON, EffectType::REGENERATION};
+
+    CombatantStore batch;
+    CombatantStore scalar;
+    std::vector<std::unique_ptr<Warrior>> characters;
+    for (int i = 0; i < 203; ++i) {
+        characters.push_back(std::make_unique<Warrior>("W" + std::to_string(i), random.uniformInt(1, 200), 0, 10, 0));
+        characters.back()->setContext(&quiet);
+        batch.add(*characters.back());
+        scalar.add(*characters.back());
+    }
+
+    for (int tick = 0; tick < 12; ++tick) {
+        for (size_t i = 0; i < characters.size(); ++i) {
+            if (random.uniformInt(0, 2) == 0) {
+                EffectType type = types[random.uniformInt(0, 3)];
+                int duration = random.uniformInt(1, 4);
+                int damage = random.uniformInt(-2, 40);
+                int healing = random.uniformInt(-2, 40);
+                CombatantHandle handle{static_cast<uint32_t>(i)};
+                characters[i]->applyEffect(type, 0.5f, duration, damage, healing);
+                batch.applyEffect(handle, type, 0.5f, duration, damage, healing);
+                scalar.applyEffect(handle, type, 0.5f, duration, damage, healing);
+            }
+        }
+
+        batch.updateAllEffects();
+        scalar.updateAllEffects(CombatantStore::TickKernel::SCALAR);
+        for (size_t i = 0; i < characters.size(); ++i) {
+            characters[i]->updateEffect();
+            CombatantHandle handle{static_cast<uint32_t>(i)};
+            ASSERT_EQ(batch.getHealth(handle), characters[i]->getHealth());
+            ASSERT_EQ(scalar.getHealth(handle), characters[i]->getHealth());
+            const auto& effects = characters[i]->getActiveEffects();
+            auto range = batch.getEffectRange(handle);
+            ASSERT_EQ(range.second - range.first, effects.size());
+            for (size_t e = 0; e < effects.size(); ++e) {
+                EXPECT_EQ(batch.getEffect(handle, e).duration, effects[e].duration);
+                EXPECT_EQ(batch.getEffect(handle, e).type, effects[e].type);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Tests that decks hold card ids backed by shared catalog prototypes
+ * @details Drawn cards must be the catalog prototypes, copies of a deck must
+ *          be independent and cards outside the catalog must be rejected
+ */
+TEST(CardCatalogTest, DecksShareFlyweightPrototypes) {
+    for (size_t i = 0; i < CardCatalog::size(); ++i) {
+        CardId id = static_cast<CardId>(i);
+        EXPECT_EQ(CardCatalog::get(id)->getId(), id);
+    }
+
+    Deck deck{CardId::FIREBALL, CardId::REGENERATION};
+    deck.addCard(std::make_shared<Poison>());
+    Deck copy = deck;
+    EXPECT_EQ(deck.drawCard(), CardCatalog::get(CardId::POISON));
+    EXPECT_EQ(deck.getCards().front().get(), CardCatalog::get(CardId::FIREBALL).get());
+    EXPECT_EQ(copy.size(), 3u);
+
+    copy.removeCard(CardCatalog::get(CardId::REGENERATION));
+    EXPECT_EQ(copy.getCardIds(), (std::vector<CardId>{CardId::FIREBALL, CardId::POISON}));
+
+    EXPECT_THROW(deck.addCard(std::make_shared<TestCard>()), std::invalid_argument);
+    EXPECT_THROW(CardCatalog::get(CardId::NONE), std::out_of_range);
+}
+
+/**
+ * @brief Tests that the per-kind counts of a deck follow every change to it
+ */
+TEST(DeckTest, KindIndex) {
+    Deck deck{CardId::POISON, CardId::REGENERATION, CardId::POISON};
+    EXPECT_EQ(deck.count(CardId::POISON), 2u);
+    EXPECT_TRUE(deck.contains(CardId::REGENERATION));
+    EXPECT_FALSE(deck.contains(CardId::SHIELD));
+    EXPECT_EQ(deck.find(CardId::REGENERATION), 1u);
+    EXPECT_EQ(deck.find(CardId::SHIELD), Deck::npos);
+    EXPECT_EQ(deck.count(CardId::NONE), 0u);
+
+    deck.drawCard();
+    deck.removeCard(CardId::REGENERATION);
+    deck.removeCard(CardId::SHIELD);
+    EXPECT_EQ(deck.count(CardId::POISON), 1u);
+    EXPECT_FALSE(deck.contains(CardId::REGENERATION));
+    EXPECT_EQ(deck.getCardIds(), (std::vector<CardId>{CardId::POISON}));
+
+    deck.addCard(CardId::SHIELD);
+    deck.removeAt(0);
+    EXPECT_EQ(deck.find(CardId::SHIELD), 0u);
+    EXPECT_EQ(deck.count(CardId::POISON), 0u);
+    EXPECT_THROW(deck.removeAt(1), std::out_of_range);
+    EXPECT_THROW(deck.addCard(CardId::NONE), std::invalid_argument);
+
+    auto boss = std::make_shared<Warrior>("Boss", 20, 50, 20, 5);
+    auto hero = std::make_shared<Warrior>("Hero", 100, 50, 20, 5);
+    auto bossDeck = std::make_shared<Deck>(Deck{CardId::ATTACK, CardId::REGENERATION});
+    BossAI ai(boss, hero, bossDeck);
+    GameContext context(5, nullptr);
+    ai.makeDecision(*boss, *hero, context);
+    EXPECT_GT(boss->getEffectDuration(EffectType::REGENERATION), 0);
+    EXPECT_FALSE(bossDeck->contains(CardId::REGENERATION));
+}
+
+/**
+ * @brief Tests that cards resolve their targets through the entity kind tag
+ * @details Characters of every class must be recognised and carry the
+ *          kind of their class, while plain entities are left untouched by
+ *          character-only cards
+ */
+TEST(EntityKindTest, CardsTargetCharactersWithoutRtti) {
+    Entity dummy("Dummy", 100, 50);
+    Warrior warrior("Warrior", 100, 50, 20, 5);
+    Mage mage("Mage", 80, 100, 10, 3);
+    Archer archer("Archer", 90, 60, 15, 4);
+    Healer healer("Healer", 90, 100, 8, 4);
+    EXPECT_EQ(dummy.getKind(), EntityKind::ENTITY);
+    EXPECT_EQ(warrior.getKind(), EntityKind::WARRIOR);
+    EXPECT_EQ(mage.getKind(), EntityKind::MAGE);
+    EXPECT_EQ(archer.getKind(), EntityKind::ARCHER);
+    EXPECT_EQ(healer.getKind(), EntityKind::HEALER);
+    EXPECT_EQ(Character::from(static_cast<Entity&>(archer)), &archer);
+    EXPECT_EQ(Character::from(static_cast<Entity&>(healer)), &healer);
+    EXPECT_EQ(Character::from(dummy), nullptr);
+    EXPECT_EQ(Character::from(static_cast<Entity&>(mage)), &mage);
+    const Entity& constWarrior = warrior;
+    EXPECT_EQ(Character::from(constWarrior), &warrior);
+
+    GameContext context(3, nullptr);
+    Poison poison;
+    poison.play(dummy, context);
+    poison.play(warrior, context);
+    EXPECT_EQ(dummy.getHealth(), 100);
+    EXPECT_EQ(warrior.getEffectDuration(EffectType::POISON), 5);
+}
+
+/**
+ * @brief Tests that the tree search finds winning moves and honours its limits
+ * @details A lethal Fireball must be preferred over a weak attack, a Lightning
+ *          Card that kills on every roll must be found through its chance node
+ *          by a root-parallel search, and an unlimited search must stop at its
+ *          deadline
+ */
+TEST(MctsAITest, FindsLethalMovesWithinBudget) {
+    GameContext context(11, nullptr);
+    auto healer = std::make_shared<Healer>("Healer", 30, 100, 5, 0);
+    auto warrior = std::make_shared<Warrior>("Warrior", 20, 50, 30, 0);
+
+    healer->setDeck(std::make_shared<Deck>(Deck{CardId::REGENERATION, CardId::FIREBALL}));
+    MctsAI ai(std::chrono::seconds(10));
+    ai.setMaxIterations(3000);
+    MctsMove move = ai.chooseMove(*healer, *warrior, context);
+    EXPECT_EQ(move.action, BattleAction::ABILITY);
+    EXPECT_EQ(move.card, CardId::FIREBALL);
+    EXPECT_EQ(ai.getLastStats().iterations, 3000u);
+    EXPECT_GT(ai.getLastStats().bestValue, 0.9);
+
+    warrior = std::make_shared<Warrior>("Warrior", 10, 50, 30, 0);
+    healer->setDeck(std::make_shared<Deck>(Deck{CardId::LIGHTNING}));
+    MctsAI parallel(std::chrono::seconds(10), 4);
+    parallel.setMaxIterations(1000);
+    move = parallel.chooseMove(*healer, *warrior, context);
+    EXPECT_EQ(move.card, CardId::LIGHTNING);
+    EXPECT_EQ(parallel.getLastStats().threads, 4u);
+    EXPECT_EQ(parallel.getLastStats().iterations, 4000u);
+
+    parallel.makeDecision(*healer, *warrior, context);
+    EXPECT_FALSE(warrior->isAlive());
+    EXPECT_EQ(healer->getDeck()->size(), 0u);
+
+    warrior = std::make_shared<Warrior>("Warrior", 100, 50, 30, 0);
+    MctsAI timed(std::chrono::milliseconds(20), 2);
+    auto start = std::chrono::steady_clock::now();
+    timed.chooseMove(*healer, *warrior, context);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(2));
+    EXPECT_GT(timed.getLastStats().iterations, 0u);
+}
+
+/**
+ * @brief Tests that chance nodes keep their moves while the tree grows
+ * @details Lightning rolls are added as children of chance nodes many
+ *          times while the node vector reallocates; run under a sanitizer
+ *          build this catches reads of a move from freed node storage
+ */
+TEST(MctsAITest, GrowsChanceNodesPastCapacity) {
+    GameContext context(17, nullptr);
+    auto healer = std::make_shared<Healer>("Healer", 200, 100, 5, 0);
+    auto warrior = std::make_shared<Warrior>("Warrior", 200, 50, 10, 0);
+    healer->setDeck(std::make_shared<Deck>(Deck{CardId::LIGHTNING, CardId::LIGHTNING, CardId::LIGHTNING}));
+    warrior->setDeck(std::make_shared<Deck>(Deck{CardId::LIGHTNING, CardId::LIGHTNING}));
+
+    MctsAI ai(std::chrono::seconds(10));
+    ai.setMaxIterations(5000);
+    MctsMove move = ai.chooseMove(*healer, *warrior, context);
+    EXPECT_EQ(ai.getLastStats().iterations, 5000u);
+    EXPECT_GT(ai.getLastStats().nodes, 2000u);
+    EXPECT_TRUE(move.action == BattleAction::ATTACK || move.action == BattleAction::DEFEND ||
+                move.card == CardId::LIGHTNING);
+}
+
+/**
+ * @brief Tests that the dungeon boss chooses its moves with the tree search
+ * @details Verifies that:
+ *          - The dungeon boss's BossAI has its search enabled
+ *          - BattleEngine hands the boss's turns to the search, whose
+ *            threads are kept from one decision to the next
+ *          - Boss battles with the same seed play out the same
+ */
+TEST(MctsAITest, SearchesForTheDungeonBoss) {
+    auto playBossBattle = [](uint64_t seed, MctsSearchStats& stats) {
+        GameContext context(seed, nullptr, GameContext::ClockMode::VIRTUAL);
+        auto player = createCharacter("Warrior", "Hero");
+        DungeonMode dungeon(player);
+        dungeon.generateBoss();
+        auto boss = dungeon.getBoss();
+        EXPECT_EQ(boss->getAI()->getKind(), AIKind::BOSS);
+        auto ai = std::static_pointer_cast<BossAI>(boss->getAI());
+        EXPECT_NE(ai->getSearch(), nullptr);
+        if (!ai->getSearch()) {
+            return std::make_tuple(BattleResult::Winner::DRAW, 0, 0, 0);
+        }
+
+        BattleEngine engine(player, boss, context);
+        engine.setMaxTurns(40);
+        AutoActionSource autopilot;
+        BattleResult result = engine.run(autopilot);
+        stats = ai->getSearch()->getLastStats();
+        return std::make_tuple(result.winner, result.turns, result.playerDamageDealt, result.enemyDamageDealt);
+    };
+
+    MctsSearchStats first;
+    MctsSearchStats second;
+    auto expected = playBossBattle(21, first);
+    EXPECT_GT(std::get<1>(expected), 1);
+    EXPECT_EQ(first.threads, BossAI::SEARCH_THREADS);
+    EXPECT_EQ(first.iterations, BossAI::SEARCH_ITERATIONS * BossAI::SEARCH_THREADS);
+    EXPECT_EQ(playBossBattle(21, second), expected);
+    EXPECT_EQ(second.bestVisits, first.bestVisits);
+}
+
+/**
+ * @brief Tests that a battle state snapshot round-trips to the live characters
+ * @details Stats, progression, effects, deck and inventory changed after the
+ *          capture must all come back on restore, and a memcpy clone must
+ *          restore the same state
+ */
+TEST(BattleStateTest, RoundTripsLiveCharacters) {
+    GameContext context(2, nullptr);
+    Warrior warrior("Warrior", 100, 50, 20, 5);
+    Mage mage("Mage", 80, 100, 10, 3);
+    warrior.setContext(&context);
+    mage.setContext(&context);
+    mage.applyEffect(EffectType::POISON, 1.0f, 3, 5);
+    auto potion = std::make_unique<HealthPotion>();
+    Item* potionItem = potion.get();
+    warrior.getInventory()->addItem(std::move(potion));
+
+    BattleState saved = BattleState::capture(warrior, mage);
+    BattleState clone;
+    std::memcpy(&clone, &saved, sizeof(BattleState));
+
+    warrior.attack(mage);
+    mage.attack(warrior);
+    mage.updateEffect();
+    warrior.setDefense(40);
+    warrior.getDeck()->drawCard();
+    mage.getDeck()->addCard(CardId::SHIELD);
+    warrior.getInventory()->useItem(potionItem, warrior);
+    CombatantSnapshot changed = CombatantSnapshot::capture(mage);
+
+    clone.restore(warrior, mage);
+    EXPECT_EQ(warrior.getHealth(), 100);
+    EXPECT_EQ(warrior.getDefense(), 5);
+    EXPECT_EQ(mage.getHealth(), 80);
+    EXPECT_EQ(mage.getMana(), 100);
+    EXPECT_EQ(mage.getEffectDuration(EffectType::POISON), 3);
+    EXPECT_EQ(warrior.getDeck()->size(), static_cast<size_t>(saved.player.cardCount));
+    EXPECT_FALSE(mage.getDeck()->contains(CardId::SHIELD));
+    ASSERT_EQ(warrior.getInventory()->getItems().size(), static_cast<size_t>(saved.player.itemCount));
+    EXPECT_EQ(warrior.getInventory()->getItems().back(), potionItem);
+
+    BattleState again = BattleState::capture(warrior, mage);
+    EXPECT_EQ(std::memcmp(&again.enemy.effects, &saved.enemy.effects, sizeof(saved.enemy.effects)), 0);
+    EXPECT_NE(changed.health, again.enemy.health);
+
+    for (size_t i = 0; i <= CombatantSnapshot::MAX_EFFECTS; ++i) {
+        mage.applyEffect(EffectType::SLOW, 0.9f, 2);
+    }
+    EXPECT_THROW(CombatantSnapshot::capture(mage), std::length_error);
+}
+
+/**
+ * @brief Tests that the command log takes back and replays combat exactly
+ * @details Ensures that:
+ *          - Undoing a turn restores stats, progression, effects, deck and inventory
+ *          - Redoing it reproduces the changed state
+ *          - An UNDO choice rolls a battle round back, statistics included
+ */
+TEST(CommandLogTest, UndoRedoCombat) {
+    auto expectSame = [](const CombatantSnapshot& a, const CombatantSnapshot& b) {
+        EXPECT_EQ(a.health, b.health);
+        EXPECT_EQ(a.mana, b.mana);
+        EXPECT_EQ(a.damageReduction, b.damageReduction);
+        EXPECT_EQ(a.defense, b.defense);
+        EXPECT_EQ(a.attackPower, b.attackPower);
+        EXPECT_EQ(a.level, b.level);
+        EXPECT_EQ(a.experience, b.experience);
+        EXPECT_EQ(a.kills, b.kills);
+        ASSERT_EQ(a.effectCount, b.effectCount);
+        for (size_t i = 0; i < a.effectCount; ++i) {
+            EXPECT_EQ(a.effects[i].type, b.effects[i].type);
+            EXPECT_EQ(a.effects[i].duration, b.effects[i].duration);
+        }
+        ASSERT_EQ(a.cardCount, b.cardCount);
+        EXPECT_TRUE(std::equal(a.cards.begin(), a.cards.begin() + a.cardCount, b.cards.begin()));
+        ASSERT_EQ(a.itemCount, b.itemCount);
+        EXPECT_TRUE(std::equal(a.items.begin(), a.items.begin() + a.itemCount, b.items.begin()));
+    };
+
+    GameContext context(3, nullptr);
+    CommandLog log;
+    context.setCommandLog(&log);
+    Warrior warrior("Warrior", 100, 50, 20, 5);
+    Mage mage("Mage", 80, 100, 10, 3);
+    warrior.setContext(&context);
+    mage.setContext(&context);
+    auto potion = std::make_unique<HealthPotion>();
+    Item* potionItem = potion.get();
+    warrior.getInventory()->addItem(std::move(potion));
+    mage.applyEffect(EffectType::BURN, 1.0f, 3, 2);
+    BattleState before = BattleState::capture(warrior, mage);
+
+    size_t start = log.position();
+    log.markTurn();
+    warrior.attack(mage);
+    mage.attack(warrior);
+    mage.applyEffect(EffectType::POISON, 1.0f, 1, 5);
+    mage.updateEffect();
+    warrior.setDefense(warrior.getDefense() + 5);
+    warrior.getDeck()->drawCard(context);
+    warrior.getDeck()->removeCard(CardId::ATTACK, context);
+    warrior.getInventory()->useItem(potionItem, warrior);
+    warrior.gainExp(warrior.getRequiredExp());
+    warrior.incrementKills();
+    BattleState after = BattleState::capture(warrior, mage);
+    EXPECT_EQ(after.player.level, before.player.level + 1);
+    EXPECT_EQ(after.enemy.effectCount, 1);
+
+    EXPECT_TRUE(log.undoTurn());
+    EXPECT_EQ(log.position(), start);
+    BattleState undone = BattleState::capture(warrior, mage);
+    expectSame(undone.player, before.player);
+    expectSame(undone.enemy, before.enemy);
+
+    EXPECT_TRUE(log.redoTurn());
+    EXPECT_FALSE(log.canRedo());
+    BattleState redone = BattleState::capture(warrior, mage);
+    expectSame(redone.player, after.player);
+    expectSame(redone.enemy, after.enemy);
+    context.setCommandLog(nullptr);
+
+    class ScriptSource : public ActionSource {
+    public:
+        std::vector<BattleAction> script;
+        size_t next = 0;
+        BattleChoice chooseAction(Character& self, Character& opponent) override {
+            return BattleChoice(next < script.size() ? script[next++] : BattleAction::ATTACK);
+        }
+    };
+
+    auto runBattle = [](std::vector<BattleAction> script, CommandLog* history) {
+        GameContext session(11, nullptr);
+        auto hero = std::make_shared<Warrior>("Hero", 120, 50, 20, 4);
+        auto brute = std::make_shared<Warrior>("Brute", 120, 0, 15, 2);
+        BattleEngine engine(hero, brute, session);
+        engine.setBattleId(1);
+        engine.setMaxTurns(4);
+        engine.setCommandLog(history);
+        ScriptSource source;
+        source.script = std::move(script);
+        BattleResult result = engine.run(source);
+        return std::make_pair(result, BattleState::capture(*hero, *brute));
+    };
+
+    CommandLog history;
+    auto plain = runBattle({BattleAction::ATTACK, BattleAction::DEFEND}, nullptr);
+    auto withUndo = runBattle({BattleAction::UNDO, BattleAction::ATTACK, BattleAction::ATTACK,
+                               BattleAction::UNDO, BattleAction::DEFEND}, &history);
+    EXPECT_EQ(withUndo.first.turns, plain.first.turns);
+    EXPECT_EQ(withUndo.first.playerDamageDealt, plain.first.playerDamageDealt);
+    EXPECT_EQ(withUndo.first.enemyDamageDealt, plain.first.enemyDamageDealt);
+    expectSame(withUndo.second.player, plain.second.player);
+    expectSame(withUndo.second.enemy, plain.second.enemy);
+}
+
+/**
+ * @brief Tests the Zobrist hash of battle states
+ * @details Ensures that:
+ *          - Store rows and snapshots of the same character hash alike
+ *          - Incremental updates agree with hashing from scratch
+ *          - Side to move and identical effects are not lost
+ */
+TEST(BattleHashTest, IncrementalUpdatesMatchFullHash) {
+    GameContext context(5, nullptr);
+    Warrior warrior("Warrior", 100, 50, 20, 5);
+    Mage mage("Mage", 80, 100, 10, 3);
+    warrior.setContext(&context);
+    mage.setContext(&context);
+    mage.applyEffect(EffectType::POISON, 1.0f, 3, 5);
+
+    CombatantStore store;
+    CombatantHandle row = store.add(mage);
+    uint64_t fromStore = BattleHash::combatant(store, row, 1);
+    for (size_t kind = 0; kind < CardCatalog::size(); ++kind) {
+        CardId card = static_cast<CardId>(kind);
+        fromStore ^= BattleHash::cards(1, card, static_cast<uint32_t>(mage.getDeck()->count(card)));
+    }
+    EXPECT_EQ(fromStore, BattleHash::combatant(CombatantSnapshot::capture(mage), 1));
+
+    BattleHash hash = BattleHash::of(BattleState::capture(warrior, mage), 0);
+    EXPECT_NE(hash, BattleHash::of(BattleState::capture(warrior, mage), 1));
+    EXPECT_NE(hash, BattleHash::of(BattleState::capture(mage, warrior), 0));
+
+    int health = mage.getHealth();
+    warrior.attack(mage);
+    hash.changeStat(BattleHash::Feature::HEALTH, 1, health, mage.getHealth());
+    EXPECT_EQ(hash, BattleHash::of(BattleState::capture(warrior, mage), 0));
+
+    size_t shields = warrior.getDeck()->count(CardId::SHIELD);
+    warrior.getDeck()->removeCard(CardId::SHIELD);
+    hash.changeCards(0, CardId::SHIELD, static_cast<uint32_t>(shields), static_cast<uint32_t>(shields - 1));
+    EXPECT_EQ(hash, BattleHash::of(BattleState::capture(warrior, mage), 0));
+
+    size_t slot = mage.getActiveEffects().size();
+    mage.applyEffect(EffectType::POISON, 1.0f, 3, 5);
+    hash.toggle(BattleHash::effect(1, slot, mage.getActiveEffects().back()));
+    EXPECT_EQ(hash, BattleHash::of(BattleState::capture(warrior, mage), 0));
+    EXPECT_NE(BattleHash::effect(1, 0, mage.getActiveEffects()[0]), BattleHash::effect(1, 1, mage.getActiveEffects()[1]));
+}
+
+/**
+ * @brief Tests the lock-free transposition table and its use by MctsAI
+ * @details Ensures that:
+ *          - Samples are averaged and colliding states replace each other
+ *          - Concurrent writers never produce an entry for the wrong state
+ *          - A shared table lets later searches reuse earlier playouts
+ *          - Playouts cached at another distance from the horizon are not
+ *            reused
+ */
+TEST(TranspositionTableTest, SharedEvaluations) {
+    TranspositionTable table(1000);
+    EXPECT_EQ(table.capacity(), 1024u);
+
+    TranspositionTable::Evaluation evaluation;
+    EXPECT_FALSE(table.probe(42, evaluation));
+    table.record(42, 1.0);
+    table.record(42, 0.0);
+    ASSERT_TRUE(table.probe(42, evaluation));
+    EXPECT_EQ(evaluation.samples, 2u);
+    EXPECT_FLOAT_EQ(evaluation.value, 0.5f);
+
+    table.record(42 + table.capacity(), 1.0);
+    EXPECT_FALSE(table.probe(42, evaluation));
+    EXPECT_TRUE(table.probe(42 + table.capacity(), evaluation));
+    table.clear();
+    EXPECT_FALSE(table.probe(42 + table.capacity(), evaluation));
+
+    std::vector<std::thread> writers;
+    std::atomic<int> wrong{0};
+    for (uint64_t writer = 0; writer < 4; ++writer) {
+        writers.emplace_back([&, writer] {
+            for (uint64_t i = 0; i < 20000; ++i) {
+                uint64_t key = ((i % 64) << 32) | (writer << 8) | (i % 64);
+                table.store(key, {static_cast<uint32_t>(writer + 1), static_cast<float>(writer)});
+                TranspositionTable::Evaluation seen;
+                if (table.probe(key, seen) && seen.samples != writer + 1) {
+                    wrong++;
+                }
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    EXPECT_EQ(wrong.load(), 0);
+
+    GameContext context(11, nullptr);
+    auto healer = std::make_shared<Healer>("Healer", 30, 100, 5, 0);
+    auto warrior = std::make_shared<Warrior>("Warrior", 20, 50, 30, 0);
+    healer->setDeck(std::make_shared<Deck>(Deck{CardId::REGENERATION, CardId::FIREBALL}));
+    auto shared = std::make_shared<TranspositionTable>();
+    MctsAI first(std::chrono::seconds(10));
+    MctsAI second(std::chrono::seconds(10), 2);
+    first.setTranspositionTable(shared);
+    second.setTranspositionTable(shared);
+    first.setMaxIterations(2000);
+    second.setMaxIterations(2000);
+
+    EXPECT_EQ(first.chooseMove(*healer, *warrior, context).card, CardId::FIREBALL);
+    MctsMove move = second.chooseMove(*healer, *warrior, context);
+    EXPECT_EQ(move.card, CardId::FIREBALL);
+    EXPECT_GT(second.getLastStats().tableHits, 0u);
+    EXPECT_GT(second.getLastStats().bestValue, 0.9);
+
+    std::array<uint64_t, 2> hits{};
+    for (size_t i = 0; i < hits.size(); ++i) {
+        GameContext shortContext(23, nullptr);
+        MctsAI shortSighted(std::chrono::seconds(10));
+        shortSighted.setTranspositionTable(i == 0 ? std::make_shared<TranspositionTable>() : shared);
+        shortSighted.setHorizon(1);
+        shortSighted.setMaxIterations(2000);
+        shortSighted.chooseMove(*healer, *warrior, shortContext);
+        hits[i] = shortSighted.getLastStats().tableHits;
+    }
+    EXPECT_EQ(hits[1], hits[0]);
+}
+
+/**
+ * @brief Tests the exact outcome solver
+ * @details Ensures that:
+ *          - Two Lightning Cards kill a 40 HP target with probability 11/21
+ *          - Equal states reached by different rolls are merged
+ *          - The characters are left as they were
+ *          - A solved matchup agrees with simulated battles
+ */
+TEST(BattleSolverTest, ExactOddsMatchEnumerationAndSimulation) {
+    GameContext context(1, nullptr);
+    auto caster = std::make_shared<Healer>("Caster", 100, 0, 0, 0);
+    auto dummy = std::make_shared<Warrior>("Dummy", 40, 0, 0, 0);
+    caster->setDeck(std::make_shared<Deck>(Deck{CardId::LIGHTNING, CardId::LIGHTNING}));
+
+    BattleSolver solver(caster, dummy, context);
+    solver.setMaxTurns(5);
+    BattleOdds odds = solver.solve();
+    EXPECT_NEAR(odds.playerWins, 11.0 / 21.0, 1e-12);
+    EXPECT_NEAR(odds.draws, 10.0 / 21.0, 1e-12);
+    EXPECT_EQ(odds.enemyWins, 0.0);
+    EXPECT_NEAR(odds.meanTurns, 11.0 / 21.0 * 2 + 10.0 / 21.0 * 5, 1e-9);
+    // One start state, 21 rolls after the first strike, then the 20 surviving health values
+    EXPECT_EQ(odds.states, 1u + 21u + 3u * 20u);
+    EXPECT_EQ(dummy->getHealth(), 40);
+    EXPECT_EQ(caster->getDeck()->size(), 2u);
+    EXPECT_EQ(context.randomInt(0, 0), 0);
+
+    MatchupSimulator simulator("Warrior", "Mage");
+    BattleOdds exact = simulator.solve();
+    EXPECT_NEAR(exact.playerWins + exact.enemyWins + exact.draws, 1.0, 1e-9);
+    MatchupStats stats = simulator.run(2000, 2, 7);
+    auto interval = stats.winRateInterval(stats.winsA);
+    EXPECT_GE(exact.playerWins, interval.first);
+    EXPECT_LE(exact.playerWins, interval.second);
+    EXPECT_NEAR(exact.meanTurns, stats.meanTurns(), 3 * stats.meanTurnsMargin() + 1e-9);
+}
+
+/**
+ * @brief Tests generating, mapping and playing from an endgame tablebase
+ * @details Ensures that:
+ *          - Files are page-aligned and do not depend on the thread count
+ *          - The table picked by the pairing's rules gives the optimal move,
+ *            including Regeneration where an immediate Lightning could fail
+ *          - BossAI plays the tabled move instead of its random routine
+ *          - Uncovered states, other pairings and broken files are rejected
+ */
+TEST(EndgameTablebaseTest, GeneratedTablePlaysOptimalMoves) {
+    auto boss = std::make_shared<Warrior>("Boss", 4, 0, 3, 0);
+    auto hero = std::make_shared<Healer>("Hero", 11, 0, 4, 0);
+    EndgameRules rules;
+    ASSERT_TRUE(EndgameRules::between(*boss, *hero, rules));
+    EXPECT_EQ(rules.heroHit, 4);
+    EXPECT_EQ(rules.bossHit, 3);
+    EXPECT_FALSE(rules.bossCastsFireballs);
+    EndgameRules unused;
+    EXPECT_FALSE(EndgameRules::between(*DungeonMode::createBoss(), Mage("Hero", 100, 100, 15, 5), unused));
+
+    auto directory = std::filesystem::temp_directory_path();
+    std::string serial = (directory / "card-rpg-endgame-1.tb").string();
+    std::string parallel = (directory / "card-rpg-endgame-3.tb").string();
+    EndgameTablebase::generate(serial, {rules}, 12, 1);
+    EndgameTablebase::generate(parallel, {rules}, 12, 3);
+    std::ifstream first(serial, std::ios::binary);
+    std::ifstream second(parallel, std::ios::binary);
+    std::string serialBytes((std::istreambuf_iterator<char>(first)), std::istreambuf_iterator<char>());
+    std::string parallelBytes((std::istreambuf_iterator<char>(second)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(serialBytes.size() % EndgameTablebase::PAGE_SIZE, 0u);
+    EXPECT_TRUE(serialBytes == parallelBytes);
+
+    EndgameTablebase tablebase(parallel);
+    EXPECT_EQ(tablebase.tableCount(), 1u);
+    EndgameTablebase::Move move;
+    Deck deck{CardId::LIGHTNING, CardId::REGENERATION};
+    ASSERT_TRUE(tablebase.lookup(*boss, *hero, deck, move));
+    EXPECT_EQ(move, EndgameTablebase::Move::REGENERATION);
+    ASSERT_TRUE(tablebase.lookup(Warrior("Boss", 30, 0, 3, 0), Healer("Hero", 10, 0, 4, 0),
+                                 Deck{CardId::LIGHTNING}, move));
+    EXPECT_EQ(move, EndgameTablebase::Move::LIGHTNING);
+
+    EXPECT_FALSE(tablebase.lookup(*boss, Healer("Hero", 12, 0, 4, 0), deck, move));
+    EXPECT_FALSE(tablebase.lookup(*boss, *hero, Deck{CardId::ATTACK}, move));
+    hero->setAttackPower(6);
+    EXPECT_FALSE(tablebase.lookup(*boss, *hero, deck, move));
+    hero->setAttackPower(4);
+    EXPECT_FALSE(EndgameTablebase().lookup(*boss, *hero, deck, move));
+
+    GameContext context(3, nullptr);
+    context.setEndgameTablebase(&tablebase);
+    auto bossDeck = std::make_shared<Deck>(deck);
+    BossAI ai(boss, hero, bossDeck);
+    ai.makeDecision(*boss, *hero, context);
+    EXPECT_EQ(hero->getHealth(), 11);
+    EXPECT_FALSE(bossDeck->contains(CardId::REGENERATION));
+    EXPECT_TRUE(bossDeck->contains(CardId::LIGHTNING));
+    ASSERT_EQ(boss->getActiveEffects().size(), 1u);
+    EXPECT_EQ(boss->getActiveEffects()[0].type, EffectType::REGENERATION);
+
+    {
+        std::ofstream broken(serial, std::ios::binary | std::ios::trunc);
+        broken << std::string(EndgameTablebase::PAGE_SIZE, 'x');
+    }
+    EXPECT_THROW(tablebase.open(serial), std::runtime_error);
+    EXPECT_FALSE(tablebase.isOpen());
+    std::remove(serial.c_str());
+    std::remove(parallel.c_str());
+    EXPECT_THROW(tablebase.open(serial), std::runtime_error);
+}
+
+/**
+ * @brief Tests that boss battles run by the engine play tabled moves
+ * @details Verifies that:
+ *          - A table for the dungeon boss covers every state with both
+ *            sides below its health limit, for every hand
+ *          - BattleEngine hands the boss's turns to its BossAI, which plays
+ *            moves from the tablebase once the endgame is reached
+ */
+TEST(EndgameTablebaseTest, BossBattlesPlayTabledMoves) {
+    auto hero = createCharacter("Warrior", "Hero");
+    auto boss = DungeonMode::createBoss();
+    EndgameRules rules;
+    ASSERT_TRUE(EndgameRules::between(*boss, *hero, rules));
+    const int limit = 20;
+    std::string path = (std::filesystem::temp_directory_path() / "card-rpg-endgame-boss.tb").string();
+    EndgameTablebase::generate(path, {rules}, limit);
+    EndgameTablebase tablebase(path);
+
+    auto setHealth = [](Character& character, int health) {
+        character.heal(Entity::MAX_HEALTH);
+        character.takeDamage(character.getHealth() - health);
+    };
+    const CardId cards[] = {CardId::FIREBALL, CardId::LIGHTNING, CardId::REGENERATION};
+    EndgameTablebase::Move move;
+    int covered = 0;
+    for (int hand = 0; hand < 8; ++hand) {
+        Deck deck;
+        for (int card = 0; card < 3; ++card) {
+            if (hand & (1 << card)) {
+                deck.addCard(cards[card]);
+            }
+        }
+        for (int bossHealth = 1; bossHealth < limit; ++bossHealth) {
+            for (int heroHealth = 1; heroHealth < limit; ++heroHealth) {
+                setHealth(*boss, bossHealth);
+                setHealth(*hero, heroHealth);
+                covered += tablebase.lookup(*boss, *hero, deck, move) ? 1 : 0;
+            }
+        }
+    }
+    EXPECT_EQ(covered, 8 * (limit - 1) * (limit - 1));
+
+    setHealth(*boss, 15);
+    setHealth(*hero, 19);
+    auto bossDeck = std::make_shared<Deck>(Deck{CardId::FIREBALL, CardId::LIGHTNING, CardId::REGENERATION});
+    boss->setDeck(bossDeck);
+    auto ai = std::make_shared<BossAI>(boss, hero, bossDeck);
+    boss->setAI(ai);
+    GameContext context(5, nullptr, GameContext::ClockMode::VIRTUAL);
+    context.setEndgameTablebase(&tablebase);
+    BattleEngine engine(hero, boss, context);
+    engine.setMaxTurns(100);
+    AutoActionSource autopilot;
+    BattleResult result = engine.run(autopilot);
+    EXPECT_GT(ai->getEndgameMoves(), 0u);
+    EXPECT_LE(ai->getEndgameMoves(), static_cast<uint64_t>(result.turns));
+    std::remove(path.c_str());
+}
+
+/**
+ * @brief Tests the Philox generator against the published known-answer vectors
+ */
+TEST(RandomServiceTest, PhiloxKnownAnswers) {
+    Philox4x32::Counter zero = Philox4x32::generate({0, 0, 0, 0}, {0, 0});
+    EXPECT_EQ(zero, (Philox4x32::Counter{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+
+    Philox4x32::Counter pi = Philox4x32::generate({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+                                                  {0xa4093822, 0x299f31d0});
+    EXPECT_EQ(pi, (Philox4x32::Counter{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+}
+
+/**
+ * @brief Tests that streams are reproducible, independent and stay in range
+ * @details Equal (seed, battle, turn) triples must give equal streams, a
+ *          different turn a different one, and batches must match single draws,
+ *          from any position in a block, over the full range and with rejections
+ */
+TEST(RandomServiceTest, StreamsAndBatches) {
+    RandomService service(99);
+    RandomStream a = service.stream(3, 7);
+    RandomStream b = service.stream(3, 7);
+    RandomStream c = service.stream(3, 8);
+
+    bool differs = false;
+    for (int i = 0; i < 16; ++i) {
+        uint32_t value = a.next();
+        EXPECT_EQ(value, b.next());
+        differs = differs || value != c.next();
+    }
+    EXPECT_TRUE(differs);
+
+    int batch[64];
+    a.fillUniform(10, 30, batch, 64);
+    for (int value : batch) {
+        EXPECT_EQ(value, b.uniformInt(10, 30));
+        EXPECT_GE(value, 10);
+        EXPECT_LE(value, 30);
+    }
+    EXPECT_EQ(a.uniformInt(5, 5), 5);
+
+    int wide[11];
+    a.fillUniform(std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), wide, 11);
+    b.uniformInt(5, 5);
+    for (int value : wide) {
+        EXPECT_EQ(value, b.uniformInt(std::numeric_limits<int>::min(), std::numeric_limits<int>::max()));
+    }
+    int rejecting[400];
+    a.fillUniform(-0x40000000, 0x7FFFFFFF, rejecting, 400);
+    for (int value : rejecting) {
+        EXPECT_EQ(value, b.uniformInt(-0x40000000, 0x7FFFFFFF));
+    }
+}
+
+/**
+ * @brief Tests that a battle replays exactly from its seed and battle id
+ * @details Lightning damage rolls must repeat when the same battle id is
+ *          replayed in a fresh session, and change for another battle id
+ */
+TEST(RandomServiceTest, BattleReplay) {
+    class LightningSource : public ActionSource {
+    public:
+        BattleChoice chooseAction(Character& self, Character& opponent) override {
+            return BattleChoice(BattleAction::ABILITY, 0);
+        }
+    };
+
+    auto playBattle = [](uint64_t battleId) {
+        GameContext context(5, nullptr, GameContext::ClockMode::VIRTUAL);
+        auto player = std::make_shared<Warrior>("Hero", 200, 200, 20, 10);
+        auto enemy = std::make_shared<Warrior>("Golem", 200, 0, 10, 0);
+        auto deck = std::make_shared<Deck>();
+        deck->addCard(std::make_shared<LightningCard>());
+        player->setDeck(deck);
+
+        BattleEngine engine(player, enemy, context);
+        engine.setMaxTurns(4);
+        engine.setBattleId(battleId);
+        LightningSource source;
+        return engine.run(source);
+    };
+
+    BattleResult first = playBattle(17);
+    BattleResult replay = playBattle(17);
+    BattleResult other = playBattle(18);
+    EXPECT_EQ(first.battleId, 17u);
+    EXPECT_EQ(first.playerDamageDealt, replay.playerDamageDealt);
+    EXPECT_NE(first.playerDamageDealt, other.playerDamageDealt);
+
+    GameContext context(5, nullptr);
+    context.beginBattle(17);
+    int total = 0;
+    for (uint32_t turn = 1; turn <= 4; ++turn) {
+        int roll = 0;
+        context.beginTurn(turn);
+        LightningCard::rollDamage(context, &roll, 1);
+        total += roll;
+    }
+    EXPECT_EQ(total, first.playerDamageDealt);
+}
+
+/**
+ * @brief Tests recording battles into a replay file and playing them back
+ * @details Verifies that:
+ *          - BattleMode, PvPMode and DungeonMode battles are recorded
+ *            through a recorder attached to the context
+ *          - The binary format reads back what was written and stays small
+ *          - The recorder's file, appended to battle by battle, reads back
+ *            like the replay written at once, index included
+ *          - Every recorded battle replays to its recorded outcome
+ *          - Truncated data is rejected
+ *          - AIs and items without a kind replays know are refused
+ */
+TEST(BattleReplayTest, RecordsAndReplaysBattles) {
+    class ScriptedSource : public ActionSource {
+    private:
+        size_t turn = 0;
+
+    public:
+        BattleChoice chooseAction(Character& self, Character& opponent) override {
+            static const BattleChoice script[] = {
+                BattleChoice(BattleAction::ABILITY, 0), BattleChoice(BattleAction::ATTACK),
+                BattleChoice(BattleAction::ITEM, 0),    BattleChoice(BattleAction::DEFEND),
+                BattleChoice(BattleAction::ABILITY, 1), BattleChoice(BattleAction::AUTO)};
+            return script[turn++ % (sizeof(script) / sizeof(script[0]))];
+        }
+    };
+
+    GameContext context(11, nullptr, GameContext::ClockMode::VIRTUAL);
+    std::string path = (std::filesystem::temp_directory_path() / "card-rpg-session.replay").string();
+    ReplayRecorder recorder(path);
+    context.setReplayRecorder(&recorder);
+
+    auto hero = createCharacter("Archer", "Hero");
+    auto heroDeck = std::make_shared<Deck>();
+    heroDeck->addCard(CardId::POISON);
+    heroDeck->addCard(CardId::LIGHTNING);
+    hero->setDeck(heroDeck);
+    hero->getInventory()->addItem(std::make_unique<HealthPotion>());
+    hero->getInventory()->addItem(std::make_unique<Weapon>("Longbow", "A sturdy bow", 4));
+    BattleMode battle(hero, std::make_shared<Warrior>("Orc", 120, 0, 15, 4), std::make_shared<ScriptedSource>());
+    battle.setContext(&context);
+    battle.start();
+
+    auto mage = createCharacter("Mage", "Merlin");
+    auto healer = createCharacter("Healer", "Mercy");
+    mage->setContext(&context);
+    healer->setContext(&context);
+    PvPMode pvp(mage, healer, std::make_shared<ScriptedSource>());
+    pvp.setContext(&context);
+    pvp.setMaxTurns(60);
+    pvp.start();
+
+    DungeonMode dungeon(createCharacter("Warrior", "Conan"), std::make_shared<AutoActionSource>());
+    dungeon.setContext(&context);
+    dungeon.start();
+    context.setReplayRecorder(nullptr);
+
+    const BattleReplay& recorded = recorder.getReplay();
+    ASSERT_GE(recorded.battles.size(), 3u);
+    EXPECT_EQ(recorded.seed, 11u);
+    EXPECT_EQ(recorded.battles[0].turns, battle.getResult().turns);
+    EXPECT_EQ(recorded.battles[1].mode, ReplayBattle::Mode::PVP);
+    EXPECT_EQ(recorded.battles[1].winner, pvp.getResult().winner);
+    EXPECT_TRUE(recorded.battles[2].automatic);
+    EXPECT_TRUE(recorded.battles[2].choices.empty());
+
+    std::stringstream file;
+    recorded.write(file);
+    BattleReplay loaded = BattleReplay::read(file);
+    ASSERT_EQ(loaded.battles.size(), recorded.battles.size());
+    EXPECT_EQ(loaded.battles[0].player.items.size(), 2u);
+    EXPECT_EQ(loaded.battles[0].player.items[1].value, 4);
+    EXPECT_EQ(loaded.battles[0].choices, recorded.battles[0].choices);
+    CombatantSnapshot loadedState = loaded.battles[0].player.state;
+    loadedState.items = recorded.battles[0].player.state.items;
+    EXPECT_TRUE(loadedState == recorded.battles[0].player.state);
+
+    BattleReplay saved = BattleReplay::load(path);
+    EXPECT_EQ(saved.seed, recorded.seed);
+    ASSERT_EQ(saved.battles.size(), recorded.battles.size());
+    std::ifstream savedFile(path, std::ios::binary);
+    ReplayIndex index = BattleReplay::readIndex(savedFile);
+    ASSERT_EQ(index.battles.size(), recorded.battles.size());
+    for (size_t i = 0; i < recorded.battles.size(); ++i) {
+        EXPECT_EQ(saved.battles[i].choices, recorded.battles[i].choices);
+        EXPECT_EQ(saved.battles[i].roundHashes, recorded.battles[i].roundHashes);
+        ReplayBattle indexed = BattleReplay::readBattle(savedFile, index.battles[i].offset);
+        EXPECT_EQ(indexed.battleId, recorded.battles[i].battleId);
+        EXPECT_EQ(indexed.turns, recorded.battles[i].turns);
+    }
+    savedFile.close();
+    std::remove(path.c_str());
+
+    for (const ReplayBattle& replayed : loaded.battles) {
+        BattleResult result = replayed.replay(loaded.seed);
+        EXPECT_EQ(result.battleId, replayed.battleId);
+        EXPECT_EQ(result.winner, replayed.winner);
+        EXPECT_EQ(result.turns, replayed.turns);
+        EXPECT_FALSE(replayed.verify(loaded.seed).divergence.has_value());
+    }
+    EXPECT_EQ(loaded.battles[0].replay(loaded.seed).playerDamageDealt, battle.getResult().playerDamageDealt);
+
+    BattleReplay single;
+    single.seed = loaded.seed;
+    single.battles.push_back(loaded.battles[0]);
+    std::stringstream singleFile;
+    single.write(singleFile);
+    EXPECT_LT(singleFile.str().size(), 200u + 4 * single.battles[0].roundHashes.size());
+
+    std::string bytes = file.str();
+    std::stringstream truncated(bytes.substr(0, bytes.size() - 3));
+    EXPECT_THROW(BattleReplay::read(truncated), std::runtime_error);
+    std::stringstream garbage("not a replay at all");
+    EXPECT_THROW(BattleReplay::read(garbage), std::runtime_error);
+
+    class Trinket : public Item {
+    public:
+        Trinket() : Item("Trinket", "Does nothing") {}
+        void apply(Character&) override {}
+    };
+    auto searcher = std::make_shared<Warrior>("Searcher", 100, 0, 10, 5);
+    searcher->setAI(std::make_shared<MctsAI>(std::chrono::milliseconds(1)));
+    EXPECT_THROW(ReplayCombatant::capture(*searcher), std::invalid_argument);
+    searcher->setAI(nullptr);
+    searcher->getInventory()->addItem(std::make_unique<Trinket>());
+    EXPECT_THROW(ReplayCombatant::capture(*searcher), std::invalid_argument);
+}
+
+/**
+ * @brief Tests seeking through a long recorded battle with keyframes
+ * @details Verifies that:
+ *          - Keyframes are taken during long battles, and those rounds
+ *            undone past are dropped
+ *          - Seeking forwards and backwards, and stepping, reach the same
+ *            state as playing the battle from its start
+ *          - The index locates a single battle, which reads back with its
+ *            keyframes
+ *          - Files of the first format version still load
+ */
+TEST(BattleReplayTest, SeeksThroughKeyframes) {
+    class UndoingSource : public ActionSource {
+    private:
+        size_t turn = 0;
+
+    public:
+        BattleChoice chooseAction(Character& self, Character& opponent) override {
+            ++turn;
+            if (turn % 7 == 0 || (turn >= 50 && turn < 54)) {
+                return BattleChoice(BattleAction::UNDO);
+            }
+            return BattleChoice(turn % 5 == 0 ? BattleAction::DEFEND : BattleAction::ATTACK);
+        }
+    };
+
+    GameContext context(23, nullptr, GameContext::ClockMode::VIRTUAL);
+    auto hero = std::make_shared<Warrior>("Hero", 200, 0, 9, 8);
+    auto orc = std::make_shared<Warrior>("Orc", 200, 0, 9, 8);
+    ReplayRecorder recorder;
+    recorder.beginBattle(context, ReplayBattle::Mode::BATTLE, *hero, *orc, 0, true, false);
+    UndoingSource script;
+    RecordingActionSource source(script, recorder);
+    CommandLog log;
+    BattleEngine engine(hero, orc, context);
+    engine.setQuiet(true);
+    engine.setCommandLog(&log);
+    engine.setReplayRecorder(&recorder);
+    BattleResult result = engine.run(source);
+    recorder.endBattle(result);
+    log.clear();
+
+    const ReplayBattle& recorded = recorder.getReplay().battles[0];
+    ASSERT_GT(recorded.turns, 100);
+    ASSERT_GE(recorded.keyframes.size(), 2u);
+    EXPECT_GT(recorded.keyframes[0].progress.turns, 35);
+    EXPECT_EQ(recorded.keyframeAt(recorded.keyframes[0].progress.turns - 1), nullptr);
+    EXPECT_EQ(recorded.keyframeAt(recorded.turns), &recorded.keyframes.back());
+
+    std::stringstream file;
+    recorder.getReplay().write(file);
+    ReplayIndex index = BattleReplay::readIndex(file);
+    ASSERT_EQ(index.battles.size(), 1u);
+    EXPECT_EQ(index.seed, 23u);
+    EXPECT_EQ(index.battles[0].turns, recorded.turns);
+    EXPECT_EQ(index.battles[0].keyframeTurns.size(), recorded.keyframes.size());
+    ReplayBattle loaded = BattleReplay::readBattle(file, index.battles[0].offset);
+    EXPECT_EQ(loaded.choices, recorded.choices);
+    ASSERT_EQ(loaded.keyframes.size(), recorded.keyframes.size());
+
+    ReplayBattle unindexed = loaded;
+    unindexed.keyframes.clear();
+    unindexed.roundHashes.clear();
+    auto expectSame = [&](const ReplayCursor& cursor, int turn) {
+        ReplayCursor reference(unindexed, 23);
+        reference.seek(turn);
+        EXPECT_EQ(cursor.getTurn(), reference.getTurn()) << "turn " << turn;
+        EXPECT_EQ(cursor.getPlayer().getHealth(), reference.getPlayer().getHealth()) << "turn " << turn;
+        EXPECT_EQ(cursor.getEnemy().getHealth(), reference.getEnemy().getHealth()) << "turn " << turn;
+        EXPECT_EQ(cursor.getProgress().playerDamageDealt, reference.getProgress().playerDamageDealt);
+        EXPECT_EQ(cursor.getProgress().enemyDamageDealt, reference.getProgress().enemyDamageDealt);
+    };
+
+    ReplayCursor cursor(loaded, 23);
+    for (int turn : {recorded.turns, 40, 5, recorded.keyframes[0].progress.turns, recorded.turns - 3, 0}) {
+        cursor.seek(turn);
+        expectSame(cursor, turn);
+    }
+    cursor.seek(recorded.keyframes[0].progress.turns);
+    EXPECT_TRUE(cursor.stepBackward());
+    expectSame(cursor, recorded.keyframes[0].progress.turns - 1);
+    EXPECT_TRUE(cursor.stepForward());
+    EXPECT_TRUE(cursor.stepForward());
+    expectSame(cursor, recorded.keyframes[0].progress.turns + 1);
+    cursor.seek(recorded.turns);
+    EXPECT_FALSE(cursor.stepForward());
+    EXPECT_EQ(cursor.getPlayer().getHealth(), hero->getHealth());
+    EXPECT_EQ(cursor.getEnemy().getHealth(), orc->getHealth());
+
+    BattleReplay shortReplay;
+    shortReplay.seed = 23;
+    shortReplay.battles.push_back(unindexed);
+    std::stringstream current;
+    shortReplay.write(current);
+    std::string bytes = current.str();
+    uint64_t indexOffset = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        indexOffset |= static_cast<uint64_t>(static_cast<uint8_t>(bytes[bytes.size() - 8 + i])) << (8 * i);
+    }
+    std::string first = bytes.substr(0, indexOffset - 2);
+    first[8] = 1;
+    std::stringstream firstFile(first);
+    BattleReplay old = BattleReplay::read(firstFile);
+    ASSERT_EQ(old.battles.size(), 1u);
+    EXPECT_EQ(old.battles[0].choices, recorded.choices);
+    EXPECT_EQ(old.battles[0].replay(old.seed).turns, recorded.turns);
+}
+
+/**
+ * @brief Tests checking replayed battles against their recorded round hashes
+ * @details Verifies that:
+ *          - A battle records one hash per round and one at its end, and
+ *            they survive the file format
+ *          - An unchanged battle replays with every hash matching
+ *          - A changed choice or hash is reported at the first round it
+ *            affects, with the events of the round that led to it
+ */
+TEST(BattleReplayTest, VerifiesRoundHashes) {
+    class AttackingSource : public ActionSource {
+    public:
+        BattleChoice chooseAction(Character& self, Character& opponent) override {
+            return BattleChoice(BattleAction::ATTACK);
+        }
+    };
+
+    GameContext context(31, nullptr, GameContext::ClockMode::VIRTUAL);
+    auto hero = std::make_shared<Warrior>("Hero", 200, 0, 12, 8);
+    auto orc = std::make_shared<Warrior>("Orc", 200, 0, 11, 8);
+    ReplayRecorder recorder;
+    recorder.beginBattle(context, ReplayBattle::Mode::BATTLE, *hero, *orc, 0, false, false);
+    AttackingSource script;
+    RecordingActionSource source(script, recorder);
+    BattleEngine engine(hero, orc, context);
+    engine.setReplayRecorder(&recorder);
+    recorder.endBattle(engine.run(source));
+
+    std::stringstream file;
+    recorder.getReplay().write(file);
+    BattleReplay loaded = BattleReplay::read(file);
+    const ReplayBattle& recorded = loaded.battles[0];
+    ASSERT_GT(recorded.turns, 10);
+    EXPECT_EQ(recorded.roundHashes, recorder.getReplay().battles[0].roundHashes);
+    EXPECT_EQ(recorded.roundHashes.size(), static_cast<size_t>(recorded.turns) + 1);
+
+    ReplayCheck check = recorded.verify(loaded.seed);
+    EXPECT_FALSE(check.divergence.has_value());
+    EXPECT_EQ(check.rounds, recorded.roundHashes.size());
+    EXPECT_EQ(check.result.turns, recorded.turns);
+
+    ReplayBattle changedChoice = recorded;
+    changedChoice.choices[3] = static_cast<uint8_t>(BattleAction::DEFEND);
+    check = changedChoice.verify(loaded.seed);
+    ASSERT_TRUE(check.divergence.has_value());
+    EXPECT_EQ(check.divergence->round, 4u);
+    EXPECT_EQ(check.divergence->turn, 4);
+    EXPECT_NE(check.divergence->expected, check.divergence->actual);
+    EXPECT_FALSE(check.divergence->events.empty());
+
+    ReplayBattle changedHash = recorded;
+    changedHash.roundHashes[2] ^= 1;
+    check = changedHash.verify(loaded.seed);
+    ASSERT_TRUE(check.divergence.has_value());
+    EXPECT_EQ(check.divergence->round, 2u);
+    EXPECT_EQ(check.rounds, 3u);
+}
+
+/**
+ * @brief Tests storing benchmark runs and flagging regressions between them
+ * @details Verifies that:
+ *          - Only repetitions are read from Google Benchmark JSON, in
+ *            nanoseconds whatever the time unit
+ *          - The Mann-Whitney p-value is small for separated samples and 1
+ *            for identical ones
+ *          - Only significant changes beyond the threshold are flagged, and
+ *            benchmarks with too few repetitions are not tested
+ *          - A stored run is found again by its commit
+ */
+TEST(BenchmarkBaselineTest, ComparesRunsAndFlagsRegressions) {
+    std::istringstream output(R"({
+        "context": {"num_cpus": 4},
+        "benchmarks": [
+            {"name": "BM_A/4", "run_name": "BM_A/4", "run_type": "iteration", "cpu_time": 1.5, "time_unit": "us"},
+            {"name": "BM_A/4", "run_name": "BM_A/4", "run_type": "iteration", "cpu_time": 2e3, "time_unit": "ns"},
+            {"name": "BM_A/4_mean", "run_name": "BM_A/4", "run_type": "aggregate", "cpu_time": 1750}
+        ]
+    })");
+    BenchmarkRun parsed = BenchmarkRun::parse(output);
+    ASSERT_EQ(parsed.samples.size(), 1u);
+    EXPECT_EQ(parsed.samples["BM_A/4"], (std::vector<double>{1500, 2000}));
+    std::istringstream invalid(R"({"benchmarks": [{"name": "BM_A"}]})");
+    EXPECT_THROW(BenchmarkRun::parse(invalid), std::runtime_error);
+
+    std::vector<double> fast = {100, 101, 102, 103, 104, 105, 106, 107};
+    std::vector<double> slow = {120, 121, 122, 123, 124, 125, 126, 127};
+    EXPECT_LT(mannWhitneyPValue(fast, slow), 0.01);
+    EXPECT_DOUBLE_EQ(mannWhitneyPValue(fast, fast), 1.0);
+
+    BenchmarkRun baseline;
+    BenchmarkRun current;
+    baseline.samples["regressed"] = fast;
+    current.samples["regressed"] = slow;
+    baseline.samples["improved"] = slow;
+    current.samples["improved"] = fast;
+    baseline.samples["small"] = fast;
+    current.samples["small"] = {101, 102, 103, 104, 105, 106, 107, 108};
+    baseline.samples["short"] = {100, 100};
+    current.samples["short"] = {200, 200};
+    baseline.samples["removed"] = fast;
+    std::vector<BenchmarkComparison> comparisons = compareBenchmarkRuns(baseline, current, 0.05, 0.05);
+    ASSERT_EQ(comparisons.size(), 4u);
+    EXPECT_EQ(comparisons[0].name, "improved");
+    EXPECT_EQ(comparisons[0].verdict, BenchmarkComparison::Verdict::IMPROVEMENT);
+    EXPECT_EQ(comparisons[1].name, "regressed");
+    EXPECT_EQ(comparisons[1].verdict, BenchmarkComparison::Verdict::REGRESSION);
+    EXPECT_NEAR(comparisons[1].change, 20.0 / 103.5, 1e-9);
+    EXPECT_EQ(comparisons[2].verdict, BenchmarkComparison::Verdict::TOO_FEW_SAMPLES);
+    EXPECT_EQ(comparisons[3].name, "small");
+    EXPECT_EQ(comparisons[3].verdict, BenchmarkComparison::Verdict::UNCHANGED);
+
+    auto directory = std::filesystem::temp_directory_path() / "card-rpg-baselines";
+    std::filesystem::remove_all(directory);
+    std::string result = (std::filesystem::temp_directory_path() / "card-rpg-benchmarks.json").string();
+    {
+        std::ofstream file(result);
+        file << output.str();
+    }
+    BenchmarkBaseline store(directory.string());
+    std::string commit = "0123456789abcdef0123456789abcdef01234567";
+    EXPECT_FALSE(store.has(commit));
+    EXPECT_THROW(store.load(commit), std::runtime_error);
+    store.store(commit, result);
+    EXPECT_TRUE(store.has(commit));
+    EXPECT_EQ(store.load(commit).samples, parsed.samples);
+    std::filesystem::remove_all(directory);
+    std::remove(result.c_str());
+}
+
+/**
+ * @brief Tests matchup statistics merging and unknown class rejection
+ */
+TEST(MatchupSimulatorTest, StatsMergeAndValidation) {
+    MatchupStats a;
+    a.record(0, 4);
+    a.record(1, 6);
+    MatchupStats b;
+    b.record(-1, 10);
+    a.merge(b);
+
+    EXPECT_EQ(a.battles, 3u);
+    EXPECT_EQ(a.draws, 1u);
+    EXPECT_DOUBLE_EQ(a.meanTurns(), 20.0 / 3.0);
+    EXPECT_GT(a.meanTurnsMargin(), 0.0);
+
+    EXPECT_THROW(MatchupSimulator("Warrior", "Dragon"), std::invalid_argument);
+}
@@ -0,0 +1,221 @@
+/**
+ * @file bench_baseline.cpp
+ * @brief Local store of benchmark baselines and regression check
+ * @details Stores the JSON output of the benchmarks target under the git
+ *          commit it was measured at, and compares a new run against a
+ *          stored one with the Mann-Whitney U test. Benchmarks that got
+ *          significantly slower by more than a threshold are printed as a
+ *          table and make the tool exit with 1.
+ */
+
+#include "BenchmarkBaseline.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    /** @brief Default smallest relative change reported, in percent */
+    constexpr double DEFAULT_THRESHOLD = 5.0;
+
+    /** @brief Default significance level */
+    constexpr double DEFAULT_ALPHA = 0.05;
+
+    /**
+     * @brief Print the usage
+     */
+    void usage() {
+        std::cerr << "Usage: bench-baseline store DIR RESULT.json [--commit REF]\n"
+                  << "       bench-baseline compare DIR RESULT.json [--baseline REF] [--threshold PERCENT] "
+                     "[--alpha LEVEL]\n"
+                  << "RESULT.json is the output of benchmarks --benchmark_out_format=json; run it with\n"
+                  << "--benchmark_repetitions=10 or more so the comparison has samples to test." << std::endl;
+    }
+
+    /**
+     * @brief Run a git command and capture its output
+     * @param arguments Arguments after "git"
+     * @return Output with trailing whitespace removed, empty on failure
+     */
+    std::string git(const std::string& arguments) {
+        std::string output;
+        FILE* pipe = popen(("git " + arguments + " 2>/dev/null").c_str(), "r");
+        if (!pipe) {
+            return output;
+        }
+        char buffer[256];
+        while (std::fgets(buffer, sizeof(buffer), pipe)) {
+            output += buffer;
+        }
+        if (pclose(pipe) != 0) {
+            return "";
+        }
+        while (!output.empty() && std::isspace(static_cast<unsigned char>(output.back()))) {
+            output.pop_back();
+        }
+        return output;
+    }
+
+    /**
+     * @brief Resolve a git revision to a full commit hash
+     * @param ref The revision, such as HEAD or a branch name
+     * @return The commit hash
+     * @throws std::invalid_argument if the revision is not a commit
+     */
+    std::string resolveCommit(const std::string& ref) {
+        bool safe = !ref.empty() && std::all_of(ref.begin(), ref.end(), [](char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || std::string("._/~^@{}-").find(c) != std::string::npos;
+        });
+        std::string commit = safe ? git("rev-parse --verify --quiet '" + ref + "^{commit}'") : "";
+        if (commit.empty()) {
+            throw std::invalid_argument("Not a git commit: " + ref);
+        }
+        return commit;
+    }
+
+    /**
+     * @brief Format a duration with a readable unit
+     * @param nanoseconds The duration
+     * @return The duration in ns, us, ms or s
+     */
+    std::string formatTime(double nanoseconds) {
+        static const char* const units[] = {"ns", "us", "ms", "s"};
+        size_t unit = 0;
+        while (nanoseconds >= 1000 && unit + 1 < sizeof(units) / sizeof(units[0])) {
+            nanoseconds /= 1000;
+            unit++;
+        }
+        std::ostringstream text;
+        text << std::fixed << std::setprecision(nanoseconds < 100 ? 2 : 1) << nanoseconds << ' ' << units[unit];
+        return text.str();
+    }
+
+    /**
+     * @brief Store a run under a commit
+     * @param directory Store directory
+     * @param resultPath JSON output of the run
+     * @param ref Revision the run was measured at
+     * @return Exit code
+     */
+    int store(const std::string& directory, const std::string& resultPath, const std::string& ref) {
+        std::string commit = resolveCommit(ref);
+        if (ref == "HEAD" && !git("status --porcelain --untracked-files=no").empty()) {
+            std::cerr << "Warning: the working tree has uncommitted changes the run may include" << std::endl;
+        }
+        BenchmarkBaseline(directory).store(commit, resultPath);
+        std::cout << "Stored " << resultPath << " as the baseline of " << commit << std::endl;
+        return 0;
+    }
+
+    /**
+     * @brief Compare a run against a stored baseline and print the regressions
+     * @param directory Store directory
+     * @param resultPath JSON output of the run
+     * @param ref Revision of the baseline
+     * @param threshold Smallest relative change reported, in percent
+     * @param alpha Significance level
+     * @return 1 if a benchmark regressed, 0 otherwise
+     */
+    int compare(const std::string& directory, const std::string& resultPath, const std::string& ref,
+                double threshold, double alpha) {
+        std::string commit = resolveCommit(ref);
+        BenchmarkRun baseline = BenchmarkBaseline(directory).load(commit);
+        BenchmarkRun current = BenchmarkRun::load(resultPath);
+        std::vector<BenchmarkComparison> comparisons = compareBenchmarkRuns(baseline, current, threshold / 100, alpha);
+
+        size_t counts[4] = {};
+        std::vector<const BenchmarkComparison*> regressions;
+        size_t nameWidth = 9;
+        for (const BenchmarkComparison& comparison : comparisons) {
+            counts[static_cast<size_t>(comparison.verdict)]++;
+            if (comparison.verdict == BenchmarkComparison::Verdict::REGRESSION) {
+                regressions.push_back(&comparison);
+                nameWidth = std::max(nameWidth, comparison.name.size());
+            }
+        }
+        std::sort(regressions.begin(), regressions.end(),
+                  [](const BenchmarkComparison* a, const BenchmarkComparison* b) { return a->change > b->change; });
+
+        std::cout << "Baseline " << commit.substr(0, 12) << ", threshold " << threshold << "%, Mann-Whitney alpha "
+                  << alpha << std::endl;
+        if (regressions.empty()) {
+            std::cout << "No regressions" << std::endl;
+        } else {
+            std::cout << std::left << std::setw(static_cast<int>(nameWidth)) << "Benchmark" << std::right
+                      << std::setw(14) << "Baseline" << std::setw(14) << "Current" << std::setw(10) << "Change"
+                      << std::setw(10) << "p-value" << std::endl;
+            for (const BenchmarkComparison* regression : regressions) {
+                std::ostringstream change;
+                change << std::showpos << std::fixed << std::setprecision(1) << regression->change * 100 << '%';
+                std::ostringstream pValue;
+                pValue << std::setprecision(2) << regression->pValue;
+                std::cout << std::left << std::setw(static_cast<int>(nameWidth)) << regression->name << std::right
+                          << std::setw(14) << formatTime(regression->baselineMedian) << std::setw(14)
+                          << formatTime(regression->currentMedian) << std::setw(10) << change.str() << std::setw(10)
+                          << pValue.str() << std::endl;
+            }
+        }
+
+        using Verdict = BenchmarkComparison::Verdict;
+        std::cout << comparisons.size() << " benchmarks compared: "
+                  << counts[static_cast<size_t>(Verdict::REGRESSION)] << " regressed, "
+                  << counts[static_cast<size_t>(Verdict::IMPROVEMENT)] << " improved, "
+                  << counts[static_cast<size_t>(Verdict::UNCHANGED)] << " unchanged";
+        if (counts[static_cast<size_t>(Verdict::TOO_FEW_SAMPLES)] > 0) {
+            std::cout << ", " << counts[static_cast<size_t>(Verdict::TOO_FEW_SAMPLES)] << " with fewer than "
+                      << MIN_BENCHMARK_SAMPLES << " repetitions";
+        }
+        std::cout << std::endl;
+        return regressions.empty() ? 0 : 1;
+    }
+}
+
+/**
+ * @brief Entry point of the baseline tool
+ * @param argc Number of command-line arguments
+ * @param argv Array of command-line arguments
+ * @return 0 on success, 1 on regressions, 2 on invalid arguments or errors
+ */
+int main(int argc, char* argv[]) {
+    if (argc < 4 || argc % 2 != 0) {
+        usage();
+        return 2;
+    }
+    std::string command = argv[1];
+    std::string ref = "HEAD";
+    double threshold = DEFAULT_THRESHOLD;
+    double alpha = DEFAULT_ALPHA;
+    try {
+        for (int i = 4; i + 1 < argc; i += 2) {
+            std::string option = argv[i];
+            if ((option == "--commit" && command == "store") || (option == "--baseline" && command == "compare")) {
+                ref = argv[i + 1];
+            } else if (option == "--threshold" && command == "compare") {
+                threshold = std::stod(argv[i + 1]);
+            } else if (option == "--alpha" && command == "compare") {
+                alpha = std::stod(argv[i + 1]);
+            } else {
+                throw std::invalid_argument("Unknown option " + option);
+            }
+        }
+        if (threshold < 0 || alpha <= 0 || alpha >= 1) {
+            throw std::invalid_argument("Threshold must not be negative and alpha must be between 0 and 1");
+        }
+        if (command == "store") {
+            return store(argv[2], argv[3], ref);
+        }
+        if (command == "compare") {
+            return compare(argv[2], argv[3], ref, threshold, alpha);
+        }
+        usage();
+        return 2;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 2;
+    }
+}
@@ -0,0 +1,178 @@
+/**
+ * @file replay_verify.cpp
+ * @brief Bulk determinism check of recorded replays
+ * @details Re-simulates every battle of every replay file under a directory
+ *          on all hardware threads and compares each round's rolling state
+ *          hash with the one stored in the file. A battle that leaves its
+ *          recording is reported at the first round that differs, together
+ *          with the combat events of the round that led to it.
+ */
+
+#include "BattleReplay.h"
+#include "GameContext.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    /**
+     * @struct FileReport
+     * @brief Outcome of checking one replay file
+     */
+    struct FileReport {
+        /** @brief Number of battles checked */
+        size_t battles = 0;
+
+        /** @brief Number of rounds replayed */
+        uint64_t turns = 0;
+
+        /** @brief Number of battles that diverged */
+        size_t diverged = 0;
+
+        /** @brief Reason the file could not be read, naming the file; empty if it was read */
+        std::string error;
+
+        /** @brief Description of every divergence, in battle order */
+        std::vector<std::string> problems;
+    };
+
+    /**
+     * @brief Check every battle of a replay file
+     * @param path Path of the file
+     * @return What was checked and what diverged
+     */
+    FileReport verifyFile(const std::string& path) {
+        FileReport report;
+        BattleReplay replay;
+        try {
+            replay = BattleReplay::load(path);
+        } catch (const std::exception& e) {
+            report.error = e.what();
+            return report;
+        }
+
+        for (const ReplayBattle& battle : replay.battles) {
+            ReplayCheck check = battle.verify(replay.seed);
+            report.battles++;
+            report.turns += static_cast<uint64_t>(std::max(check.result.turns, 0));
+
+            std::string problem;
+            if (check.divergence) {
+                const ReplayDivergence& divergence = *check.divergence;
+                problem = "diverged at turn " + std::to_string(divergence.turn) + " (round hash " +
+                          std::to_string(divergence.round + 1) + " of " + std::to_string(battle.roundHashes.size()) +
+                          ")";
+                if (divergence.events.empty()) {
+                    problem += ", no events in the round before";
+                } else {
+                    problem += ", events of the round before:";
+                    for (const std::string& event : divergence.events) {
+                        problem += "\n    " + event;
+                    }
+                }
+            } else if (check.result.winner != battle.winner || check.result.turns != battle.turns) {
+                problem = "ended after " + std::to_string(check.result.turns) + " turns, recorded " +
+                          std::to_string(battle.turns);
+            }
+            if (!problem.empty()) {
+                report.diverged++;
+                report.problems.push_back("  battle " + std::to_string(battle.battleId) + ": " + problem);
+            }
+        }
+        return report;
+    }
+}
+
+/**
+ * @brief Entry point of the replay verifier
+ * @param argc Number of command-line arguments
+ * @param argv Array of command-line arguments
+ * @return 0 if every battle replayed as recorded, 1 otherwise
+ * @details Usage: replay-verify DIR [--threads N]. Every regular file under
+ *          DIR is read as a replay; files that are not count as failures.
+ */
+int main(int argc, char* argv[]) {
+    unsigned threads = 0;
+    if (argc == 4 && std::string(argv[2]) == "--threads") {
+        try {
+            threads = static_cast<unsigned>(std::stoul(argv[3]));
+        } catch (const std::exception&) {
+            argc = 0;
+        }
+    }
+    if (argc != 2 && argc != 4) {
+        std::cerr << "Usage: replay-verify DIR [--threads N]" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> paths;
+    try {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(argv[1])) {
+            if (entry.is_regular_file()) {
+                paths.push_back(entry.path().string());
+            }
+        }
+    } catch (const std::filesystem::filesystem_error& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    std::sort(paths.begin(), paths.end());
+
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(std::min<size_t>(threads, std::max<size_t>(1, paths.size())));
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<FileReport> reports(paths.size());
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for (unsigned worker = 0; worker < threads; ++worker) {
+        workers.emplace_back([&]() {
+            GameContext::Mute mute(GameContext::threadDefault());
+            for (size_t i = next.fetch_add(1, std::memory_order_relaxed); i < paths.size();
+                 i = next.fetch_add(1, std::memory_order_relaxed)) {
+                reports[i] = verifyFile(paths[i]);
+            }
+        });
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t battles = 0;
+    size_t diverged = 0;
+    size_t unreadable = 0;
+    uint64_t turns = 0;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        const FileReport& report = reports[i];
+        battles += report.battles;
+        diverged += report.diverged;
+        turns += report.turns;
+        if (!report.error.empty()) {
+            unreadable++;
+            std::cout << report.error << std::endl;
+        } else if (!report.problems.empty()) {
+            std::cout << paths[i] << ":" << std::endl;
+            for (const std::string& problem : report.problems) {
+                std::cout << problem << std::endl;
+            }
+        }
+    }
+
+    std::cout << "Verified " << battles << " battles (" << turns << " turns) in " << paths.size() << " files on "
+              << threads << " threads in " << seconds << " s";
+    if (seconds > 0) {
+        std::cout << ", " << static_cast<uint64_t>(turns / seconds) << " turns/s";
+    }
+    std::cout << std::endl;
+    std::cout << diverged << " diverged, " << unreadable << " unreadable" << std::endl;
+    return diverged == 0 && unreadable == 0 ? 0 : 1;
+}